@@ -11,6 +11,18 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
+IF(WITH_INTERNAL_BLAS AND NOT WITH_MKLML)
+    # Blas<kX86> runs on lite/backends/x86/math/sgemm, there is nothing to
+    # download, cblas is kept as an empty target for the libraries using it.
+    SET(CBLAS_PROVIDER internal)
+    ADD_DEFINITIONS(-DPADDLE_USE_INTERNAL_BLAS)
+    MESSAGE(STATUS "BLAS library: in-tree sgemm")
+    SET(dummyfile ${CMAKE_CURRENT_BINARY_DIR}/cblas_dummy.c)
+    FILE(WRITE ${dummyfile} "const char *dummy_cblas = \"${dummyfile}\";")
+    ADD_LIBRARY(cblas STATIC ${dummyfile})
+    RETURN()
+ENDIF()
+
 INCLUDE(cblas)
 
 IF(NOT ${CBLAS_FOUND})
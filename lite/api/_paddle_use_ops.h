@@ -84,6 +84,7 @@ USE_LITE_OP(flatten2)
 USE_LITE_OP(split)
 USE_LITE_OP(fake_quantize_moving_average_abs_max);
 USE_LITE_OP(fake_dequantize_max_abs);
+USE_LITE_OP(dequantize_abs_max);
 USE_LITE_OP(fake_quantize_range_abs_max);
 USE_LITE_OP(calib);
 USE_LITE_OP(calib_once);
@@ -107,6 +108,7 @@ USE_LITE_OP(fill_constant)
 USE_LITE_OP(while)
 USE_LITE_OP(lod_reset)
 USE_LITE_OP(lookup_table)
+USE_LITE_OP(fused_multihead_attention)
 USE_LITE_OP(multiclass_nms)
 USE_LITE_OP(graph_op)
 USE_LITE_OP(sequence_expand)
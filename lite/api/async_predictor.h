@@ -0,0 +1,198 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/core/tensor.h"
+#include "lite/core/weight_store.h"
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/cpu_info.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+/*
+ * AsyncPredictor runs the requests on a pool of worker threads, each of them
+ * owns a predictor created by `creator`. A request owns its input and output
+ * tensors, so a caller can keep submitting requests while the previous ones
+ * are still computing. The requests are run in the submission order, by the
+ * first idle worker.
+ *
+ * The inputs are shared with the feed tensors of the predictor without a
+ * copy, the outputs are copied out of the fetch tensors.
+ *
+ * PredictorT is `Predictor` or `LightPredictor`. The workers share the
+ * weights through the WeightStore.
+ *
+ * With `spread_over_numa_nodes`, on x86 Linux, the workers are bound to the
+ * NUMA nodes in turn and each one creates its predictor on its own thread, so
+ * that its weights and buffers are allocated on its node. The weights are
+ * then replicated per node, and shared by the workers of the node.
+ *
+ * Usage:
+ *
+ *   AsyncPredictor<Predictor> async([&] {
+ *     std::unique_ptr<Predictor> predictor(new Predictor);
+ *     predictor->Build(config, config.valid_places());
+ *     return predictor;
+ *   }, 4);
+ *   auto outputs = async.RunAsync(std::move(inputs));
+ *   // ...
+ *   outputs.get();
+ */
+template <typename PredictorT>
+class AsyncPredictor {
+ public:
+  using Tensors = std::vector<Tensor>;
+  using Callback = std::function<void(Tensors&&)>;
+
+  // If `max_queue_size` is not zero, `RunAsync` blocks while there are as
+  // many requests waiting for a worker. With `spread_over_numa_nodes` the
+  // creator is called on the worker threads, concurrently.
+  AsyncPredictor(const std::function<std::unique_ptr<PredictorT>()>& creator,
+                 int num_workers = 1,
+                 size_t max_queue_size = 0,
+                 bool spread_over_numa_nodes = false)
+      : max_queue_size_(max_queue_size) {
+    CHECK_GT(num_workers, 0);
+    std::vector<int> nodes;
+#ifdef LITE_WITH_X86
+    if (spread_over_numa_nodes) nodes = x86::NumaNodes();
+#endif
+    predictors_.resize(num_workers);
+    if (nodes.empty()) {
+      for (auto& predictor : predictors_) {
+        predictor = creator();
+        CHECK(predictor);
+      }
+    }
+    for (int i = 0; i < num_workers; ++i) {
+      if (nodes.empty()) {
+        workers_.emplace_back(&AsyncPredictor::Work, this, i);
+        continue;
+      }
+      const int node = nodes[i % nodes.size()];
+      workers_.emplace_back([this, creator, i, node] {
+#ifdef LITE_WITH_X86
+        if (!x86::BindToNumaNode(node)) {
+          LOG(WARNING) << "Failed to bind a worker to the NUMA node " << node;
+        }
+#endif
+        {
+          WeightStore::NumaNodeGuard numa_guard(node);
+          predictors_[i] = creator();
+          CHECK(predictors_[i]);
+        }
+        Work(i);
+      });
+    }
+  }
+
+  // Finish all the submitted requests.
+  ~AsyncPredictor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    not_empty_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Run the predictor on `inputs`, in the order of the feed vars. The
+  // callback gets the outputs in the order of the fetch vars, it is called
+  // on a worker thread.
+  void RunAsync(Tensors&& inputs, Callback&& callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CHECK(!stopped_);
+    not_full_.wait(lock, [this] {
+      return max_queue_size_ == 0 || requests_.size() < max_queue_size_;
+    });
+    requests_.emplace_back(std::move(inputs), std::move(callback));
+    lock.unlock();
+    not_empty_.notify_one();
+  }
+
+  std::future<Tensors> RunAsync(Tensors&& inputs) {
+    auto promise = std::make_shared<std::promise<Tensors>>();
+    auto future = promise->get_future();
+    RunAsync(std::move(inputs), [promise](Tensors&& outputs) {
+      promise->set_value(std::move(outputs));
+    });
+    return future;
+  }
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  struct Request {
+    Request() = default;
+    Request(Tensors&& inputs, Callback&& callback)
+        : inputs(std::move(inputs)), callback(std::move(callback)) {}
+    Tensors inputs;
+    Callback callback;
+  };
+
+  void Work(int i) {
+    PredictorT* predictor = predictors_[i].get();
+    while (true) {
+      Request request;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock,
+                        [this] { return stopped_ || !requests_.empty(); });
+        if (requests_.empty()) return;
+        request = std::move(requests_.front());
+        requests_.pop_front();
+      }
+      not_full_.notify_one();
+      request.callback(Run(predictor, request.inputs));
+    }
+  }
+
+  static Tensors Run(PredictorT* predictor, const Tensors& inputs) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      predictor->GetInput(i)->ShareDataWith(inputs[i]);
+    }
+    predictor->Run();
+    Tensors outputs(predictor->GetOutputNames().size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      const Tensor* out = predictor->GetOutput(i);
+      outputs[i].CopyDataFrom(*out);
+      outputs[i].set_precision(out->precision());
+    }
+    return outputs;
+  }
+
+  std::vector<std::unique_ptr<PredictorT>> predictors_;
+  std::vector<std::thread> workers_;
+  std::deque<Request> requests_;
+  size_t max_queue_size_;
+  bool stopped_{false};
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+}  // namespace lite
+}  // namespace paddle
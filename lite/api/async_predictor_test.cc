@@ -0,0 +1,130 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/api/async_predictor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+// Doubles its input, counts the runs of all the instances.
+class FakePredictor {
+ public:
+  explicit FakePredictor(std::atomic<int>* runs) : runs_(runs) {}
+
+  Tensor* GetInput(size_t offset) { return &input_; }
+  const Tensor* GetOutput(size_t offset) const { return &output_; }
+  std::vector<std::string> GetOutputNames() { return {"out"}; }
+
+  void Run() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    output_.Resize(input_.dims());
+    auto* out = output_.mutable_data<float>();
+    for (int64_t i = 0; i < input_.numel(); ++i) {
+      out[i] = input_.data<float>()[i] * 2;
+    }
+    ++*runs_;
+  }
+
+ private:
+  std::atomic<int>* runs_;
+  Tensor input_;
+  Tensor output_;
+};
+
+std::vector<Tensor> MakeInputs(float v) {
+  std::vector<Tensor> inputs(1);
+  inputs[0].Resize({3});
+  auto* data = inputs[0].mutable_data<float>();
+  for (int i = 0; i < 3; ++i) data[i] = v + i;
+  return inputs;
+}
+
+TEST(AsyncPredictor, future) {
+  std::atomic<int> runs(0);
+  AsyncPredictor<FakePredictor> async(
+      [&] {
+        return std::unique_ptr<FakePredictor>(new FakePredictor(&runs));
+      },
+      3);
+  ASSERT_EQ(async.num_workers(), 3UL);
+  std::vector<std::future<std::vector<Tensor>>> futures;
+  for (int k = 0; k < 16; ++k) {
+    futures.push_back(async.RunAsync(MakeInputs(k)));
+  }
+  for (int k = 0; k < 16; ++k) {
+    auto outputs = futures[k].get();
+    ASSERT_EQ(outputs.size(), 1UL);
+    ASSERT_EQ(outputs[0].numel(), 3);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(outputs[0].data<float>()[i], 2.f * (k + i));
+    }
+  }
+  EXPECT_EQ(runs.load(), 16);
+}
+
+TEST(AsyncPredictor, callback) {
+  std::atomic<int> runs(0);
+  std::atomic<int> done(0);
+  std::atomic<int> wrong(0);
+  {
+    // A bounded queue, and the destructor finishes the pending requests.
+    AsyncPredictor<FakePredictor> async(
+        [&] {
+          return std::unique_ptr<FakePredictor>(new FakePredictor(&runs));
+        },
+        2,
+        2);
+    for (int k = 0; k < 10; ++k) {
+      async.RunAsync(MakeInputs(k), [&, k](std::vector<Tensor>&& outputs) {
+        if (outputs[0].data<float>()[0] != 2.f * k) ++wrong;
+        ++done;
+      });
+    }
+  }
+  EXPECT_EQ(done.load(), 10);
+  EXPECT_EQ(wrong.load(), 0);
+}
+
+TEST(AsyncPredictor, numa_nodes) {
+  std::atomic<int> runs(0);
+  std::atomic<int> unbound(0);
+  AsyncPredictor<FakePredictor> async(
+      [&] {
+#ifdef LITE_WITH_X86
+        // Created on a worker bound to a node.
+        if (x86::BoundNumaNode() < 0) ++unbound;
+#endif
+        return std::unique_ptr<FakePredictor>(new FakePredictor(&runs));
+      },
+      3,
+      0,
+      true);
+  ASSERT_EQ(async.num_workers(), 3UL);
+  std::vector<std::future<std::vector<Tensor>>> futures;
+  for (int k = 0; k < 8; ++k) {
+    futures.push_back(async.RunAsync(MakeInputs(k)));
+  }
+  for (int k = 0; k < 8; ++k) {
+    EXPECT_EQ(futures[k].get()[0].data<float>()[0], 2.f * k);
+  }
+  EXPECT_EQ(runs.load(), 8);
+  EXPECT_EQ(unbound.load(), 0);
+}
+
+}  // namespace lite
+}  // namespace paddle
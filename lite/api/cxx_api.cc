@@ -19,7 +19,12 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/weight_store.h"
 #include "lite/utils/io.h"
+#ifdef LITE_WITH_X86
+#include "lite/backends/host/host_allocator.h"
+#include "lite/backends/x86/cpu_info.h"
+#endif
 
 namespace paddle {
 namespace lite {
@@ -129,13 +134,10 @@ void Predictor::SaveOpKernelInfo(const std::string &model_dir) {
 }
 
 lite::Tensor *Predictor::GetInput(size_t offset) {
-  CHECK(input_names_.size() > offset)
-      << "The network has " << input_names_.size() << " inputs"
+  CHECK(input_tensors_.size() > offset)
+      << "The network has " << input_tensors_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto *in_var = exec_scope_->FindVar(input_names_[offset]);
-  CHECK(in_var) << "no fatch variable " << input_names_[offset]
-                << " in exec_scope";
-  return in_var->GetMutable<lite::Tensor>();
+  return input_tensors_[offset];
 }
 
 // get inputs names
@@ -165,26 +167,33 @@ void Predictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+
+  // Resolve the feed and fetch tensors once, so that the accessors called
+  // for every request need not look them up in the scope by name.
+  input_tensors_.clear();
+  for (auto &name : input_names_) {
+    auto *in_var = exec_scope_->FindVar(name);
+    CHECK(in_var) << "no feed variable " << name << " in exec_scope";
+    input_tensors_.push_back(in_var->GetMutable<lite::Tensor>());
+  }
+  output_tensors_.clear();
+  for (auto &name : output_names_) {
+    auto *out_var = exec_scope_->FindVar(name);
+    CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
+    output_tensors_.push_back(out_var->GetMutable<lite::Tensor>());
+  }
 }
 
 const lite::Tensor *Predictor::GetOutput(size_t offset) const {
-  CHECK(output_names_.size() > offset)
-      << "The network has " << output_names_.size() << " outputs"
+  CHECK(output_tensors_.size() > offset)
+      << "The network has " << output_tensors_.size() << " outputs"
       << ", the offset should be less than this.";
-  const std::string name = output_names_.at(offset);
-  auto *out_var = exec_scope_->FindVar(name);
-  CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
-  return out_var->GetMutable<lite::Tensor>();
+  return output_tensors_[offset];
 }
 
 std::vector<const lite::Tensor *> Predictor::GetOutputs() const {
-  std::vector<const lite::Tensor *> outputs;
-  size_t out_size = output_names_.size();
-  for (size_t i = 0; i < out_size; i++) {
-    const std::string name = output_names_.at(i);
-    outputs.push_back(GetTensor(name));
-  }
-  return outputs;
+  return std::vector<const lite::Tensor *>(output_tensors_.begin(),
+                                           output_tensors_.end());
 }
 
 const cpp::ProgramDesc &Predictor::program_desc() const {
@@ -202,6 +211,20 @@ void Predictor::Build(const lite_api::CxxConfig &config,
   const bool model_from_memory = config.model_from_memory();
   LOG(INFO) << "load from memory " << model_from_memory;
 
+  // The weights are loaded and transformed by a thread of the node, so that
+  // their pages are allocated there. The caller gets its CPUs back after.
+  numa_node_ = config.numa_node();
+#ifdef LITE_WITH_X86
+  x86::NumaBindingGuard binding(numa_node_);
+  if (numa_node_ >= 0 && !binding.bound()) {
+    LOG(WARNING) << "Failed to bind to the NUMA node " << numa_node_
+                 << ", the predictor runs unbound";
+    numa_node_ = -1;
+  }
+#else
+  numa_node_ = -1;
+#endif
+  WeightStore::NumaNodeGuard numa_guard(numa_node_);
   Build(model_path,
         model_file,
         param_file,
@@ -209,6 +232,7 @@ void Predictor::Build(const lite_api::CxxConfig &config,
         passes,
         model_type,
         model_from_memory);
+  MoveToNumaNode();
 }
 void Predictor::Build(const std::string &model_path,
                       const std::string &model_file,
@@ -261,6 +285,60 @@ void Predictor::Build(const cpp::ProgramDesc &desc,
   PrepareFeedFetch();
 }
 
+void Predictor::PreplanShapes(
+    const std::map<std::string, ShapeRange> &ranges) {
+#ifdef LITE_WITH_X86
+  // Bound while the buffers are planned only, as in `Build`.
+  x86::NumaBindingGuard binding(numa_node_);
+#endif
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  program_->PreplanShapes(ranges);
+  MoveToNumaNode();
+}
+
+void Predictor::BindNumaNode() {
+#ifdef LITE_WITH_X86
+  if (x86::BoundNumaNode() == numa_node_) return;
+  if (!x86::BindToNumaNode(numa_node_)) {
+    LOG(WARNING) << "Failed to bind to the NUMA node " << numa_node_
+                 << ", the predictor runs unbound";
+    numa_node_ = -1;
+  }
+#else
+  numa_node_ = -1;
+#endif
+}
+
+void Predictor::MoveToNumaNode() {
+#ifdef LITE_WITH_X86
+  if (numa_node_ < 0) return;
+  // The smaller buffers share their pages with the ones of other predictors,
+  // possibly on other nodes, they are left to the first touch of the bound
+  // threads.
+  auto *allocator = GetHostAllocator();
+  std::set<const void *> moved;
+  for (const Scope *scope : {static_cast<const Scope *>(scope_.get()),
+                             exec_scope_}) {
+    for (auto &name : scope->LocalVarNames()) {
+      auto *var = scope->FindLocalVar(name);
+      if (!var || !var->IsType<lite::Tensor>()) continue;
+      const auto &tensor = var->Get<lite::Tensor>();
+      const auto &buffer = tensor.buffer();
+      if (!buffer || tensor.memory_size() == 0 ||
+          (tensor.target() != TARGET(kHost) &&
+           tensor.target() != TARGET(kX86))) {
+        continue;
+      }
+      const void *data = buffer->data();
+      if (!allocator->OwnsPages(data) || !moved.insert(data).second) continue;
+      x86::MoveToNumaNode(data, buffer->space(), numa_node_);
+    }
+  }
+#endif
+}
+
 void Predictor::GenRuntimeProgram() {
   program_ = optimizer_.GenRuntimeProgram();
   CHECK_EQ(exec_scope_, program_->exec_scope());
@@ -271,6 +349,12 @@ const lite::Tensor *Predictor::GetTensor(const std::string &name) const {
   auto *var = exec_scope_->FindVar(name);
   return &var->Get<lite::Tensor>();
 }
+
+lite::Tensor *Predictor::GetMutableTensor(const std::string &name) {
+  auto *var = exec_scope_->FindVar(name);
+  CHECK(var) << "no variable named with " << name << " in exec_scope";
+  return var->GetMutable<lite::Tensor>();
+}
 // get input by name
 lite::Tensor *Predictor::GetInputByName(const std::string &name) {
   auto element = std::find(input_names_.begin(), input_names_.end(), name);
@@ -63,12 +63,39 @@ class LITE_API Predictor {
 
   // Run the predictor for a single batch of data.
   void Run() {
+    if (numa_node_ >= 0) BindNumaNode();
     if (!program_generated_) {
       GenRuntimeProgram();
     }
     program_->Run();
   }
 
+  // Run only the ops needed by the outputs `fetch_names`. The vars in
+  // `start_names` are set by the caller with `GetMutableTensor` before, and
+  // the ops computing them are skipped.
+  void Run(const std::vector<std::string>& fetch_names,
+           const std::vector<std::string>& start_names = {}) {
+    if (numa_node_ >= 0) BindNumaNode();
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    program_->Run(fetch_names, start_names);
+  }
+
+  // Cache the outputs of the subgraph from `input_names` to `output_names`
+  // for the recent inputs, see `RuntimeProgram::Memoize`.
+  void Memoize(const std::vector<std::string>& input_names,
+               const std::vector<std::string>& output_names,
+               size_t capacity = 16) {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    program_->Memoize(input_names, output_names, capacity);
+  }
+
+  // See `RuntimeProgram::PreplanShapes`.
+  void PreplanShapes(const std::map<std::string, ShapeRange>& ranges);
+
   // Get offset-th col of feed inputs.
   lite::Tensor* GetInput(size_t offset);
   // get input by name.
@@ -84,6 +111,7 @@ class LITE_API Predictor {
 
   const cpp::ProgramDesc& program_desc() const;
   const lite::Tensor* GetTensor(const std::string& name) const;
+  lite::Tensor* GetMutableTensor(const std::string& name);
   const RuntimeProgram& runtime_program() const;
 
   // This method is disabled in mobile, for unnecessary dependencies required.
@@ -103,6 +131,13 @@ class LITE_API Predictor {
 #endif
 
  private:
+  // Bind the calling thread to the NUMA node of the predictor, it stays
+  // bound after the run.
+  void BindNumaNode();
+  // Move the large tensors of the predictor which own their pages to its
+  // NUMA node, the ones allocated before the threads were bound.
+  void MoveToNumaNode();
+
   Optimizer optimizer_;
   cpp::ProgramDesc program_desc_;
   std::shared_ptr<Scope> scope_;
@@ -111,6 +146,12 @@ class LITE_API Predictor {
   bool program_generated_{false};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // The feed and fetch tensors in the exec scope, resolved from the names
+  // above in `PrepareFeedFetch`.
+  std::vector<lite::Tensor*> input_tensors_;
+  std::vector<lite::Tensor*> output_tensors_;
+  // See `CxxConfig::set_numa_node`.
+  int numa_node_{-1};
 };
 
 class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
@@ -126,6 +167,9 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
 
   void Run() override;
 
+  void Run(const std::vector<std::string>& fetch_names,
+           const std::vector<std::string>& start_names) override;
+
   std::string GetVersion() const override;
 
   // get inputs names and get outputs names
@@ -135,6 +179,9 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   std::unique_ptr<const lite_api::Tensor> GetTensor(
       const std::string& name) const override;
 
+  std::unique_ptr<lite_api::Tensor> GetMutableTensor(
+      const std::string& name) override;
+
   // Get InputTebsor by name
   std::unique_ptr<lite_api::Tensor> GetInputByName(
       const std::string& name) override;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/api/cxx_api.h"
+#include <map>
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/device_info.h"
@@ -27,6 +28,15 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #endif
   auto places = config.valid_places();
   raw_predictor_.Build(config, places);
+  if (!config.shape_ranges().empty()) {
+    std::map<std::string, ShapeRange> ranges;
+    for (auto &it : config.shape_ranges()) {
+      auto &range = it.second;
+      ranges[it.first] =
+          ShapeRange{range.min_shape, range.opt_shape, range.max_shape};
+    }
+    raw_predictor_.PreplanShapes(ranges);
+  }
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
@@ -50,6 +60,11 @@ std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
 
 void CxxPaddleApiImpl::Run() { raw_predictor_.Run(); }
 
+void CxxPaddleApiImpl::Run(const std::vector<std::string> &fetch_names,
+                           const std::vector<std::string> &start_names) {
+  raw_predictor_.Run(fetch_names, start_names);
+}
+
 std::string CxxPaddleApiImpl::GetVersion() const { return version(); }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
@@ -58,6 +73,12 @@ std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
   return std::unique_ptr<const lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
+std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetMutableTensor(
+    const std::string &name) {
+  return std::unique_ptr<lite_api::Tensor>(
+      new lite_api::Tensor(raw_predictor_.GetMutableTensor(name)));
+}
+
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
     const std::string &name) {
   return std::unique_ptr<lite_api::Tensor>(
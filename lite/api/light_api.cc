@@ -23,36 +23,37 @@ void LightPredictor::Build(const std::string& model_dir,
                            const std::string& param_buffer,
                            lite_api::LiteModelType model_type,
                            bool model_from_memory) {
+  // The params loaded from files are streamed in the background while the
+  // program is being built.
+  ParamStreamLoader param_loader;
   switch (model_type) {
-#ifndef LITE_ON_TINY_PUBLISH
     case lite_api::LiteModelType::kProtobuf:
-      LoadModelPb(model_dir, "", "", scope_.get(), &cpp_program_desc_);
+      param_loader.LoadModelPb(
+          model_dir, "", "", scope_.get(), &cpp_program_desc_);
       break;
-#endif
     case lite_api::LiteModelType::kNaiveBuffer: {
       if (model_from_memory) {
         LoadModelNaiveFromMemory(
             model_buffer, param_buffer, scope_.get(), &cpp_program_desc_);
       } else {
-        LoadModelNaive(model_dir, scope_.get(), &cpp_program_desc_);
+        param_loader.LoadModelNaive(
+            model_dir, scope_.get(), &cpp_program_desc_);
       }
       break;
     }
     default:
       LOG(FATAL) << "Unknown model type";
   }
-  BuildRuntimeProgram(cpp_program_desc_);
+  BuildRuntimeProgram(cpp_program_desc_, &param_loader);
+  param_loader.WaitAll();
   PrepareFeedFetch();
 }
 
 Tensor* LightPredictor::GetInput(size_t offset) {
-  CHECK(input_names_.size() > offset)
-      << "The network has " << input_names_.size() << " inputs"
+  CHECK(input_tensors_.size() > offset)
+      << "The network has " << input_tensors_.size() << " inputs"
       << ", the offset should be less than this.";
-  auto* in_var = program_->exec_scope()->FindVar(input_names_[offset]);
-  CHECK(in_var) << "no fatch variable " << input_names_[offset]
-                << " in exec_scope";
-  return in_var->GetMutable<lite::Tensor>();
+  return input_tensors_[offset];
 }
 
 // get input by name
@@ -72,13 +73,10 @@ Tensor* LightPredictor::GetInputByName(const std::string& name) {
 }
 
 const Tensor* LightPredictor::GetOutput(size_t offset) {
-  CHECK(output_names_.size() > offset)
-      << "The network has " << output_names_.size() << " outputs"
+  CHECK(output_tensors_.size() > offset)
+      << "The network has " << output_tensors_.size() << " outputs"
       << ", the offset should be less than this.";
-  auto* out_var = program_->exec_scope()->FindVar(output_names_.at(offset));
-  CHECK(out_var) << "no fatch variable " << output_names_.at(offset)
-                 << " in exec_scope";
-  return out_var->GetMutable<lite::Tensor>();
+  return output_tensors_[offset];
 }
 // get inputs names
 std::vector<std::string> LightPredictor::GetInputNames() {
@@ -111,12 +109,29 @@ void LightPredictor::PrepareFeedFetch() {
     output_names_[fetchs[i]->GetAttr<int>("col")] =
         fetchs[i]->Input("X").front();
   }
+
+  // Resolve the feed and fetch tensors once, so that the accessors called
+  // for every request need not look them up in the scope by name.
+  auto* exec_scope = program_->exec_scope();
+  input_tensors_.clear();
+  for (auto& name : input_names_) {
+    auto* in_var = exec_scope->FindVar(name);
+    CHECK(in_var) << "no feed variable " << name << " in exec_scope";
+    input_tensors_.push_back(in_var->GetMutable<lite::Tensor>());
+  }
+  output_tensors_.clear();
+  for (auto& name : output_names_) {
+    auto* out_var = exec_scope->FindVar(name);
+    CHECK(out_var) << "no fatch variable " << name << " in exec_scope";
+    output_tensors_.push_back(out_var->GetMutable<lite::Tensor>());
+  }
 }
 
-void LightPredictor::BuildRuntimeProgram(const cpp::ProgramDesc& prog) {
+void LightPredictor::BuildRuntimeProgram(const cpp::ProgramDesc& prog,
+                                         ParamStreamLoader* param_loader) {
   std::vector<Instruction> insts;
   // 1. Create op first
-  Program program(prog, scope_, {});
+  Program program(prog, scope_, {}, param_loader);
 
   // 2. Create Instructs
 
@@ -29,6 +29,7 @@
 #include "lite/core/tensor.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
+#include "lite/model_parser/param_stream_loader.h"
 
 namespace paddle {
 namespace lite {
@@ -51,6 +52,25 @@ class LITE_API LightPredictor {
 
   void Run() { program_->Run(); }
 
+  // Run only the ops needed by the outputs `fetch_names`, see
+  // `Predictor::Run`.
+  void Run(const std::vector<std::string>& fetch_names,
+           const std::vector<std::string>& start_names = {}) {
+    program_->Run(fetch_names, start_names);
+  }
+
+  // See `RuntimeProgram::Memoize`.
+  void Memoize(const std::vector<std::string>& input_names,
+               const std::vector<std::string>& output_names,
+               size_t capacity = 16) {
+    program_->Memoize(input_names, output_names, capacity);
+  }
+
+  // See `RuntimeProgram::PreplanShapes`.
+  void PreplanShapes(const std::map<std::string, ShapeRange>& ranges) {
+    program_->PreplanShapes(ranges);
+  }
+
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
   // get input by name.
@@ -63,6 +83,12 @@ class LITE_API LightPredictor {
     return &var->Get<lite::Tensor>();
   }
 
+  lite::Tensor* GetMutableTensor(const std::string& name) {
+    auto* var = program_->exec_scope()->FindVar(name);
+    CHECK(var) << "no variable named with " << name << " in exec_scope";
+    return var->GetMutable<lite::Tensor>();
+  }
+
   // get inputnames and get outputnames.
   std::vector<std::string> GetInputNames();
   std::vector<std::string> GetOutputNames();
@@ -76,7 +102,8 @@ class LITE_API LightPredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool model_from_memory = false);
 
-  void BuildRuntimeProgram(const cpp::ProgramDesc& prog);
+  void BuildRuntimeProgram(const cpp::ProgramDesc& prog,
+                           ParamStreamLoader* param_loader = nullptr);
 
  private:
   std::shared_ptr<Scope> scope_;
@@ -84,6 +111,10 @@ class LITE_API LightPredictor {
   cpp::ProgramDesc cpp_program_desc_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  // The feed and fetch tensors in the exec scope, resolved from the names
+  // above in `PrepareFeedFetch`.
+  std::vector<Tensor*> input_tensors_;
+  std::vector<Tensor*> output_tensors_;
 };
 
 class LightPredictorImpl : public lite_api::PaddlePredictor {
@@ -96,12 +127,17 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
 
   void Run() override;
 
+  void Run(const std::vector<std::string>& fetch_names,
+           const std::vector<std::string>& start_names) override;
+
   std::string GetVersion() const override;
   std::vector<std::string> GetInputNames() override;
   std::vector<std::string> GetOutputNames() override;
 
   std::unique_ptr<const lite_api::Tensor> GetTensor(
       const std::string& name) const override;
+  std::unique_ptr<lite_api::Tensor> GetMutableTensor(
+      const std::string& name) override;
   // Get InputTebsor by name
   std::unique_ptr<lite_api::Tensor> GetInputByName(
       const std::string& name) override;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/api/light_api.h"
+#include <map>
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/version.h"
@@ -29,6 +30,15 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
                          config.param_buffer(),
                          config.model_from_memory(),
                          lite_api::LiteModelType::kNaiveBuffer));
+  if (!config.shape_ranges().empty()) {
+    std::map<std::string, ShapeRange> ranges;
+    for (auto& it : config.shape_ranges()) {
+      auto& range = it.second;
+      ranges[it.first] =
+          ShapeRange{range.min_shape, range.opt_shape, range.max_shape};
+    }
+    raw_predictor_->PreplanShapes(ranges);
+  }
 }
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInput(int i) {
@@ -44,6 +54,11 @@ std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetOutput(
 
 void LightPredictorImpl::Run() { raw_predictor_->Run(); }
 
+void LightPredictorImpl::Run(const std::vector<std::string>& fetch_names,
+                             const std::vector<std::string>& start_names) {
+  raw_predictor_->Run(fetch_names, start_names);
+}
+
 std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
 
 std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetTensor(
@@ -51,6 +66,11 @@ std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetTensor(
   return std::unique_ptr<const lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetTensor(name)));
 }
+std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetMutableTensor(
+    const std::string& name) {
+  return std::unique_ptr<lite_api::Tensor>(
+      new lite_api::Tensor(raw_predictor_->GetMutableTensor(name)));
+}
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
     const std::string& name) {
   return std::unique_ptr<lite_api::Tensor>(
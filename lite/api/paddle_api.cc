@@ -14,6 +14,7 @@
 
 #include "lite/api/paddle_api.h"
 #include "lite/core/device_info.h"
+#include "lite/core/memory.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
 
@@ -151,6 +152,14 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+MemoryUsage PaddlePredictor::GetMemoryUsage(TargetType target) const {
+  auto stats = lite::GetMemoryStats(target);
+  MemoryUsage usage;
+  usage.live_bytes = stats.live_bytes;
+  usage.peak_bytes = stats.peak_bytes;
+  return usage;
+}
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
@@ -181,5 +190,16 @@ void ConfigBase::set_threads(int threads) {
 #endif
 }
 
+void ConfigBase::set_shape_range(const std::string &name,
+                                 const shape_t &min_shape,
+                                 const shape_t &opt_shape,
+                                 const shape_t &max_shape) {
+  CHECK(min_shape.size() == opt_shape.size() &&
+        opt_shape.size() == max_shape.size())
+      << "the min, opt and max shapes of " << name
+      << " should have the same rank";
+  shape_ranges_[name] = ShapeRange{min_shape, opt_shape, max_shape};
+}
+
 }  // namespace lite_api
 }  // namespace paddle
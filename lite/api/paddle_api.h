@@ -19,6 +19,7 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -65,6 +66,23 @@ struct LITE_API Tensor {
   void* raw_tensor_;
 };
 
+/// The bytes held by the tensors of a target, counted over all the predictors
+/// of the process.
+struct LITE_API MemoryUsage {
+  int64_t live_bytes{0};
+  int64_t peak_bytes{0};
+};
+
+/// The shapes an input takes. When the predictor is created, the shapes are
+/// only inferred at `max_shape` and the output buffers are sized for it, no
+/// kernel runs. The input is left at `opt_shape`. The workspaces of the
+/// kernels are still allocated by the first run.
+struct LITE_API ShapeRange {
+  shape_t min_shape;
+  shape_t opt_shape;
+  shape_t max_shape;
+};
+
 /// The PaddlePredictor defines the basic interfaces for different kinds of
 /// predictors.
 class LITE_API PaddlePredictor {
@@ -79,6 +97,14 @@ class LITE_API PaddlePredictor {
 
   virtual void Run() = 0;
 
+  /// Run only the ops needed by the outputs `fetch_names`. The tensors in
+  /// `start_names` are filled by the caller with `GetMutableTensor` before,
+  /// the ops computing them are skipped, and must not be needed by another
+  /// output. The pruned ops are cached for each pair of `fetch_names` and
+  /// `start_names`.
+  virtual void Run(const std::vector<std::string>& fetch_names,
+                   const std::vector<std::string>& start_names) = 0;
+
   virtual std::string GetVersion() const = 0;
 
   // Get input names
@@ -93,6 +119,12 @@ class LITE_API PaddlePredictor {
   virtual std::unique_ptr<const Tensor> GetTensor(
       const std::string& name) const = 0;
 
+  /// Get a writable tensor by the var name, to set a start var of `Run`.
+  virtual std::unique_ptr<Tensor> GetMutableTensor(const std::string& name) = 0;
+
+  /// Get the memory held by the tensors of `target`.
+  virtual MemoryUsage GetMemoryUsage(TargetType target) const;
+
   /// Persist the optimized model to disk. This API is only supported by
   /// CxxConfig, and the persisted model can be reused for MobileConfig.
   virtual void SaveOptimizedModel(
@@ -108,6 +140,7 @@ class LITE_API ConfigBase {
   std::string model_dir_;
   int threads_{1};
   PowerMode mode_{LITE_POWER_NO_BIND};
+  std::map<std::string, ShapeRange> shape_ranges_;
 
  public:
   explicit ConfigBase(PowerMode mode = LITE_POWER_NO_BIND, int threads = 1);
@@ -120,6 +153,17 @@ class LITE_API ConfigBase {
   // set Thread
   void set_threads(int threads);
   int threads() const { return threads_; }
+  /// Declare the shapes the input `name` takes. With the ranges set, the
+  /// predictor infers the shapes at the max shapes when created and sizes
+  /// the output buffers for them, then the runs with the inputs in their
+  /// ranges allocate no output buffer.
+  void set_shape_range(const std::string& name,
+                       const shape_t& min_shape,
+                       const shape_t& opt_shape,
+                       const shape_t& max_shape);
+  const std::map<std::string, ShapeRange>& shape_ranges() const {
+    return shape_ranges_;
+  }
 };
 
 /// CxxConfig is the config for the Full feature predictor.
@@ -128,6 +172,7 @@ class LITE_API CxxConfig : public ConfigBase {
   std::string model_file_;
   std::string param_file_;
   bool model_from_memory_{false};
+  int numa_node_{-1};
 
  public:
   void set_valid_places(const std::vector<Place>& x) { valid_places_ = x; }
@@ -146,6 +191,14 @@ class LITE_API CxxConfig : public ConfigBase {
   std::string model_file() const { return model_file_; }
   std::string param_file() const { return param_file_; }
   bool model_from_memory() const { return model_from_memory_; }
+  /// Bind the threads running the predictor to the CPUs of a NUMA node, and
+  /// place its weights and buffers in the memory of the node, -1 to not bind.
+  /// The weights are only shared with the predictors of the same node. The
+  /// calling thread is bound while the predictor is created, then restored,
+  /// but each run binds the calling thread and its OpenMP threads to the node
+  /// and leaves them bound. Only used on x86 Linux.
+  void set_numa_node(int node) { numa_node_ = node; }
+  int numa_node() const { return numa_node_; }
 };
 
 /// MobileConfig is the config for the light weight predictor, it will skip
@@ -104,6 +104,12 @@ static size_t PrecisionTypeLength(PrecisionType type) {
       return 4;
     case PrecisionType::kFP16:
       return 2;
+    case PrecisionType::kBool:
+      return 1;
+    case PrecisionType::kInt64:
+      return 8;
+    case PrecisionType::kInt16:
+      return 2;
     default:
       return 4;
   }
@@ -102,7 +102,8 @@ void BindLiteCxxConfig(py::module *m) {
       .def("param_file", &CxxConfig::param_file)
       .def("set_valid_places", &CxxConfig::set_valid_places)
       .def("set_model_buffer", &CxxConfig::set_model_buffer)
-      .def("model_from_memory", &CxxConfig::model_from_memory);
+      .def("model_from_memory", &CxxConfig::model_from_memory)
+      .def("set_shape_range", &CxxConfig::set_shape_range);
 #ifdef LITE_WITH_ARM
   cxx_config.def("set_threads", &CxxConfig::set_threads)
       .def("threads", &CxxConfig::threads)
@@ -119,7 +120,8 @@ void BindLiteMobileConfig(py::module *m) {
       .def("set_model_dir", &MobileConfig::set_model_dir)
       .def("model_dir", &MobileConfig::model_dir)
       .def("set_model_buffer", &MobileConfig::set_model_buffer)
-      .def("model_from_memory", &MobileConfig::model_from_memory);
+      .def("model_from_memory", &MobileConfig::model_from_memory)
+      .def("set_shape_range", &MobileConfig::set_shape_range);
 #ifdef LITE_WITH_ARM
   mobile_config.def("set_threads", &MobileConfig::set_threads)
       .def("threads", &MobileConfig::threads)
@@ -238,7 +240,16 @@ void BindLiteCxxPredictor(py::module *m) {
       .def(py::init<>())
       .def("get_input", &CxxPaddleApiImpl::GetInput)
       .def("get_output", &CxxPaddleApiImpl::GetOutput)
-      .def("run", &CxxPaddleApiImpl::Run)
+      .def("run", [](CxxPaddleApiImpl &self) { self.Run(); })
+      .def("run",
+           [](CxxPaddleApiImpl &self,
+              const std::vector<std::string> &fetch_names,
+              const std::vector<std::string> &start_names) {
+             self.Run(fetch_names, start_names);
+           },
+           py::arg("fetch_names"),
+           py::arg("start_names") = std::vector<std::string>())
+      .def("get_tensor", &CxxPaddleApiImpl::GetMutableTensor)
       .def("get_version", &CxxPaddleApiImpl::GetVersion)
       .def("save_optimized_model",
            [](CxxPaddleApiImpl &self, const std::string &output_dir) {
@@ -253,7 +264,16 @@ void BindLiteLightPredictor(py::module *m) {
       .def(py::init<>())
       .def("get_input", &LightPredictorImpl::GetInput)
       .def("get_output", &LightPredictorImpl::GetOutput)
-      .def("run", &LightPredictorImpl::Run)
+      .def("run", [](LightPredictorImpl &self) { self.Run(); })
+      .def("run",
+           [](LightPredictorImpl &self,
+              const std::vector<std::string> &fetch_names,
+              const std::vector<std::string> &start_names) {
+             self.Run(fetch_names, start_names);
+           },
+           py::arg("fetch_names"),
+           py::arg("start_names") = std::vector<std::string>())
+      .def("get_tensor", &LightPredictorImpl::GetMutableTensor)
       .def("get_version", &LightPredictorImpl::GetVersion)
       .def("save_optimized_model",
            [](LightPredictorImpl &self, const std::string &output_dir) {
@@ -105,7 +105,11 @@ void pooling_basic(const float* din,
               hend = std::min(hend, hin);
               wend = std::min(wend, win);
               int pool_size = (hend - hstart) * (wend - wstart);
-              if (pool_size == 0) continue;
+              if (pool_size == 0) {
+                // The window lies in the padding.
+                dout_row[j] = 0.f;
+                continue;
+              }
               float tmp1 = din_ch[hstart * win + wstart];
               for (int h = hstart; h < hend; ++h) {
                 for (int w = wstart; w < wend; ++w) {
@@ -140,7 +144,10 @@ void pooling_basic(const float* din,
                 hend = std::min(hend, hin);
                 wend = std::min(wend, win);
                 int pool_size = (hend - hstart) * (wend - wstart);
-                if (pool_size == 0) continue;
+                if (pool_size == 0) {
+                  dout_row[j] = 0.f;
+                  continue;
+                }
                 float sum = 0.f;
                 for (int h = hstart; h < hend; ++h) {
                   for (int w = wstart; w < wend; ++w) {
@@ -172,7 +179,10 @@ void pooling_basic(const float* din,
                 hend = std::min(hend, hin);
                 wend = std::min(wend, win);
                 int pool_size = (hend - hstart) * (wend - wstart);
-                if (pool_size == 0) continue;
+                if (pool_size == 0) {
+                  dout_row[j] = 0.f;
+                  continue;
+                }
                 float sum = 0.f;
                 for (int h = hstart; h < hend; ++h) {
                   for (int w = wstart; w < wend; ++w) {
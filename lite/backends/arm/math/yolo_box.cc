@@ -113,6 +113,9 @@ void yolobox(lite::Tensor* X,
   float* Boxes_data = Boxes->mutable_data<float>();
 
   float* Scores_data = Scores->mutable_data<float>();
+  // The boxes under conf_thresh are skipped, they are left zero.
+  memset(Boxes_data, 0, Boxes->numel() * sizeof(float));
+  memset(Scores_data, 0, Scores->numel() * sizeof(float));
 
   float box[4];
   for (int i = 0; i < n; i++) {
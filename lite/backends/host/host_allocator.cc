@@ -0,0 +1,239 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/host_allocator.h"
+#include <cstdint>
+#include <cstdlib>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+constexpr size_t CachingHostAllocator::kMaxClassSize;
+constexpr int CachingHostAllocator::kNumClasses;
+
+namespace {
+
+// The alignment of the blocks, the header of a block sits right before it.
+constexpr size_t kAlign = 64;
+constexpr size_t kHugePageSize = 2 << 20;
+
+struct BlockHeader {
+  // The pointer the system returned.
+  void* raw;
+  // The bytes mapped by mmap, zero if the block is from malloc.
+  size_t mapped;
+  // The size class, -1 for a large block.
+  int size_class;
+};
+static_assert(sizeof(BlockHeader) <= kAlign, "the block header is too large");
+
+BlockHeader* Header(void* ptr) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - kAlign);
+}
+
+HostAllocator* host_allocator{nullptr};
+
+}  // namespace
+
+HostAllocator* GetHostAllocator() {
+  return host_allocator ? host_allocator : &CachingHostAllocator::Global();
+}
+
+void SetHostAllocator(HostAllocator* allocator) { host_allocator = allocator; }
+
+// Set once the cache of the calling thread is destroyed, the buffers of the
+// thread_local objects destroyed after it skip the cache.
+static thread_local bool thread_cache_destroyed = false;
+
+// The blocks cached by a thread, they go to the shared pool when the thread
+// exits.
+struct HostThreadCache {
+  std::vector<void*> blocks[CachingHostAllocator::kNumClasses];
+  size_t bytes{0};
+
+  ~HostThreadCache() {
+    auto* allocator = &CachingHostAllocator::Global();
+    for (int i = 0; i < CachingHostAllocator::kNumClasses; ++i) {
+      for (void* ptr : blocks[i]) {
+        allocator->GiveShared(ptr, i);
+      }
+    }
+    thread_cache_destroyed = true;
+  }
+};
+
+static thread_local HostThreadCache thread_cache;
+
+CachingHostAllocator& CachingHostAllocator::Global() {
+  // Never destroyed, the thread caches give their blocks back on exit.
+  static auto* x = new CachingHostAllocator;
+  return *x;
+}
+
+int CachingHostAllocator::SizeClass(size_t size) {
+  if (size <= kAlign) return 0;
+  // 2^k < size <= 2^(k+1), the classes between are 2^k + j * 2^(k-2).
+  int k = 6;
+  while ((static_cast<size_t>(1) << (k + 1)) < size) ++k;
+  size_t base = static_cast<size_t>(1) << k;
+  size_t j = (size - 1 - base) / (base >> 2) + 1;
+  return (k - 6) * 4 + static_cast<int>(j);
+}
+
+size_t CachingHostAllocator::ClassSize(int size_class) {
+  if (size_class == 0) return kAlign;
+  int k = 6 + (size_class - 1) / 4;
+  size_t base = static_cast<size_t>(1) << k;
+  return base + ((size_class - 1) % 4 + 1) * (base >> 2);
+}
+
+size_t CachingHostAllocator::UsableSize(size_t size) const {
+  return size <= kMaxClassSize ? ClassSize(SizeClass(size)) : size;
+}
+
+bool CachingHostAllocator::OwnsPages(const void* ptr) const {
+  if (!ptr) return false;
+  auto* header = Header(const_cast<void*>(ptr));
+  return header->mapped > 0 && header->size_class < 0;
+}
+
+void* CachingHostAllocator::Allocate(size_t size) {
+  if (size > kMaxClassSize) {
+    return SystemAllocate(size, -1);
+  }
+  int size_class = SizeClass(size);
+  if (!thread_cache_destroyed && !thread_cache.blocks[size_class].empty()) {
+    void* ptr = thread_cache.blocks[size_class].back();
+    thread_cache.blocks[size_class].pop_back();
+    thread_cache.bytes -= ClassSize(size_class);
+    return ptr;
+  }
+  void* ptr = TakeShared(size_class);
+  return ptr ? ptr : SystemAllocate(ClassSize(size_class), size_class);
+}
+
+void CachingHostAllocator::Deallocate(void* ptr) {
+  if (!ptr) return;
+  int size_class = Header(ptr)->size_class;
+  if (size_class < 0) {
+    SystemDeallocate(ptr);
+    return;
+  }
+  size_t class_size = ClassSize(size_class);
+  if (!thread_cache_destroyed &&
+      thread_cache.bytes + class_size <= thread_cache_bytes_) {
+    thread_cache.blocks[size_class].push_back(ptr);
+    thread_cache.bytes += class_size;
+    return;
+  }
+  GiveShared(ptr, size_class);
+}
+
+void CachingHostAllocator::ReleaseCache() {
+  if (!thread_cache_destroyed) {
+    for (int i = 0; i < kNumClasses; ++i) {
+      for (void* ptr : thread_cache.blocks[i]) {
+        SystemDeallocate(ptr);
+      }
+      thread_cache.blocks[i].clear();
+    }
+    thread_cache.bytes = 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < kNumClasses; ++i) {
+    for (void* ptr : shared_[i]) {
+      SystemDeallocate(ptr);
+    }
+    shared_[i].clear();
+  }
+  shared_bytes_ = 0;
+}
+
+void* CachingHostAllocator::TakeShared(int size_class) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& blocks = shared_[size_class];
+  if (blocks.empty()) return nullptr;
+  void* ptr = blocks.back();
+  blocks.pop_back();
+  shared_bytes_ -= ClassSize(size_class);
+  return ptr;
+}
+
+void CachingHostAllocator::GiveShared(void* ptr, int size_class) {
+  size_t class_size = ClassSize(size_class);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shared_bytes_ + class_size <= shared_cache_bytes_) {
+      shared_[size_class].push_back(ptr);
+      shared_bytes_ += class_size;
+      return;
+    }
+  }
+  SystemDeallocate(ptr);
+}
+
+void* CachingHostAllocator::SystemAllocate(size_t size, int size_class) {
+  void* raw = nullptr;
+  size_t mapped = 0;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (huge_page_threshold_ > 0 && size >= huge_page_threshold_) {
+    mapped = (size + kAlign + kHugePageSize - 1) / kHugePageSize *
+             kHugePageSize;
+    raw = mmap(nullptr,
+               mapped,
+               PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS,
+               -1,
+               0);
+    if (raw == MAP_FAILED) {
+      raw = nullptr;
+      mapped = 0;
+    } else if (madvise(raw, mapped, MADV_HUGEPAGE)) {
+      VLOG(4) << "transparent huge pages are not available";
+    }
+  }
+#endif
+  char* ptr = nullptr;
+  if (raw) {
+    ptr = static_cast<char*>(raw) + kAlign;
+  } else {
+    raw = malloc(size + 2 * kAlign);
+    if (!raw) return nullptr;
+    ptr = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(raw) + 2 * kAlign - 1) & ~(kAlign - 1));
+  }
+  auto* header = Header(ptr);
+  header->raw = raw;
+  header->mapped = mapped;
+  header->size_class = size_class;
+  return ptr;
+}
+
+void CachingHostAllocator::SystemDeallocate(void* ptr) {
+  auto* header = Header(ptr);
+#ifdef __linux__
+  if (header->mapped) {
+    munmap(header->raw, header->mapped);
+    return;
+  }
+#endif
+  free(header->raw);
+}
+
+}  // namespace lite
+}  // namespace paddle
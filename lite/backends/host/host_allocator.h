@@ -0,0 +1,118 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <mutex>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * HostAllocator serves the memory of TargetWrapper<kHost>, so of all the
+ * host, x86 and ARM buffers. The memory is aligned to 64 bytes and is not
+ * zeroed.
+ */
+class HostAllocator {
+ public:
+  virtual ~HostAllocator() = default;
+
+  virtual void* Allocate(size_t size) = 0;
+
+  virtual void Deallocate(void* ptr) = 0;
+
+  // The bytes `Allocate(size)` actually provides, a buffer can grow up to it
+  // without allocating again.
+  virtual size_t UsableSize(size_t size) const { return size; }
+
+  // Whether the block `ptr` is alone on its pages and they go back to the
+  // system when it is freed, so that a policy set on the pages, e.g. by
+  // mbind, affects no other block.
+  virtual bool OwnsPages(const void* ptr) const { return false; }
+};
+
+HostAllocator* GetHostAllocator();
+
+// Replace the host allocator, it is not owned. It must be called before any
+// host memory is allocated, a null one restores the caching allocator.
+void SetHostAllocator(HostAllocator* allocator);
+
+/*
+ * CachingHostAllocator keeps the freed blocks to serve the next allocations,
+ * so that a workload with variable shapes does not go to the system for each
+ * request.
+ *
+ * The blocks up to 4 MB are rounded up to size classes, four per power of
+ * two, and the freed ones are cached by the freeing thread without locking.
+ * Beyond the limit of the thread cache they go to a pool shared by the
+ * threads, and beyond the limit of the pool back to the system. The larger
+ * blocks are always allocated by the system, with transparent huge pages on
+ * Linux if they exceed the huge page threshold.
+ */
+class CachingHostAllocator : public HostAllocator {
+ public:
+  static CachingHostAllocator& Global();
+
+  void* Allocate(size_t size) override;
+
+  void Deallocate(void* ptr) override;
+
+  size_t UsableSize(size_t size) const override;
+
+  // Only the blocks beyond kMaxClassSize mapped with huge pages, the other
+  // ones share their pages or are reused by the cache.
+  bool OwnsPages(const void* ptr) const override;
+
+  // Free the blocks cached by the calling thread and the shared pool.
+  void ReleaseCache();
+
+  void set_thread_cache_bytes(size_t x) { thread_cache_bytes_ = x; }
+  void set_shared_cache_bytes(size_t x) { shared_cache_bytes_ = x; }
+  // Zero to disable the huge pages.
+  void set_huge_page_threshold(size_t x) { huge_page_threshold_ = x; }
+
+  size_t shared_cache_bytes() const { return shared_bytes_; }
+
+  static constexpr size_t kMaxClassSize = 4 << 20;
+  static constexpr int kNumClasses = 65;
+
+  // Get the size class of `size`, up to kMaxClassSize.
+  static int SizeClass(size_t size);
+  // Get the block size of a size class.
+  static size_t ClassSize(int size_class);
+
+ private:
+  friend struct HostThreadCache;
+
+  CachingHostAllocator() = default;
+
+  void* SystemAllocate(size_t size, int size_class);
+  void SystemDeallocate(void* ptr);
+  // Take a block from the shared pool, null if there is none.
+  void* TakeShared(int size_class);
+  // Give a block to the shared pool, or to the system if it is full.
+  void GiveShared(void* ptr, int size_class);
+
+  size_t thread_cache_bytes_{8 << 20};
+  size_t shared_cache_bytes_{64 << 20};
+  size_t huge_page_threshold_{0};
+
+  std::mutex mutex_;
+  std::vector<void*> shared_[kNumClasses];
+  size_t shared_bytes_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/concat_inplace.h"
+#include <cstring>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+namespace {
+
+// Give `tensor` a buffer of its own, the shared one is left to its views.
+void Detach(lite::Tensor* tensor) {
+  auto dims = tensor->dims();
+  auto lod = tensor->lod();
+  tensor->ShareDataWith(lite::Tensor());
+  tensor->Resize(dims);
+  *tensor->mutable_lod() = lod;
+}
+
+}  // namespace
+
+bool ConcatInplace::Run(const std::vector<lite::Tensor*>& inputs,
+                        int axis,
+                        size_t elem_size,
+                        lite::Tensor* out) {
+  auto out_dims = out->dims();
+  // An empty input can not be a view.
+  bool viewable = !inputs.empty() && out_dims.Slice(0, axis).production() == 1;
+  for (auto* in : inputs) {
+    viewable = viewable && in->dims().production() > 0;
+  }
+  if (!viewable) {
+    if (viewed_) Detach(out);
+    viewed_ = false;
+    return false;
+  }
+
+  std::vector<size_t> offsets(inputs.size());
+  size_t total = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    offsets[i] = total;
+    total += inputs[i]->dims().production() * elem_size;
+  }
+  CHECK_EQ(total, out_dims.production() * elem_size);
+
+  const char* out_base = static_cast<const char*>(out->raw_data());
+  bool aliased = out->IsInitialized();
+  for (size_t i = 0; i < inputs.size() && aliased; ++i) {
+    aliased = inputs[i]->raw_data() == out_base + offsets[i];
+  }
+  if (aliased) return true;
+
+  // Gather the inputs into a fresh buffer, the old one may still back some
+  // of them.
+  auto lod = out->lod();
+  lite::Tensor gathered;
+  gathered.Resize(out_dims);
+  char* dst = static_cast<char*>(gathered.mutable_data(out->target(), total));
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::memcpy(dst + offsets[i],
+                inputs[i]->raw_data(),
+                inputs[i]->dims().production() * elem_size);
+  }
+  out->ShareDataWith(gathered);
+  *out->mutable_lod() = lod;
+  viewed_ = true;
+
+  lite::Tensor bytes;
+  bytes.ShareDataWith(gathered);
+  bytes.Resize(DDim(std::vector<int64_t>({static_cast<int64_t>(total)})));
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto in_dims = inputs[i]->dims();
+    auto in_lod = inputs[i]->lod();
+    size_t size = in_dims.production() * elem_size;
+    inputs[i]->ShareDataWith(
+        bytes.Slice<int8_t>(offsets[i], offsets[i] + size));
+    inputs[i]->Resize(in_dims);
+    *inputs[i]->mutable_lod() = in_lod;
+  }
+  return true;
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
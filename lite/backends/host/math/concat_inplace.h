@@ -0,0 +1,51 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * Concat without copies. When the dims before `axis` are all 1, every input
+ * is a contiguous range of the output, so the inputs are turned into views of
+ * the output buffer and their producers write straight into it on the next
+ * runs. It returns false when the layout cannot be concatenated in place, the
+ * caller does a normal concat then.
+ *
+ * Once the inputs are views, a run costs only a check of their addresses. If
+ * a producer has moved its output elsewhere, e.g. after a shape change, the
+ * inputs are copied into a new output buffer and viewed again.
+ */
+class ConcatInplace {
+ public:
+  bool Run(const std::vector<lite::Tensor*>& inputs,
+           int axis,
+           size_t elem_size,
+           lite::Tensor* out);
+
+ private:
+  // Whether the inputs have been made views of `out`, the output must then
+  // leave the shared buffer before a normal concat writes into it.
+  bool viewed_{false};
+};
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
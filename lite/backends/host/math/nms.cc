@@ -0,0 +1,113 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms.h"
+#include <algorithm>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The selected boxes a candidate is compared with before checking whether it
+// is already suppressed. Most suppressions come from the first few boxes.
+static constexpr int kIoUBatch = 16;
+
+void GetMaxScoreIndex(const float* scores,
+                      int num,
+                      float threshold,
+                      int top_k,
+                      ScoreIndex* sorted) {
+  sorted->clear();
+  for (int i = 0; i < num; ++i) {
+    if (scores[i] > threshold) {
+      sorted->emplace_back(scores[i], i);
+    }
+  }
+  auto descend = [](const std::pair<float, int>& a,
+                    const std::pair<float, int>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  if (top_k > -1 && top_k < static_cast<int>(sorted->size())) {
+    std::partial_sort(
+        sorted->begin(), sorted->begin() + top_k, sorted->end(), descend);
+    sorted->resize(top_k);
+  } else {
+    std::sort(sorted->begin(), sorted->end(), descend);
+  }
+}
+
+void NMSBoxes(const float* boxes,
+              const ScoreIndex& sorted,
+              float nms_threshold,
+              float eta,
+              bool normalized,
+              std::vector<int>* selected) {
+  selected->clear();
+  const float norm = normalized ? 0.f : 1.f;
+  std::vector<float> xmin, ymin, xmax, ymax, area;
+  xmin.reserve(sorted.size());
+  ymin.reserve(sorted.size());
+  xmax.reserve(sorted.size());
+  ymax.reserve(sorted.size());
+  area.reserve(sorted.size());
+
+  float adaptive_threshold = nms_threshold;
+  for (const auto& item : sorted) {
+    const float* box = boxes + item.second * 4;
+    const float box_area = BBoxArea(box, normalized);
+    const float* kx1 = xmin.data();
+    const float* ky1 = ymin.data();
+    const float* kx2 = xmax.data();
+    const float* ky2 = ymax.data();
+    const float* karea = area.data();
+    const int num = static_cast<int>(xmin.size());
+    bool keep = true;
+    for (int k0 = 0; k0 < num && keep; k0 += kIoUBatch) {
+      const int k1 = std::min(num, k0 + kIoUBatch);
+      int suppressed = 0;
+      for (int k = k0; k < k1; ++k) {
+        const float inter_xmin = std::max(box[0], kx1[k]);
+        const float inter_ymin = std::max(box[1], ky1[k]);
+        const float inter_xmax = std::min(box[2], kx2[k]);
+        const float inter_ymax = std::min(box[3], ky2[k]);
+        const float inter_w = inter_xmax - inter_xmin + norm;
+        const float inter_h = inter_ymax - inter_ymin + norm;
+        const float inter_area = inter_w * inter_h;
+        const bool disjoint = (kx1[k] > box[2]) | (kx2[k] < box[0]) |
+                              (ky1[k] > box[3]) | (ky2[k] < box[1]);
+        const float overlap =
+            disjoint ? 0.f : inter_area / (box_area + karea[k] - inter_area);
+        suppressed |= !(overlap <= adaptive_threshold);
+      }
+      keep = !suppressed;
+    }
+    if (keep) {
+      xmin.push_back(box[0]);
+      ymin.push_back(box[1]);
+      xmax.push_back(box[2]);
+      ymax.push_back(box[3]);
+      area.push_back(box_area);
+      selected->push_back(item.second);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
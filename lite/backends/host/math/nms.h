@@ -0,0 +1,66 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The candidates of NMS, a score and the index of its box.
+typedef std::vector<std::pair<float, int>> ScoreIndex;
+
+/*
+ * Collect the scores above `threshold` and keep the `top_k` highest ones, or
+ * all of them with a negative top_k, in descending order. Equal scores keep
+ * the order of their indices, as a stable sort of all the scores would, but
+ * only the kept ones are sorted.
+ */
+void GetMaxScoreIndex(const float* scores,
+                      int num,
+                      float threshold,
+                      int top_k,
+                      ScoreIndex* sorted);
+
+// The area of a [xmin, ymin, xmax, ymax] box, 0 if it is invalid.
+inline float BBoxArea(const float* box, bool normalized) {
+  if (box[2] < box[0] || box[3] < box[1]) {
+    return 0.f;
+  }
+  const float w = box[2] - box[0];
+  const float h = box[3] - box[1];
+  return normalized ? w * h : (w + 1) * (h + 1);
+}
+
+/*
+ * Greedy NMS over [xmin, ymin, xmax, ymax] boxes, visited in the order of
+ * `sorted`. A box is selected unless its IoU with a selected one is above the
+ * threshold, which decays by `eta` after every selection while it is above
+ * 0.5. The selected boxes are kept as columns, so that the IoU of a candidate
+ * is computed against a batch of them at a time by a vectorized loop.
+ */
+void NMSBoxes(const float* boxes,
+              const ScoreIndex& sorted,
+              float nms_threshold,
+              float eta,
+              bool normalized,
+              std::vector<int>* selected);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/rowwise_quant.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+int64_t QuantizedRowBytes(int64_t width, int bit_length) {
+  CHECK(bit_length == 8 || bit_length == 4)
+      << "only 8 and 4 bits are supported, but got " << bit_length;
+  return bit_length == 8 ? width : (width + 1) / 2;
+}
+
+void QuantizeRowwise(const float* din,
+                     int64_t rows,
+                     int64_t width,
+                     int bit_length,
+                     int8_t* dout,
+                     float* scales) {
+  const int64_t row_bytes = QuantizedRowBytes(width, bit_length);
+  const int range = (1 << (bit_length - 1)) - 1;
+  for (int64_t i = 0; i < rows; ++i) {
+    const float* row = din + i * width;
+    int8_t* qrow = dout + i * row_bytes;
+    float max_abs = 0.f;
+    for (int64_t j = 0; j < width; ++j) {
+      max_abs = std::max(max_abs, std::fabs(row[j]));
+    }
+    float scale = max_abs / range;
+    scales[i] = scale;
+    float inv_scale = scale > 0.f ? 1.f / scale : 0.f;
+    if (bit_length == 8) {
+      for (int64_t j = 0; j < width; ++j) {
+        qrow[j] = static_cast<int8_t>(std::round(row[j] * inv_scale));
+      }
+    } else {
+      memset(qrow, 0, row_bytes);
+      for (int64_t j = 0; j < width; ++j) {
+        int q = static_cast<int>(std::round(row[j] * inv_scale));
+        uint8_t nibble = static_cast<uint8_t>(q) & 0x0f;
+        qrow[j / 2] |= static_cast<int8_t>(j % 2 ? nibble << 4 : nibble);
+      }
+    }
+  }
+}
+
+void DequantizeRow(const int8_t* din,
+                   int64_t width,
+                   int bit_length,
+                   float scale,
+                   float* dout) {
+  if (bit_length == 8) {
+    for (int64_t j = 0; j < width; ++j) {
+      dout[j] = din[j] * scale;
+    }
+    return;
+  }
+  CHECK_EQ(bit_length, 4) << "only 8 and 4 bits are supported";
+  int64_t j = 0;
+  for (; j + 1 < width; j += 2) {
+    int8_t byte = din[j / 2];
+    // Sign extend the two nibbles.
+    dout[j] = (static_cast<int8_t>(byte << 4) >> 4) * scale;
+    dout[j + 1] = (byte >> 4) * scale;
+  }
+  if (j < width) {
+    dout[j] = (static_cast<int8_t>(din[j / 2] << 4) >> 4) * scale;
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,53 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * Row-wise symmetric quantization of a [rows, width] float matrix, used by the
+ * quantized embedding tables. Each row has its own scale, a value is
+ * dequantized as `q * scale[row]`.
+ *
+ * With bit_length 8 a row stores one int8 per value. With bit_length 4 a row
+ * stores two values per byte, the even column in the lower nibble, and the
+ * last byte is padded when the width is odd.
+ */
+
+// The number of bytes of a quantized row.
+int64_t QuantizedRowBytes(int64_t width, int bit_length);
+
+void QuantizeRowwise(const float* din,
+                     int64_t rows,
+                     int64_t width,
+                     int bit_length,
+                     int8_t* dout,
+                     float* scales);
+
+// Dequantize one quantized row of `width` values into `dout`.
+void DequantizeRow(const int8_t* din,
+                   int64_t width,
+                   int bit_length,
+                   float scale,
+                   float* dout);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
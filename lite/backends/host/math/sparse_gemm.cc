@@ -0,0 +1,237 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/sparse_gemm.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The columns of the output computed at a time by SparseDenseMatMul.
+static constexpr int kTile = 64;
+// Smaller products are not worth waking the threads up for.
+static constexpr int kMinParallelWork = 1 << 14;
+
+static bool IsNonzeroBlock(const float* dense,
+                           int cols,
+                           int block_h,
+                           int block_w) {
+  for (int r = 0; r < block_h; ++r) {
+    for (int c = 0; c < block_w; ++c) {
+      if (dense[r * cols + c] != 0.f) return true;
+    }
+  }
+  return false;
+}
+
+int CountNonzeroBlocks(
+    const float* dense, int rows, int cols, int block_h, int block_w) {
+  CHECK_EQ(rows % block_h, 0);
+  CHECK_EQ(cols % block_w, 0);
+  int count = 0;
+  for (int i = 0; i < rows; i += block_h) {
+    for (int j = 0; j < cols; j += block_w) {
+      count += IsNonzeroBlock(dense + i * cols + j, cols, block_h, block_w);
+    }
+  }
+  return count;
+}
+
+void DenseToBlockCsr(const float* dense,
+                     int rows,
+                     int cols,
+                     int block_h,
+                     int block_w,
+                     std::vector<float>* values,
+                     std::vector<int>* index) {
+  CHECK_EQ(rows % block_h, 0);
+  CHECK_EQ(cols % block_w, 0);
+  values->clear();
+  std::vector<int> block_cols;
+  index->assign(1, 0);
+  for (int i = 0; i < rows; i += block_h) {
+    for (int j = 0; j < cols; j += block_w) {
+      const float* block = dense + i * cols + j;
+      if (!IsNonzeroBlock(block, cols, block_h, block_w)) continue;
+      for (int r = 0; r < block_h; ++r) {
+        values->insert(
+            values->end(), block + r * cols, block + r * cols + block_w);
+      }
+      block_cols.push_back(j / block_w);
+    }
+    index->push_back(static_cast<int>(block_cols.size()));
+  }
+  index->insert(index->end(), block_cols.begin(), block_cols.end());
+}
+
+// The block row `br` of the output, a tile of kTile columns of its BH rows at
+// a time.
+template <int BH>
+static void SparseDenseBlockRow(const BlockCsrMatrix& a,
+                                int br,
+                                const float* b,
+                                int n,
+                                const float* bias,
+                                float* out) {
+  const int bw = a.block_w;
+  const int begin = a.row_offsets[br];
+  const int end = a.row_offsets[br + 1];
+  float* out_rows = out + static_cast<int64_t>(br) * BH * n;
+  float acc[BH][kTile];
+  for (int j0 = 0; j0 < n; j0 += kTile) {
+    const int len = std::min(kTile, n - j0);
+    for (int r = 0; r < BH; ++r) {
+      const float init = bias ? bias[br * BH + r] : 0.f;
+      for (int j = 0; j < len; ++j) {
+        acc[r][j] = init;
+      }
+    }
+    for (int k = begin; k < end; ++k) {
+      const float* v = a.values + static_cast<int64_t>(k) * BH * bw;
+      const float* b_rows =
+          b + static_cast<int64_t>(a.block_cols[k]) * bw * n + j0;
+      for (int c = 0; c < bw; ++c) {
+        const float* b_row = b_rows + c * n;
+        for (int r = 0; r < BH; ++r) {
+          const float w = v[r * bw + c];
+          for (int j = 0; j < len; ++j) {
+            acc[r][j] += w * b_row[j];
+          }
+        }
+      }
+    }
+    for (int r = 0; r < BH; ++r) {
+      std::memcpy(out_rows + r * n + j0, acc[r], sizeof(float) * len);
+    }
+  }
+}
+
+template <int BH>
+static void SparseDenseMatMulImpl(const BlockCsrMatrix& a,
+                                  const float* b,
+                                  int n,
+                                  const float* bias,
+                                  float* out) {
+  const int block_rows = a.rows / BH;
+#ifdef _OPENMP
+  const bool parallel =
+      block_rows > 1 &&
+      static_cast<int64_t>(a.num_blocks()) * BH * a.block_w * n >=
+          kMinParallelWork;
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+  for (int br = 0; br < block_rows; ++br) {
+    SparseDenseBlockRow<BH>(a, br, b, n, bias, out);
+  }
+}
+
+void SparseDenseMatMul(const BlockCsrMatrix& a,
+                       const float* b,
+                       int n,
+                       const float* bias,
+                       float* out) {
+  switch (a.block_h) {
+    case 1:
+      SparseDenseMatMulImpl<1>(a, b, n, bias, out);
+      break;
+    case 2:
+      SparseDenseMatMulImpl<2>(a, b, n, bias, out);
+      break;
+    case 4:
+      SparseDenseMatMulImpl<4>(a, b, n, bias, out);
+      break;
+    case 8:
+      SparseDenseMatMulImpl<8>(a, b, n, bias, out);
+      break;
+    default:
+      LOG(FATAL) << "unsupported block height " << a.block_h;
+  }
+}
+
+// One row of the output, BW is the block width, or 0 if it is only known at
+// runtime.
+template <int BW>
+static void DenseSparseRow(const float* a_row,
+                           const BlockCsrMatrix& b,
+                           float* out_row) {
+  const int bw = BW > 0 ? BW : b.block_w;
+  const int bh = b.block_h;
+  std::memset(out_row, 0, sizeof(float) * b.cols);
+  for (int br = 0; br < b.rows / bh; ++br) {
+    const int begin = b.row_offsets[br];
+    const int end = b.row_offsets[br + 1];
+    for (int r = 0; r < bh; ++r) {
+      const float x = a_row[br * bh + r];
+      if (x == 0.f) continue;
+      for (int k = begin; k < end; ++k) {
+        const float* v = b.values + (static_cast<int64_t>(k) * bh + r) * bw;
+        float* o = out_row + b.block_cols[k] * bw;
+        for (int c = 0; c < bw; ++c) {
+          o[c] += x * v[c];
+        }
+      }
+    }
+  }
+}
+
+template <int BW>
+static void DenseSparseMatMulImpl(const float* a,
+                                  int m,
+                                  const BlockCsrMatrix& b,
+                                  float* out) {
+#ifdef _OPENMP
+  const bool parallel =
+      m > 1 &&
+      static_cast<int64_t>(b.num_blocks()) * b.block_h * b.block_w * m >=
+          kMinParallelWork;
+#pragma omp parallel for if (parallel)
+#endif
+  for (int i = 0; i < m; ++i) {
+    DenseSparseRow<BW>(a + static_cast<int64_t>(i) * b.rows,
+                       b,
+                       out + static_cast<int64_t>(i) * b.cols);
+  }
+}
+
+void DenseSparseMatMul(const float* a,
+                       int m,
+                       const BlockCsrMatrix& b,
+                       float* out) {
+  switch (b.block_w) {
+    case 1:
+      DenseSparseMatMulImpl<1>(a, m, b, out);
+      break;
+    case 4:
+      DenseSparseMatMulImpl<4>(a, m, b, out);
+      break;
+    case 8:
+      DenseSparseMatMulImpl<8>(a, m, b, out);
+      break;
+    case 16:
+      DenseSparseMatMulImpl<16>(a, m, b, out);
+      break;
+    default:
+      DenseSparseMatMulImpl<0>(a, m, b, out);
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * A [rows, cols] matrix in the block-CSR format. The matrix is cut into
+ * block_h x block_w blocks, whose sizes divide rows and cols, and only the
+ * blocks with a nonzero are kept, each one row-major in `values`. The blocks
+ * of the block row r are [row_offsets[r], row_offsets[r + 1]), in the order
+ * of their block columns `block_cols`.
+ *
+ * The offsets and the columns are stored one after the other in one int32
+ * index, [rows / block_h + 1 offsets, the columns of the blocks].
+ */
+struct BlockCsrMatrix {
+  const float* values{nullptr};
+  const int* row_offsets{nullptr};
+  const int* block_cols{nullptr};
+  int rows{0};
+  int cols{0};
+  int block_h{1};
+  int block_w{1};
+
+  BlockCsrMatrix() = default;
+  BlockCsrMatrix(const float* values,
+                 const int* index,
+                 int rows,
+                 int cols,
+                 int block_h,
+                 int block_w)
+      : values(values),
+        row_offsets(index),
+        block_cols(index + rows / block_h + 1),
+        rows(rows),
+        cols(cols),
+        block_h(block_h),
+        block_w(block_w) {}
+
+  int num_blocks() const { return row_offsets[rows / block_h]; }
+};
+
+// The blocks of a row-major [rows, cols] matrix with a nonzero.
+int CountNonzeroBlocks(
+    const float* dense, int rows, int cols, int block_h, int block_w);
+
+// Encode a row-major [rows, cols] matrix, see BlockCsrMatrix.
+void DenseToBlockCsr(const float* dense,
+                     int rows,
+                     int cols,
+                     int block_h,
+                     int block_w,
+                     std::vector<float>* values,
+                     std::vector<int>* index);
+
+/*
+ * out[rows, n] = a * b[cols, n] + bias, with one bias per row, which may be
+ * null. This is a 1x1 convolution of a [cols, n] image by a sparse
+ * [rows, cols] filter. The output is computed by tiles of columns, so that a
+ * tile of block_h rows stays in the L1 cache while it is accumulated and each
+ * loaded row of b is used by all the rows of a block. Block heights of 1, 2,
+ * 4 and 8 are supported.
+ */
+void SparseDenseMatMul(const BlockCsrMatrix& a,
+                       const float* b,
+                       int n,
+                       const float* bias,
+                       float* out);
+
+/*
+ * out[m, cols] = a[m, rows] * b, e.g. the product of a mul by its sparse
+ * weight. Each nonzero of a is multiplied by the blocks of the matching
+ * block row of b, the zeros of a, e.g. after a relu, are skipped.
+ */
+void DenseSparseMatMul(const float* a,
+                       int m,
+                       const BlockCsrMatrix& b,
+                       float* out);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -15,28 +15,16 @@
 #include "lite/core/target_wrapper.h"
 #include <cstring>
 #include <memory>
+#include "lite/backends/host/host_allocator.h"
 
 namespace paddle {
 namespace lite {
 
-const int MALLOC_ALIGN = 64;
-
 void* TargetWrapper<TARGET(kHost)>::Malloc(size_t size) {
-  size_t offset = sizeof(void*) + MALLOC_ALIGN - 1;
-  char* p = static_cast<char*>(malloc(offset + size));
-  if (!p) {
-    return nullptr;
-  }
-  void* r = reinterpret_cast<void*>(reinterpret_cast<size_t>(p + offset) &
-                                    (~(MALLOC_ALIGN - 1)));
-  static_cast<void**>(r)[-1] = p;
-  memset(r, 0, size);
-  return r;
+  return GetHostAllocator()->Allocate(size);
 }
 void TargetWrapper<TARGET(kHost)>::Free(void* ptr) {
-  if (ptr) {
-    free(static_cast<void**>(ptr)[-1]);
-  }
+  GetHostAllocator()->Deallocate(ptr);
 }
 void TargetWrapper<TARGET(kHost)>::MemcpySync(void* dst,
                                               const void* src,
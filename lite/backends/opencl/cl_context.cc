@@ -41,11 +41,9 @@ cl::Program &CLContext::GetProgram(const std::string &file_name,
     return *(it->second);
   }
 
-  auto program = CLRuntime::Global()->CreateProgram(
-      GetContext(), CLRuntime::Global()->cl_path() + "/cl_kernel/" + file_name);
-
   VLOG(3) << " --- begin build program -> " << program_key << " --- ";
-  CLRuntime::Global()->BuildProgram(program.get(), options);
+  auto program =
+      CLRuntime::Global()->CreateBuiltProgram(GetContext(), file_name, options);
   VLOG(3) << " --- end build program -> " << program_key << " --- ";
 
   programs_[program_key] = std::move(program);
@@ -15,8 +15,10 @@ limitations under the License. */
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <random>
+#include <string>
 #include <vector>
 #include "lite/backends/opencl/cl_caller.h"
 #include "lite/backends/opencl/cl_context.h"
@@ -56,6 +58,37 @@ TEST(cl_test, context_test) {
   context.AddKernel("elementwise_add", "image/elementwise_add_kernel.cl", "");
 }
 
+TEST(cl_test, embedded_source_test) {
+  auto *runtime = CLRuntime::Global();
+  CHECK(runtime->IsInitSuccess());
+  runtime->set_cl_path("/nonexistent");
+  auto source = runtime->GetProgramSource("image/pool_kernel.cl");
+  EXPECT_EQ(source.find("#include <cl_common.h>"), std::string::npos);
+  auto &context = runtime->context();
+  auto program = runtime->CreateProgram(context, "image/pool_kernel.cl");
+  CHECK(runtime->BuildProgram(program.get()));
+  runtime->set_cl_path(FLAGS_cl_path);
+}
+
+TEST(cl_test, program_cache_test) {
+  auto *runtime = CLRuntime::Global();
+  CHECK(runtime->IsInitSuccess());
+  char dir[] = "/tmp/cl_cache_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir));
+  runtime->set_cl_cache_dir(dir);
+  auto &context = runtime->context();
+  // The first one is built from the source and saved, the second one is
+  // loaded from the binary.
+  for (int i = 0; i < 2; ++i) {
+    auto program = runtime->CreateBuiltProgram(
+        context, "image/elementwise_add_kernel.cl", "");
+    cl_int status;
+    cl::Kernel kernel(*program, "elementwise_add", &status);
+    EXPECT_EQ(status, CL_SUCCESS);
+  }
+  runtime->set_cl_cache_dir("");
+}
+
 TEST(cl_test, kernel_test) {
   auto *runtime = CLRuntime::Global();
   CHECK(runtime->IsInitSuccess());
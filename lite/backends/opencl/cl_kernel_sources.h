@@ -0,0 +1,27 @@
+/* Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+#include <map>
+#include <string>
+
+namespace paddle {
+namespace lite {
+
+// The sources under cl_kernel/, embedded by the CMakeLists.txt at build time
+// and keyed by their path relative to cl_kernel/, e.g. "image/relu_kernel.cl".
+const std::map<std::string, const char*>& CLKernelSources();
+
+}  // namespace lite
+}  // namespace paddle
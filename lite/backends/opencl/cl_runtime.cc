@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/opencl/cl_runtime.h"
+#include <cstdio>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/backends/opencl/cl_kernel_sources.h"
 #include "lite/utils/cp_logging.h"
 
 namespace paddle {
@@ -73,23 +76,151 @@ cl::CommandQueue& CLRuntime::command_queue() {
   return *command_queue_;
 }
 
-std::unique_ptr<cl::Program> CLRuntime::CreateProgram(
-    const cl::Context& context, std::string file_name) {
-  std::ifstream file{file_name, std::ios::binary | std::ios::ate};
-  CHECK(file.is_open()) << "Can't open file from " << file_name;
+namespace {
+
+bool ReadFile(const std::string& path, std::string* content) {
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file.is_open()) return false;
   auto size = file.tellg();
-  CHECK(size > 0) << "size is too small.";
-  std::string content(size, '\0');
+  if (size <= 0) return false;
+  content->assign(size, '\0');
   file.seekg(0);
-  file.read(&content[0], size);
+  file.read(&(*content)[0], size);
+  return file.good();
+}
+
+// FNV-1a, stable from run to run, to name the cached program binaries.
+std::string HashKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  return hex;
+}
+
+}  // namespace
+
+std::string CLRuntime::GetProgramSource(const std::string& file_name) {
+  std::string content;
+  auto& embedded = CLKernelSources();
+  auto it = embedded.find(file_name);
+  if (it != embedded.end()) {
+    content = it->second;
+  } else {
+    CHECK(ReadFile(file_name, &content) ||
+          ReadFile(cl_path_ + "/cl_kernel/" + file_name, &content))
+        << "Can't open file from " << file_name;
+  }
+  // Inline `#include <cl_common.h>` and the like, the embedded sources are
+  // built without the include path.
+  std::string res;
+  std::istringstream lines(content);
+  std::string line;
+  while (std::getline(lines, line)) {
+    auto begin = line.find_first_not_of(" \t");
+    if (begin != std::string::npos && line.compare(begin, 8, "#include") == 0) {
+      auto open = line.find_first_of("<\"", begin + 8);
+      auto close = line.find_first_of(">\"", open + 1);
+      if (open != std::string::npos && close != std::string::npos) {
+        auto header = embedded.find(line.substr(open + 1, close - open - 1));
+        if (header != embedded.end()) {
+          res += header->second;
+          res += "\n";
+          continue;
+        }
+      }
+    }
+    res += line;
+    res += "\n";
+  }
+  return res;
+}
+
+std::unique_ptr<cl::Program> CLRuntime::CreateProgramWithSource(
+    const cl::Context& context, const std::string& source) {
   cl::Program::Sources sources;
-  sources.push_back(content);
+  sources.push_back(source);
   auto prog =
       std::unique_ptr<cl::Program>(new cl::Program(context, sources, &status_));
-  VLOG(4) << "OpenCL kernel file name: " << file_name;
-  VLOG(4) << "Program source size: " << content.size();
+  VLOG(4) << "Program source size: " << source.size();
   CL_CHECK_FATAL(status_);
-  return std::move(prog);
+  return prog;
+}
+
+std::unique_ptr<cl::Program> CLRuntime::CreateProgram(
+    const cl::Context& context, std::string file_name) {
+  VLOG(4) << "OpenCL kernel file name: " << file_name;
+  return CreateProgramWithSource(context, GetProgramSource(file_name));
+}
+
+std::unique_ptr<cl::Program> CLRuntime::CreateBuiltProgram(
+    const cl::Context& context,
+    const std::string& file_name,
+    const std::string& options) {
+  auto source = GetProgramSource(file_name);
+  std::string cache_path;
+  if (!cl_cache_dir_.empty()) {
+    std::string key = device().getInfo<CL_DEVICE_NAME>() + "\n" +
+                      device().getInfo<CL_DEVICE_VERSION>() + "\n" +
+                      device().getInfo<CL_DRIVER_VERSION>() + "\n" +
+                      BuildOptions(options) + "\n" + source;
+    cache_path = cl_cache_dir_ + "/" + HashKey(key) + ".bin";
+    auto prog = LoadProgramBinary(context, cache_path, options);
+    if (prog) {
+      VLOG(3) << "Program " << file_name << " is loaded from " << cache_path;
+      return prog;
+    }
+  }
+  auto prog = CreateProgramWithSource(context, source);
+  BuildProgram(prog.get(), options);
+  if (!cache_path.empty()) {
+    SaveProgramBinary(*prog, cache_path);
+  }
+  return prog;
+}
+
+std::unique_ptr<cl::Program> CLRuntime::LoadProgramBinary(
+    const cl::Context& context,
+    const std::string& path,
+    const std::string& options) {
+  std::string content;
+  if (!ReadFile(path, &content)) return nullptr;
+  cl::Program::Binaries binaries{
+      std::vector<unsigned char>(content.begin(), content.end())};
+  std::vector<cl_int> binary_status;
+  std::unique_ptr<cl::Program> prog(new cl::Program(
+      context, {device()}, binaries, &binary_status, &status_));
+  if (status_ == CL_SUCCESS && binary_status[0] == CL_SUCCESS) {
+    status_ = prog->build({device()}, BuildOptions(options).c_str());
+  }
+  if (status_ != CL_SUCCESS) {
+    // The driver might have been updated with the same version string.
+    LOG(WARNING) << "Invalid OpenCL program binary " << path
+                 << ", rebuild it from the source.";
+    return nullptr;
+  }
+  return prog;
+}
+
+void CLRuntime::SaveProgramBinary(const cl::Program& program,
+                                  const std::string& path) {
+  auto binaries = program.getInfo<CL_PROGRAM_BINARIES>(&status_);
+  if (status_ != CL_SUCCESS || binaries.empty() || binaries[0].empty()) {
+    LOG(WARNING) << "Failed to get the OpenCL program binary.";
+    return;
+  }
+  // Write to a temporary file first, another process might be reading it.
+  std::string tmp_path = path + ".tmp";
+  std::ofstream file{tmp_path, std::ios::binary};
+  file.write(reinterpret_cast<const char*>(binaries[0].data()),
+             binaries[0].size());
+  file.close();
+  if (!file.good() || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the OpenCL program binary to " << path;
+    std::remove(tmp_path.c_str());
+  }
 }
 
 std::unique_ptr<cl::UserEvent> CLRuntime::CreateEvent(
@@ -100,9 +231,12 @@ std::unique_ptr<cl::UserEvent> CLRuntime::CreateEvent(
   return std::move(event);
 }
 
+std::string CLRuntime::BuildOptions(const std::string& options) {
+  return options + " -cl-fast-relaxed-math -I " + cl_path_ + "/cl_kernel";
+}
+
 bool CLRuntime::BuildProgram(cl::Program* program, const std::string& options) {
-  std::string build_option = options + " -cl-fast-relaxed-math -I " +
-                             CLRuntime::Global()->cl_path() + "/cl_kernel";
+  std::string build_option = BuildOptions(options);
   status_ = program->build({*device_}, build_option.c_str());
   CL_CHECK_ERROR(status_);
 
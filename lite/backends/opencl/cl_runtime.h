@@ -38,9 +38,22 @@ class CLRuntime {
 
   cl::CommandQueue& command_queue();
 
+  // Create a program from the source of `file_name`, the embedded source if
+  // it is a path relative to cl_kernel/, or the file otherwise.
   std::unique_ptr<cl::Program> CreateProgram(const cl::Context& context,
                                              std::string file_name);
 
+  // Create and build the program of `file_name` with `options`. If the cache
+  // directory is set, the binary built for the same device, driver, options
+  // and source is loaded from it, or it is stored there once built.
+  std::unique_ptr<cl::Program> CreateBuiltProgram(const cl::Context& context,
+                                                  const std::string& file_name,
+                                                  const std::string& options);
+
+  // Get the source of `file_name` with the includes of the kernel headers
+  // inlined.
+  std::string GetProgramSource(const std::string& file_name);
+
   std::unique_ptr<cl::UserEvent> CreateEvent(const cl::Context& context);
 
   bool BuildProgram(cl::Program* program, const std::string& options = "");
@@ -51,6 +64,11 @@ class CLRuntime {
 
   void set_cl_path(std::string cl_path) { cl_path_ = cl_path; }
 
+  std::string cl_cache_dir() { return cl_cache_dir_; }
+
+  // The existing directory to cache the program binaries, empty to disable.
+  void set_cl_cache_dir(std::string dir) { cl_cache_dir_ = dir; }
+
  private:
   CLRuntime() = default;
 
@@ -60,6 +78,17 @@ class CLRuntime {
 
   bool InitializeDevice();
 
+  std::string BuildOptions(const std::string& options);
+
+  std::unique_ptr<cl::Program> CreateProgramWithSource(
+      const cl::Context& context, const std::string& source);
+
+  std::unique_ptr<cl::Program> LoadProgramBinary(const cl::Context& context,
+                                                 const std::string& path,
+                                                 const std::string& options);
+
+  void SaveProgramBinary(const cl::Program& program, const std::string& path);
+
   std::shared_ptr<cl::Context> CreateContext() {
     auto context = std::make_shared<cl::Context>(
         std::vector<cl::Device>{device()}, nullptr, nullptr, nullptr, &status_);
@@ -82,6 +111,8 @@ class CLRuntime {
 
   std::string cl_path_;
 
+  std::string cl_cache_dir_;
+
   std::shared_ptr<cl::Platform> platform_{nullptr};
 
   std::shared_ptr<cl::Context> context_{nullptr};
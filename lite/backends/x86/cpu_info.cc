@@ -29,8 +29,21 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <gflags/gflags.h>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT
 
 DEFINE_double(fraction_of_cpu_memory_to_use,
               1,
@@ -155,6 +168,171 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
 }
 #endif
 
+namespace {
+
+// A list of the sysfs format, e.g. "0-3,8,10-11".
+std::vector<int> ParseIdList(const std::string& list) {
+  std::vector<int> ids;
+  const char* p = list.c_str();
+  while (*p) {
+    char* end;
+    const long first = std::strtol(p, &end, 10);  // NOLINT
+    if (end == p) break;
+    long last = first;  // NOLINT
+    p = end;
+    if (*p == '-') {
+      last = std::strtol(p + 1, &end, 10);
+      if (end == p + 1) break;
+      p = end;
+    }
+    for (long id = first; id <= last; ++id) {  // NOLINT
+      ids.push_back(static_cast<int>(id));
+    }
+    if (*p == ',') ++p;
+  }
+  return ids;
+}
+
+// The CPUs of each node, indexed by the node id.
+const std::vector<std::vector<int>>& NumaTopology() {
+  static const std::vector<std::vector<int>> topology = [] {
+    std::vector<std::vector<int>> cpus;
+#ifdef __linux__
+    const std::string root = "/sys/devices/system/node/";
+    std::ifstream online(root + "online");
+    std::string nodes;
+    if (online >> nodes) {
+      for (int node : ParseIdList(nodes)) {
+        std::ifstream file(root + "node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (node < 0 || !(file >> list)) continue;
+        if (static_cast<int>(cpus.size()) <= node) cpus.resize(node + 1);
+        cpus[node] = ParseIdList(list);
+      }
+    }
+#endif
+    bool any = false;
+    for (auto& node : cpus) any = any || !node.empty();
+    if (!any) {
+      cpus.assign(1, std::vector<int>());
+      const int n = std::max<int>(std::thread::hardware_concurrency(), 1);
+      for (int i = 0; i < n; ++i) cpus[0].push_back(i);
+    }
+    return cpus;
+  }();
+  return topology;
+}
+
+thread_local int bound_numa_node = -1;
+
+#ifdef __linux__
+// Set the CPUs of the calling thread and of the OpenMP threads it runs.
+bool SetThreadAffinity(const cpu_set_t& mask) {
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) return false;
+#ifdef _OPENMP
+  // The team of the calling thread may have been started elsewhere, each
+  // thread binds itself.
+#pragma omp parallel
+  { sched_setaffinity(0, sizeof(mask), &mask); }
+#endif
+  return true;
+}
+#endif  // __linux__
+
+}  // namespace
+
+std::vector<int> NumaNodes() {
+  const auto& topology = NumaTopology();
+  std::vector<int> nodes;
+  for (size_t i = 0; i < topology.size(); ++i) {
+    if (!topology[i].empty()) nodes.push_back(static_cast<int>(i));
+  }
+  return nodes;
+}
+
+std::vector<int> NumaNodeCpus(int node) {
+  const auto& topology = NumaTopology();
+  if (node < 0 || node >= static_cast<int>(topology.size())) return {};
+  return topology[node];
+}
+
+bool BindToNumaNode(int node) {
+#ifdef __linux__
+  const auto cpus = NumaNodeCpus(node);
+  if (cpus.empty()) return false;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+  }
+  if (!SetThreadAffinity(mask)) return false;
+  bound_numa_node = node;
+  return true;
+#else
+  return false;
+#endif  // __linux__
+}
+
+int BoundNumaNode() { return bound_numa_node; }
+
+NumaBindingGuard::NumaBindingGuard(int node) : saved_node_(bound_numa_node) {
+  if (node < 0) return;
+  if (node == saved_node_) {
+    bound_ = true;
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) saved_cpus_.push_back(cpu);
+  }
+#endif  // __linux__
+  bound_ = BindToNumaNode(node);
+  restore_ = bound_;
+}
+
+NumaBindingGuard::~NumaBindingGuard() {
+  if (!restore_) return;
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : saved_cpus_) {
+    CPU_SET(cpu, &mask);
+  }
+  SetThreadAffinity(mask);
+#endif  // __linux__
+  bound_numa_node = saved_node_;
+}
+
+bool MoveToNumaNode(const void* data, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (!data || size == 0 || NumaNodeCpus(node).empty()) return false;
+  // The values of <numaif.h>, which is not always installed: the pages
+  // prefer the node and the ones already allocated elsewhere are moved.
+  const int kMpolPreferred = 1;
+  const unsigned kMpolMfMove = 1 << 1;
+  const uintptr_t page = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+  const uintptr_t end =
+      (reinterpret_cast<uintptr_t>(data) + size + page - 1) & ~(page - 1);
+  const int bits = 8 * sizeof(unsigned long);        // NOLINT
+  std::vector<unsigned long> mask(node / bits + 1);  // NOLINT
+  mask[node / bits] |= 1UL << (node % bits);
+  // The kernel reads one bit less than `maxnode`.
+  return syscall(SYS_mbind,
+                 begin,
+                 end - begin,
+                 kMpolPreferred,
+                 mask.data(),
+                 mask.size() * bits + 1,
+                 kMpolMfMove) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
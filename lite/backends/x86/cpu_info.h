@@ -15,6 +15,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <vector>
 
 #ifdef _WIN32
 #if defined(__AVX2__)
@@ -75,6 +76,45 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+//! The NUMA nodes with CPUs, read from /sys/devices/system/node on Linux. A
+//! machine without NUMA, or another OS, has the node 0 with all the CPUs.
+std::vector<int> NumaNodes();
+
+//! The CPUs of a NUMA node, empty for an unknown node.
+std::vector<int> NumaNodeCpus(int node);
+
+//! Bind the calling thread and the OpenMP threads it runs to the CPUs of a
+//! NUMA node, so that the memory they first touch is allocated on the node.
+//! Return false if the node is unknown or the OS does not support it.
+bool BindToNumaNode(int node);
+
+//! The node the calling thread was bound to by `BindToNumaNode`, -1 if none.
+int BoundNumaNode();
+
+//! Bind the calling thread to a NUMA node as `BindToNumaNode` does while it
+//! lives, then give the thread and its OpenMP team back the CPUs and the node
+//! they were bound to before. A node < 0 binds nothing.
+class NumaBindingGuard {
+ public:
+  explicit NumaBindingGuard(int node);
+  ~NumaBindingGuard();
+
+  //! Whether the thread is bound to the node.
+  bool bound() const { return bound_; }
+
+ private:
+  std::vector<int> saved_cpus_;
+  int saved_node_{-1};
+  bool bound_{false};
+  bool restore_{false};
+};
+
+//! Move the pages holding [data, data + size) to the memory of a NUMA node,
+//! e.g. the weights loaded by another thread. The range is rounded out to
+//! whole pages, which keep preferring the node, so it should own its pages.
+//! Return false if it failed.
+bool MoveToNumaNode(const void* data, size_t size, int node);
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
@@ -29,6 +29,18 @@
 #include <cblas.h>
 #endif
 
+#ifdef PADDLE_USE_INTERNAL_BLAS
+#include "lite/backends/x86/math/sgemm.h"
+
+// Without a cblas header, the enums that Blas takes are declared here.
+enum CBLAS_ORDER { CblasRowMajor = 101, CblasColMajor = 102 };
+enum CBLAS_TRANSPOSE {
+  CblasNoTrans = 111,
+  CblasTrans = 112,
+  CblasConjTrans = 113
+};
+#endif
+
 namespace paddle {
 namespace lite {
 namespace x86 {
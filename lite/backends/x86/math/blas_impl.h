@@ -236,6 +236,121 @@ struct CBlas<double> {
   }
 };
 
+#elif defined(PADDLE_USE_INTERNAL_BLAS)
+
+// The row-major cblas routines that Blas calls, as plain loops. The float GEMM
+// runs on the in-tree sgemm.
+template <typename T>
+struct LoopCBlas {
+  static void GEMM(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   CBLAS_TRANSPOSE transB,
+                   int M,
+                   int N,
+                   int K,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *B,
+                   int ldb,
+                   T beta,
+                   T *C,
+                   int ldc) {
+    PADDLE_ENFORCE_EQ(order, CblasRowMajor);
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        T sum = 0;
+        for (int k = 0; k < K; ++k) {
+          T a = transA == CblasNoTrans ? A[i * lda + k] : A[k * lda + i];
+          T b = transB == CblasNoTrans ? B[k * ldb + j] : B[j * ldb + k];
+          sum += a * b;
+        }
+        T c = beta == 0 ? 0 : beta * C[i * ldc + j];
+        C[i * ldc + j] = alpha * sum + c;
+      }
+    }
+  }
+
+  static void AXPY(int n, T alpha, const T *x, int incx, T *y, int incy) {
+    for (int i = 0; i < n; ++i) {
+      y[i * incy] += alpha * x[i * incx];
+    }
+  }
+
+  static void VCOPY(int n, const T *x, int incx, T *y, int incy) {
+    for (int i = 0; i < n; ++i) {
+      y[i * incy] = x[i * incx];
+    }
+  }
+
+  static void GEMV(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE trans,
+                   int M,
+                   int N,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *x,
+                   int incx,
+                   T beta,
+                   T *y,
+                   int incy) {
+    PADDLE_ENFORCE_EQ(order, CblasRowMajor);
+    int rows = trans == CblasNoTrans ? M : N;
+    for (int i = 0; i < rows; ++i) {
+      y[i * incy] = beta == 0 ? 0 : beta * y[i * incy];
+    }
+    if (trans == CblasNoTrans) {
+      for (int i = 0; i < M; ++i) {
+        T sum = 0;
+        for (int j = 0; j < N; ++j) sum += A[i * lda + j] * x[j * incx];
+        y[i * incy] += alpha * sum;
+      }
+    } else {
+      for (int i = 0; i < M; ++i) {
+        T xi = alpha * x[i * incx];
+        for (int j = 0; j < N; ++j) y[j * incy] += A[i * lda + j] * xi;
+      }
+    }
+  }
+};
+
+template <>
+struct CBlas<float> : public LoopCBlas<float> {
+  static void GEMM(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   CBLAS_TRANSPOSE transB,
+                   int M,
+                   int N,
+                   int K,
+                   float alpha,
+                   const float *A,
+                   int lda,
+                   const float *B,
+                   int ldb,
+                   float beta,
+                   float *C,
+                   int ldc) {
+    PADDLE_ENFORCE_EQ(order, CblasRowMajor);
+    Sgemm(transA != CblasNoTrans,
+          transB != CblasNoTrans,
+          M,
+          N,
+          K,
+          alpha,
+          A,
+          lda,
+          B,
+          ldb,
+          beta,
+          C,
+          ldc);
+  }
+};
+
+template <>
+struct CBlas<double> : public LoopCBlas<double> {};
+
 #else
 
 template <>
@@ -0,0 +1,384 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_winograd.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/conv_winograd_kernel.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The transforms of Lavin & Gray, with the points 0, +-1, +-2 for F(4, 3)
+// and 0, +-1, +-2, +-1/2 for F(6, 3): the input one B^T, the filter one G and
+// the output one A^T.
+const float kBT4[6 * 6] = {4, 0,  -5, 0,  1, 0, 0, -4, -4, 1,  1, 0,
+                           0, 4,  -4, -1, 1, 0, 0, -2, -1, 2,  1, 0,
+                           0, 2,  -1, -2, 1, 0, 0, 4,  0,  -5, 0, 1};
+const float kG4[6 * 3] = {1.f / 4,
+                          0,
+                          0,
+                          -1.f / 6,
+                          -1.f / 6,
+                          -1.f / 6,
+                          -1.f / 6,
+                          1.f / 6,
+                          -1.f / 6,
+                          1.f / 24,
+                          1.f / 12,
+                          1.f / 6,
+                          1.f / 24,
+                          -1.f / 12,
+                          1.f / 6,
+                          0,
+                          0,
+                          1};
+const float kAT4[4 * 6] = {1, 1, 1,  1, 1, 0, 0, 1, -1, 2, -2, 0,
+                           0, 1, 1,  4, 4, 0, 0, 1, -1, 8, -8, 1};
+
+const float kBT6[8 * 8] = {
+    1, 0,     -5.25f, 0,      5.25f,  0,      -1, 0,  // NOLINT
+    0, 1,     1,      -4.25f, -4.25f, 1,      1,  0,  // NOLINT
+    0, -1,    1,      4.25f,  -4.25f, -1,     1,  0,  // NOLINT
+    0, 0.5f,  0.25f,  -2.5f,  -1.25f, 2,      1,  0,  // NOLINT
+    0, -0.5f, 0.25f,  2.5f,   -1.25f, -2,     1,  0,  // NOLINT
+    0, 2,     4,      -2.5f,  -5,     0.5f,   1,  0,  // NOLINT
+    0, -2,    4,      2.5f,   -5,     -0.5f,  1,  0,  // NOLINT
+    0, -1,    0,      5.25f,  0,      -5.25f, 0,  1};
+const float kG6[8 * 3] = {1,
+                          0,
+                          0,
+                          -2.f / 9,
+                          -2.f / 9,
+                          -2.f / 9,
+                          -2.f / 9,
+                          2.f / 9,
+                          -2.f / 9,
+                          1.f / 90,
+                          1.f / 45,
+                          2.f / 45,
+                          1.f / 90,
+                          -1.f / 45,
+                          2.f / 45,
+                          32.f / 45,
+                          16.f / 45,
+                          8.f / 45,
+                          32.f / 45,
+                          -16.f / 45,
+                          8.f / 45,
+                          0,
+                          0,
+                          1};
+const float kAT6[6 * 8] = {
+    1, 1,  1,  1,  1,   1,        1,         0,  // NOLINT
+    0, 1,  -1, 2,  -2,  0.5f,     -0.5f,     0,  // NOLINT
+    0, 1,  1,  4,  4,   0.25f,    0.25f,     0,  // NOLINT
+    0, 1,  -1, 8,  -8,  0.125f,   -0.125f,   0,  // NOLINT
+    0, 1,  1,  16, 16,  0.0625f,  0.0625f,   0,  // NOLINT
+    0, 1,  -1, 32, -32, 0.03125f, -0.03125f, 1};
+
+void GenericMatMul(const float* mat,
+                   int rows,
+                   int cols,
+                   const float* x,
+                   int ldx,
+                   float* y,
+                   int ldy,
+                   int n) {
+  for (int r = 0; r < rows; ++r) {
+    float* yr = y + r * ldy;
+    std::fill(yr, yr + n, 0.f);
+    for (int i = 0; i < cols; ++i) {
+      const float m = mat[r * cols + i];
+      if (m == 0.f) continue;
+      const float* xi = x + i * ldx;
+      for (int l = 0; l < n; ++l) {
+        yr[l] += m * xi[l];
+      }
+    }
+  }
+}
+
+WinogradMatMul CurrentMatMul() {
+  static const WinogradMatMul matmul = [] {
+    if (MayIUse(avx512f) && WinogradAvx512MatMul()) {
+      return WinogradAvx512MatMul();
+    }
+    if (MayIUse(avx2) && WinogradAvx2MatMul()) {
+      return WinogradAvx2MatMul();
+    }
+    return WinogradGenericMatMul();
+  }();
+  return matmul;
+}
+
+void Activate(const SgemmEpilogue& ep, float bias, float* data, int size) {
+  switch (ep.act) {
+    case lite_api::ActivationType::kIndentity:
+      for (int i = 0; i < size; ++i) data[i] += bias;
+      break;
+    case lite_api::ActivationType::kRelu:
+      for (int i = 0; i < size; ++i) data[i] = std::max(data[i] + bias, 0.f);
+      break;
+    case lite_api::ActivationType::kRelu6:
+      for (int i = 0; i < size; ++i) {
+        data[i] = std::min(std::max(data[i] + bias, 0.f), 6.f);
+      }
+      break;
+    case lite_api::ActivationType::kLeakyRelu:
+      for (int i = 0; i < size; ++i) {
+        const float v = data[i] + bias;
+        data[i] = v > 0.f ? v : v * ep.leaky_alpha;
+      }
+      break;
+    default:
+      LOG(FATAL) << "winograd conv does not support activation "
+                 << static_cast<int>(ep.act);
+  }
+}
+
+}  // namespace
+
+WinogradMatMul WinogradGenericMatMul() { return GenericMatMul; }
+
+WinogradConv3x3::WinogradConv3x3(int tile,
+                                 const float* filter,
+                                 int oc,
+                                 int ic)
+    : tile_(tile), alpha_(tile + 2), oc_(oc), ic_(ic) {
+  CHECK(tile == 4 || tile == 6) << "unsupported winograd tile " << tile;
+  const float* g = tile == 4 ? kG4 : kG6;
+  bt_ = tile == 4 ? kBT4 : kBT6;
+  at_ = tile == 4 ? kAT4 : kAT6;
+  const int alpha = alpha_;
+  weights_.resize(static_cast<size_t>(alpha) * alpha * oc * ic);
+  const int64_t plane = static_cast<int64_t>(oc) * ic;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int k = 0; k < oc; ++k) {
+    // G * w * G^T, by rows then columns.
+    std::vector<float> gw(alpha * 3);
+    for (int c = 0; c < ic; ++c) {
+      const float* w = filter + (static_cast<int64_t>(k) * ic + c) * 9;
+      for (int r = 0; r < alpha; ++r) {
+        for (int j = 0; j < 3; ++j) {
+          gw[r * 3 + j] = g[r * 3] * w[j] + g[r * 3 + 1] * w[3 + j] +
+                          g[r * 3 + 2] * w[6 + j];
+        }
+      }
+      float* u = weights_.data() + static_cast<int64_t>(k) * ic + c;
+      for (int r = 0; r < alpha; ++r) {
+        for (int s = 0; s < alpha; ++s) {
+          u[(r * alpha + s) * plane] = gw[r * 3] * g[s * 3] +
+                                       gw[r * 3 + 1] * g[s * 3 + 1] +
+                                       gw[r * 3 + 2] * g[s * 3 + 2];
+        }
+      }
+    }
+  }
+}
+
+int WinogradConv3x3::PickTile(int oh, int ow) {
+  // The multiplications of a point of every tile, F(4, 3) on a tie as it is
+  // the more accurate one.
+  auto work = [&](int m) {
+    const int64_t tiles =
+        static_cast<int64_t>((oh + m - 1) / m) * ((ow + m - 1) / m);
+    return tiles * (m + 2) * (m + 2);
+  };
+  return work(6) < work(4) ? 6 : 4;
+}
+
+void WinogradConv3x3::InputTransform(
+    const float* in, int ih, int iw, int pad_h, int pad_w, int tiles_w) {
+  const int m = tile_;
+  const int alpha = alpha_;
+  const int tiles = tiles_;
+  const int tiles_h = tiles / tiles_w;
+  const int64_t point_stride = static_cast<int64_t>(ic_) * tiles;
+  const WinogradMatMul matmul = CurrentMatMul();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+  {
+    // The input tiles of a channel as [alpha, alpha, tiles], and their
+    // transform along the rows.
+    std::vector<float> patch(alpha * alpha * tiles);
+    std::vector<float> rows(alpha * alpha * tiles);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int c = 0; c < ic_; ++c) {
+      const float* plane = in + static_cast<int64_t>(c) * ih * iw;
+      for (int ty = 0; ty < tiles_h; ++ty) {
+        for (int i = 0; i < alpha; ++i) {
+          const int y = ty * m - pad_h + i;
+          float* dst = patch.data() + i * alpha * tiles + ty * tiles_w;
+          if (y < 0 || y >= ih) {
+            for (int j = 0; j < alpha; ++j) {
+              std::fill(dst + j * tiles, dst + j * tiles + tiles_w, 0.f);
+            }
+            continue;
+          }
+          const float* src = plane + static_cast<int64_t>(y) * iw;
+          for (int tx = 0; tx < tiles_w; ++tx) {
+            const int x0 = tx * m - pad_w;
+            for (int j = 0; j < alpha; ++j) {
+              const int x = x0 + j;
+              dst[j * tiles + tx] = x >= 0 && x < iw ? src[x] : 0.f;
+            }
+          }
+        }
+      }
+      // B^T * d along the rows of the tiles, then along their columns, into
+      // the [alpha^2, ic, tiles] layout of the GEMM.
+      matmul(bt_,
+             alpha,
+             alpha,
+             patch.data(),
+             alpha * tiles,
+             rows.data(),
+             alpha * tiles,
+             alpha * tiles);
+      for (int r = 0; r < alpha; ++r) {
+        matmul(bt_,
+               alpha,
+               alpha,
+               rows.data() + r * alpha * tiles,
+               tiles,
+               input_.data() + r * alpha * point_stride +
+                   static_cast<int64_t>(c) * tiles,
+               point_stride,
+               tiles);
+      }
+    }
+  }
+}
+
+void WinogradConv3x3::OutputTransform(float* out,
+                                      int oh,
+                                      int ow,
+                                      int tiles_w,
+                                      const SgemmEpilogue* epilogue) {
+  const int m = tile_;
+  const int alpha = alpha_;
+  const int tiles = tiles_;
+  const int tiles_h = tiles / tiles_w;
+  const int64_t point_stride = static_cast<int64_t>(oc_) * tiles;
+  const WinogradMatMul matmul = CurrentMatMul();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+  {
+    // A^T * M along the columns of the tiles as [m, alpha, tiles], then along
+    // their rows as [m, m, tiles].
+    std::vector<float> cols(m * alpha * tiles);
+    std::vector<float> result(m * m * tiles);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int k = 0; k < oc_; ++k) {
+      const float* src = output_.data() + static_cast<int64_t>(k) * tiles;
+      for (int s = 0; s < alpha; ++s) {
+        matmul(at_,
+               m,
+               alpha,
+               src + s * point_stride,
+               alpha * point_stride,
+               cols.data() + s * tiles,
+               alpha * tiles,
+               tiles);
+      }
+      for (int a = 0; a < m; ++a) {
+        matmul(at_,
+               m,
+               alpha,
+               cols.data() + a * alpha * tiles,
+               tiles,
+               result.data() + a * m * tiles,
+               tiles,
+               tiles);
+      }
+      float* plane = out + static_cast<int64_t>(k) * oh * ow;
+      for (int ty = 0; ty < tiles_h; ++ty) {
+        const int rows = std::min(m, oh - ty * m);
+        for (int a = 0; a < rows; ++a) {
+          float* dst = plane + static_cast<int64_t>(ty * m + a) * ow;
+          const float* row = result.data() + a * m * tiles + ty * tiles_w;
+          for (int tx = 0; tx < tiles_w; ++tx) {
+            const int width = std::min(m, ow - tx * m);
+            for (int b = 0; b < width; ++b) {
+              dst[tx * m + b] = row[b * tiles + tx];
+            }
+          }
+        }
+      }
+      if (epilogue) {
+        Activate(*epilogue,
+                 epilogue->bias ? epilogue->bias[k] : 0.f,
+                 plane,
+                 oh * ow);
+      }
+    }
+  }
+}
+
+void WinogradConv3x3::Run(const lite::X86Context& context,
+                          const float* in,
+                          int ih,
+                          int iw,
+                          int pad_h,
+                          int pad_w,
+                          float* out,
+                          int oh,
+                          int ow,
+                          const SgemmEpilogue* epilogue) {
+  CHECK_EQ(oh, ih + 2 * pad_h - 2);
+  CHECK_EQ(ow, iw + 2 * pad_w - 2);
+  const int tiles_w = (ow + tile_ - 1) / tile_;
+  tiles_ = ((oh + tile_ - 1) / tile_) * tiles_w;
+  const int points = alpha_ * alpha_;
+  input_.resize(static_cast<size_t>(points) * ic_ * tiles_);
+  output_.resize(static_cast<size_t>(points) * oc_ * tiles_);
+
+  InputTransform(in, ih, iw, pad_h, pad_w, tiles_w);
+  auto blas = GetBlas<lite::TargetType::kX86, float>(context);
+  blas.BatchedGEMM(CblasNoTrans,
+                   CblasNoTrans,
+                   oc_,
+                   tiles_,
+                   ic_,
+                   1.f,
+                   weights_.data(),
+                   input_.data(),
+                   0.f,
+                   output_.data(),
+                   points,
+                   static_cast<int64_t>(oc_) * ic_,
+                   static_cast<int64_t>(ic_) * tiles_);
+  OutputTransform(out, oh, ow, tiles_w, epilogue);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,86 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/backends/x86/math/sgemm.h"
+#include "lite/core/context.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * A 3x3 convolution of stride 1 by the winograd algorithm F(m x m, 3 x 3),
+ * m = 4 or 6: the output is cut into m x m tiles, each one computed from the
+ * (m + 2) x (m + 2) input tile that covers it. The filter is transformed once
+ * when the engine is made. For an image, the input tiles of every channel are
+ * transformed, then each of the (m + 2)^2 points of the transformed tiles is
+ * an [oc, ic] x [ic, tiles] GEMM, all of them in one batched GEMM, and the
+ * output transform gives the tiles back with the bias and the activation.
+ * The transforms run over all the tiles of a channel side by side, with the
+ * widest vector ISA of the CPU.
+ */
+class WinogradConv3x3 {
+ public:
+  // `filter` is [oc, ic, 3, 3].
+  WinogradConv3x3(int tile, const float* filter, int oc, int ic);
+
+  int tile() const { return tile_; }
+
+  // One [ic, ih, iw] image into its [oc, oh, ow] output. Only the bias and the
+  // activation of the epilogue are used, the bias is one per output channel.
+  void Run(const lite::X86Context& context,
+           const float* in,
+           int ih,
+           int iw,
+           int pad_h,
+           int pad_w,
+           float* out,
+           int oh,
+           int ow,
+           const SgemmEpilogue* epilogue = nullptr);
+
+  // The tile size of the least work on an oh x ow output, 4 or 6.
+  static int PickTile(int oh, int ow);
+
+ private:
+  void InputTransform(
+      const float* in, int ih, int iw, int pad_h, int pad_w, int tiles_w);
+  void OutputTransform(float* out,
+                       int oh,
+                       int ow,
+                       int tiles_w,
+                       const SgemmEpilogue* epilogue);
+
+  int tile_;
+  int alpha_;
+  int oc_;
+  int ic_;
+  int tiles_{0};
+  const float* bt_;
+  const float* at_;
+  // [alpha^2, oc, ic], the filter at every point of the transformed tiles.
+  std::vector<float> weights_;
+  // [alpha^2, ic, tiles] and [alpha^2, oc, tiles], kept between the runs.
+  std::vector<float> input_;
+  std::vector<float> output_;
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
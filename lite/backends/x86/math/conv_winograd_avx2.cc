@@ -0,0 +1,85 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_winograd_kernel.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define LITE_WINOGRAD_WITH_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_WINOGRAD_WITH_AVX2
+
+// 16 tiles at a time in two registers, the zeros of the matrix are skipped.
+static void Avx2MatMul(const float* mat,
+                       int rows,
+                       int cols,
+                       const float* x,
+                       int ldx,
+                       float* y,
+                       int ldy,
+                       int n) {
+  for (int r = 0; r < rows; ++r) {
+    const float* m = mat + r * cols;
+    float* yr = y + r * ldy;
+    int l = 0;
+    for (; l + 16 <= n; l += 16) {
+      __m256 acc0 = _mm256_setzero_ps();
+      __m256 acc1 = _mm256_setzero_ps();
+      for (int i = 0; i < cols; ++i) {
+        if (m[i] == 0.f) continue;
+        const __m256 w = _mm256_set1_ps(m[i]);
+        const float* xi = x + i * ldx + l;
+        acc0 = _mm256_fmadd_ps(w, _mm256_loadu_ps(xi), acc0);
+        acc1 = _mm256_fmadd_ps(w, _mm256_loadu_ps(xi + 8), acc1);
+      }
+      _mm256_storeu_ps(yr + l, acc0);
+      _mm256_storeu_ps(yr + l + 8, acc1);
+    }
+    for (; l + 8 <= n; l += 8) {
+      __m256 acc = _mm256_setzero_ps();
+      for (int i = 0; i < cols; ++i) {
+        if (m[i] == 0.f) continue;
+        acc = _mm256_fmadd_ps(
+            _mm256_set1_ps(m[i]), _mm256_loadu_ps(x + i * ldx + l), acc);
+      }
+      _mm256_storeu_ps(yr + l, acc);
+    }
+    for (; l < n; ++l) {
+      float acc = 0.f;
+      for (int i = 0; i < cols; ++i) {
+        acc += m[i] * x[i * ldx + l];
+      }
+      yr[l] = acc;
+    }
+  }
+}
+
+WinogradMatMul WinogradAvx2MatMul() { return Avx2MatMul; }
+
+#else
+
+WinogradMatMul WinogradAvx2MatMul() { return nullptr; }
+
+#endif  // LITE_WINOGRAD_WITH_AVX2
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,67 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_winograd_kernel.h"
+
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef __AVX512F__
+
+// 16 tiles at a time, the last ones under a mask.
+static void Avx512MatMul(const float* mat,
+                         int rows,
+                         int cols,
+                         const float* x,
+                         int ldx,
+                         float* y,
+                         int ldy,
+                         int n) {
+  for (int r = 0; r < rows; ++r) {
+    const float* m = mat + r * cols;
+    float* yr = y + r * ldy;
+    for (int l = 0; l < n; l += 16) {
+      const __mmask16 mask =
+          n - l >= 16 ? static_cast<__mmask16>(0xffff)
+                      : static_cast<__mmask16>((1u << (n - l)) - 1);
+      __m512 acc = _mm512_setzero_ps();
+      for (int i = 0; i < cols; ++i) {
+        if (m[i] == 0.f) continue;
+        acc = _mm512_fmadd_ps(_mm512_set1_ps(m[i]),
+                              _mm512_maskz_loadu_ps(mask, x + i * ldx + l),
+                              acc);
+      }
+      _mm512_mask_storeu_ps(yr + l, mask, acc);
+    }
+  }
+}
+
+WinogradMatMul WinogradAvx512MatMul() { return Avx512MatMul; }
+
+#else
+
+WinogradMatMul WinogradAvx512MatMul() { return nullptr; }
+
+#endif  // __AVX512F__
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
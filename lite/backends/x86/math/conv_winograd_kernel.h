@@ -0,0 +1,47 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// The transform kernels of conv_winograd.cc, built like the micro-kernels of
+// sgemm in one translation unit per ISA.
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * y[r * ldy + l] = sum_i mat[r * cols + i] * x[i * ldx + l] for r < rows and
+ * l < n. Both passes of a winograd transform are such a product of a small
+ * matrix by rows of many tiles side by side.
+ */
+typedef void (*WinogradMatMul)(const float* mat,
+                               int rows,
+                               int cols,
+                               const float* x,
+                               int ldx,
+                               float* y,
+                               int ldy,
+                               int n);
+
+WinogradMatMul WinogradGenericMatMul();
+// nullptr if the translation unit is built without the ISA.
+WinogradMatMul WinogradAvx2MatMul();
+WinogradMatMul WinogradAvx512MatMul();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
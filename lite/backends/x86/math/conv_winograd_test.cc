@@ -0,0 +1,162 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_winograd.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/conv_winograd_kernel.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+static void conv3x3_ref(const float* in,
+                        const float* filter,
+                        const float* bias,
+                        bool relu,
+                        int ic,
+                        int oc,
+                        int ih,
+                        int iw,
+                        int pad,
+                        float* out) {
+  const int oh = ih + 2 * pad - 2, ow = iw + 2 * pad - 2;
+  for (int k = 0; k < oc; ++k) {
+    for (int y = 0; y < oh; ++y) {
+      for (int x = 0; x < ow; ++x) {
+        double sum = bias ? bias[k] : 0.f;
+        for (int c = 0; c < ic; ++c) {
+          for (int i = 0; i < 3; ++i) {
+            const int yy = y - pad + i;
+            if (yy < 0 || yy >= ih) continue;
+            for (int j = 0; j < 3; ++j) {
+              const int xx = x - pad + j;
+              if (xx < 0 || xx >= iw) continue;
+              sum += static_cast<double>(in[(c * ih + yy) * iw + xx]) *
+                     filter[((k * ic + c) * 3 + i) * 3 + j];
+            }
+          }
+        }
+        const float v = static_cast<float>(sum);
+        out[(k * oh + y) * ow + x] = relu ? std::max(v, 0.f) : v;
+      }
+    }
+  }
+}
+
+static std::vector<float> random_vector(size_t n, std::mt19937* rng) {
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> v(n);
+  for (auto& x : v) x = dist(*rng);
+  return v;
+}
+
+TEST(conv_winograd_x86, compare_with_ref) {
+  struct Case {
+    int ih, iw, pad;
+    bool bias, relu;
+  };
+  std::vector<Case> cases{{9, 11, 1, true, false},
+                          {16, 16, 1, false, true},
+                          {7, 5, 0, true, true},
+                          {13, 17, 2, false, false},
+                          {3, 3, 1, true, false}};
+  const int ic = 5, oc = 7;
+  std::mt19937 rng(19);
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  auto& context = ctx->As<X86Context>();
+  auto filter = random_vector(oc * ic * 9, &rng);
+  auto bias = random_vector(oc, &rng);
+  for (int tile : {4, 6}) {
+    WinogradConv3x3 conv(tile, filter.data(), oc, ic);
+    // One engine for every shape, the buffers follow it.
+    for (auto& c : cases) {
+      const int oh = c.ih + 2 * c.pad - 2, ow = c.iw + 2 * c.pad - 2;
+      auto in = random_vector(ic * c.ih * c.iw, &rng);
+      std::vector<float> out(oc * oh * ow), ref(oc * oh * ow);
+      SgemmEpilogue epilogue;
+      epilogue.bias = c.bias ? bias.data() : nullptr;
+      epilogue.act = c.relu ? lite_api::ActivationType::kRelu
+                            : lite_api::ActivationType::kIndentity;
+      conv.Run(context,
+               in.data(),
+               c.ih,
+               c.iw,
+               c.pad,
+               c.pad,
+               out.data(),
+               oh,
+               ow,
+               &epilogue);
+      conv3x3_ref(in.data(),
+                  filter.data(),
+                  epilogue.bias,
+                  c.relu,
+                  ic,
+                  oc,
+                  c.ih,
+                  c.iw,
+                  c.pad,
+                  ref.data());
+      for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], ref[i], 1e-4f * (1.f + std::fabs(ref[i])))
+            << "tile " << tile << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(conv_winograd_x86, pick_tile) {
+  // Few tiles of 6 are wasted on a large output.
+  EXPECT_EQ(WinogradConv3x3::PickTile(56, 56), 6);
+  EXPECT_EQ(WinogradConv3x3::PickTile(8, 8), 4);
+  EXPECT_EQ(WinogradConv3x3::PickTile(14, 14), 4);
+}
+
+TEST(conv_winograd_x86, transform_isa) {
+  std::mt19937 rng(7);
+  const int rows = 6, cols = 8, n = 37, ldx = 40, ldy = 41;
+  auto mat = random_vector(rows * cols, &rng);
+  mat[3] = 0.f;
+  auto x = random_vector(cols * ldx, &rng);
+  std::vector<float> ref(rows * ldy), y(rows * ldy);
+  WinogradGenericMatMul()(
+      mat.data(), rows, cols, x.data(), ldx, ref.data(), ldy, n);
+  std::vector<WinogradMatMul> kernels;
+  if (MayIUse(avx2) && WinogradAvx2MatMul()) {
+    kernels.push_back(WinogradAvx2MatMul());
+  }
+  if (MayIUse(avx512f) && WinogradAvx512MatMul()) {
+    kernels.push_back(WinogradAvx512MatMul());
+  }
+  for (auto matmul : kernels) {
+    matmul(mat.data(), rows, cols, x.data(), ldx, y.data(), ldy, n);
+    for (int r = 0; r < rows; ++r) {
+      for (int l = 0; l < n; ++l) {
+        EXPECT_NEAR(y[r * ldy + l], ref[r * ldy + l], 1e-5);
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/x86/math/im2col.h"
+#include <algorithm>
 #include <vector>
 #include "lite/backends/x86/math/im2col_cfo_cpu.h"
 #include "lite/utils/paddle_enforce.h"
@@ -97,23 +98,36 @@ class Col2ImFunctor<lite::x86::math::ColFormat::kCFO,
                       "Output_height and padding(padding_up, padding_down) are "
                       "inconsistent.");
 
-    int channels_col = im_channels * filter_height * filter_width;
+    int filter_size = filter_height * filter_width;
 
     T* im_data = im->mutable_data<T>();
     const T* col_data = col.data<T>();
 
-    for (int c = 0; c < channels_col; ++c) {
-      int w_offset = c % filter_width;
-      int h_offset = (c / filter_width) % filter_height;
-      int c_im = c / (filter_width * filter_height);
-      for (int h = 0; h < col_height; ++h) {
-        int im_row_idx = h * stride[0] - padding[0] + h_offset * dilation[0];
-        for (int w = 0; w < col_width; ++w) {
-          int im_col_idx = w * stride[1] - padding[1] + w_offset * dilation[1];
-          if ((im_row_idx) >= 0 && (im_row_idx) < im_height &&
-              (im_col_idx) >= 0 && (im_col_idx) < im_width) {
-            im_data[(im_row_idx + c_im * im_height) * im_width + im_col_idx] +=
-                col_data[(c * col_height + h) * col_width + w];
+    // The channels of the image are added up independently. The columns of a
+    // filter offset which land inside the width of the image are
+    // [w_begin, w_end), so the rows are added up without a check.
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int c_im = 0; c_im < im_channels; ++c_im) {
+      T* im_channel = im_data + c_im * im_height * im_width;
+      for (int k = 0; k < filter_size; ++k) {
+        int c = c_im * filter_size + k;
+        int w_offset = k % filter_width;
+        int h_offset = k / filter_width;
+        int w_shift = w_offset * dilation[1] - padding[1];
+        int w_begin = w_shift >= 0 ? 0 : (-w_shift + stride[1] - 1) / stride[1];
+        int w_end = im_width - 1 - w_shift < 0
+                        ? 0
+                        : std::min((im_width - 1 - w_shift) / stride[1] + 1,
+                                   col_width);
+        for (int h = 0; h < col_height; ++h) {
+          int im_row_idx = h * stride[0] - padding[0] + h_offset * dilation[0];
+          if (im_row_idx < 0 || im_row_idx >= im_height) continue;
+          T* im_row = im_channel + im_row_idx * im_width;
+          const T* col_row = col_data + (c * col_height + h) * col_width;
+          for (int w = w_begin; w < w_end; ++w) {
+            im_row[w * stride[1] + w_shift] += col_row[w];
           }
         }
       }
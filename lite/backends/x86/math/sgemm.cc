@@ -0,0 +1,495 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/sgemm_kernel.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// A block of A is kMC x kKC and stays in L2, a panel of B is kKC x kNC and
+// stays in L3. kMC and kNC are multiples of every mr and nr.
+constexpr int kMC = 144;
+constexpr int kKC = 256;
+constexpr int kNC = 2048;
+// The largest mr * nr of the micro-kernels.
+constexpr int kMaxTile = 12 * 32;
+// Smaller products are not worth waking the threads up for.
+constexpr double kParallelThreshold = 64. * 64. * 64.;
+
+void GenericKernel4x8(int kc,
+                      const float* a,
+                      const float* b,
+                      float* c,
+                      int ldc,
+                      bool overwrite) {
+  float acc[4][8] = {{0.f}};
+  for (int p = 0; p < kc; ++p) {
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 8; ++j) {
+        acc[i][j] += a[i] * b[j];
+      }
+    }
+    a += 4;
+    b += 8;
+  }
+  for (int i = 0; i < 4; ++i) {
+    float* ci = c + i * ldc;
+    for (int j = 0; j < 8; ++j) {
+      ci[j] = overwrite ? acc[i][j] : ci[j] + acc[i][j];
+    }
+  }
+}
+
+const SgemmKernel* DefaultKernel() {
+  if (MayIUse(avx512f) && SgemmAvx512Kernel()) {
+    return SgemmAvx512Kernel();
+  }
+  if (MayIUse(avx2) && SgemmAvx2Kernel()) {
+    return SgemmAvx2Kernel();
+  }
+  return SgemmGenericKernel();
+}
+
+std::atomic<const SgemmKernel*>& CurrentKernel() {
+  static std::atomic<const SgemmKernel*> kernel(DefaultKernel());
+  return kernel;
+}
+
+int NumThreads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+inline int DivUp(int a, int b) { return (a + b - 1) / b; }
+
+// Pack alpha * op(A)[0:mc, 0:kc] into slivers of mr rows, the last one padded
+// with zeros. `A` points at the first element of the block.
+void PackA(bool trans,
+           const float* A,
+           int lda,
+           int mc,
+           int kc,
+           float alpha,
+           int mr,
+           float* dst) {
+  for (int i0 = 0; i0 < mc; i0 += mr) {
+    int m = std::min(mr, mc - i0);
+    if (!trans) {
+      for (int i = 0; i < m; ++i) {
+        const float* src = A + static_cast<int64_t>(i0 + i) * lda;
+        for (int p = 0; p < kc; ++p) {
+          dst[p * mr + i] = alpha * src[p];
+        }
+      }
+    } else {
+      for (int p = 0; p < kc; ++p) {
+        const float* src = A + static_cast<int64_t>(p) * lda + i0;
+        for (int i = 0; i < m; ++i) {
+          dst[p * mr + i] = alpha * src[i];
+        }
+      }
+    }
+    if (m < mr) {
+      for (int p = 0; p < kc; ++p) {
+        std::fill(dst + p * mr + m, dst + (p + 1) * mr, 0.f);
+      }
+    }
+    dst += mr * kc;
+  }
+}
+
+// Pack the sliver op(B)[0:kc, j0:j0 + nr] of an nc wide panel, padded with
+// zeros past nc. `B` points at the first element of the panel.
+void PackBSliver(bool trans,
+                 const float* B,
+                 int ldb,
+                 int kc,
+                 int nc,
+                 int j0,
+                 int nr,
+                 float* dst) {
+  int n = std::min(nr, nc - j0);
+  for (int p = 0; p < kc; ++p) {
+    float* d = dst + p * nr;
+    if (!trans) {
+      std::memcpy(
+          d, B + static_cast<int64_t>(p) * ldb + j0, n * sizeof(float));
+    } else {
+      for (int j = 0; j < n; ++j) {
+        d[j] = B[static_cast<int64_t>(j0 + j) * ldb + p];
+      }
+    }
+    std::fill(d + n, d + nr, 0.f);
+  }
+}
+
+void PackB(bool trans,
+           const float* B,
+           int ldb,
+           int kc,
+           int nc,
+           int nr,
+           float* dst,
+           bool parallel) {
+  int slivers = DivUp(nc, nr);
+#ifdef _OPENMP
+#pragma omp parallel for if (parallel)
+#endif
+  for (int s = 0; s < slivers; ++s) {
+    PackBSliver(trans, B, ldb, kc, nc, s * nr, nr, dst + s * kc * nr);
+  }
+}
+
+// Multiply a packed mc x kc block of A with a packed kc x nc panel of B into
+// C, tile by tile. The partial tiles at the edges go through a buffer.
+void MacroKernel(const SgemmKernel& ker,
+                 int mc,
+                 int nc,
+                 int kc,
+                 const float* pa,
+                 const float* pb,
+                 float* C,
+                 int ldc,
+                 bool overwrite) {
+  const int mr = ker.mr;
+  const int nr = ker.nr;
+  float tile[kMaxTile];
+  for (int j = 0; j < nc; j += nr) {
+    int n = std::min(nr, nc - j);
+    const float* b = pb + j * kc;
+    for (int i = 0; i < mc; i += mr) {
+      int m = std::min(mr, mc - i);
+      const float* a = pa + i * kc;
+      float* c = C + static_cast<int64_t>(i) * ldc + j;
+      if (m == mr && n == nr) {
+        ker.compute(kc, a, b, c, ldc, overwrite);
+        continue;
+      }
+      ker.compute(kc, a, b, tile, nr, true);
+      for (int ii = 0; ii < m; ++ii) {
+        float* ci = c + static_cast<int64_t>(ii) * ldc;
+        const float* ti = tile + ii * nr;
+        for (int jj = 0; jj < n; ++jj) {
+          ci[jj] = overwrite ? ti[jj] : ci[jj] + ti[jj];
+        }
+      }
+    }
+  }
+}
+
+void CheckEpilogue(const SgemmEpilogue* ep) {
+  if (!ep) return;
+  switch (ep->act) {
+    case lite_api::ActivationType::kIndentity:
+    case lite_api::ActivationType::kRelu:
+    case lite_api::ActivationType::kRelu6:
+    case lite_api::ActivationType::kLeakyRelu:
+      break;
+    default:
+      LOG(FATAL) << "sgemm epilogue does not support activation "
+                 << static_cast<int>(ep->act);
+  }
+}
+
+// Apply the epilogue to C[r0:r1, c0:c1].
+void ApplyEpilogue(const SgemmEpilogue& ep,
+                   float* C,
+                   int ldc,
+                   int r0,
+                   int r1,
+                   int c0,
+                   int c1) {
+  for (int i = r0; i < r1; ++i) {
+    float* row = C + static_cast<int64_t>(i) * ldc;
+    if (ep.bias && ep.bias_per_row) {
+      float b = ep.bias[i];
+      for (int j = c0; j < c1; ++j) row[j] += b;
+    } else if (ep.bias) {
+      for (int j = c0; j < c1; ++j) row[j] += ep.bias[j];
+    }
+    switch (ep.act) {
+      case lite_api::ActivationType::kRelu:
+        for (int j = c0; j < c1; ++j) row[j] = std::max(row[j], 0.f);
+        break;
+      case lite_api::ActivationType::kRelu6:
+        for (int j = c0; j < c1; ++j) {
+          row[j] = std::min(std::max(row[j], 0.f), 6.f);
+        }
+        break;
+      case lite_api::ActivationType::kLeakyRelu:
+        for (int j = c0; j < c1; ++j) {
+          row[j] = row[j] > 0.f ? row[j] : row[j] * ep.leaky_alpha;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// C = beta * C, with beta = 0 clearing C even if it holds NaNs.
+void ScaleC(int M, int N, float beta, float* C, int ldc) {
+  for (int i = 0; i < M; ++i) {
+    float* row = C + static_cast<int64_t>(i) * ldc;
+    if (beta == 0.f) {
+      std::fill(row, row + N, 0.f);
+    } else {
+      for (int j = 0; j < N; ++j) row[j] *= beta;
+    }
+  }
+}
+
+// Where the panels of B come from, either B itself or a SgemmPackedB.
+struct BSource {
+  bool trans;
+  const float* data;
+  int ld;
+  const SgemmPackedB* packed;
+};
+
+void Gemm(const SgemmKernel& ker,
+          bool trans_a,
+          int M,
+          int N,
+          int K,
+          float alpha,
+          const float* A,
+          int lda,
+          const BSource& b,
+          float beta,
+          float* C,
+          int ldc,
+          const SgemmEpilogue* ep) {
+  CHECK_GE(M, 0);
+  CHECK_GE(N, 0);
+  CHECK_GE(K, 0);
+  CheckEpilogue(ep);
+  if (M == 0 || N == 0) return;
+  if (K == 0 || alpha == 0.f) {
+    if (beta != 1.f) ScaleC(M, N, beta, C, ldc);
+    if (ep) ApplyEpilogue(*ep, C, ldc, 0, M, 0, N);
+    return;
+  }
+  // The first panel of K stores into C when beta is 0, otherwise C is scaled
+  // up front and every panel accumulates.
+  if (beta != 0.f && beta != 1.f) {
+    ScaleC(M, N, beta, C, ldc);
+    beta = 1.f;
+  }
+
+  const int nr = ker.nr;
+  const int threads = NumThreads();
+  const bool parallel = threads > 1 && static_cast<double>(M) * N * K >=
+                                           kParallelThreshold;
+  const int m_blocks = DivUp(M, kMC);
+  std::vector<float> packed_b;
+  if (!b.packed) {
+    packed_b.resize(static_cast<size_t>(kKC) * DivUp(std::min(N, kNC), nr) *
+                    nr);
+  }
+
+  for (int jc = 0; jc < N; jc += kNC) {
+    const int nc = std::min(kNC, N - jc);
+    // With few blocks of A, also split the panel of B across the threads.
+    const int slivers = DivUp(nc, nr);
+    int n_chunks = parallel ? DivUp(threads, m_blocks) : 1;
+    n_chunks = std::max(1, std::min(n_chunks, slivers));
+    const int chunk_slivers = DivUp(slivers, n_chunks);
+    n_chunks = DivUp(slivers, chunk_slivers);
+
+    for (int pc = 0; pc < K; pc += kKC) {
+      const int kc = std::min(kKC, K - pc);
+      const float* pb = nullptr;
+      if (b.packed) {
+        pb = b.packed->panel(pc, jc, kc);
+      } else {
+        const float* src =
+            b.trans ? b.data + static_cast<int64_t>(jc) * b.ld + pc
+                    : b.data + static_cast<int64_t>(pc) * b.ld + jc;
+        PackB(b.trans, src, b.ld, kc, nc, nr, packed_b.data(), parallel);
+        pb = packed_b.data();
+      }
+      const bool overwrite = pc == 0 && beta == 0.f;
+      const bool last = pc + kc == K;
+      const int items = m_blocks * n_chunks;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+      for (int t = 0; t < items; ++t) {
+        thread_local std::vector<float> packed_a;
+        packed_a.resize(kMC * kKC);
+        const int ic = (t / n_chunks) * kMC;
+        const int mc = std::min(kMC, M - ic);
+        const int j0 = (t % n_chunks) * chunk_slivers * nr;
+        const int j1 = std::min(nc, j0 + chunk_slivers * nr);
+        const float* src = trans_a
+                               ? A + static_cast<int64_t>(pc) * lda + ic
+                               : A + static_cast<int64_t>(ic) * lda + pc;
+        PackA(trans_a, src, lda, mc, kc, alpha, ker.mr, packed_a.data());
+        MacroKernel(ker,
+                    mc,
+                    j1 - j0,
+                    kc,
+                    packed_a.data(),
+                    pb + j0 * kc,
+                    C + static_cast<int64_t>(ic) * ldc + jc + j0,
+                    ldc,
+                    overwrite);
+        if (last && ep) {
+          ApplyEpilogue(*ep, C, ldc, ic, ic + mc, jc + j0, jc + j1);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+const SgemmKernel* SgemmGenericKernel() {
+  static const SgemmKernel kernel = {4, 8, GenericKernel4x8};
+  return &kernel;
+}
+
+void Sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc,
+           const SgemmEpilogue* epilogue) {
+  BSource b{trans_b, B, ldb, nullptr};
+  Gemm(*CurrentKernel().load(),
+       trans_a,
+       M,
+       N,
+       K,
+       alpha,
+       A,
+       lda,
+       b,
+       beta,
+       C,
+       ldc,
+       epilogue);
+}
+
+SgemmPackedB::SgemmPackedB(bool trans_b, int K, int N, const float* B, int ldb)
+    : K_(K), N_(N), nr_(CurrentKernel().load()->nr) {
+  CHECK_GE(K, 0);
+  CHECK_GE(N, 0);
+  n_padded_ = DivUp(N, nr_) * nr_;
+  data_.resize(static_cast<size_t>(K) * n_padded_);
+  // Every panel of kKC rows is laid out as the driver packs it on the fly,
+  // kc x nr slivers one after another.
+  for (int pc = 0; pc < K; pc += kKC) {
+    int kc = std::min(kKC, K - pc);
+    const float* src = trans_b ? B + pc : B + static_cast<int64_t>(pc) * ldb;
+    PackB(trans_b,
+          src,
+          ldb,
+          kc,
+          N,
+          nr_,
+          data_.data() + static_cast<size_t>(pc) * n_padded_,
+          true);
+  }
+}
+
+const float* SgemmPackedB::panel(int k, int n, int kc) const {
+  return data_.data() + static_cast<size_t>(k) * n_padded_ +
+         static_cast<size_t>(n) * kc;
+}
+
+void SgemmPacked(bool trans_a,
+                 int M,
+                 float alpha,
+                 const float* A,
+                 int lda,
+                 const SgemmPackedB& B,
+                 float beta,
+                 float* C,
+                 int ldc,
+                 const SgemmEpilogue* epilogue) {
+  const SgemmKernel* ker = CurrentKernel().load();
+  CHECK_EQ(ker->nr, B.nr()) << "B is packed for another micro-kernel";
+  BSource b{false, nullptr, 0, &B};
+  Gemm(*ker,
+       trans_a,
+       M,
+       B.N(),
+       B.K(),
+       alpha,
+       A,
+       lda,
+       b,
+       beta,
+       C,
+       ldc,
+       epilogue);
+}
+
+SgemmIsa GetSgemmIsa() {
+  const SgemmKernel* ker = CurrentKernel().load();
+  if (ker == SgemmAvx512Kernel()) return SgemmIsa::kAvx512;
+  if (ker == SgemmAvx2Kernel()) return SgemmIsa::kAvx2;
+  return SgemmIsa::kGeneric;
+}
+
+bool SetSgemmIsa(SgemmIsa isa) {
+  const SgemmKernel* ker = nullptr;
+  switch (isa) {
+    case SgemmIsa::kGeneric:
+      ker = SgemmGenericKernel();
+      break;
+    case SgemmIsa::kAvx2:
+      ker = MayIUse(avx2) ? SgemmAvx2Kernel() : nullptr;
+      break;
+    case SgemmIsa::kAvx512:
+      ker = MayIUse(avx512f) ? SgemmAvx512Kernel() : nullptr;
+      break;
+  }
+  if (!ker) return false;
+  CurrentKernel().store(ker);
+  return true;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/*
+ * An in-tree single precision GEMM for x86, so that a build without MKL does
+ * not depend on an external BLAS. It follows the usual BLIS layout: B is
+ * packed into panels of KC x NC, A into blocks of MC x KC, and a register
+ * blocked micro-kernel computes an MR x NR tile of C from them. The
+ * micro-kernel is picked at runtime, AVX-512, AVX2/FMA or a portable one.
+ */
+
+#include <vector>
+#include "lite/api/paddle_place.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Applied to a tile of C right after its last update, while it is in cache.
+struct SgemmEpilogue {
+  // One value per column of C, or per row with `bias_per_row`.
+  const float* bias{nullptr};
+  bool bias_per_row{false};
+  // kIndentity, kRelu, kRelu6 or kLeakyRelu.
+  lite_api::ActivationType act{lite_api::ActivationType::kIndentity};
+  float leaky_alpha{0.f};
+};
+
+// C = alpha * op(A) * op(B) + beta * C, all matrices row-major, followed by
+// the epilogue if there is one. op(A) is M x K and op(B) is K x N.
+void Sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc,
+           const SgemmEpilogue* epilogue = nullptr);
+
+/*
+ * op(B) packed once in the layout of the micro-kernel, for a weight that is
+ * multiplied many times, e.g. by fc or conv. The packing is tied to the
+ * micro-kernel in use when it is made.
+ */
+class SgemmPackedB {
+ public:
+  SgemmPackedB(bool trans_b, int K, int N, const float* B, int ldb);
+
+  int K() const { return K_; }
+  int N() const { return N_; }
+  int nr() const { return nr_; }
+  // The panel of rows [k, k + kc), starting at column `n`.
+  const float* panel(int k, int n, int kc) const;
+
+ private:
+  int K_;
+  int N_;
+  int nr_;
+  int n_padded_;
+  std::vector<float> data_;
+};
+
+// C = alpha * op(A) * B + beta * C with a prepacked B.
+void SgemmPacked(bool trans_a,
+                 int M,
+                 float alpha,
+                 const float* A,
+                 int lda,
+                 const SgemmPackedB& B,
+                 float beta,
+                 float* C,
+                 int ldc,
+                 const SgemmEpilogue* epilogue = nullptr);
+
+enum class SgemmIsa { kGeneric = 0, kAvx2, kAvx512 };
+
+// The micro-kernel in use, the widest one the CPU supports by default.
+SgemmIsa GetSgemmIsa();
+// Switch the micro-kernel, for tests and benchmarks. Return false if it is
+// not built in or not supported by the CPU.
+bool SetSgemmIsa(SgemmIsa isa);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm_kernel.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define LITE_SGEMM_WITH_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_SGEMM_WITH_AVX2
+
+// 6 x 16: 12 accumulators, 2 registers of B and one broadcast of A.
+static void Avx2Kernel6x16(int kc,
+                           const float* a,
+                           const float* b,
+                           float* c,
+                           int ldc,
+                           bool overwrite) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+#define LITE_SGEMM_AVX2_ROW(i)                  \
+  {                                             \
+    __m256 ai = _mm256_broadcast_ss(a + i);     \
+    c##i##0 = _mm256_fmadd_ps(ai, b0, c##i##0); \
+    c##i##1 = _mm256_fmadd_ps(ai, b1, c##i##1); \
+  }
+
+  for (int p = 0; p < kc; ++p) {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    LITE_SGEMM_AVX2_ROW(0)
+    LITE_SGEMM_AVX2_ROW(1)
+    LITE_SGEMM_AVX2_ROW(2)
+    LITE_SGEMM_AVX2_ROW(3)
+    LITE_SGEMM_AVX2_ROW(4)
+    LITE_SGEMM_AVX2_ROW(5)
+    a += 6;
+    b += 16;
+  }
+#undef LITE_SGEMM_AVX2_ROW
+
+#define LITE_SGEMM_AVX2_STORE(i)                                 \
+  {                                                              \
+    float* ci = c + i * ldc;                                     \
+    if (!overwrite) {                                            \
+      c##i##0 = _mm256_add_ps(c##i##0, _mm256_loadu_ps(ci));     \
+      c##i##1 = _mm256_add_ps(c##i##1, _mm256_loadu_ps(ci + 8)); \
+    }                                                            \
+    _mm256_storeu_ps(ci, c##i##0);                               \
+    _mm256_storeu_ps(ci + 8, c##i##1);                           \
+  }
+
+  LITE_SGEMM_AVX2_STORE(0)
+  LITE_SGEMM_AVX2_STORE(1)
+  LITE_SGEMM_AVX2_STORE(2)
+  LITE_SGEMM_AVX2_STORE(3)
+  LITE_SGEMM_AVX2_STORE(4)
+  LITE_SGEMM_AVX2_STORE(5)
+#undef LITE_SGEMM_AVX2_STORE
+}
+
+const SgemmKernel* SgemmAvx2Kernel() {
+  static const SgemmKernel kernel = {6, 16, Avx2Kernel6x16};
+  return &kernel;
+}
+
+#else
+
+const SgemmKernel* SgemmAvx2Kernel() { return nullptr; }
+
+#endif  // LITE_SGEMM_WITH_AVX2
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
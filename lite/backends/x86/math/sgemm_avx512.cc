@@ -0,0 +1,115 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm_kernel.h"
+
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef __AVX512F__
+
+// 12 x 32: 24 accumulators, 2 registers of B and one broadcast of A.
+static void Avx512Kernel12x32(int kc,
+                              const float* a,
+                              const float* b,
+                              float* c,
+                              int ldc,
+                              bool overwrite) {
+  __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+  __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+  __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+  __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+  __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+  __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+  __m512 c60 = _mm512_setzero_ps(), c61 = _mm512_setzero_ps();
+  __m512 c70 = _mm512_setzero_ps(), c71 = _mm512_setzero_ps();
+  __m512 c80 = _mm512_setzero_ps(), c81 = _mm512_setzero_ps();
+  __m512 c90 = _mm512_setzero_ps(), c91 = _mm512_setzero_ps();
+  __m512 c100 = _mm512_setzero_ps(), c101 = _mm512_setzero_ps();
+  __m512 c110 = _mm512_setzero_ps(), c111 = _mm512_setzero_ps();
+
+#define LITE_SGEMM_AVX512_ROW(i)                \
+  {                                             \
+    __m512 ai = _mm512_set1_ps(a[i]);           \
+    c##i##0 = _mm512_fmadd_ps(ai, b0, c##i##0); \
+    c##i##1 = _mm512_fmadd_ps(ai, b1, c##i##1); \
+  }
+
+  for (int p = 0; p < kc; ++p) {
+    __m512 b0 = _mm512_loadu_ps(b);
+    __m512 b1 = _mm512_loadu_ps(b + 16);
+    LITE_SGEMM_AVX512_ROW(0)
+    LITE_SGEMM_AVX512_ROW(1)
+    LITE_SGEMM_AVX512_ROW(2)
+    LITE_SGEMM_AVX512_ROW(3)
+    LITE_SGEMM_AVX512_ROW(4)
+    LITE_SGEMM_AVX512_ROW(5)
+    LITE_SGEMM_AVX512_ROW(6)
+    LITE_SGEMM_AVX512_ROW(7)
+    LITE_SGEMM_AVX512_ROW(8)
+    LITE_SGEMM_AVX512_ROW(9)
+    LITE_SGEMM_AVX512_ROW(10)
+    LITE_SGEMM_AVX512_ROW(11)
+    a += 12;
+    b += 32;
+  }
+#undef LITE_SGEMM_AVX512_ROW
+
+#define LITE_SGEMM_AVX512_STORE(i)                                \
+  {                                                               \
+    float* ci = c + i * ldc;                                      \
+    if (!overwrite) {                                             \
+      c##i##0 = _mm512_add_ps(c##i##0, _mm512_loadu_ps(ci));      \
+      c##i##1 = _mm512_add_ps(c##i##1, _mm512_loadu_ps(ci + 16)); \
+    }                                                             \
+    _mm512_storeu_ps(ci, c##i##0);                                \
+    _mm512_storeu_ps(ci + 16, c##i##1);                           \
+  }
+
+  LITE_SGEMM_AVX512_STORE(0)
+  LITE_SGEMM_AVX512_STORE(1)
+  LITE_SGEMM_AVX512_STORE(2)
+  LITE_SGEMM_AVX512_STORE(3)
+  LITE_SGEMM_AVX512_STORE(4)
+  LITE_SGEMM_AVX512_STORE(5)
+  LITE_SGEMM_AVX512_STORE(6)
+  LITE_SGEMM_AVX512_STORE(7)
+  LITE_SGEMM_AVX512_STORE(8)
+  LITE_SGEMM_AVX512_STORE(9)
+  LITE_SGEMM_AVX512_STORE(10)
+  LITE_SGEMM_AVX512_STORE(11)
+#undef LITE_SGEMM_AVX512_STORE
+}
+
+const SgemmKernel* SgemmAvx512Kernel() {
+  static const SgemmKernel kernel = {12, 32, Avx512Kernel12x32};
+  return &kernel;
+}
+
+#else
+
+const SgemmKernel* SgemmAvx512Kernel() { return nullptr; }
+
+#endif  // __AVX512F__
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,52 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// The micro-kernels of sgemm.cc. The ISA specific ones are built in their own
+// translation units with the matching compiler flags, so they must not pull
+// in any header with inline functions that the rest of the library shares.
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * Compute an mr x nr tile of C from a packed sliver of A, laid out as
+ * a[p * mr + i], and a packed sliver of B, laid out as b[p * nr + j], both
+ * kc long. The product is stored into C with `overwrite`, otherwise added.
+ */
+typedef void (*SgemmMicroKernel)(int kc,
+                                 const float* a,
+                                 const float* b,
+                                 float* c,
+                                 int ldc,
+                                 bool overwrite);
+
+struct SgemmKernel {
+  int mr;
+  int nr;
+  SgemmMicroKernel compute;
+};
+
+const SgemmKernel* SgemmGenericKernel();
+// nullptr if the translation unit is built without the ISA.
+const SgemmKernel* SgemmAvx2Kernel();
+const SgemmKernel* SgemmAvx512Kernel();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
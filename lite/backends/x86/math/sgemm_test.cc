@@ -0,0 +1,271 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+void RefSgemm(bool trans_a,
+              bool trans_b,
+              int M,
+              int N,
+              int K,
+              float alpha,
+              const float* A,
+              int lda,
+              const float* B,
+              int ldb,
+              float beta,
+              float* C,
+              int ldc) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      double sum = 0;
+      for (int k = 0; k < K; ++k) {
+        float a = trans_a ? A[k * lda + i] : A[i * lda + k];
+        float b = trans_b ? B[j * ldb + k] : B[k * ldb + j];
+        sum += static_cast<double>(a) * b;
+      }
+      float c = beta == 0.f ? 0.f : beta * C[i * ldc + j];
+      C[i * ldc + j] = alpha * static_cast<float>(sum) + c;
+    }
+  }
+}
+
+std::vector<float> RandomVector(size_t n, std::mt19937* rng) {
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> v(n);
+  for (auto& x : v) x = dist(*rng);
+  return v;
+}
+
+void ExpectNear(const std::vector<float>& a,
+                const std::vector<float>& b,
+                int K) {
+  ASSERT_EQ(a.size(), b.size());
+  float tol = 1e-5f * std::max(K, 1) + 1e-5f;
+  for (size_t i = 0; i < a.size(); ++i) {
+    ASSERT_NEAR(a[i], b[i], tol) << "at " << i;
+  }
+}
+
+std::vector<SgemmIsa> SupportedIsas() {
+  std::vector<SgemmIsa> isas;
+  SgemmIsa origin = GetSgemmIsa();
+  for (auto isa : {SgemmIsa::kGeneric, SgemmIsa::kAvx2, SgemmIsa::kAvx512}) {
+    if (SetSgemmIsa(isa)) isas.push_back(isa);
+  }
+  SetSgemmIsa(origin);
+  return isas;
+}
+
+TEST(sgemm_x86, compare_with_reference) {
+  std::mt19937 rng(0);
+  const int shapes[][3] = {{1, 1, 1},
+                           {1, 100, 37},
+                           {37, 1, 50},
+                           {13, 17, 19},
+                           {64, 64, 64},
+                           {150, 70, 300},
+                           {7, 2100, 5},
+                           {200, 33, 513}};
+  SgemmIsa origin = GetSgemmIsa();
+  for (auto isa : SupportedIsas()) {
+    ASSERT_TRUE(SetSgemmIsa(isa));
+    for (auto& shape : shapes) {
+      int M = shape[0], N = shape[1], K = shape[2];
+      for (int t = 0; t < 4; ++t) {
+        bool trans_a = t & 1;
+        bool trans_b = t & 2;
+        // Leading dimensions larger than the matrices.
+        int lda = (trans_a ? M : K) + 3;
+        int ldb = (trans_b ? K : N) + 1;
+        int ldc = N + 2;
+        auto A = RandomVector((trans_a ? K : M) * lda, &rng);
+        auto B = RandomVector((trans_b ? N : K) * ldb, &rng);
+        for (float beta : {0.f, 1.f, 0.5f}) {
+          auto C = RandomVector(M * ldc, &rng);
+          auto expect = C;
+          if (beta == 0.f) std::fill(C.begin(), C.end(), NAN);
+          RefSgemm(trans_a,
+                   trans_b,
+                   M,
+                   N,
+                   K,
+                   1.5f,
+                   A.data(),
+                   lda,
+                   B.data(),
+                   ldb,
+                   beta,
+                   expect.data(),
+                   ldc);
+          Sgemm(trans_a,
+                trans_b,
+                M,
+                N,
+                K,
+                1.5f,
+                A.data(),
+                lda,
+                B.data(),
+                ldb,
+                beta,
+                C.data(),
+                ldc);
+          // Only the M x N part is written, the padding keeps the NaNs.
+          for (int i = 0; i < M; ++i) {
+            for (int j = N; j < ldc; ++j) {
+              if (beta == 0.f) {
+                EXPECT_TRUE(std::isnan(C[i * ldc + j]));
+              }
+              C[i * ldc + j] = expect[i * ldc + j];
+            }
+          }
+          ExpectNear(C, expect, K);
+        }
+      }
+    }
+  }
+  SetSgemmIsa(origin);
+}
+
+TEST(sgemm_x86, epilogue) {
+  std::mt19937 rng(1);
+  const int M = 30, N = 45, K = 70;
+  auto A = RandomVector(M * K, &rng);
+  auto B = RandomVector(K * N, &rng);
+  auto bias = RandomVector(std::max(M, N), &rng);
+  std::vector<float> ref(M * N);
+  RefSgemm(false,
+           false,
+           M,
+           N,
+           K,
+           1.f,
+           A.data(),
+           K,
+           B.data(),
+           N,
+           0.f,
+           ref.data(),
+           N);
+
+  SgemmEpilogue ep;
+  ep.bias = bias.data();
+  for (bool per_row : {false, true}) {
+    for (auto act : {lite_api::ActivationType::kIndentity,
+                     lite_api::ActivationType::kRelu,
+                     lite_api::ActivationType::kRelu6,
+                     lite_api::ActivationType::kLeakyRelu}) {
+      ep.bias_per_row = per_row;
+      ep.act = act;
+      ep.leaky_alpha = 0.1f;
+      std::vector<float> expect(M * N);
+      for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < N; ++j) {
+          float v = ref[i * N + j] + (per_row ? bias[i] : bias[j]);
+          switch (act) {
+            case lite_api::ActivationType::kRelu:
+              v = std::max(v, 0.f);
+              break;
+            case lite_api::ActivationType::kRelu6:
+              v = std::min(std::max(v, 0.f), 6.f);
+              break;
+            case lite_api::ActivationType::kLeakyRelu:
+              v = v > 0.f ? v : 0.1f * v;
+              break;
+            default:
+              break;
+          }
+          expect[i * N + j] = v;
+        }
+      }
+      std::vector<float> C(M * N);
+      Sgemm(false,
+            false,
+            M,
+            N,
+            K,
+            1.f,
+            A.data(),
+            K,
+            B.data(),
+            N,
+            0.f,
+            C.data(),
+            N,
+            &ep);
+      ExpectNear(C, expect, K);
+    }
+  }
+}
+
+TEST(sgemm_x86, packed_b) {
+  std::mt19937 rng(2);
+  SgemmIsa origin = GetSgemmIsa();
+  for (auto isa : SupportedIsas()) {
+    ASSERT_TRUE(SetSgemmIsa(isa));
+    for (bool trans_b : {false, true}) {
+      const int K = 600, N = 2200;
+      int ldb = trans_b ? K : N;
+      auto B = RandomVector(K * N, &rng);
+      SgemmPackedB packed(trans_b, K, N, B.data(), ldb);
+      ASSERT_EQ(packed.K(), K);
+      ASSERT_EQ(packed.N(), N);
+      // The same packed B multiplied by several A.
+      for (int M : {1, 9, 160}) {
+        auto A = RandomVector(M * K, &rng);
+        std::vector<float> expect(M * N), C(M * N);
+        RefSgemm(false,
+                 trans_b,
+                 M,
+                 N,
+                 K,
+                 1.f,
+                 A.data(),
+                 K,
+                 B.data(),
+                 ldb,
+                 0.f,
+                 expect.data(),
+                 N);
+        SgemmPacked(
+            false, M, 1.f, A.data(), K, packed, 0.f, C.data(), N, nullptr);
+        ExpectNear(C, expect, K);
+      }
+    }
+  }
+  SetSgemmIsa(origin);
+}
+
+TEST(sgemm_x86, zero_k) {
+  std::vector<float> C(6, 2.f);
+  Sgemm(
+      false, false, 2, 3, 0, 1.f, nullptr, 1, nullptr, 3, 0.5f, C.data(), 3);
+  for (float c : C) EXPECT_EQ(c, 1.f);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
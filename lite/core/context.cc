@@ -16,6 +16,9 @@
 
 #ifdef LITE_WITH_OPENCL
 DEFINE_string(cl_path, "/data/local/tmp/opencl", "The OpenCL kernels path.");
+DEFINE_string(cl_cache_dir,
+              "",
+              "The directory to cache the OpenCL program binaries.");
 #endif
 
 namespace paddle {
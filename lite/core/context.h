@@ -45,6 +45,7 @@
 
 #ifdef LITE_WITH_OPENCL
 DECLARE_string(cl_path);
+DECLARE_string(cl_cache_dir);
 #endif
 
 namespace paddle {
@@ -288,6 +289,7 @@ class Context<TargetType::kOpenCL> {
     // Init cl runtime.
     CHECK(CLRuntime::Global()->IsInitSuccess()) << "OpenCL runtime init failed";
     CLRuntime::Global()->set_cl_path(FLAGS_cl_path);
+    CLRuntime::Global()->set_cl_cache_dir(FLAGS_cl_cache_dir);
 
     cl_context_ = std::make_shared<CLContext>();
     cl_wait_list_ = std::make_shared<WaitListType>();
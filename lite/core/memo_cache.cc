@@ -0,0 +1,118 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/memo_cache.h"
+#include <cstring>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+bool IsHostTensor(const Tensor& x) {
+  return x.target() == TARGET(kHost) || x.target() == TARGET(kX86) ||
+         x.target() == TARGET(kARM);
+}
+
+// FNV-1a over the bytes, 8 bytes at a time.
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+  const uint64_t kPrime = 1099511628211ULL;
+  auto* bytes = static_cast<const char*>(data);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(bytes[i])) * kPrime;
+  }
+  return hash;
+}
+
+bool SameTensor(const Tensor& a, const Tensor& b) {
+  return a.dims() == b.dims() && a.lod() == b.lod() &&
+         a.precision() == b.precision() &&
+         a.memory_size() == b.memory_size() &&
+         memcmp(a.raw_data(), b.raw_data(), a.memory_size()) == 0;
+}
+
+}  // namespace
+
+uint64_t TensorMemoCache::Hash(const std::vector<const Tensor*>& tensors) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto* x : tensors) {
+    CHECK(IsHostTensor(*x)) << "only the host tensors can be memoized";
+    auto& dims = x->dims();
+    for (size_t i = 0; i < dims.size(); ++i) {
+      int64_t d = dims[i];
+      hash = HashBytes(&d, sizeof(d), hash);
+    }
+    for (auto& level : x->lod()) {
+      hash = HashBytes(level.data(), level.size() * sizeof(level[0]), hash);
+    }
+    int precision = static_cast<int>(x->precision());
+    hash = HashBytes(&precision, sizeof(precision), hash);
+    if (x->memory_size()) {
+      hash = HashBytes(x->raw_data(), x->memory_size(), hash);
+    }
+  }
+  return hash;
+}
+
+const std::vector<Tensor>* TensorMemoCache::Find(
+    uint64_t hash, const std::vector<const Tensor*>& inputs) {
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->hash != hash || it->inputs.size() != inputs.size()) continue;
+    bool same = true;
+    for (size_t i = 0; i < inputs.size() && same; ++i) {
+      same = SameTensor(it->inputs[i], *inputs[i]);
+    }
+    if (!same) continue;
+    entries_.splice(entries_.begin(), entries_, it);
+    return &entries_.front().outputs;
+  }
+  return nullptr;
+}
+
+void TensorMemoCache::Insert(uint64_t hash,
+                             std::vector<Tensor>&& inputs,
+                             std::vector<Tensor>&& outputs) {
+  if (entries_.size() == capacity_) {
+    entries_.pop_back();
+  }
+  entries_.emplace_front();
+  auto& entry = entries_.front();
+  entry.hash = hash;
+  entry.inputs = std::move(inputs);
+  entry.outputs = std::move(outputs);
+}
+
+void TensorMemoCache::Copy(const Tensor& src, Tensor* dst) {
+  CHECK(IsHostTensor(src)) << "only the host tensors can be memoized";
+  dst->CopyDataFrom(src);
+  dst->set_precision(src.precision());
+}
+
+std::vector<Tensor> TensorMemoCache::Snapshot(
+    const std::vector<const Tensor*>& x) {
+  std::vector<Tensor> res(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    Copy(*x[i], &res[i]);
+  }
+  return res;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,71 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#include <cstdint>
+#include <list>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * TensorMemoCache maps the content of a list of input tensors to the output
+ * tensors computed from them, keeping at most `capacity` entries in the least
+ * recently used order. The entries are found by a hash of the inputs, and
+ * checked against a copy of the inputs, so a hash collision never returns
+ * the outputs of other inputs.
+ *
+ * Only the tensors in the host memory are supported.
+ */
+class TensorMemoCache {
+ public:
+  explicit TensorMemoCache(size_t capacity) : capacity_(capacity) {
+    CHECK_GT(capacity_, 0UL);
+  }
+
+  // Hash the dims, lod, precision and data of the tensors.
+  static uint64_t Hash(const std::vector<const Tensor*>& tensors);
+
+  // Get the outputs cached for `inputs`, or null if there are none. The
+  // result is valid until the next `Insert`.
+  const std::vector<Tensor>* Find(uint64_t hash,
+                                  const std::vector<const Tensor*>& inputs);
+
+  // Cache the outputs of the inputs, both are copies taken with `Copy` or
+  // `Snapshot`, the tensors they come from might be changed since.
+  void Insert(uint64_t hash,
+              std::vector<Tensor>&& inputs,
+              std::vector<Tensor>&& outputs);
+
+  static void Copy(const Tensor& src, Tensor* dst);
+  static std::vector<Tensor> Snapshot(const std::vector<const Tensor*>& x);
+
+  size_t size() const { return entries_.size(); }
+  size_t capacity() const { return capacity_; }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    std::vector<Tensor> inputs;
+    std::vector<Tensor> outputs;
+  };
+
+  size_t capacity_;
+  // The most recently used entry goes first.
+  std::list<Entry> entries_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -13,17 +13,21 @@
 // limitations under the License.
 
 #include "lite/core/memory.h"
+#include <atomic>
+#include <cstring>
+#include "lite/backends/host/host_allocator.h"
 
 namespace paddle {
 namespace lite {
 
-void* TargetMalloc(TargetType target, size_t size) {
+void* TargetMalloc(TargetType target, size_t size, bool zero) {
   void* data{nullptr};
   switch (target) {
     case TargetType::kHost:
     case TargetType::kX86:
     case TargetType::kARM:
       data = TargetWrapper<TARGET(kHost)>::Malloc(size);
+      if (zero && data) memset(data, 0, size);
       break;
 #ifdef LITE_WITH_CUDA
     case TargetType::kCUDA:
@@ -46,6 +50,44 @@ void* TargetMalloc(TargetType target, size_t size) {
   return data;
 }
 
+size_t TargetAllocationSize(TargetType target, size_t size) {
+  switch (target) {
+    case TargetType::kHost:
+    case TargetType::kX86:
+    case TargetType::kARM:
+      return GetHostAllocator()->UsableSize(size);
+    default:
+      return size;
+  }
+}
+
+static std::atomic<int64_t> live_bytes[static_cast<int>(TARGET(NUM))];
+static std::atomic<int64_t> peak_bytes[static_cast<int>(TARGET(NUM))];
+
+MemoryStats GetMemoryStats(TargetType target) {
+  MemoryStats stats;
+  stats.live_bytes = live_bytes[static_cast<int>(target)].load();
+  stats.peak_bytes = peak_bytes[static_cast<int>(target)].load();
+  return stats;
+}
+
+void ResetPeakMemory(TargetType target) {
+  int i = static_cast<int>(target);
+  peak_bytes[i] = live_bytes[i].load();
+}
+
+void RecordBufferMalloc(TargetType target, size_t size) {
+  int i = static_cast<int>(target);
+  int64_t live = live_bytes[i] += static_cast<int64_t>(size);
+  int64_t peak = peak_bytes[i].load();
+  while (live > peak && !peak_bytes[i].compare_exchange_weak(peak, live)) {
+  }
+}
+
+void RecordBufferFree(TargetType target, size_t size) {
+  live_bytes[static_cast<int>(target)] -= static_cast<int64_t>(size);
+}
+
 void TargetFree(TargetType target, void* data) {
   switch (target) {
     case TargetType::kHost:
@@ -29,13 +29,33 @@ namespace paddle {
 namespace lite {
 
 // Malloc memory for a specific Target. All the targets should be an element in
-// the `switch` here.
-LITE_API void* TargetMalloc(TargetType target, size_t size);
+// the `switch` here. The memory is not zeroed, unless `zero` is set, which is
+// only supported by the host targets.
+LITE_API void* TargetMalloc(TargetType target,
+                            size_t size,
+                            bool zero = false);
 
 // Free memory for a specific Target. All the targets should be an element in
 // the `switch` here.
 void LITE_API TargetFree(TargetType target, void* data);
 
+// The bytes actually allocated by `TargetMalloc(target, size)`.
+size_t TargetAllocationSize(TargetType target, size_t size);
+
+// The bytes held by the buffers of a target, over all the predictors.
+struct MemoryStats {
+  int64_t live_bytes{0};
+  int64_t peak_bytes{0};
+};
+
+LITE_API MemoryStats GetMemoryStats(TargetType target);
+
+// Restart the peak of a target from its live bytes.
+LITE_API void ResetPeakMemory(TargetType target);
+
+void RecordBufferMalloc(TargetType target, size_t size);
+void RecordBufferFree(TargetType target, size_t size);
+
 // Copy a buffer from host to another target.
 void TargetCopy(TargetType target, void* dst, const void* src, size_t size);
 #ifdef LITE_WITH_OPENCL
@@ -85,12 +105,21 @@ class Buffer {
   TargetType target() const { return target_; }
   size_t space() const { return space_; }
 
+  // A read-only buffer may be shared by the tensors of several predictors,
+  // see WeightStore. The tensors copy it before writing.
+  bool read_only() const { return read_only_; }
+  void set_read_only(bool read_only) { read_only_ = read_only; }
+
   void ResetLazy(TargetType target, size_t size) {
     if (target != target_ || space_ < size) {
       Free();
+      // Take the slack of the allocator, so that the buffer grows in place
+      // up to it.
+      size = TargetAllocationSize(target, size);
       data_ = TargetMalloc(target, size);
       target_ = target;
       space_ = size;
+      RecordBufferMalloc(target_, space_);
     }
   }
 
@@ -109,6 +138,7 @@ class Buffer {
       data_ = TargetWrapperCL::MallocImage<T>(img_w, img_h);
       target_ = target;
       space_ = size;  // un-used for opencl Image2D
+      RecordBufferMalloc(target_, space_);
       cl_image2d_width_ = img_w;
       cl_image2d_height_ = img_h;
     }
@@ -118,14 +148,14 @@ class Buffer {
   void Free() {
     if (space_ > 0) {
       TargetFree(target_, data_);
+      RecordBufferFree(target_, space_);
     }
     target_ = TargetType::kHost;
     space_ = 0;
   }
 
   void CopyDataFrom(const Buffer& other, size_t nbytes) {
-    target_ = other.target_;
-    ResizeLazy(nbytes);
+    ResetLazy(other.target_, nbytes);
     // TODO(Superjomn) support copy between different targets.
     TargetCopy(target_, data_, other.data_, nbytes);
   }
@@ -139,6 +169,7 @@ class Buffer {
   size_t cl_image2d_height_{0};  // only used for OpenCL Image2D
   void* data_{nullptr};
   TargetType target_{TargetType::kHost};
+  bool read_only_{false};
 };
 
 }  // namespace lite
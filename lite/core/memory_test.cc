@@ -14,6 +14,9 @@
 
 #include "lite/core/memory.h"
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include "lite/backends/host/host_allocator.h"
 
 namespace paddle {
 namespace lite {
@@ -30,5 +33,101 @@ TEST(memory, test) {
 #endif
 }
 
+TEST(memory, zero) {
+  auto* buf = static_cast<char*>(TargetMalloc(TARGET(kHost), 100));
+  memset(buf, 1, 100);
+  TargetFree(TARGET(kHost), buf);
+  // The block is reused, it is zeroed on demand only.
+  buf = static_cast<char*>(TargetMalloc(TARGET(kHost), 100, true));
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(buf[i], 0);
+  }
+  TargetFree(TARGET(kHost), buf);
+}
+
+TEST(memory, buffer_stats) {
+  auto before = GetMemoryStats(TARGET(kX86));
+  {
+    Buffer buffer;
+    buffer.ResetLazy(TARGET(kX86), 1000);
+    // Rounded up to the size class.
+    EXPECT_EQ(buffer.space(), 1024UL);
+    auto stats = GetMemoryStats(TARGET(kX86));
+    EXPECT_EQ(stats.live_bytes, before.live_bytes + 1024);
+    EXPECT_GE(stats.peak_bytes, stats.live_bytes);
+    // It grows in place up to the size class.
+    void* data = buffer.data();
+    buffer.ResetLazy(TARGET(kX86), 1024);
+    EXPECT_EQ(buffer.data(), data);
+  }
+  EXPECT_EQ(GetMemoryStats(TARGET(kX86)).live_bytes, before.live_bytes);
+  ResetPeakMemory(TARGET(kX86));
+  EXPECT_EQ(GetMemoryStats(TARGET(kX86)).peak_bytes, before.live_bytes);
+}
+
+TEST(host_allocator, size_class) {
+  using A = CachingHostAllocator;
+  EXPECT_EQ(A::SizeClass(1), 0);
+  EXPECT_EQ(A::ClassSize(0), 64UL);
+  EXPECT_EQ(A::ClassSize(A::SizeClass(65)), 80UL);
+  EXPECT_EQ(A::ClassSize(A::SizeClass(129)), 160UL);
+  EXPECT_EQ(A::SizeClass(A::kMaxClassSize), A::kNumClasses - 1);
+  EXPECT_EQ(A::ClassSize(A::kNumClasses - 1), A::kMaxClassSize);
+  for (size_t size = 1; size <= A::kMaxClassSize; size += size / 7 + 1) {
+    int c = A::SizeClass(size);
+    EXPECT_GE(A::ClassSize(c), size);
+    if (c > 0) {
+      EXPECT_LT(A::ClassSize(c - 1), size);
+    }
+  }
+}
+
+TEST(host_allocator, reuse) {
+  auto& allocator = CachingHostAllocator::Global();
+  void* p = allocator.Allocate(1000);
+  ASSERT_TRUE(p);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0UL);
+  allocator.Deallocate(p);
+  EXPECT_EQ(allocator.Allocate(900), p);
+  allocator.Deallocate(p);
+
+  // The blocks cached by a thread go to the shared pool when it exits.
+  void* q = nullptr;
+  std::thread([&] {
+    q = allocator.Allocate(3000);
+    allocator.Deallocate(q);
+  }).join();
+  EXPECT_GT(allocator.shared_cache_bytes(), 0UL);
+  EXPECT_EQ(allocator.Allocate(3000), q);
+  allocator.Deallocate(q);
+  allocator.ReleaseCache();
+  EXPECT_EQ(allocator.shared_cache_bytes(), 0UL);
+}
+
+TEST(host_allocator, large) {
+  auto& allocator = CachingHostAllocator::Global();
+  allocator.set_huge_page_threshold(4 << 20);
+  for (size_t size : {5UL << 20, 9UL << 20}) {
+    auto* p = static_cast<char*>(allocator.Allocate(size));
+    ASSERT_TRUE(p);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0UL);
+    p[0] = 1;
+    p[size - 1] = 1;
+#ifdef __linux__
+    // Mapped for itself, its pages can be moved to a NUMA node.
+    EXPECT_TRUE(allocator.OwnsPages(p));
+#endif
+    allocator.Deallocate(p);
+  }
+  allocator.set_huge_page_threshold(0);
+  // A block of a size class is reused, a large one from malloc may share
+  // its pages.
+  for (size_t size : {1000UL, 5UL << 20}) {
+    void* p = allocator.Allocate(size);
+    EXPECT_FALSE(allocator.OwnsPages(p));
+    allocator.Deallocate(p);
+  }
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -22,6 +22,9 @@ namespace mir {
 class ArgumentTypeDisplayPass : public DebugPass {
  public:
   void Apply(const std::unique_ptr<SSAGraph>& graph) override {
+    // This pass runs many times in the optimizer, do not walk the graph if
+    // nothing will be printed.
+    if (!VLOG_IS_ON(3)) return;
     VLOG(3) << "== Argument types ==";
     for (auto& node : graph->mutable_nodes()) {
       if (!node.IsArg()) continue;
@@ -0,0 +1,86 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/concat_inplace_pass.h"
+#include <memory>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+bool IsHost(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+
+}  // namespace
+
+bool ConcatInplacePass::IsInplace(Node* node) const {
+  auto& stmt = node->AsStmt();
+  auto* op_info = stmt.op_info();
+  if (stmt.op_type() != "concat" || stmt.kernels().empty()) return false;
+  if (!IsHost(stmt.picked_kernel().target())) return false;
+  if (op_info->HasInput("AxisTensor") &&
+      !op_info->Input("AxisTensor").empty()) {
+    return false;
+  }
+
+  // A var concatenated twice can not be two views.
+  auto inputs = op_info->Input("X");
+  std::set<std::string> names(inputs.begin(), inputs.end());
+  if (names.size() != inputs.size()) return false;
+
+  for (auto* in : node->inlinks) {
+    auto& arg = in->AsArg();
+    if (arg.is_weight || arg.is_persist || !names.count(arg.name)) {
+      return false;
+    }
+    if (in->inlinks.size() != 1 || in->outlinks.size() != 1) return false;
+    auto& producer = in->inlinks.front()->AsStmt();
+    if (skipped_producers_.count(producer.op_type())) return false;
+    if (producer.kernels().empty() ||
+        !IsHost(producer.picked_kernel().target())) {
+      return false;
+    }
+  }
+  for (auto* out : node->outlinks) {
+    if (out->AsArg().is_weight || out->AsArg().is_persist) return false;
+  }
+  return true;
+}
+
+void ConcatInplacePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || !IsInplace(node)) continue;
+    auto& stmt = node->AsStmt();
+    auto op_info = *stmt.op_info();
+    op_info.SetAttr("inplace", true);
+    stmt.op()->Attach(op_info, stmt.op()->scope());
+    for (auto& kernel : stmt.kernels()) {
+      stmt.op()->AttachKernel(kernel.get());
+    }
+    VLOG(4) << "concat " << op_info.Output("Out").front() << " in place";
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(concat_inplace_pass, paddle::lite::mir::ConcatInplacePass)
+    .BindTargets({TARGET(kHost), TARGET(kX86), TARGET(kARM)});
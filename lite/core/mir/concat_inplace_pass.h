@@ -0,0 +1,65 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConcatInplacePass lets the host concat kernels skip their copies. It sets
+ * the attr `inplace` of a concat whose inputs are produced by host ops and
+ * consumed by the concat only, the kernel then turns the inputs into views of
+ * its output buffer at run time, and their producers write straight into it.
+ *
+ * The views are contiguous only when the dims before the concat axis are all
+ * 1, e.g. a channel concat of a single image. The shapes are unknown here, so
+ * the kernel checks that on every run and copies as usual otherwise.
+ */
+class ConcatInplacePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsInplace(Node* node) const;
+
+ private:
+  // The ops which replace the buffers of their outputs instead of writing
+  // into them, or whose outputs live across runs.
+  const std::set<std::string> skipped_producers_{{"feed",
+                                                  "while",
+                                                  "conditional_block",
+                                                  "conditional_block_infer",
+                                                  "graph_op",
+                                                  "reshape",
+                                                  "reshape2",
+                                                  "flatten",
+                                                  "flatten2",
+                                                  "squeeze",
+                                                  "squeeze2",
+                                                  "unsqueeze",
+                                                  "unsqueeze2",
+                                                  "slice",
+                                                  "split"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
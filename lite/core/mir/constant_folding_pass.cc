@@ -0,0 +1,136 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+bool ConstantFoldingPass::IsFoldable(
+    Node* node, const std::unordered_set<std::string>& unstable_vars) const {
+  auto& stmt = node->AsStmt();
+  if (skipped_ops_.count(stmt.op_type())) return false;
+  if (node->outlinks.empty()) return false;
+  auto* scope = stmt.op()->scope();
+  for (auto* in : node->inlinks) {
+    if (!in->IsArg() || !in->AsArg().is_weight) return false;
+    auto* var = scope->FindVar(in->AsArg().name);
+    if (!var || !var->IsType<lite::Tensor>()) return false;
+    // The quantized weights are left to their int8 kernels.
+    auto precision = var->Get<lite::Tensor>().precision();
+    if (precision == PRECISION(kInt8)) return false;
+  }
+  for (auto* out : node->outlinks) {
+    if (!out->IsArg() || out->AsArg().is_weight || out->AsArg().is_persist) {
+      return false;
+    }
+    if (unstable_vars.count(out->AsArg().name)) return false;
+  }
+  return true;
+}
+
+bool ConstantFoldingPass::RunOnHost(Node* node) const {
+  auto& stmt = node->AsStmt();
+  auto op = stmt.op();
+  std::vector<Place> host_places;
+  for (auto& place : op->valid_places()) {
+    if (place.target == TARGET(kHost) || place.target == TARGET(kX86) ||
+        place.target == TARGET(kARM)) {
+      host_places.push_back(place);
+    }
+  }
+  host_places.emplace_back(TARGET(kHost), PRECISION(kFloat));
+
+  auto kernels = op->CreateKernels(host_places);
+  for (auto& kernel : kernels) {
+    auto precision = kernel->precision();
+    if (precision != PRECISION(kFloat) && precision != PRECISION(kAny)) {
+      continue;
+    }
+    kernel->SetContext(
+        ContextScheduler::Global().NewContext(kernel->target()));
+    CHECK(op->CheckShape());
+    op->InferShape();
+    kernel->Launch();
+    VLOG(3) << "fold " << stmt.op_type() << " with " << kernel->summary();
+    return true;
+  }
+  return false;
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  // The kernels of the model optimize tool are fake ones which can not run.
+  return;
+#endif
+  // The vars written by more than one op, e.g. a `fill_constant` counter that
+  // `increment` updates in place, and the vars read or written by the control
+  // flow ops, which stand for the reads and writes of their sub-blocks, do not
+  // keep the value of their first writer, so they can not become weights.
+  std::unordered_map<std::string, int> writers;
+  std::unordered_set<std::string> unstable_vars;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsStmt()) continue;
+    const bool control_flow =
+        control_flow_ops_.count(node.AsStmt().op_type()) > 0;
+    for (auto* out : node.outlinks) {
+      if (!out->IsArg()) continue;
+      const auto& name = out->AsArg().name;
+      if (++writers[name] > 1 || control_flow) unstable_vars.insert(name);
+    }
+    if (!control_flow) continue;
+    for (auto* in : node.inlinks) {
+      if (in->IsArg()) unstable_vars.insert(in->AsArg().name);
+    }
+  }
+
+  int folded = 0;
+  // The outputs of a folded op become weights, so its consumers later in the
+  // topological order can be folded as well.
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || !IsFoldable(node, unstable_vars)) continue;
+    if (!RunOnHost(node)) continue;
+
+    auto* scope = node->AsStmt().op()->scope();
+    for (auto* out : node->outlinks) {
+      out->AsArg().is_weight = true;
+      scope->FindVar(out->AsArg().name)
+          ->GetMutable<lite::Tensor>()
+          ->set_persistable(true);
+    }
+    std::unordered_set<const Node*> nodes2rm = {node};
+    // The weights only consumed by the folded op are not needed any more.
+    for (auto* in : node->inlinks) {
+      if (in->outlinks.size() == 1) nodes2rm.insert(in);
+    }
+    GraphSafeRemoveNodes(graph.get(), nodes2rm);
+    ++folded;
+  }
+  VLOG(3) << "constant folding removed " << folded << " ops";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass, paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kAny)});
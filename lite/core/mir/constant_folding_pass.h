@@ -0,0 +1,77 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConstantFoldingPass executes the ops whose inputs are all weights, such as a
+ * `transpose` of a weight or a `fill_constant` followed by `elementwise_mul`,
+ * once with a host kernel at optimize time. Their outputs become persistable
+ * weights and the ops are removed from the graph, the chains of such ops are
+ * folded in the topological order.
+ *
+ * The ops that depend on the shape of an activation, e.g. `prior_box`, can not
+ * be folded here for the feed shapes are unknown until the first run. Neither
+ * can the ops whose outputs are written again later, such as a `fill_constant`
+ * loop counter updated by `increment` or by the sub-block of a `while`.
+ */
+class ConstantFoldingPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // Whether all the inputs of `node` are weights and none of its outputs is,
+  // nor in `unstable_vars`, the vars written again or used by control flows.
+  bool IsFoldable(Node* node,
+                  const std::unordered_set<std::string>& unstable_vars) const;
+  // Run the op of `node` with a host kernel, return false if there is no one.
+  bool RunOnHost(Node* node) const;
+
+ private:
+  // The ops which are random, have side effects or control flows.
+  const std::set<std::string> skipped_ops_{{"feed",
+                                            "fetch",
+                                            "while",
+                                            "conditional_block",
+                                            "conditional_block_infer",
+                                            "graph_op",
+                                            "increment",
+                                            "dropout",
+                                            "uniform_random",
+                                            "gaussian_random",
+                                            "io_copy",
+                                            "io_copy_once",
+                                            "calib",
+                                            "calib_once",
+                                            "layout",
+                                            "layout_once"}};
+  // The ops running a sub-block over the vars of their inputs and outputs.
+  const std::set<std::string> control_flow_ops_{
+      {"while", "conditional_block", "conditional_block_infer"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,197 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Op list:
+// (w)->scale->(w_scaled)->scale->(w_scaled2)------------|
+// (feed)->feed->(x)---------------------------elementwise_add->(out)
+// After pass:
+// (w_scaled2), (feed)->feed->(x)->elementwise_add->(out)
+std::unique_ptr<SSAGraph> BuildGraph(cpp::ProgramDesc* program_desc,
+                                     const std::shared_ptr<Scope>& scope,
+                                     const std::vector<Place>& valid_places) {
+  auto* main_block = program_desc->AddBlock<cpp::BlockDesc>();
+  for (auto name : {"w", "w_scaled", "w_scaled2", "x", "out"}) {
+    auto* var = main_block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(std::string(name) == "w");
+  }
+
+  auto* w = scope->Var("w")->GetMutable<lite::Tensor>();
+  w->Resize({2, 3});
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < w->numel(); i++) {
+    w_data[i] = i;
+  }
+  w->set_persistable(true);
+
+  auto add_scale = [&](const std::string& in, const std::string& out) {
+    auto* scale_op = main_block->AddOp<cpp::OpDesc>();
+    scale_op->SetType("scale");
+    scale_op->SetInput("X", {in});
+    scale_op->SetOutput("Out", {out});
+    scale_op->SetAttr("scale", 2.f);
+    scale_op->SetAttr("bias", 1.f);
+    scale_op->SetAttr("bias_after_scale", true);
+  };
+  auto* feed_op = main_block->AddOp<cpp::OpDesc>();
+  feed_op->SetType("feed");
+  feed_op->SetInput("X", {"feed"});
+  feed_op->SetOutput("Out", {"x"});
+  feed_op->SetAttr("col", 0);
+
+  add_scale("w", "w_scaled");
+  add_scale("w_scaled", "w_scaled2");
+
+  auto* add_op = main_block->AddOp<cpp::OpDesc>();
+  add_op->SetType("elementwise_add");
+  add_op->SetInput("X", {"x"});
+  add_op->SetInput("Y", {"w_scaled2"});
+  add_op->SetOutput("Out", {"out"});
+  add_op->SetAttr("axis", -1);
+
+  lite::Program program(*program_desc, scope, valid_places);
+  auto graph = std::unique_ptr<SSAGraph>(new SSAGraph());
+  graph->Build(program, valid_places);
+  return graph;
+}
+
+TEST(constant_folding_pass, fold_weight_chain) {
+  cpp::ProgramDesc program_desc;
+  std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)},
+                            {TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(&program_desc, scope, places);
+
+  auto pass = PassManager::Global().LookUp("constant_folding_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto stmts = graph->StmtTopologicalOrder();
+  ASSERT_EQ(stmts.size(), 2UL);
+  EXPECT_EQ(stmts.back()->AsStmt().op_type(), "elementwise_add");
+  for (auto* in : stmts.back()->inlinks) {
+    if (in->AsArg().name == "w_scaled2") {
+      EXPECT_TRUE(in->AsArg().is_weight);
+    }
+  }
+
+  auto* exec_scope = stmts.back()->AsStmt().op()->scope();
+  auto* folded = exec_scope->FindVar("w_scaled2");
+  ASSERT_TRUE(folded);
+  auto& folded_t = folded->Get<lite::Tensor>();
+  EXPECT_TRUE(folded_t.persistable());
+  ASSERT_EQ(folded_t.numel(), 6);
+  for (int i = 0; i < folded_t.numel(); i++) {
+    EXPECT_NEAR(folded_t.data<float>()[i], (i * 2.f + 1.f) * 2.f + 1.f, 1e-6);
+  }
+}
+
+// Op list:
+// fill_constant->(i)->increment->(i)
+// The counter `i` is written again by increment, so nothing is folded and every
+// run starts again from the value of fill_constant.
+TEST(constant_folding_pass, keep_var_written_again) {
+  cpp::ProgramDesc program_desc;
+  std::vector<Place> places{{TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto* main_block = program_desc.AddBlock<cpp::BlockDesc>();
+  auto* var = main_block->AddVar<cpp::VarDesc>();
+  var->SetName("i");
+  var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+  var->SetPersistable(false);
+
+  auto* fill_op = main_block->AddOp<cpp::OpDesc>();
+  fill_op->SetType("fill_constant");
+  fill_op->SetOutput("Out", {"i"});
+  fill_op->SetAttr("dtype", static_cast<int>(VarDescAPI::VarDataType::FP32));
+  fill_op->SetAttr("shape", std::vector<int64_t>({1}));
+  fill_op->SetAttr("value", 3.f);
+  fill_op->SetAttr("force_cpu", false);
+
+  auto* increment_op = main_block->AddOp<cpp::OpDesc>();
+  increment_op->SetType("increment");
+  increment_op->SetInput("X", {"i"});
+  increment_op->SetOutput("Out", {"i"});
+  increment_op->SetAttr("step", 2.f);
+
+  lite::Program program(program_desc, scope, places);
+  auto graph = std::unique_ptr<SSAGraph>(new SSAGraph());
+  graph->Build(program, places);
+
+  auto pass = PassManager::Global().LookUp("constant_folding_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto stmts = graph->StmtTopologicalOrder();
+  ASSERT_EQ(stmts.size(), 2UL);
+  EXPECT_EQ(stmts.front()->AsStmt().op_type(), "fill_constant");
+  for (auto* out : stmts.front()->outlinks) {
+    EXPECT_FALSE(out->AsArg().is_weight);
+  }
+
+  std::vector<std::unique_ptr<KernelBase>> kernels;
+  for (auto* node : stmts) {
+    auto op = node->AsStmt().op();
+    auto candidates = op->CreateKernels(places);
+    ASSERT_FALSE(candidates.empty());
+    kernels.emplace_back(std::move(candidates.front()));
+    kernels.back()->SetContext(
+        ContextScheduler::Global().NewContext(kernels.back()->target()));
+  }
+  auto* exec_scope = stmts.front()->AsStmt().op()->scope();
+  for (int run = 0; run < 2; run++) {
+    for (size_t k = 0; k < stmts.size(); k++) {
+      auto op = stmts[k]->AsStmt().op();
+      ASSERT_TRUE(op->CheckShape());
+      op->InferShape();
+      kernels[k]->Launch();
+    }
+    auto& i = exec_scope->FindVar("i")->Get<lite::Tensor>();
+    EXPECT_FALSE(i.persistable());
+    ASSERT_EQ(i.numel(), 1);
+    EXPECT_NEAR(i.data<float>()[0], 5.f, 1e-6) << "run " << run;
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(scale);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(fill_constant);
+USE_LITE_OP(increment);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(fill_constant, kHost, kFloat, kNCHW, def);
+USE_LITE_KERNEL(increment, kHost, kFloat, kNCHW, def);
+USE_MIR_PASS(constant_folding_pass);
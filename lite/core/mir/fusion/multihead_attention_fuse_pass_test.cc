@@ -0,0 +1,198 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/multihead_attention_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The attention of a transformer layer as exported by Fluid, q, k and v are
+// projections of x, the heads are split and merged by reshape2 + transpose2.
+// With `cross_attention`, k and v are projections of another input, and
+// `k_heads` is the head number k is split into.
+std::unique_ptr<SSAGraph> BuildGraph(cpp::ProgramDesc* program_desc,
+                                     const std::shared_ptr<Scope>& scope,
+                                     const std::vector<Place>& valid_places,
+                                     bool with_dropout,
+                                     bool cross_attention = false,
+                                     int k_heads = 2) {
+  auto* main_block = program_desc->AddBlock<cpp::BlockDesc>();
+  auto add_var = [&](const std::string& name) {
+    auto* var = main_block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(false);
+    scope->Var(name)->GetMutable<lite::Tensor>();
+  };
+  auto add_op = [&](const std::string& type,
+                    const std::vector<std::string>& inputs,
+                    const std::vector<std::string>& outputs) {
+    auto* op = main_block->AddOp<cpp::OpDesc>();
+    op->SetType(type);
+    const char* in_args[] = {"X", "Y"};
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      op->SetInput(in_args[i], {inputs[i]});
+      add_var(inputs[i]);
+    }
+    op->SetOutput("Out", {outputs[0]});
+    add_var(outputs[0]);
+    if (outputs.size() > 1) {
+      op->SetOutput(type == "dropout" ? "Mask" : "XShape", {outputs[1]});
+      add_var(outputs[1]);
+    }
+    return op;
+  };
+  auto project = [&](const std::string& x, const std::string& out) {
+    auto w = out + "_w";
+    auto* var = main_block->AddVar<cpp::VarDesc>();
+    var->SetName(w);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(true);
+    auto* w_t = scope->Var(w)->GetMutable<lite::Tensor>();
+    w_t->Resize({8, 8});
+    w_t->mutable_data<float>();
+    w_t->set_persistable(true);
+    auto* mul = add_op("mul", {x, w}, {out});
+    mul->SetAttr("x_num_col_dims", 2);
+    mul->SetAttr("y_num_col_dims", 1);
+  };
+  auto split_heads = [&](const std::string& x, int heads) {
+    add_op("reshape2", {x}, {x + "_r", x + "_rs"})
+        ->SetAttr("shape", std::vector<int>({0, 0, heads, 8 / heads}));
+    add_op("transpose2", {x + "_r"}, {x + "_t", x + "_ts"})
+        ->SetAttr("axis", std::vector<int>({0, 2, 1, 3}));
+    return x + "_t";
+  };
+
+  project("x", "q");
+  project(cross_attention ? "memory" : "x", "k");
+  project(cross_attention ? "memory" : "x", "v");
+  auto q = split_heads("q", 2);
+  auto k = split_heads("k", k_heads);
+  auto v = split_heads("v", 2);
+  auto* scale = add_op("scale", {q}, {"q_scaled"});
+  scale->SetAttr("scale", 0.5f);
+  scale->SetAttr("bias", 0.f);
+  scale->SetAttr("bias_after_scale", true);
+  auto* qk = add_op("matmul", {"q_scaled", k}, {"qk"});
+  qk->SetAttr("transpose_X", false);
+  qk->SetAttr("transpose_Y", true);
+  qk->SetAttr("alpha", 1.f);
+  add_op("elementwise_add", {"qk", "mask"}, {"qk_masked"})
+      ->SetAttr("axis", -1);
+  add_op("softmax", {"qk_masked"}, {"weights"})->SetAttr("axis", -1);
+  std::string weights = "weights";
+  if (with_dropout) {
+    auto* dropout = add_op("dropout", {weights}, {"dropped", "dropout_mask"});
+    dropout->SetAttr("dropout_prob", 0.1f);
+    dropout->SetAttr("fix_seed", false);
+    dropout->SetAttr("seed", 0);
+    dropout->SetAttr("dropout_implementation",
+                     std::string("downgrade_in_infer"));
+    weights = "dropped";
+  }
+  auto* qkv = add_op("matmul", {weights, v}, {"qkv"});
+  qkv->SetAttr("transpose_X", false);
+  qkv->SetAttr("transpose_Y", false);
+  qkv->SetAttr("alpha", 1.f);
+  add_op("transpose2", {"qkv"}, {"qkv_t", "qkv_ts"})
+      ->SetAttr("axis", std::vector<int>({0, 2, 1, 3}));
+  add_op("reshape2", {"qkv_t"}, {"out", "out_rs"})
+      ->SetAttr("shape", std::vector<int>({0, 0, 8}));
+
+  lite::Program program(*program_desc, scope, valid_places);
+  auto graph = std::unique_ptr<SSAGraph>(new SSAGraph());
+  graph->Build(program, valid_places);
+  return graph;
+}
+
+TEST(multihead_attention_fuse_pass, fuse) {
+  for (bool with_dropout : {false, true}) {
+    cpp::ProgramDesc program_desc;
+    std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)}};
+    auto scope = std::make_shared<Scope>();
+    auto graph = BuildGraph(&program_desc, scope, places, with_dropout);
+
+    auto pass =
+        PassManager::Global().LookUp("lite_multihead_attention_fuse_pass");
+    ASSERT_TRUE(pass);
+    pass->Apply(graph);
+
+    // The three projections are left.
+    auto stmts = graph->StmtTopologicalOrder();
+    ASSERT_EQ(stmts.size(), 4UL);
+    auto& stmt = stmts.back()->AsStmt();
+    ASSERT_EQ(stmt.op_type(), "fused_multihead_attention");
+    auto* op_info = stmt.op_info();
+    EXPECT_EQ(op_info->Input("Q").front(), "q");
+    EXPECT_EQ(op_info->Input("K").front(), "k");
+    EXPECT_EQ(op_info->Input("V").front(), "v");
+    EXPECT_EQ(op_info->Input("BiasQK").front(), "mask");
+    EXPECT_EQ(op_info->Output("Out").front(), "out");
+    EXPECT_EQ(op_info->GetAttr<int>("head_number"), 2);
+    EXPECT_FLOAT_EQ(op_info->GetAttr<float>("alpha"), 0.5f);
+    EXPECT_FLOAT_EQ(op_info->GetAttr<float>("out_scale"),
+                    with_dropout ? 0.9f : 1.f);
+  }
+}
+
+TEST(multihead_attention_fuse_pass, not_fuse) {
+  // k and v longer than q, then a k split into other heads.
+  for (int k_heads : {0, 4}) {
+    cpp::ProgramDesc program_desc;
+    std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)}};
+    auto scope = std::make_shared<Scope>();
+    auto graph = BuildGraph(
+        &program_desc, scope, places, false, k_heads == 0, k_heads ? 4 : 2);
+    const size_t num_stmts = graph->StmtTopologicalOrder().size();
+
+    auto pass =
+        PassManager::Global().LookUp("lite_multihead_attention_fuse_pass");
+    ASSERT_TRUE(pass);
+    pass->Apply(graph);
+
+    auto stmts = graph->StmtTopologicalOrder();
+    EXPECT_EQ(stmts.size(), num_stmts);
+    for (auto* node : stmts) {
+      EXPECT_NE(node->AsStmt().op_type(), "fused_multihead_attention");
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(mul);
+USE_LITE_OP(reshape2);
+USE_LITE_OP(transpose2);
+USE_LITE_OP(scale);
+USE_LITE_OP(matmul);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(softmax);
+USE_LITE_OP(dropout);
+USE_LITE_OP(fused_multihead_attention);
@@ -0,0 +1,300 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/multihead_attention_fuser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+namespace {
+
+const std::vector<int> kHeadsAxis{0, 2, 1, 3};
+
+// The projection, fc or mul followed by an optional bias add, which outputs
+// `var`. The projections of one input by weights of the same dims and with
+// the same num_col_dims output the same shape.
+std::string ProjectionOf(const Node* var) {
+  if (var->inlinks.size() != 1) return "";
+  auto* op_node = var->inlinks.front();
+  auto* op_info = op_node->stmt()->op_info();
+  auto* scope = op_node->stmt()->op()->scope();
+  // The tensor of the weight `node`, nullptr if it is not a weight.
+  auto weight = [&](const Node* node) -> const lite::Tensor* {
+    if (!node->arg()->is_weight && !node->arg()->is_persist) return nullptr;
+    auto* w = scope->FindVar(node->arg()->name);
+    return w ? &w->Get<lite::Tensor>() : nullptr;
+  };
+
+  const std::string& type = op_info->Type();
+  if (type == "elementwise_add") {
+    // A 1-D bias does not change the shape.
+    const Node* x = nullptr;
+    for (auto* in : op_node->inlinks) {
+      if (in->arg()->name == op_info->Input("X").front()) {
+        x = in;
+      } else if (!weight(in) || weight(in)->dims().size() != 1) {
+        return "";
+      }
+    }
+    return x ? ProjectionOf(x) : "";
+  }
+  std::string x_arg, w_arg, num_col_dims;
+  if (type == "fc") {
+    x_arg = "Input";
+    w_arg = "W";
+    num_col_dims = "in_num_col_dims";
+  } else if (type == "mul") {
+    x_arg = "X";
+    w_arg = "Y";
+    num_col_dims = "x_num_col_dims";
+  } else {
+    return "";
+  }
+  const lite::Tensor* w = nullptr;
+  for (auto* in : op_node->inlinks) {
+    if (in->arg()->name == op_info->Input(w_arg).front()) w = weight(in);
+  }
+  if (!w) return "";
+  return op_info->Input(x_arg).front() + " " +
+         std::to_string(op_info->GetAttr<int>(num_col_dims)) + " " +
+         w->dims().repr();
+}
+
+}  // namespace
+
+PMNode* MultiheadAttentionFuser::SplitHeads(const std::string& prefix) {
+  auto* in = VarNode(prefix)->assert_is_op_input("reshape2", "X");
+  auto* reshape = OpNode(prefix + "_reshape", "reshape2")
+                      ->assert_op_attr_satisfied<std::vector<int>>(
+                          "shape", [](const std::vector<int>& shape) {
+                            return shape.size() == 4 && shape[2] > 0;
+                          });
+  auto* reshape_out = VarNode(prefix + "_reshape_out")
+                          ->assert_is_op_output("reshape2", "Out")
+                          ->assert_is_op_input("transpose2", "X");
+  auto* reshape_xshape =
+      VarNode(prefix + "_reshape_xshape")
+          ->assert_is_op_output("reshape2", "XShape");
+  auto* transpose = OpNode(prefix + "_transpose", "transpose2")
+                        ->assert_op_attr("axis", kHeadsAxis);
+  auto* transpose_out = VarNode(prefix + "_transpose_out")
+                            ->assert_is_op_output("transpose2", "Out");
+  auto* transpose_xshape =
+      VarNode(prefix + "_transpose_xshape")
+          ->assert_is_op_output("transpose2", "XShape");
+
+  *in >> *reshape >> *reshape_out >> *transpose >> *transpose_out;
+  *reshape >> *reshape_xshape;
+  *transpose >> *transpose_xshape;
+
+  reshape->AsIntermediate();
+  reshape_out->AsIntermediate();
+  reshape_xshape->AsIntermediate();
+  transpose->AsIntermediate();
+  transpose_out->AsIntermediate();
+  transpose_xshape->AsIntermediate();
+  return transpose_out;
+}
+
+void MultiheadAttentionFuser::BuildPattern() {
+  // create nodes.
+  auto* q = SplitHeads("q")->assert_is_op_input("scale", "X");
+  auto* k = SplitHeads("k")->assert_is_op_input("matmul", "Y");
+  auto* v = SplitHeads("v")->assert_is_op_input("matmul", "Y");
+
+  auto* scale = OpNode("scale", "scale")->assert_op_attr<float>("bias", 0.f);
+  auto* scale_out = VarNode("scale_out")
+                        ->assert_is_op_output("scale", "Out")
+                        ->assert_is_op_input("matmul", "X");
+  auto* qk_matmul = OpNode("qk_matmul", "matmul")
+                        ->assert_op_attr<bool>("transpose_X", false)
+                        ->assert_op_attr<bool>("transpose_Y", true);
+  auto* qk_out = VarNode("qk_out")
+                     ->assert_is_op_output("matmul", "Out")
+                     ->assert_is_op_input("elementwise_add", "X");
+  auto* mask = VarNode("mask")->assert_is_op_input("elementwise_add", "Y");
+  auto* add = OpNode("add", "elementwise_add")
+                  ->assert_op_attr_satisfied<int>(
+                      "axis", [](int axis) { return axis == -1; });
+  auto* add_out = VarNode("add_out")
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_is_op_input("softmax", "X");
+  auto* softmax = OpNode("softmax", "softmax")
+                      ->assert_op_attr_satisfied<int>(
+                          "axis", [](int axis) { return axis == -1; });
+  auto* softmax_out =
+      VarNode("softmax_out")->assert_is_op_output("softmax", "Out");
+  auto* qkv_matmul = OpNode("qkv_matmul", "matmul")
+                         ->assert_op_attr<bool>("transpose_X", false)
+                         ->assert_op_attr<bool>("transpose_Y", false);
+  auto* qkv_out = VarNode("qkv_out")
+                      ->assert_is_op_output("matmul", "Out")
+                      ->assert_is_op_input("transpose2", "X");
+  auto* out_transpose = OpNode("out_transpose", "transpose2")
+                            ->assert_op_attr("axis", kHeadsAxis);
+  auto* out_transpose_out = VarNode("out_transpose_out")
+                                ->assert_is_op_output("transpose2", "Out")
+                                ->assert_is_op_input("reshape2", "X");
+  auto* out_transpose_xshape =
+      VarNode("out_transpose_xshape")
+          ->assert_is_op_output("transpose2", "XShape");
+  auto* out_reshape = OpNode("out_reshape", "reshape2")
+                          ->assert_op_attr_satisfied<std::vector<int>>(
+                              "shape", [](const std::vector<int>& shape) {
+                                return shape.size() == 3;
+                              });
+  auto* out_reshape_xshape =
+      VarNode("out_reshape_xshape")->assert_is_op_output("reshape2", "XShape");
+  auto* out = VarNode("out")->assert_is_op_output("reshape2", "Out");
+
+  // create topology.
+  std::vector<PMNode*> qk_inputs{scale_out, k};
+  std::vector<PMNode*> add_inputs{qk_out, mask};
+  *q >> *scale >> *scale_out;
+  qk_inputs >> *qk_matmul >> *qk_out;
+  add_inputs >> *add >> *add_out >> *softmax >> *softmax_out;
+  PMNode* weights = softmax_out;
+  if (with_dropout_) {
+    softmax_out->assert_is_op_input("dropout", "X");
+    auto* dropout = OpNode("dropout", "dropout");
+    auto* dropout_out =
+        VarNode("dropout_out")->assert_is_op_output("dropout", "Out");
+    auto* dropout_mask =
+        VarNode("dropout_mask")->assert_is_op_output("dropout", "Mask");
+    *softmax_out >> *dropout >> *dropout_out;
+    *dropout >> *dropout_mask;
+    dropout->AsIntermediate();
+    dropout_out->AsIntermediate();
+    dropout_mask->AsIntermediate();
+    weights = dropout_out;
+  }
+  weights->assert_is_op_input("matmul", "X");
+  std::vector<PMNode*> qkv_inputs{weights, v};
+  qkv_inputs >> *qkv_matmul >> *qkv_out >> *out_transpose >>
+      *out_transpose_out >> *out_reshape >> *out;
+  *out_transpose >> *out_transpose_xshape;
+  *out_reshape >> *out_reshape_xshape;
+
+  // nodes to remove
+  for (auto* node : {scale,
+                     scale_out,
+                     qk_matmul,
+                     qk_out,
+                     add,
+                     add_out,
+                     softmax,
+                     softmax_out,
+                     qkv_matmul,
+                     qkv_out,
+                     out_transpose,
+                     out_transpose_out,
+                     out_transpose_xshape,
+                     out_reshape,
+                     out_reshape_xshape}) {
+    node->AsIntermediate();
+  }
+}
+
+bool MultiheadAttentionFuser::IsValidMatch(const key2nodes_t& matched) {
+  auto shape = [&](const std::string& key) {
+    return matched.at(key)->stmt()->op_info()->GetAttr<std::vector<int>>(
+        "shape");
+  };
+  // The heads are [head_number, head_size], both known, and alike for q, k
+  // and v. The output merges them back into the last axis.
+  auto q_shape = shape("q_reshape");
+  if (q_shape[2] <= 0 || q_shape[3] <= 0 || shape("k_reshape") != q_shape ||
+      shape("v_reshape") != q_shape) {
+    VLOG(4) << "the heads of q, k and v differ";
+    return false;
+  }
+  auto out_shape = shape("out_reshape");
+  if (out_shape[2] != q_shape[2] * q_shape[3] &&
+      !(out_shape[2] == -1 && out_shape[0] == 0 && out_shape[1] == 0)) {
+    VLOG(4) << "the output does not merge the heads";
+    return false;
+  }
+
+  auto* q = matched.at("q");
+  auto* k = matched.at("k");
+  auto* v = matched.at("v");
+  if (q->arg()->name == k->arg()->name && q->arg()->name == v->arg()->name) {
+    return true;
+  }
+  auto projection = ProjectionOf(q);
+  if (projection.empty() || ProjectionOf(k) != projection ||
+      ProjectionOf(v) != projection) {
+    VLOG(4) << "q, k and v may have different shapes";
+    return false;
+  }
+  return true;
+}
+
+void MultiheadAttentionFuser::InsertNewNode(SSAGraph* graph,
+                                            const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto attention_op =
+      LiteOpRegistry::Global().Create("fused_multihead_attention");
+  auto qk_matmul = matched.at("qk_matmul")->stmt()->op();
+  auto* scope = qk_matmul->scope();
+  auto& valid_places = qk_matmul->valid_places();
+  attention_op->Attach(op_desc, scope);
+
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(attention_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("q"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("k"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("v"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("mask"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc MultiheadAttentionFuser::GenOpDesc(const key2nodes_t& matched) {
+  auto attr = [&](const std::string& key) {
+    return matched.at(key)->stmt()->op_info();
+  };
+  float alpha = attr("scale")->GetAttr<float>("scale") *
+                attr("qk_matmul")->GetAttr<float>("alpha");
+  float out_scale = attr("qkv_matmul")->GetAttr<float>("alpha");
+  if (with_dropout_ &&
+      attr("dropout")->GetAttr<std::string>("dropout_implementation") ==
+          "downgrade_in_infer") {
+    out_scale *= 1.f - attr("dropout")->GetAttr<float>("dropout_prob");
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_multihead_attention");
+  op_desc.SetInput("Q", {matched.at("q")->arg()->name});
+  op_desc.SetInput("K", {matched.at("k")->arg()->name});
+  op_desc.SetInput("V", {matched.at("v")->arg()->name});
+  op_desc.SetInput("BiasQK", {matched.at("mask")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr(
+      "head_number",
+      attr("q_reshape")->GetAttr<std::vector<int>>("shape")[2]);
+  op_desc.SetAttr("alpha", alpha);
+  op_desc.SetAttr("out_scale", out_scale);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
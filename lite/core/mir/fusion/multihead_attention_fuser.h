@@ -0,0 +1,62 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/*
+ * Fuse the scaled dot-product attention of a transformer layer into the op
+ * fused_multihead_attention:
+ *
+ *   q -> reshape2 -> transpose2 -> scale --\
+ *   k -> reshape2 -> transpose2 ------------ matmul -> elementwise_add(mask)
+ *     -> softmax [-> dropout] -> matmul -> transpose2 -> reshape2 -> out
+ *   v -> reshape2 -> transpose2 ------------/
+ *
+ * The reshapes split the hidden size into [head_number, head_size] and the
+ * transposes are [0, 2, 1, 3]. The shapes are unknown here, q, k and v must be
+ * the same var or the projections of the same var by weights of the same
+ * dims, e.g. the self-attention of a transformer encoder. The cross-attention
+ * of a decoder, whose k and v may be longer than q, is not fused.
+ */
+class MultiheadAttentionFuser : public FuseBase {
+ public:
+  explicit MultiheadAttentionFuser(bool with_dropout)
+      : with_dropout_(with_dropout) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+  // The fused op takes Q, K and V of one shape, split into the same heads.
+  bool IsValidMatch(const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  // Build `prefix` -> reshape2 -> transpose2, return the transposed var.
+  PMNode* SplitHeads(const std::string& prefix);
+
+  bool with_dropout_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -46,6 +46,14 @@ void QuantDequantFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
     fusion::DeleteQuantDequantOpFuser fuser(op_type);
     fuser(graph.get());
   }
+
+  // fuse the dequant op into the quantized embedding lookup
+  fusion::DequantLookupTableFuser dequant_lookup_fuser;
+  dequant_lookup_fuser(graph.get());
+
+  // quantize the float embedding tables row-wise
+  fusion::QuantizeLookupTableFuser quant_lookup_fuser;
+  quant_lookup_fuser(graph.get());
 }
 
 }  // namespace mir
@@ -0,0 +1,208 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/mir/fusion/quant_dequant_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/backends/host/math/rowwise_quant.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The lookups of a 4 x 6 embedding table "emb", with the ids "ids".
+class LookupGraph {
+ public:
+  LookupGraph() : scope_(std::make_shared<Scope>()) {
+    block_ = program_desc_.AddBlock<cpp::BlockDesc>();
+    AddVar("ids", false);
+    auto* table = AddVar("emb", true);
+    table->Resize({4, 6});
+    auto* data = table->mutable_data<float>();
+    for (int i = 0; i < 24; ++i) {
+      data[i] = static_cast<float>(i % 9 - 4);
+    }
+  }
+
+  // A lookup_table to `out`, with the attr `bit_length` if it is not 0.
+  void AddLookup(const std::string& out, int bit_length = 0) {
+    auto* op = block_->AddOp<cpp::OpDesc>();
+    op->SetType("lookup_table");
+    op->SetInput("Ids", {"ids"});
+    op->SetInput("W", {"emb"});
+    op->SetOutput("Out", {out});
+    op->SetAttr<int64_t>("padding_idx", -1);
+    if (bit_length) op->SetAttr<int>("bit_length", bit_length);
+    AddVar(out, false);
+  }
+
+  // A dequantize_abs_max of `x` to `out`, with the scale var `scale`.
+  void AddDequant(const std::string& x,
+                  const std::string& scale,
+                  float scale_value,
+                  const std::string& out) {
+    auto* op = block_->AddOp<cpp::OpDesc>();
+    op->SetType("dequantize_abs_max");
+    op->SetInput("X", {x});
+    op->SetInput("Scale", {scale});
+    op->SetOutput("Out", {out});
+    op->SetAttr<float>("max_range", 127.f);
+    auto* scale_t = AddVar(scale, true);
+    scale_t->Resize({1});
+    scale_t->mutable_data<float>()[0] = scale_value;
+    AddVar(out, false);
+  }
+
+  std::unique_ptr<SSAGraph> Fuse() {
+    std::vector<Place> places{{TARGET(kHost), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, places));
+    std::unique_ptr<SSAGraph> graph(new SSAGraph());
+    graph->Build(*program_, places);
+    auto pass = PassManager::Global().LookUp("lite_quant_dequant_fuse_pass");
+    CHECK(pass);
+    pass->Apply(graph);
+    return graph;
+  }
+
+  // The vars created by the pass are in the exec scope of the program.
+  const Tensor& var(const std::string& name) const {
+    auto* var = program_->exec_scope()->FindVar(name);
+    CHECK(var) << "no var " << name;
+    return var->Get<Tensor>();
+  }
+
+ private:
+  Tensor* AddVar(const std::string& name, bool persistable) {
+    auto* var = block_->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(persistable);
+    auto* tensor = scope_->Var(name)->GetMutable<Tensor>();
+    tensor->set_persistable(persistable);
+    return tensor;
+  }
+
+  cpp::ProgramDesc program_desc_;
+  cpp::BlockDesc* block_;
+  std::shared_ptr<Scope> scope_;
+  std::unique_ptr<Program> program_;
+};
+
+std::vector<const OpInfo*> OpsOf(const std::unique_ptr<SSAGraph>& graph,
+                                 const std::string& type) {
+  std::vector<const OpInfo*> ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->AsStmt().op_type() == type) {
+      ops.push_back(node->AsStmt().op_info());
+    }
+  }
+  return ops;
+}
+
+TEST(quant_dequant_fuse_pass, dequant_lookup_table) {
+  // Each lookup is dequantized with its own scale.
+  LookupGraph g;
+  g.AddLookup("a");
+  g.AddDequant("a", "s0", 0.5f, "out0");
+  g.AddLookup("b");
+  g.AddDequant("b", "s1", 2.f, "out1");
+  auto graph = g.Fuse();
+
+  EXPECT_TRUE(OpsOf(graph, "dequantize_abs_max").empty());
+  auto lookups = OpsOf(graph, "lookup_table");
+  ASSERT_EQ(lookups.size(), 2UL);
+  EXPECT_EQ(g.var("emb").precision(), PRECISION(kInt8));
+  for (auto* op : lookups) {
+    EXPECT_TRUE(op->GetAttr<bool>("enable_int8"));
+    EXPECT_EQ(op->GetAttr<int>("bit_length"), 8);
+    EXPECT_EQ(op->GetAttr<int64_t>("row_width"), 6);
+    const bool first = op->Output("Out").front() == "out0";
+    const std::string scale_name =
+        first ? "emb.s0.row_scale" : "emb.s1.row_scale";
+    EXPECT_EQ(op->Input("Scale").front(), scale_name);
+    auto& scale = g.var(scale_name);
+    ASSERT_EQ(scale.numel(), 4);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_FLOAT_EQ(scale.data<float>()[i], (first ? 0.5f : 2.f) / 127.f);
+    }
+  }
+}
+
+TEST(quant_dequant_fuse_pass, dequant_lookup_table_shared_with_float) {
+  // The table is also read as float, it is left unchanged.
+  LookupGraph g;
+  g.AddLookup("a");
+  g.AddDequant("a", "s0", 0.5f, "out0");
+  g.AddLookup("b");
+  auto graph = g.Fuse();
+
+  EXPECT_EQ(OpsOf(graph, "dequantize_abs_max").size(), 1UL);
+  for (auto* op : OpsOf(graph, "lookup_table")) {
+    EXPECT_FALSE(op->HasInput("Scale") && !op->Input("Scale").empty());
+  }
+  EXPECT_NE(g.var("emb").precision(), PRECISION(kInt8));
+  EXPECT_EQ(g.var("emb").data<float>()[1], -3.f);
+}
+
+TEST(quant_dequant_fuse_pass, quantize_lookup_table) {
+  // The table is quantized once, the lookups share its row scales.
+  LookupGraph g;
+  g.AddLookup("a", 8);
+  g.AddLookup("b", 8);
+  auto graph = g.Fuse();
+
+  auto lookups = OpsOf(graph, "lookup_table");
+  ASSERT_EQ(lookups.size(), 2UL);
+  for (auto* op : lookups) {
+    EXPECT_TRUE(op->GetAttr<bool>("enable_int8"));
+    EXPECT_EQ(op->GetAttr<int64_t>("row_width"), 6);
+    EXPECT_EQ(op->Input("Scale").front(), "emb.row_scale");
+  }
+  auto& table = g.var("emb");
+  EXPECT_EQ(table.precision(), PRECISION(kInt8));
+  EXPECT_EQ(table.dims()[1], host::math::QuantizedRowBytes(6, 8));
+  EXPECT_EQ(g.var("emb.row_scale").numel(), 4);
+}
+
+TEST(quant_dequant_fuse_pass, quantize_lookup_table_mixed_bit_length) {
+  // The lookups want the table in 8 and 4 bits, it stays in float.
+  LookupGraph g;
+  g.AddLookup("a", 8);
+  g.AddLookup("b", 4);
+  auto graph = g.Fuse();
+
+  for (auto* op : OpsOf(graph, "lookup_table")) {
+    EXPECT_FALSE(op->HasAttr("enable_int8") &&
+                 op->GetAttr<bool>("enable_int8"));
+  }
+  EXPECT_NE(g.var("emb").precision(), PRECISION(kInt8));
+  EXPECT_EQ(g.var("emb").dims(), DDim({4, 6}));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(lookup_table);
+USE_LITE_OP(dequantize_abs_max);
+USE_MIR_PASS(lite_quant_dequant_fuse_pass);
@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #include "lite/core/mir/fusion/quant_dequant_op_fuser.h"
+#include <functional>
 #include <memory>
 #include <unordered_set>
 #include <vector>
+#include "lite/backends/host/math/rowwise_quant.h"
 #include "lite/utils/string.h"
 
 namespace paddle {
@@ -23,6 +25,46 @@ namespace lite {
 namespace mir {
 namespace fusion {
 
+namespace {
+
+// Create the per-row scale tensor `scale_name` of a quantized table, return
+// its argument node.
+Node* CreateRowScale(SSAGraph* graph,
+                     lite::Scope* scope,
+                     const std::string& scale_name,
+                     int64_t rows) {
+  auto* scale_t = scope->Var(scale_name)->GetMutable<lite::Tensor>();
+  scale_t->Resize({rows});
+  scale_t->set_persistable(true);
+  scale_t->set_precision(PRECISION(kFloat));
+  auto* scale_node = graph->NewArgumentNode(scale_name);
+  scale_node->AsArg().is_weight = true;
+  return scale_node;
+}
+
+// The tables are converted in place, so every op reading one must read it
+// quantized.
+bool AllConsumersQuantized(Node* table,
+                           const std::function<bool(Node*)>& quantized) {
+  for (auto* op : table->outlinks) {
+    if (!op->IsStmt() || op->AsStmt().op_type() != "lookup_table" ||
+        !quantized(op)) {
+      VLOG(4) << "The table " << table->arg()->name << " is read as float";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsInt8Lookup(Node* lookup_op, int bit_length) {
+  auto* op_info = lookup_op->AsStmt().op_info();
+  return op_info->HasAttr("enable_int8") &&
+         op_info->GetAttr<bool>("enable_int8") &&
+         op_info->GetAttr<int>("bit_length") == bit_length;
+}
+
+}  // namespace
+
 void DeleteQuantOpFuser::BuildPattern() {
   auto* input_scale_node = VarNode("input_scale_node")
                                ->assert_is_op_input(quant_op_type_, "InScale");
@@ -355,6 +397,196 @@ cpp::OpDesc DeleteQuantDequantOpFuser::GenOpDesc(const key2nodes_t& matched) {
   return op_desc;
 }
 
+void DequantLookupTableFuser::BuildPattern() {
+  auto* ids = VarNode("ids")->assert_is_op_input("lookup_table", "Ids");
+  auto* table = VarNode("table")->assert_is_op_input("lookup_table", "W");
+  auto* lookup_op = OpNode("lookup_op", "lookup_table")
+                        ->assert_is_op("lookup_table")
+                        ->AsIntermediate();
+  auto* lookup_out = VarNode("lookup_out")
+                         ->assert_is_op_output("lookup_table", "Out")
+                         ->assert_is_op_input("dequantize_abs_max", "X")
+                         ->AsIntermediate();
+  auto* dequant_scale = VarNode("dequant_scale")
+                            ->assert_is_op_input("dequantize_abs_max", "Scale")
+                            ->AsIntermediate();
+  auto* dequant_op = OpNode("dequant_op", "dequantize_abs_max")
+                         ->assert_is_op("dequantize_abs_max")
+                         ->AsIntermediate();
+  auto* dequant_out =
+      VarNode("dequant_out")->assert_is_op_output("dequantize_abs_max", "Out");
+
+  lookup_op->LinksFrom({ids, table});
+  lookup_out->LinksFrom({lookup_op});
+  dequant_op->LinksFrom({lookup_out, dequant_scale});
+  dequant_out->LinksFrom({dequant_op});
+  VLOG(4) << "DequantLookupTableFuser BuildPattern";
+}
+
+bool DequantLookupTableFuser::IsValidMatch(const key2nodes_t& matched) {
+  // The other lookup_tables of the table are dequantized as well, or already
+  // fused.
+  return AllConsumersQuantized(matched.at("table"), [](Node* op) {
+    if (IsInt8Lookup(op, 8)) return true;
+    for (auto* out : op->outlinks) {
+      if (out->outlinks.size() != 1 || !out->outlinks.front()->IsStmt() ||
+          out->outlinks.front()->AsStmt().op_type() != "dequantize_abs_max") {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+void DequantLookupTableFuser::InsertNewNode(SSAGraph* graph,
+                                            const key2nodes_t& matched) {
+  auto* ids = matched.at("ids");
+  auto* table = matched.at("table");
+  auto* lookup_op = matched.at("lookup_op");
+  auto* dequant_scale = matched.at("dequant_scale");
+  auto* dequant_op = matched.at("dequant_op");
+  auto* dequant_out = matched.at("dequant_out");
+
+  auto* scope = lookup_op->stmt()->op()->scope();
+  auto& valid_places = lookup_op->stmt()->op()->valid_places();
+  float max_range = dequant_op->stmt()->op_info()->GetAttr<float>("max_range");
+  float scale = scope->FindVar(dequant_scale->arg()->name)
+                    ->GetMutable<lite::Tensor>()
+                    ->data<float>()[0];
+
+  // The table may be shared by several lookup_tables, it is converted to int8
+  // by the first one.
+  auto table_name = table->arg()->name;
+  auto* table_t = scope->FindVar(table_name)->GetMutable<lite::Tensor>();
+  CHECK_EQ(table_t->dims().size(), 2UL);
+  int64_t rows = table_t->dims()[0];
+  int64_t width = table_t->dims()[1];
+  if (table_t->precision() != PRECISION(kInt8)) {
+    Tensor temp_tensor;
+    temp_tensor.CopyDataFrom(*table_t);
+    const float* temp_data = temp_tensor.data<float>();
+    int8_t* table_data = table_t->mutable_data<int8_t>();
+    for (int64_t i = 0; i < rows * width; i++) {
+      table_data[i] = static_cast<int8_t>(temp_data[i]);
+    }
+    table_t->set_persistable(true);
+    table_t->set_precision(PRECISION(kInt8));
+  }
+
+  cpp::OpDesc op_desc = *lookup_op->stmt()->op_info();
+  op_desc.SetOutput("Out", {dequant_out->arg()->name});
+  op_desc.SetAttr("enable_int8", true);
+  op_desc.SetAttr<int>("bit_length", 8);
+  op_desc.SetAttr<int64_t>("row_width", width);
+
+  // The scale differs by dequantize op, and so does the row scale.
+  std::string scale_name =
+      table_name + "." + dequant_scale->arg()->name + ".row_scale";
+  auto* scale_node = CreateRowScale(graph, scope, scale_name, rows);
+  // dequantize_abs_max computes out = x * scale / max_range.
+  auto* scale_t = scope->FindVar(scale_name)->GetMutable<lite::Tensor>();
+  float* scale_data = scale_t->mutable_data<float>();
+  for (int64_t i = 0; i < rows; i++) {
+    scale_data[i] = scale / max_range;
+  }
+  op_desc.SetInput("Scale", {scale_name});
+
+  auto new_lookup_op = LiteOpRegistry::Global().Create("lookup_table");
+  new_lookup_op->Attach(op_desc, scope);
+  auto* new_lookup_node =
+      graph->GraphCreateInstructNode(new_lookup_op, valid_places);
+
+  IR_NODE_LINK_TO(scale_node, new_lookup_node);
+  IR_NODE_LINK_TO(ids, new_lookup_node);
+  IR_NODE_LINK_TO(table, new_lookup_node);
+  IR_NODE_LINK_TO(new_lookup_node, dequant_out);
+}
+
+cpp::OpDesc DequantLookupTableFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc;
+  return op_desc;
+}
+
+void QuantizeLookupTableFuser::BuildPattern() {
+  auto* table = VarNode("table")->assert_is_op_input("lookup_table", "W");
+  auto* lookup_op = OpNode("lookup_op", "lookup_table")
+                        ->assert_is_op("lookup_table")
+                        ->assert_op_attr_satisfied<int>(
+                            "bit_length", [](const int& bits) {
+                              return bits == 8 || bits == 4;
+                            });
+  lookup_op->LinksFrom({table});
+  VLOG(4) << "QuantizeLookupTableFuser BuildPattern";
+}
+
+bool QuantizeLookupTableFuser::IsValidMatch(const key2nodes_t& matched) {
+  auto* lookup_op = matched.at("lookup_op");
+  int bit_length = lookup_op->AsStmt().op_info()->GetAttr<int>("bit_length");
+  if (IsInt8Lookup(lookup_op, bit_length)) return false;
+  // A table shared with a lookup_table of another bit_length, or one without
+  // it, stays in float.
+  return AllConsumersQuantized(matched.at("table"), [&](Node* op) {
+    auto* op_info = op->AsStmt().op_info();
+    return op_info->HasAttr("bit_length") &&
+           op_info->GetAttr<int>("bit_length") == bit_length;
+  });
+}
+
+void QuantizeLookupTableFuser::InsertNewNode(SSAGraph* graph,
+                                             const key2nodes_t& matched) {
+  auto* table = matched.at("table");
+  auto* lookup_op = matched.at("lookup_op");
+  auto& stmt = lookup_op->AsStmt();
+  auto* op_info = stmt.op_info();
+  auto* scope = stmt.op()->scope();
+  int bit_length = op_info->GetAttr<int>("bit_length");
+  auto table_name = table->arg()->name;
+  auto* table_t = scope->FindVar(table_name)->GetMutable<lite::Tensor>();
+  CHECK_EQ(table_t->dims().size(), 2UL);
+  int64_t rows = table_t->dims()[0];
+  int64_t width = table_t->dims()[1];
+
+  // The table may be shared by several lookup_tables, it is quantized by the
+  // first one, the others reuse its row scales.
+  std::string scale_name = table_name + ".row_scale";
+  auto* scale_node = CreateRowScale(graph, scope, scale_name, rows);
+  IR_NODE_LINK_TO(scale_node, lookup_op);
+  auto* scale_t = scope->FindVar(scale_name)->GetMutable<lite::Tensor>();
+  auto it = row_widths_.find(table_name);
+  if (it != row_widths_.end()) {
+    CHECK_EQ(width, host::math::QuantizedRowBytes(it->second, bit_length))
+        << "The shared table " << table_name
+        << " is quantized with another bit_length";
+    width = it->second;
+  } else {
+    CHECK(table_t->precision() != PRECISION(kInt8))
+        << "The table " << table_name << " is already quantized";
+    Tensor temp_tensor;
+    temp_tensor.CopyDataFrom(*table_t);
+    table_t->Resize({rows, host::math::QuantizedRowBytes(width, bit_length)});
+    host::math::QuantizeRowwise(temp_tensor.data<float>(),
+                                rows,
+                                width,
+                                bit_length,
+                                table_t->mutable_data<int8_t>(),
+                                scale_t->mutable_data<float>());
+    table_t->set_persistable(true);
+    table_t->set_precision(PRECISION(kInt8));
+    row_widths_[table_name] = width;
+  }
+
+  cpp::OpDesc op_desc = *op_info;
+  op_desc.SetInput("Scale", {scale_name});
+  op_desc.SetAttr("enable_int8", true);
+  op_desc.SetAttr<int64_t>("row_width", width);
+  stmt.ResetOp(op_desc, graph->valid_places());
+}
+
+cpp::OpDesc QuantizeLookupTableFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc;
+  return op_desc;
+}
+
 }  // namespace fusion
 }  // namespace mir
 }  // namespace lite
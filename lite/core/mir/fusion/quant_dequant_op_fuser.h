@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include "lite/core/mir/pattern_matcher_high_api.h"
@@ -84,6 +85,44 @@ class DeleteQuantDequantOpFuser : public FuseBase {
   std::string quantized_op_type_{};
 };
 
+/* The embedding tables quantized by PaddleSlim store the int8 values in W,
+ * and the looked-up rows are dequantized by a following dequantize_abs_max op.
+ * The fuser converts W to an int8 tensor, folds the scale into a per-row scale
+ * input of the lookup_table and deletes the dequantize op, so that the rows
+ * are dequantized on the fly by the lookup_table kernel.
+*/
+
+class DequantLookupTableFuser : public FuseBase {
+ public:
+  DequantLookupTableFuser() = default;
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+  bool IsValidMatch(const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+};
+
+/* The float embedding tables whose lookup_table op has the attr bit_length (8
+ * or 4) are quantized row-wise by this fuser, only the weight is quantized,
+ * the output of the lookup_table stays in float.
+*/
+
+class QuantizeLookupTableFuser : public FuseBase {
+ public:
+  QuantizeLookupTableFuser() = default;
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+  bool IsValidMatch(const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+
+ private:
+  // The float row width of the tables quantized by this fuser.
+  std::map<std::string, int64_t> row_widths_;
+};
+
 }  // namespace fusion
 }  // namespace mir
 }  // namespace lite
@@ -18,6 +18,7 @@
 #include <vector>
 #include "lite/core/mir/graph_visualize_pass.h"
 #include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/view_op_inplace_pass.h"
 #include "lite/core/type_system.h"
 
 namespace paddle {
@@ -31,6 +32,59 @@ typedef struct {
   std::unordered_set<std::string> adj;
 } MemNode;
 
+// The vars which inputs or outputs are invalid op will not be reused.
+bool MemoryOptimizePass::IsValidVar(Node* node) const {
+  std::set<std::string> invalid_op = {"while",
+                                      "conditional_block",
+                                      "conditional_block_infer",
+                                      "merge_lod_tensor_infer",
+                                      "merge_lod_tensor",
+                                      "equal",
+                                      "lod_reset",
+                                      "concat",
+                                      "yolo_box",
+                                      "graph_op",
+                                      "feed",
+                                      "fetch"};
+  // The outputs of these ops only depend on the input shapes, their kernels
+  // skip the computation until the shapes change, so the outputs must be
+  // kept intact.
+  std::set<std::string> cached_op = {
+      "prior_box", "density_prior_box", "anchor_generator"};
+  for (auto* tmp : node->inlinks) {
+    CHECK(tmp->IsStmt());
+    std::string op_type = tmp->AsStmt().op_info()->Type();
+    if (std::find(invalid_op.begin(), invalid_op.end(), op_type) !=
+            invalid_op.end() ||
+        cached_op.count(op_type)) {
+      return false;
+    }
+  }
+  for (auto* tmp : node->outlinks) {
+    CHECK(tmp->IsStmt());
+    std::string op_type = tmp->AsStmt().op_info()->Type();
+    if (std::find(invalid_op.begin(), invalid_op.end(), op_type) !=
+        invalid_op.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MemoryOptimizePass::CollectViews(SSAGraph* graph) {
+  view_roots_.clear();
+  for (auto& op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt()) continue;
+    auto in_name = ViewOpInplacePass::ViewedVar(op_node);
+    if (in_name.empty()) continue;
+    std::string root =
+        view_roots_.count(in_name) ? view_roots_[in_name] : in_name;
+    for (auto& out_name : op_node->AsStmt().op_info()->Output("Out")) {
+      view_roots_[out_name] = root;
+    }
+  }
+}
+
 void MemoryOptimizePass::CollectLifeCycleByDevice(
     std::unordered_map<std::string, lifecycle_map_t>* lifecycles,
     SSAGraph* graph) {
@@ -39,38 +93,6 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
   auto is_host = [](TargetType x) -> bool {
     return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
   };
-  // The vars which inputs or outputs are invalid op will not be reused.
-  auto valid_var = [&](Node* node) -> bool {
-    std::set<std::string> invalid_op = {"while",
-                                        "conditional_block",
-                                        "conditional_block_infer",
-                                        "merge_lod_tensor_infer",
-                                        "merge_lod_tensor",
-                                        "equal",
-                                        "lod_reset",
-                                        "concat",
-                                        "yolo_box",
-                                        "graph_op",
-                                        "feed",
-                                        "fetch"};
-    for (auto* tmp : node->inlinks) {
-      CHECK(tmp->IsStmt());
-      std::string op_type = tmp->AsStmt().op_info()->Type();
-      if (std::find(invalid_op.begin(), invalid_op.end(), op_type) !=
-          invalid_op.end()) {
-        return false;
-      }
-    }
-    for (auto* tmp : node->outlinks) {
-      CHECK(tmp->IsStmt());
-      std::string op_type = tmp->AsStmt().op_info()->Type();
-      if (std::find(invalid_op.begin(), invalid_op.end(), op_type) !=
-          invalid_op.end()) {
-        return false;
-      }
-    }
-    return true;
-  };
 
   for (auto& op_node : graph->StmtTopologicalOrder()) {
     if (op_node->IsStmt()) {
@@ -82,19 +104,29 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
         CHECK(node->IsArg());
         auto& arg = node->AsArg();
         if (arg.is_weight || arg.is_persist) continue;
-        if (!valid_var(node)) continue;
         std::string var_name = arg.name;
         TargetType target_type = node->AsArg().type->target();
         if (is_host(target_type)) target_type = TARGET(kHost);
+        auto& lifecycle = (*lifecycles)[TargetToStr(target_type)];
+
+        // A view is not reused, the var it shares the buffer with lives as
+        // long as the view does. The var is absent when it is not reusable.
+        auto root = view_roots_.find(var_name);
+        if (root != view_roots_.end()) {
+          if (lifecycle.count(root->second)) {
+            auto& life = lifecycle[root->second];
+            life.second = std::max(max_lifecycle_, life.second);
+          }
+          continue;
+        }
+        if (!IsValidVar(node)) continue;
 
-        if (!(*lifecycles)[TargetToStr(target_type)].count(var_name)) {
-          (*lifecycles)[TargetToStr(target_type)].emplace(
-              var_name, std::make_pair(max_lifecycle_, max_lifecycle_));
+        if (!lifecycle.count(var_name)) {
+          lifecycle.emplace(var_name,
+                            std::make_pair(max_lifecycle_, max_lifecycle_));
         } else {
-          int cur_life =
-              (*lifecycles)[TargetToStr(target_type)][var_name].second;
-          (*lifecycles)[TargetToStr(target_type)][var_name].second =
-              std::max(max_lifecycle_, cur_life);
+          int cur_life = lifecycle[var_name].second;
+          lifecycle[var_name].second = std::max(max_lifecycle_, cur_life);
         }
       }
       ++max_lifecycle_;
@@ -242,6 +274,7 @@ void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // 3. Perform reuse plan: Replace all var's name in the model according to the
   // mapping table.
   std::unordered_map<std::string, lifecycle_map_t> lifecycles;
+  CollectViews(graph.get());
   CollectLifeCycleByDevice(&lifecycles, graph.get());
   for (auto& ele : lifecycles) {
     std::unordered_map<std::string, std::string> node2cluster;
@@ -42,6 +42,11 @@ class MemoryOptimizePass : public ProgramPass {
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
 
  private:
+  // Collect the views output by the ops view_op_inplace_pass marked. The views
+  // are not reused, and the lifetime of a viewed var is extended to the last
+  // use of its views.
+  void CollectViews(SSAGraph* graph);
+  bool IsValidVar(Node* node) const;
   void CollectLifeCycleByDevice(
       std::unordered_map<std::string, lifecycle_map_t>* lifecycles, SSAGraph*);
   void MakeReusePlan(
@@ -53,6 +58,8 @@ class MemoryOptimizePass : public ProgramPass {
 
  private:
   int max_lifecycle_{-1};
+  // The view output var -> the var whose buffer it shares.
+  std::unordered_map<std::string, std::string> view_roots_;
 };
 
 }  // namespace mir
@@ -116,13 +116,63 @@ void PatternMatcher::operator()(SSAGraph *graph,
 bool PatternMatcher::MarkPMNodesInGraph(SSAGraph *graph) {
   VLOG(3) << "mark pmnodes in graph";
   if (graph->nodes().empty()) return false;
+  pmnodes2nodes_.clear();
+
+  std::vector<Node *> all_nodes;
+  std::unordered_map<std::string, std::vector<Node *>> stmts_by_type;
   for (auto &node : graph->mutable_nodes()) {
-    for (const auto &pmnode : pattern_.nodes()) {
-      if (pmnode->Tell(&node)) {
-        pmnodes2nodes_[pmnode.get()].insert(&node);
+    all_nodes.push_back(&node);
+    if (node.IsStmt() && node.stmt()->op()) {
+      stmts_by_type[node.stmt()->op_type()].push_back(&node);
+    }
+  }
+
+  // 1. The PMNodes with an asserted op type only test the statements of that
+  // type.
+  std::unordered_set<const PMNode *> marked;
+  for (auto &pmnode : pattern_.nodes()) {
+    if (!pmnode->HasAssertedOpType()) continue;
+    auto it = stmts_by_type.find(pmnode->asserted_op_type());
+    if (it != stmts_by_type.end()) {
+      MarkPMNode(pmnode.get(), it->second);
+    }
+    marked.insert(pmnode.get());
+  }
+
+  // 2. A subgraph only contains the linked nodes, so a PMNode linked to a
+  // marked PMNode only tests the neighbours of its candidates.
+  bool changed = !marked.empty();
+  while (changed) {
+    changed = false;
+    for (const auto &edge : pattern_.edges()) {
+      bool forward = marked.count(edge.first) && !marked.count(edge.second);
+      bool backward = !marked.count(edge.first) && marked.count(edge.second);
+      if (!forward && !backward) continue;
+      auto *known = forward ? edge.first : edge.second;
+      auto *unknown = forward ? edge.second : edge.first;
+      std::unordered_set<Node *> visited;
+      std::vector<Node *> neighbours;
+      auto it = pmnodes2nodes_.find(known);
+      if (it != pmnodes2nodes_.end()) {
+        for (auto *node : it->second) {
+          for (auto *x : forward ? node->outlinks : node->inlinks) {
+            if (visited.insert(x).second) neighbours.push_back(x);
+          }
+        }
       }
+      MarkPMNode(unknown, neighbours);
+      marked.insert(unknown);
+      changed = true;
     }
   }
+
+  // 3. Test the remaining PMNodes against the whole graph.
+  for (auto &pmnode : pattern_.nodes()) {
+    if (!marked.count(pmnode.get())) {
+      MarkPMNode(pmnode.get(), all_nodes);
+    }
+  }
+
   // Check to early stop if some PMNode can't find matched Node.
   for (auto &pmnode : pattern_.nodes()) {
     if (!pmnodes2nodes_.count(pmnode.get())) {
@@ -135,6 +185,15 @@ bool PatternMatcher::MarkPMNodesInGraph(SSAGraph *graph) {
   return !pmnodes2nodes_.empty();
 }
 
+void PatternMatcher::MarkPMNode(const PMNode *pmnode,
+                                const std::vector<Node *> &nodes) {
+  for (auto *node : nodes) {
+    if (pmnode->Tell(node)) {
+      pmnodes2nodes_[pmnode].insert(node);
+    }
+  }
+}
+
 // The intermediate Nodes can only link to the nodes inside the pattern, or this
 // subgraph will be droped.
 void PatternMatcher::ValidateByNodeRole(
@@ -191,16 +250,6 @@ struct HitGroup {
   std::unordered_set<Node *> nodes_;
 };
 
-// Tell whether Node a links to b.
-bool IsNodesLink(Node *a, Node *b) {
-  for (auto *node : a->outlinks) {
-    if (b == node) {
-      return true;
-    }
-  }
-  return false;
-}
-
 std::vector<PatternMatcher::subgraph_t> PatternMatcher::DetectPatterns() {
   // Init empty subgraphs.
   std::vector<PatternMatcher::subgraph_t> result;
@@ -230,20 +279,40 @@ std::vector<PatternMatcher::subgraph_t> PatternMatcher::DetectPatterns() {
     cur_groups.clear();
     if (pre_groups.empty()) break;
     // source -> target
-    for (Node *source : pmnodes2nodes_[edge.first]) {
-      for (Node *target : pmnodes2nodes_[edge.second]) {
-        // TODO(Superjomn) add some prune strategies.
-        for (const auto &group : pre_groups) {
-          if (IsNodesLink(source, target)) {
-            HitGroup new_group = group;
-            bool flag = new_group.Match(source, edge.first) &&
-                        new_group.Match(target, edge.second);
-            if (flag) {
-              new_group.Register(source, edge.first);
-              new_group.Register(target, edge.second);
-              cur_groups.push_back(new_group);
-              // TODO(Superjomn) need to unique
-            }
+    // Follow the links of the node already bound in a group, rather than
+    // testing every pair of the candidates.
+    const auto &sources = pmnodes2nodes_[edge.first];
+    const auto &targets = pmnodes2nodes_[edge.second];
+    for (const auto &group : pre_groups) {
+      auto extend = [&](Node *source, Node *target) {
+        HitGroup new_group = group;
+        bool flag = new_group.Match(source, edge.first) &&
+                    new_group.Match(target, edge.second);
+        if (flag) {
+          new_group.Register(source, edge.first);
+          new_group.Register(target, edge.second);
+          cur_groups.push_back(new_group);
+          // TODO(Superjomn) need to unique
+        }
+      };
+      auto source_it = group.roles.find(edge.first);
+      auto target_it = group.roles.find(edge.second);
+      if (source_it != group.roles.end()) {
+        Node *source = source_it->second;
+        if (!sources.count(source)) continue;
+        for (auto *target : source->outlinks) {
+          if (targets.count(target)) extend(source, target);
+        }
+      } else if (target_it != group.roles.end()) {
+        Node *target = target_it->second;
+        if (!targets.count(target)) continue;
+        for (auto *source : target->inlinks) {
+          if (sources.count(source)) extend(source, target);
+        }
+      } else {
+        for (Node *source : sources) {
+          for (auto *target : source->outlinks) {
+            if (targets.count(target)) extend(source, target);
           }
         }
       }
@@ -366,6 +435,7 @@ PMNode *PMNode::assert_is_op() {
 }
 
 PMNode *PMNode::assert_is_op(const std::string &op_type) {
+  if (asserted_op_type_.empty()) asserted_op_type_ = op_type;
   asserts_.emplace_back([op_type](const Node *x) {
     if (x && x->IsStmt()) {
       auto *op_info = x->stmt()->op_info();
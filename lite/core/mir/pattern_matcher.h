@@ -77,6 +77,14 @@ struct PMNode {
     return true;
   }
 
+  // Whether the node only matches the statements of one op type, set by
+  // `assert_is_op(op_type)`. Such nodes are seeded from an op type index
+  // instead of testing every node in the graph.
+  bool HasAssertedOpType() const {
+    return !teller_ && !asserted_op_type_.empty();
+  }
+  const std::string& asserted_op_type() const { return asserted_op_type_; }
+
   bool IsOp() const { return type_ == Type::kOp; }
   bool IsVar() const { return type_ == Type::kVar; }
 
@@ -187,6 +195,7 @@ struct PMNode {
   PMPattern* pattern_;
   std::string name_;
   std::string op_type_;
+  std::string asserted_op_type_;
   Type type_;
   Role role_{Role::kUnknown};
 };
@@ -256,9 +265,11 @@ class PMPattern {
  * This helper can be used to support fuse(conv+batchnorm => batchnorm e.g.).
  *
  * The algorithm has three phases:
- *   1. Mark the nodes that match the defined PMNodes in a PMPattern,
+ *   1. Mark the nodes that match the defined PMNodes in a PMPattern, the
+ *      PMNodes with an asserted op type are seeded from an op type index, and
+ *      the PMNodes linked to the marked ones only test their neighbours,
  *   2. Extend a PMNode to subgraphs by deducing the connection relation defined
- *      in PAPattern(the edges),
+ *      in PAPattern(the edges), following the links of the matched nodes,
  *   3. Get the filtered subgraphs and treat them with a pre-defined handler.
  *
  * Usage:
@@ -293,6 +304,9 @@ class PatternMatcher {
   // Mark the nodes that fits the pattern.
   bool MarkPMNodesInGraph(SSAGraph* graph);
 
+  // Mark the candidates of `pmnode` among `nodes`.
+  void MarkPMNode(const PMNode* pmnode, const std::vector<Node*>& nodes);
+
   // Detect all the pattern and output the hit records.
   std::vector<subgraph_t> DetectPatterns();
 
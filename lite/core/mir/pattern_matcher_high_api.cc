@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/core/mir/pattern_matcher_high_api.h"
+#include <utility>
 #include "lite/utils/cp_logging.h"
 
 namespace paddle {
@@ -24,9 +25,12 @@ void FuseBase::PerformPatternMatcher(SSAGraph *graph) {
   // Get subgraphs and record the mir::Node pointers for each PMNode.
   auto handler = [&](const PatternMatcher::subgraph_t &subgraph, SSAGraph *g) {
     // get all the reigistered nodes.
-    key2nodes_.emplace_back();
+    key2nodes_t matched;
     for (auto &item : nodes_) {
-      key2nodes_.back()[item.first] = subgraph.at(item.second);
+      matched[item.first] = subgraph.at(item.second);
+    }
+    if (IsValidMatch(matched)) {
+      key2nodes_.push_back(std::move(matched));
     }
   };
 
@@ -53,6 +53,10 @@ class FuseBase {
     return cpp::OpDesc();
   }
 
+  // Whether a matched subgraph can be fused, the checks which involve several
+  // nodes go here. The subgraphs failing it are left as they are.
+  virtual bool IsValidMatch(const key2nodes_t& matched) { return true; }
+
   PMNode* OpNode(const std::string& key) {
     return GetOrCreateNode(key)->assert_is_op();
   }
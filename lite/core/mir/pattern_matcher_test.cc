@@ -15,6 +15,10 @@
 #include "lite/core/mir/pattern_matcher.h"
 
 #include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include "lite/core/scope.h"
 
 namespace paddle {
 namespace lite {
@@ -228,6 +232,83 @@ TEST(PatternMatcher, IntermediateCheck) {
   ASSERT_EQ(count, 1);
 }
 
+// An op that only carries an op type, to build large graphs without the
+// registered ops and kernels.
+class FakeOp : public OpLite {
+ public:
+  explicit FakeOp(const std::string& type) : OpLite(type) {}
+  std::string DebugString() const override { return "fake"; }
+  void AttachKernel(KernelBase* kernel) override {}
+
+ protected:
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+};
+
+// Build a chain of `num_ops` ops alternating between mul and elementwise_add:
+//   var0 -> mul -> var1 -> elementwise_add -> var2 -> mul -> ...
+void BuildLargeGraph(SSAGraph* g, lite::Scope* scope, int num_ops) {
+  g->mutable_nodes().emplace_back();
+  Node* var = &g->mutable_nodes().back();
+  var->AsArg("var0");
+  for (int i = 0; i < num_ops; ++i) {
+    cpp::OpDesc desc;
+    desc.SetType(i % 2 ? "elementwise_add" : "mul");
+    std::shared_ptr<OpLite> op(new FakeOp(desc.Type()));
+    op->Attach(desc, scope);
+    g->mutable_nodes().emplace_back();
+    Node* op_node = &g->mutable_nodes().back();
+    op_node->AsStmt(desc.Type(), {}, op);
+    g->mutable_nodes().emplace_back();
+    Node* out = &g->mutable_nodes().back();
+    out->AsArg("var" + std::to_string(i + 1));
+    IR_NODE_LINK_TO(var, op_node);
+    IR_NODE_LINK_TO(op_node, out);
+    var = out;
+  }
+}
+
+// Benchmark the matcher on a synthetic program with 50k ops.
+TEST(PatternMatcher, LargeGraph) {
+  const int num_ops = 50000;
+  lite::Scope scope;
+  SSAGraph graph;
+  BuildLargeGraph(&graph, &scope, num_ops);
+
+  PatternMatcher matcher;
+  auto* pattern = matcher.mutable_pattern();
+  auto* mul = pattern->NewNode("mul")->AsOp("mul");
+  auto* mul_out = pattern->NewNode("mul_out")
+                      ->assert_is_op_output("mul")
+                      ->assert_is_op_input("elementwise_add")
+                      ->AsIntermediate();
+  auto* add = pattern->NewNode("add")->AsOp("elementwise_add");
+  mul->LinksTo({mul_out});
+  mul_out->LinksTo({add});
+
+  std::unordered_set<const Node*> nodes2rm;
+  auto start = std::chrono::steady_clock::now();
+  matcher(&graph, [&](const PatternMatcher::subgraph_t& s, SSAGraph* g) {
+    nodes2rm.insert(s.at(mul_out));
+  });
+  auto match_end = std::chrono::steady_clock::now();
+  GraphSafeRemoveNodes(&graph, nodes2rm);
+  auto remove_end = std::chrono::steady_clock::now();
+  auto order = graph.StmtTopologicalOrder();
+  auto sort_end = std::chrono::steady_clock::now();
+
+  using ms = std::chrono::duration<double, std::milli>;
+  LOG(INFO) << num_ops << " ops, match: " << ms(match_end - start).count()
+            << " ms, remove: " << ms(remove_end - match_end).count()
+            << " ms, topological sort: " << ms(sort_end - remove_end).count()
+            << " ms";
+  EXPECT_EQ(nodes2rm.size(), static_cast<size_t>(num_ops / 2));
+  EXPECT_EQ(order.size(), static_cast<size_t>(num_ops));
+  EXPECT_EQ(graph.nodes().size(), static_cast<size_t>(2 * num_ops + 1) -
+                                      nodes2rm.size());
+}
+
 }  // namespace mir
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,208 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/sparse_weight_pass.h"
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "lite/backends/host/math/sparse_gemm.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+constexpr float SparseWeightPass::kMaxDensity;
+constexpr int SparseWeightPass::kMinWeightSize;
+
+Node* SparseWeightPass::SparseCandidate(Node* node,
+                                        const std::string& weight_arg) const {
+  auto& stmt = node->AsStmt();
+  auto* op_info = stmt.op_info();
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return nullptr;
+  }
+  if (!op_info->HasInput(weight_arg) ||
+      op_info->Input(weight_arg).size() != 1) {
+    return nullptr;
+  }
+  const auto name = op_info->Input(weight_arg).front();
+  for (auto* in : node->inlinks) {
+    if (!in->IsArg() || in->AsArg().name != name) continue;
+    // The weights shared with other ops are kept dense.
+    if (!in->AsArg().is_weight || in->outlinks.size() != 1) return nullptr;
+    auto* var = stmt.op()->scope()->FindVar(name);
+    if (!var || !var->IsType<lite::Tensor>()) return nullptr;
+    const auto& tensor = var->Get<lite::Tensor>();
+    if (tensor.precision() != PRECISION(kFloat) || !tensor.IsInitialized() ||
+        tensor.numel() < kMinWeightSize) {
+      return nullptr;
+    }
+    return in;
+  }
+  return nullptr;
+}
+
+const DDim& SparseWeightPass::WeightDims(Node* node, Node* weight) const {
+  return node->AsStmt()
+      .op()
+      ->scope()
+      ->FindVar(weight->AsArg().name)
+      ->Get<lite::Tensor>()
+      .dims();
+}
+
+bool SparseWeightPass::Is1x1Conv(const OpInfo& op_info,
+                                 const DDim& filter_dims) const {
+  if (filter_dims.size() != 4 || filter_dims[2] != 1 || filter_dims[3] != 1 ||
+      op_info.GetAttr<int>("groups") != 1) {
+    return false;
+  }
+  if (op_info.HasInput("ResidualData") &&
+      !op_info.Input("ResidualData").empty()) {
+    return false;
+  }
+  for (auto x : op_info.GetAttr<std::vector<int>>("strides")) {
+    if (x != 1) return false;
+  }
+  for (auto x : op_info.GetAttr<std::vector<int>>("paddings")) {
+    if (x != 0) return false;
+  }
+  for (auto x : op_info.GetAttr<std::vector<int>>("dilations")) {
+    if (x != 1) return false;
+  }
+  return true;
+}
+
+bool SparseWeightPass::Sparsify(SSAGraph* graph,
+                                Node* node,
+                                Node* weight,
+                                int rows,
+                                int cols,
+                                const std::vector<std::vector<int>>& blocks) {
+  auto& stmt = node->AsStmt();
+  auto* scope = stmt.op()->scope();
+  const auto name = weight->AsArg().name;
+  const auto& tensor = scope->FindVar(name)->Get<lite::Tensor>();
+  CHECK_EQ(tensor.numel(), static_cast<int64_t>(rows) * cols);
+  const float* dense = tensor.data<float>();
+
+  for (const auto& block : blocks) {
+    const int block_h = block[0];
+    const int block_w = block[1];
+    if (rows % block_h != 0 || cols % block_w != 0) continue;
+    const int num_blocks = host::math::CountNonzeroBlocks(
+        dense, rows, cols, block_h, block_w);
+    const float density = static_cast<float>(num_blocks) * block_h * block_w /
+                          (static_cast<float>(rows) * cols);
+    if (num_blocks == 0 || density > kMaxDensity) continue;
+
+    std::vector<float> values;
+    std::vector<int> index;
+    host::math::DenseToBlockCsr(
+        dense, rows, cols, block_h, block_w, &values, &index);
+    const std::string values_name = name + "@sparse";
+    const std::string index_name = name + "@sparse_index";
+    auto* values_t = scope->Var(values_name)->GetMutable<lite::Tensor>();
+    values_t->Resize({num_blocks, block_h, block_w});
+    std::copy(values.begin(), values.end(), values_t->mutable_data<float>());
+    values_t->set_precision(PRECISION(kFloat));
+    values_t->set_persistable(true);
+    auto* index_t = scope->Var(index_name)->GetMutable<lite::Tensor>();
+    index_t->Resize({static_cast<int64_t>(index.size())});
+    std::copy(index.begin(), index.end(), index_t->mutable_data<int>());
+    index_t->set_precision(PRECISION(kInt32));
+    index_t->set_persistable(true);
+
+    auto dims = tensor.dims().Vectorize();
+    cpp::OpDesc desc = *stmt.op_info();
+    for (auto& item : *desc.mutable_inputs()) {
+      if (item.second == std::vector<std::string>({name})) {
+        desc.mutable_inputs()->erase(item.first);
+        break;
+      }
+    }
+    desc.SetInput("SparseWeight", {values_name});
+    desc.SetInput("SparseIndex", {index_name});
+    desc.SetAttr("sparse_weight_dims",
+                 std::vector<int>(dims.begin(), dims.end()));
+    desc.SetAttr("sparse_block", std::vector<int>({block_h, block_w}));
+
+    // The dense weight stays in the scope, the original program may still be
+    // optimized again from it, e.g. by a clone of the predictor.
+    GraphSafeRemoveNodes(graph, {weight});
+    for (auto& arg : {values_name, index_name}) {
+      auto* arg_node = graph->NewArgumentNode(arg);
+      arg_node->AsArg().is_weight = true;
+      DirectedLink(arg_node, node);
+    }
+    stmt.ResetOp(desc, graph->valid_places());
+    VLOG(3) << "sparse " << stmt.op_type() << " weight " << name << " with "
+            << block_h << "x" << block_w << " blocks, density " << density;
+    return true;
+  }
+  return false;
+}
+
+void SparseWeightPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The kernels of the other targets do not take sparse weights.
+  for (auto& place : graph->valid_places()) {
+    if (place.target != TARGET(kX86) && place.target != TARGET(kHost)) {
+      return;
+    }
+  }
+  int count = 0;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto* op_info = node->AsStmt().op_info();
+    const auto& op_type = op_info->Type();
+    if (op_type == "mul") {
+      auto* weight = SparseCandidate(node, "Y");
+      if (!weight) continue;
+      auto matrix = WeightDims(node, weight)
+                        .Flatten2D(op_info->GetAttr<int>("y_num_col_dims"));
+      count += Sparsify(graph.get(),
+                        node,
+                        weight,
+                        matrix[0],
+                        matrix[1],
+                        {{1, 16}, {1, 8}, {1, 4}, {1, 1}});
+    } else if (op_type == "conv2d") {
+      auto* weight = SparseCandidate(node, "Filter");
+      if (!weight) continue;
+      const auto& dims = WeightDims(node, weight);
+      if (!Is1x1Conv(*op_info, dims)) continue;
+      count += Sparsify(graph.get(),
+                        node,
+                        weight,
+                        dims[0],
+                        dims[1],
+                        {{8, 1}, {4, 1}, {1, 1}});
+    }
+  }
+  VLOG(3) << "sparse weights: " << count;
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(sparse_weight_pass, paddle::lite::mir::SparseWeightPass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("mul",
+                paddle::lite_api::Place{TARGET(kX86), PRECISION(kFloat)})
+    .BindKernel("conv2d",
+                paddle::lite_api::Place{TARGET(kX86), PRECISION(kFloat)});
@@ -0,0 +1,66 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * SparseWeightPass replaces the pruned weights of the `mul` and the 1x1
+ * `conv2d` ops by their nonzero blocks in the block-CSR format of
+ * lite/backends/host/math/sparse_gemm.h, the "SparseWeight" and
+ * "SparseIndex" inputs of the op. The dense weight is dropped from the
+ * program, so an optimized model only stores the blocks and their index.
+ *
+ * A weight is only replaced if its blocks with a nonzero hold at most
+ * `kMaxDensity` of it, with the largest block size for which it is the case:
+ * a block is a part of a row of the weight of a `mul`, its right operand, and
+ * a part of a column of the [oc, ic] filter of a `conv2d`, its left operand,
+ * so that the loops of the kernels over a block are vectorized.
+ */
+class SparseWeightPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  static constexpr float kMaxDensity = 0.3f;
+  // The smaller weights are not worth an index.
+  static constexpr int kMinWeightSize = 1024;
+
+ private:
+  // The weight of a `mul` or a `conv2d` input of `node`, nullptr if it can not
+  // be sparse.
+  Node* SparseCandidate(Node* node, const std::string& weight_arg) const;
+  const DDim& WeightDims(Node* node, Node* weight) const;
+  bool Is1x1Conv(const OpInfo& op_info, const DDim& filter_dims) const;
+
+  // Replace `weight`, a [rows, cols] matrix, by its blocks of the first size
+  // of `blocks`, {block_h, block_w}, which is sparse enough.
+  bool Sparsify(SSAGraph* graph,
+                Node* node,
+                Node* weight,
+                int rows,
+                int cols,
+                const std::vector<std::vector<int>>& blocks);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
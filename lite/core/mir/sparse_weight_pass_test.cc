@@ -0,0 +1,135 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/sparse_weight_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Op list:
+// (feed)->feed->(x)->mul(w_sparse)->(y)->mul(w_dense)->(out)
+// After pass, the first mul takes the blocks of w_sparse.
+std::unique_ptr<SSAGraph> BuildGraph(cpp::ProgramDesc* program_desc,
+                                     const std::shared_ptr<Scope>& scope,
+                                     const std::vector<Place>& valid_places) {
+  auto* main_block = program_desc->AddBlock<cpp::BlockDesc>();
+  for (auto name : {"w_sparse", "w_dense", "x", "y", "out"}) {
+    auto* var = main_block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(std::string(name).find("w_") == 0);
+  }
+
+  auto add_weight = [&](const std::string& name, bool sparse) {
+    auto* w = scope->Var(name)->GetMutable<lite::Tensor>();
+    w->Resize({64, 64});
+    auto* w_data = w->mutable_data<float>();
+    for (int i = 0; i < w->numel(); i++) {
+      // One block of 16 columns out of four is nonzero.
+      w_data[i] = !sparse || i / 16 % 4 == 1 ? i % 7 + 1.f : 0.f;
+    }
+    w->set_precision(PRECISION(kFloat));
+    w->set_persistable(true);
+  };
+  add_weight("w_sparse", true);
+  add_weight("w_dense", false);
+
+  auto* feed_op = main_block->AddOp<cpp::OpDesc>();
+  feed_op->SetType("feed");
+  feed_op->SetInput("X", {"feed"});
+  feed_op->SetOutput("Out", {"x"});
+  feed_op->SetAttr("col", 0);
+
+  auto add_mul = [&](
+      const std::string& x, const std::string& w, const std::string& out) {
+    auto* mul_op = main_block->AddOp<cpp::OpDesc>();
+    mul_op->SetType("mul");
+    mul_op->SetInput("X", {x});
+    mul_op->SetInput("Y", {w});
+    mul_op->SetOutput("Out", {out});
+    mul_op->SetAttr("x_num_col_dims", 1);
+    mul_op->SetAttr("y_num_col_dims", 1);
+  };
+  add_mul("x", "w_sparse", "y");
+  add_mul("y", "w_dense", "out");
+
+  lite::Program program(*program_desc, scope, valid_places);
+  auto graph = std::unique_ptr<SSAGraph>(new SSAGraph());
+  graph->Build(program, valid_places);
+  return graph;
+}
+
+TEST(sparse_weight_pass, mul) {
+  cpp::ProgramDesc program_desc;
+  std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)},
+                            {TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(&program_desc, scope, places);
+
+  auto pass = PassManager::Global().LookUp("sparse_weight_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto stmts = graph->StmtTopologicalOrder();
+  ASSERT_EQ(stmts.size(), 3UL);
+  auto* sparse_mul = stmts[1]->AsStmt().op_info();
+  EXPECT_FALSE(sparse_mul->HasInput("Y"));
+  ASSERT_TRUE(sparse_mul->HasInput("SparseWeight"));
+  EXPECT_EQ(sparse_mul->GetAttr<std::vector<int>>("sparse_block"),
+            std::vector<int>({1, 16}));
+  EXPECT_EQ(sparse_mul->GetAttr<std::vector<int>>("sparse_weight_dims"),
+            std::vector<int>({64, 64}));
+  int num_weights = 0;
+  for (auto* in : stmts[1]->inlinks) {
+    if (in->AsArg().is_weight) num_weights++;
+    EXPECT_NE(in->AsArg().name, "w_sparse");
+  }
+  EXPECT_EQ(num_weights, 2);
+
+  auto* exec_scope = stmts[1]->AsStmt().op()->scope();
+  auto& values =
+      exec_scope->FindVar(sparse_mul->Input("SparseWeight").front())
+          ->Get<lite::Tensor>();
+  EXPECT_TRUE(values.persistable());
+  EXPECT_EQ(values.dims(), DDim({64, 1, 16}));
+  auto& index = exec_scope->FindVar(sparse_mul->Input("SparseIndex").front())
+                    ->Get<lite::Tensor>();
+  EXPECT_EQ(index.numel(), 64 + 1 + 64);
+
+  auto* dense_mul = stmts[2]->AsStmt().op_info();
+  EXPECT_TRUE(dense_mul->HasInput("Y"));
+  EXPECT_FALSE(dense_mul->HasInput("SparseWeight"));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(mul);
+USE_LITE_KERNEL(mul, kX86, kFloat, kNCHW, def);
+USE_MIR_PASS(sparse_weight_pass);
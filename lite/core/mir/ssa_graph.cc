@@ -17,6 +17,7 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace paddle {
@@ -69,15 +70,26 @@ void SSAGraph::SortHelper(
     mir::Node *node,
     std::set<mir::Node *> *visited,
     std::vector<mir::Node *> *ret) {
+  // Depth first search with an explicit stack, the recursion overflows the
+  // call stack for the programs with tens of thousands of chained ops.
+  using adj_iterator = std::set<mir::Node *>::const_iterator;
+  std::vector<std::pair<mir::Node *, adj_iterator>> stack;
   visited->insert(node);
-
-  for (auto adj : adj_list.at(node)) {
+  stack.emplace_back(node, adj_list.at(node).begin());
+  while (!stack.empty()) {
+    auto *cur = stack.back().first;
+    auto &it = stack.back().second;
+    if (it == adj_list.at(cur).end()) {
+      ret->push_back(cur);
+      stack.pop_back();
+      continue;
+    }
+    auto *adj = *it++;
     if (visited->find(adj) == visited->end()) {
-      SortHelper(adj_list, adj, visited, ret);
+      visited->insert(adj);
+      stack.emplace_back(adj, adj_list.at(adj).begin());
     }
   }
-
-  ret->push_back(node);
 }
 
 std::vector<mir::Node *> SSAGraph::StmtTopologicalOrder() {
@@ -100,7 +112,7 @@ std::vector<mir::Node *> SSAGraph::StmtTopologicalOrder() {
 
 Node *SSAGraph::GraphCreateInstructNode(
     const std::shared_ptr<OpLite> &op, const std::vector<Place> &valid_places) {
-  node_storage_.emplace_back();
+  AppendNode();
   // TODO(Superjomn) remove one valid_places here.
   op->SetValidPlaces(valid_places);
   auto &new_node = node_storage_.back();
@@ -116,11 +128,10 @@ void SSAGraph::Build(const Program &program,
                      const std::vector<Place> &valid_places) {
   CHECK(node_storage_.empty());
 
-  auto weights_name = program.weights();
+  std::unordered_set<std::string> weights_name(program.weights().begin(),
+                                               program.weights().end());
   auto is_weights = [&](const std::string &name) -> bool {
-    auto it = std::find(weights_name.begin(), weights_name.end(), name);
-    if (it == weights_name.end()) return false;
-    return true;
+    return weights_name.count(name);
   };
 
   std::unordered_map<std::string, mir::Node *> arg_update_node_map_;
@@ -132,7 +143,7 @@ void SSAGraph::Build(const Program &program,
       if (arg_update_node_map_.count(name)) {
         arg_node = arg_update_node_map_.at(name);
       } else {
-        node_storage_.emplace_back();
+        AppendNode();
         arg_node = &node_storage_.back();
         arg_node->AsArg(name, node_storage_.size() - 1);
         arg_update_node_map_[name] = arg_node;
@@ -142,7 +153,7 @@ void SSAGraph::Build(const Program &program,
       DirectedLink(arg_node, op_node);
     }
     for (const std::string &name : op->op_info()->output_names()) {
-      node_storage_.emplace_back();
+      AppendNode();
       auto *arg_node = &node_storage_.back();
       arg_node->AsArg(name, node_storage_.size() - 1);
       arg_update_node_map_[name] = arg_node;
@@ -151,19 +162,26 @@ void SSAGraph::Build(const Program &program,
       CHECK(arg_node->IsRoleSet());
       DirectedLink(op_node, arg_node);
     }
-    CHECK(CheckLinksRoleSet());
   }
 
+  // Check the whole graph once, checking it per op is quadratic.
   CHECK(CheckNodesRoleSet());
   CheckValid();
 }
 
 void SSAGraph::RemoveNode(const mir::Node *node) {
-  auto pos = std::find_if(node_storage_.begin(),
-                          node_storage_.end(),
-                          [&node](mir::Node &n) { return &n == node; });
-  CHECK(pos != node_storage_.end());
-  node_storage_.erase(pos);
+  // The nodes might also be appended through `mutable_nodes()`, index the
+  // missing ones lazily.
+  auto pos = node_index_.find(node);
+  if (pos == node_index_.end()) {
+    for (auto it = node_storage_.begin(); it != node_storage_.end(); ++it) {
+      node_index_.emplace(&*it, it);
+    }
+    pos = node_index_.find(node);
+  }
+  CHECK(pos != node_index_.end());
+  node_storage_.erase(pos->second);
+  node_index_.erase(pos);
 }
 
 mir::Node *SSAGraph::Argument(const std::string &name) {
@@ -224,14 +242,14 @@ bool SSAGraph::CheckLinksRoleSet() {
 }
 
 Node *SSAGraph::NewArgumentNode(const std::string &name) {
-  node_storage_.emplace_back();
+  AppendNode();
   auto &arg_node = node_storage_.back();
   arg_node.AsArg(name, node_storage_.size() - 1);
   return &arg_node;
 }
 
 Node *SSAGraph::NewInstructNode() {
-  node_storage_.emplace_back();
+  AppendNode();
   return &node_storage_.back();
 }
 
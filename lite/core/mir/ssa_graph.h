@@ -20,6 +20,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/mir/node.h"
@@ -71,6 +72,12 @@ class SSAGraph : GraphBase {
 
  private:
   mir::Node *Argument(const std::string &name);
+  // Append an empty node to the storage and index it.
+  mir::Node *AppendNode() {
+    node_storage_.emplace_back();
+    node_index_.emplace(&node_storage_.back(), --node_storage_.end());
+    return &node_storage_.back();
+  }
   // Check the bidirectional connection.
   bool CheckBidirectionalConnection();
   bool CheckNodesRoleSet();
@@ -93,6 +100,10 @@ class SSAGraph : GraphBase {
 
  private:
   std::list<mir::Node> node_storage_;
+  // Locate a node in `node_storage_` in constant time for `RemoveNode`, the
+  // fusers remove many nodes from a large graph.
+  std::unordered_map<const mir::Node *, std::list<mir::Node>::iterator>
+      node_index_;
   std::map<std::string, mir::Node *> arguments_;
   std::vector<Place> valid_places_;
 };
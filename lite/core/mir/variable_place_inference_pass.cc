@@ -22,7 +22,16 @@ namespace mir {
 
 void VariablePlaceInferencePass::Apply(const std::unique_ptr<SSAGraph> &graph) {
   MarkInputPlace(graph.get());
-  InferenceArgumentPlace(graph.get());
+  // A type is only assigned to the arguments that have none, so the pass only
+  // needs to revisit the arguments created or reset since its last run. It is
+  // run many times in the optimizer, most of the runs have nothing to do.
+  auto dirty = UntypedArguments(graph.get());
+  if (dirty.empty()) {
+    VLOG(3) << "all the argument types are determined, skip";
+    return;
+  }
+  VLOG(3) << dirty.size() << " arguments to inference";
+  InferenceArgumentPlace(graph.get(), dirty);
   CheckAllArgumentTypeDetermined(graph.get());
 }
 
@@ -16,6 +16,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "lite/core/mir/pass.h"
 #include "lite/core/target_wrapper.h"
@@ -75,9 +76,33 @@ class VariablePlaceInferencePass : public DebugPass {
 #endif
   }
 
-  void InferenceArgumentPlace(SSAGraph* graph) {
+  // The arguments whose type is not determined yet, only they will be
+  // updated by `InferenceArgumentPlace`.
+  std::unordered_set<const Node*> UntypedArguments(SSAGraph* graph) {
+    std::unordered_set<const Node*> res;
+    for (auto& node : graph->mutable_nodes()) {
+      if (node.IsArg() && !node.AsArg().type) res.insert(&node);
+    }
+    return res;
+  }
+
+  bool LinksToAny(const Node* x,
+                  const std::unordered_set<const Node*>& nodes) {
+    for (auto* in : x->inlinks) {
+      if (nodes.count(in)) return true;
+    }
+    for (auto* out : x->outlinks) {
+      if (nodes.count(out)) return true;
+    }
+    return false;
+  }
+
+  // Only the statements linked to the `dirty` arguments are visited.
+  void InferenceArgumentPlace(SSAGraph* graph,
+                              const std::unordered_set<const Node*>& dirty) {
     VLOG(3) << "param-type-registry:\n" << ParamTypeRegistry::Global();
     for (auto& x : graph->StmtTopologicalOrder()) {
+      if (!LinksToAny(x, dirty)) continue;
       auto& inst = x->AsStmt();
 // The IoCopyOp is a tool operator, it won't support the type inference.
 // in fpga, we has io_copy+cali+layout tool ops, so we need type inference for
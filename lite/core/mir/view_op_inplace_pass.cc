@@ -0,0 +1,135 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/view_op_inplace_pass.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The ops whose host kernels can output a view of the input "X" (or "Input"
+// for slice) when the attr `inplace` is set.
+static const std::set<std::string>& ViewOps() {
+  static const std::set<std::string> view_ops{{"reshape",
+                                               "reshape2",
+                                               "flatten",
+                                               "flatten2",
+                                               "squeeze",
+                                               "squeeze2",
+                                               "unsqueeze",
+                                               "unsqueeze2",
+                                               "slice",
+                                               "split"}};
+  return view_ops;
+}
+
+static bool IsHost(TargetType x) {
+  return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
+}
+
+std::string ViewOpInplacePass::ViewedVar(Node* node) {
+  auto* op_info = node->AsStmt().op_info();
+  if (!ViewOps().count(op_info->Type()) || !op_info->HasAttr("inplace") ||
+      !op_info->GetAttr<bool>("inplace")) {
+    return "";
+  }
+  return op_info->Input(op_info->Type() == "slice" ? "Input" : "X").front();
+}
+
+bool ViewOpInplacePass::IsViewable(
+    Node* node, const std::unordered_map<std::string, int>& writers) const {
+  auto& stmt = node->AsStmt();
+  auto* op_info = stmt.op_info();
+  if (!ViewOps().count(op_info->Type())) return false;
+  if (stmt.kernels().empty() || !IsHost(stmt.picked_kernel().target())) {
+    return false;
+  }
+  // slice and split are views only on the outermost axis.
+  if (op_info->Type() == "slice" &&
+      op_info->GetAttr<std::vector<int>>("axes") != std::vector<int>{0}) {
+    return false;
+  }
+  if (op_info->Type() == "split" &&
+      (op_info->GetAttr<int>("axis") != 0 || op_info->HasInput("AxisTensor"))) {
+    return false;
+  }
+
+  auto in_name = op_info->Input(op_info->Type() == "slice" ? "Input" : "X")
+                     .front();
+  auto out_names = op_info->Output("Out");
+  // A var written again, e.g. in place by another op, would change the data
+  // of the other side of the view.
+  auto written_once = [&](const std::string& name) {
+    auto it = writers.find(name);
+    return it == writers.end() || it->second <= 1;
+  };
+  auto is_temporary = [&](Node* arg_node) {
+    auto& arg = arg_node->AsArg();
+    return !arg.is_weight && !arg.is_persist && arg.type &&
+           IsHost(arg.type->target()) && written_once(arg.name);
+  };
+
+  bool has_input = false;
+  for (auto* in : node->inlinks) {
+    if (in->AsArg().name != in_name) continue;
+    if (!is_temporary(in)) return false;
+    has_input = true;
+  }
+  if (!has_input) return false;
+  for (auto* out : node->outlinks) {
+    auto& name = out->AsArg().name;
+    if (std::find(out_names.begin(), out_names.end(), name) ==
+        out_names.end()) {
+      continue;
+    }
+    if (!is_temporary(out)) return false;
+    for (auto* op : out->outlinks) {
+      if (skipped_consumers_.count(op->AsStmt().op_type())) return false;
+    }
+  }
+  return true;
+}
+
+void ViewOpInplacePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  std::unordered_map<std::string, int> writers;
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsStmt()) continue;
+    for (auto* out : node.outlinks) {
+      ++writers[out->AsArg().name];
+    }
+  }
+
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt() || !IsViewable(node, writers)) continue;
+    auto& stmt = node->AsStmt();
+    auto op_info = *stmt.op_info();
+    op_info.SetAttr("inplace", true);
+    stmt.op()->Attach(op_info, stmt.op()->scope());
+    for (auto& kernel : stmt.kernels()) {
+      stmt.op()->AttachKernel(kernel.get());
+    }
+    VLOG(4) << op_info.Type() << " outputs views of " << ViewedVar(node);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(view_op_inplace_pass, paddle::lite::mir::ViewOpInplacePass)
+    .BindTargets({TARGET(kHost), TARGET(kX86), TARGET(kARM)});
@@ -0,0 +1,60 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ViewOpInplacePass lets the reshape-like ops on the host output views of
+ * their inputs. It sets the attr `inplace` of reshape, flatten, squeeze and
+ * unsqueeze, and of slice and split on the outermost axis, whose input and
+ * outputs are plain temporaries. Their kernels then share the buffer of the
+ * input instead of copying it.
+ *
+ * memory_optimize_pass does not reuse the views, and extends the lifetime of
+ * a viewed var to the last use of its views.
+ */
+class ViewOpInplacePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  // The name of the var whose buffer the outputs of the stmt `node` share,
+  // empty if `node` is not a view op marked by this pass.
+  static std::string ViewedVar(Node* node);
+
+ private:
+  bool IsViewable(Node* node,
+                  const std::unordered_map<std::string, int>& writers) const;
+
+ private:
+  // The consumers which may keep a view beyond the life of its buffer.
+  const std::set<std::string> skipped_consumers_{{"while",
+                                                  "conditional_block",
+                                                  "conditional_block_infer",
+                                                  "graph_op",
+                                                  "feed",
+                                                  "fetch"}};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,164 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/view_op_inplace_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Op list:
+// (feed)->feed->(x)->scale->(y)->reshape->(z)->scale->(out)
+// With `fetch_view`, z goes to a fetch instead of the last scale.
+std::unique_ptr<SSAGraph> BuildGraph(cpp::ProgramDesc* program_desc,
+                                     const std::shared_ptr<Scope>& scope,
+                                     const std::vector<Place>& valid_places,
+                                     bool fetch_view) {
+  auto* main_block = program_desc->AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "y", "z", "out"}) {
+    auto* var = main_block->AddVar<cpp::VarDesc>();
+    var->SetName(name);
+    var->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    var->SetPersistable(false);
+  }
+
+  auto* feed_op = main_block->AddOp<cpp::OpDesc>();
+  feed_op->SetType("feed");
+  feed_op->SetInput("X", {"feed"});
+  feed_op->SetOutput("Out", {"x"});
+  feed_op->SetAttr("col", 0);
+
+  auto add_scale = [&](const std::string& in, const std::string& out) {
+    auto* scale_op = main_block->AddOp<cpp::OpDesc>();
+    scale_op->SetType("scale");
+    scale_op->SetInput("X", {in});
+    scale_op->SetOutput("Out", {out});
+    scale_op->SetAttr("scale", 2.f);
+    scale_op->SetAttr("bias", 0.f);
+    scale_op->SetAttr("bias_after_scale", true);
+  };
+  add_scale("x", "y");
+
+  auto* reshape_op = main_block->AddOp<cpp::OpDesc>();
+  reshape_op->SetType("reshape");
+  reshape_op->SetInput("X", {"y"});
+  reshape_op->SetOutput("Out", {"z"});
+  reshape_op->SetAttr("shape", std::vector<int>({6}));
+
+  if (fetch_view) {
+    auto* fetch_op = main_block->AddOp<cpp::OpDesc>();
+    fetch_op->SetType("fetch");
+    fetch_op->SetInput("X", {"z"});
+    fetch_op->SetOutput("Out", {"fetch"});
+    fetch_op->SetAttr("col", 0);
+  } else {
+    add_scale("z", "out");
+  }
+
+  lite::Program program(*program_desc, scope, valid_places);
+  auto graph = std::unique_ptr<SSAGraph>(new SSAGraph());
+  graph->Build(program, valid_places);
+  // As variable_place_inference_pass would do for the x86 kernels.
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) {
+      node.AsArg().type = LiteType::GetTensorTy(TARGET(kX86));
+    }
+  }
+  return graph;
+}
+
+static Node* FindStmt(SSAGraph* graph, const std::string& op_type) {
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (node->AsStmt().op_type() == op_type) return node;
+  }
+  return nullptr;
+}
+
+TEST(view_op_inplace_pass, x86_reshape) {
+  cpp::ProgramDesc program_desc;
+  std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)},
+                            {TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(&program_desc, scope, places, false);
+
+  auto pass = PassManager::Global().LookUp("view_op_inplace_pass");
+  ASSERT_TRUE(pass);
+  EXPECT_TRUE(pass->Targets().count(TARGET(kX86)));
+  pass->Apply(graph);
+
+  auto* reshape = FindStmt(graph.get(), "reshape");
+  ASSERT_TRUE(reshape);
+  auto* op_info = reshape->AsStmt().op_info();
+  ASSERT_TRUE(op_info->HasAttr("inplace"));
+  EXPECT_TRUE(op_info->GetAttr<bool>("inplace"));
+  EXPECT_EQ(ViewOpInplacePass::ViewedVar(reshape), "y");
+
+  // The x86 kernel takes the attr and shares the buffer of its input.
+  auto* exec_scope = reshape->AsStmt().op()->scope();
+  auto* y = exec_scope->FindVar("y")->GetMutable<lite::Tensor>();
+  y->Resize({2, 3});
+  auto* y_data = y->mutable_data<float>();
+  for (int i = 0; i < y->numel(); i++) {
+    y_data[i] = i;
+  }
+  auto& kernel = reshape->AsStmt().picked_kernel();
+  EXPECT_EQ(kernel.target(), TARGET(kX86));
+  auto op = reshape->AsStmt().op();
+  ASSERT_TRUE(op->CheckShape());
+  op->InferShape();
+  reshape->AsStmt().kernels().front()->Launch();
+  auto& z = exec_scope->FindVar("z")->Get<lite::Tensor>();
+  EXPECT_EQ(z.dims(), DDim({6}));
+  EXPECT_EQ(z.data<float>(), y->data<float>());
+}
+
+TEST(view_op_inplace_pass, skip_fetched_view) {
+  cpp::ProgramDesc program_desc;
+  std::vector<Place> places{{TARGET(kX86), PRECISION(kFloat)},
+                            {TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto graph = BuildGraph(&program_desc, scope, places, true);
+
+  auto pass = PassManager::Global().LookUp("view_op_inplace_pass");
+  ASSERT_TRUE(pass);
+  pass->Apply(graph);
+
+  auto* reshape = FindStmt(graph.get(), "reshape");
+  ASSERT_TRUE(reshape);
+  EXPECT_TRUE(ViewOpInplacePass::ViewedVar(reshape).empty());
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(scale);
+USE_LITE_OP(reshape);
+USE_LITE_KERNEL(scale, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(reshape, kX86, kFloat, kNCHW, def);
+USE_MIR_PASS(view_op_inplace_pass);
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <chrono>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -59,6 +61,7 @@ class Optimizer {
     if (passes.empty()) {
       RunPasses(std::vector<std::string>{
           {"lite_quant_dequant_fuse_pass",     //
+           "constant_folding_pass",            // fold weight-only subgraphs
            "lite_conv_elementwise_fuse_pass",  // conv-elemwise-bn
            "lite_conv_bn_fuse_pass",           //
            "lite_conv_elementwise_fuse_pass",  // conv-bn-elemwise
@@ -72,10 +75,12 @@ class Optimizer {
            "lite_shuffle_channel_fuse_pass",              //
            "lite_transpose_softmax_transpose_fuse_pass",  //
            "lite_interpolate_fuse_pass",                  //
+           "lite_multihead_attention_fuse_pass",          //
            "identity_scale_eliminate_pass",               //
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
            "lite_elementwise_add_activation_fuse_pass",  //
 #endif
+           "sparse_weight_pass",             // pruned weights in block-CSR
            "static_kernel_pick_pass",        // pick original kernel from graph
            "variable_place_inference_pass",  // inference arg/var's
            // info(target/precision/layout/device)
@@ -112,6 +117,8 @@ class Optimizer {
 #if !defined(LITE_WITH_OPENCL) && !defined(LITE_WITH_NPU) && \
     !defined(LITE_WITH_XPU)
            // TODO(ysh329): cause CL_INVALID_MEM_OBJECT when setArg in kernel
+           "view_op_inplace_pass",
+           "concat_inplace_pass",
            "memory_optimize_pass",
 #endif
            "argument_type_display_pass"}});
@@ -196,6 +203,9 @@ class Optimizer {
 
   // Specify the passes and run them.
   void RunPasses(const std::vector<std::string>& passes) {
+    // The accumulated time of each pass in ms, some passes run many times.
+    std::map<std::string, double> pass_time;
+    double total_time = 0.;
     for (auto& x : passes) {
       LOG(INFO) << "== Running pass: " << x;
       mir::Pass* pass = mir::PassManager::Global().LookUp(x);
@@ -211,10 +221,20 @@ class Optimizer {
         LOG(INFO) << "   - Skip " << x
                   << " because the target or kernel does not match.";
       } else {
+        auto start = std::chrono::steady_clock::now();
         pass->Apply(graph_);
-        LOG(INFO) << "== Finished running: " << x;
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        pass_time[x] += ms;
+        total_time += ms;
+        LOG(INFO) << "== Finished running: " << x << " (" << ms << " ms)";
       }
     }
+    LOG(INFO) << "== Pass time summary, total " << total_time << " ms";
+    for (auto& item : pass_time) {
+      LOG(INFO) << "   - " << item.first << ": " << item.second << " ms";
+    }
   }
 
  private:
@@ -0,0 +1,371 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/pipeline_executor.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <limits>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+// The number of packets of a boundary.
+static constexpr int kNumBuffers = 2;
+
+static void BindToCores(const std::vector<int>& cores) {
+  if (cores.empty()) return;
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int core : cores) {
+    CPU_SET(core, &mask);
+  }
+  if (sched_setaffinity(0, sizeof(mask), &mask)) {
+    LOG(WARNING) << "failed to bind a pipeline stage to core " << cores[0];
+  }
+#endif
+#ifdef PADDLE_WITH_MKLML
+  omp_set_num_threads(static_cast<int>(cores.size()));
+#endif
+}
+
+void PipelineExecutor::PacketQueue::Push(Packet&& packet) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    packets_.push_back(std::move(packet));
+  }
+  cond_.notify_one();
+}
+
+bool PipelineExecutor::PacketQueue::Pop(Packet* packet) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return closed_ || !packets_.empty(); });
+  if (packets_.empty()) return false;
+  *packet = std::move(packets_.front());
+  packets_.pop_front();
+  return true;
+}
+
+void PipelineExecutor::PacketQueue::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  cond_.notify_all();
+}
+
+PipelineExecutor::PipelineExecutor(RuntimeProgram* program,
+                                   const std::vector<std::string>& input_vars,
+                                   const std::vector<std::string>& output_vars)
+    : program_(program), input_vars_(input_vars), output_vars_(output_vars) {
+  CHECK(program_);
+  CHECK(program_->exec_scope()) << "the exec scope should be set first";
+  CHECK(!program_->memoized()) << "a memoized program can not be pipelined";
+  std::set<std::string> written(input_vars.begin(), input_vars.end());
+  for (auto& inst : program_->instructions()) {
+    if (inst.is_feed_fetch()) continue;
+    auto type = inst.op()->op_info()->Type();
+    CHECK(type != "while" && type != "conditional_block")
+        << "the control flow op " << type << " can not be pipelined";
+    auto target = inst.kernel()->target();
+    CHECK(target == TARGET(kHost) || target == TARGET(kX86) ||
+          target == TARGET(kAny))
+        << "the kernel of " << type << " on " << TargetToStr(target)
+        << " can not be pipelined";
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      written.insert(name);
+    }
+  }
+  for (auto& inst : program_->instructions()) {
+    if (inst.is_feed_fetch()) continue;
+    for (auto& name : inst.op()->op_info()->input_names()) {
+      if (!written.count(name)) weights_.insert(name);
+    }
+  }
+  for (auto& name : input_vars_) {
+    CHECK(program_->exec_scope()->FindVar(name)) << "no input var " << name;
+  }
+  for (auto& name : output_vars_) {
+    CHECK(written.count(name)) << "the output var " << name
+                               << " is not computed by the program";
+  }
+}
+
+PipelineExecutor::~PipelineExecutor() {
+  if (stages_.empty()) return;
+  Close();
+  std::vector<Tensor> outputs;
+  while (Pop(&outputs)) {
+  }
+  for (auto& stage : stages_) {
+    stage->thread.join();
+  }
+}
+
+std::vector<double> PipelineExecutor::Profile(
+    const std::vector<Tensor>& inputs, int repeats) {
+  CHECK(stages_.empty()) << "the pipeline is started";
+  CHECK_EQ(inputs.size(), input_vars_.size());
+  CHECK_GT(repeats, 0);
+  auto* scope = program_->exec_scope();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto* tensor = scope->FindVar(input_vars_[i])->GetMutable<Tensor>();
+    tensor->ShareDataWith(inputs[i]);
+    tensor->set_precision(inputs[i].precision());
+  }
+  auto& insts = *program_->mutable_instructions();
+  std::vector<double> costs(insts.size(), 0.);
+  for (int k = 0; k < repeats; ++k) {
+    for (size_t i = 0; i < insts.size(); ++i) {
+      if (insts[i].is_feed_fetch()) continue;
+      auto start = std::chrono::steady_clock::now();
+      insts[i].Run();
+      auto end = std::chrono::steady_clock::now();
+      costs[i] +=
+          std::chrono::duration<double, std::micro>(end - start).count() /
+          repeats;
+    }
+  }
+  return costs;
+}
+
+std::vector<size_t> PipelineExecutor::BalancedSplit(
+    const std::vector<double>& costs, size_t k) {
+  size_t n = costs.size();
+  CHECK_GT(k, 0UL);
+  CHECK_LE(k, n);
+  std::vector<double> prefix(n + 1, 0.);
+  for (size_t i = 0; i < n; ++i) {
+    prefix[i + 1] = prefix[i] + costs[i];
+  }
+  // best[j][i] is the smallest largest part splitting the first `i` costs
+  // into `j` parts, the last part starts at from[j][i].
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<std::vector<double>> best(k + 1,
+                                        std::vector<double>(n + 1, inf));
+  std::vector<std::vector<size_t>> from(k + 1, std::vector<size_t>(n + 1, 0));
+  best[0][0] = 0.;
+  for (size_t j = 1; j <= k; ++j) {
+    for (size_t i = j; i <= n - (k - j); ++i) {
+      for (size_t p = j - 1; p < i; ++p) {
+        double cost = std::max(best[j - 1][p], prefix[i] - prefix[p]);
+        if (cost < best[j][i]) {
+          best[j][i] = cost;
+          from[j][i] = p;
+        }
+      }
+    }
+  }
+  std::vector<size_t> bounds(k + 1, n);
+  for (size_t j = k; j > 0; --j) {
+    bounds[j - 1] = from[j][bounds[j]];
+  }
+  return bounds;
+}
+
+std::set<std::string> PipelineExecutor::LiveVars(size_t pos) const {
+  auto& insts = program_->instructions();
+  std::set<std::string> live(output_vars_.begin(), output_vars_.end());
+  for (size_t i = insts.size(); i-- > pos;) {
+    if (insts[i].is_feed_fetch()) continue;
+    auto* op_info = insts[i].op()->op_info();
+    for (auto& name : op_info->output_names()) {
+      live.erase(name);
+    }
+    for (auto& name : op_info->input_names()) {
+      if (!weights_.count(name)) live.insert(name);
+    }
+  }
+  return live;
+}
+
+void PipelineExecutor::Start(
+    int num_stages,
+    const std::vector<double>& costs,
+    const std::vector<std::vector<int>>& core_groups) {
+  CHECK(stages_.empty()) << "the pipeline is started";
+  auto& insts = *program_->mutable_instructions();
+  CHECK(costs.empty() || costs.size() == insts.size())
+      << "one cost per instruction is expected";
+  std::vector<size_t> ops;
+  std::vector<double> op_costs;
+  for (size_t i = 0; i < insts.size(); ++i) {
+    if (insts[i].is_feed_fetch()) continue;
+    ops.push_back(i);
+    op_costs.push_back(costs.empty() ? 1. : costs[i]);
+  }
+  CHECK_GT(num_stages, 0);
+  size_t k = std::min(static_cast<size_t>(num_stages), ops.size());
+  CHECK(core_groups.empty() || core_groups.size() >= k)
+      << "one core group per stage is expected";
+  auto bounds = BalancedSplit(op_costs, k);
+
+  // The vars written before each position, a var live there is passed
+  // through the boundary only if it is an input or it is written before.
+  std::set<std::string> written(input_vars_.begin(), input_vars_.end());
+  std::vector<std::set<std::string>> written_before(k);
+  for (size_t s = 0, i = 0; s < k; ++s) {
+    auto begin = s == 0 ? 0 : ops[bounds[s]];
+    for (; i < begin; ++i) {
+      if (insts[i].is_feed_fetch()) continue;
+      for (auto& name : insts[i].op()->op_info()->output_names()) {
+        written.insert(name);
+      }
+    }
+    written_before[s] = written;
+  }
+
+  auto* exec_scope = program_->exec_scope();
+  for (size_t s = 0; s <= k; ++s) {
+    boundaries_.emplace_back();
+    auto& boundary = boundaries_.back();
+    if (s == 0) {
+      boundary.vars = input_vars_;
+    } else if (s == k) {
+      boundary.vars = output_vars_;
+    } else {
+      for (auto& name : LiveVars(ops[bounds[s]])) {
+        if (written_before[s].count(name)) boundary.vars.push_back(name);
+      }
+    }
+    for (int b = 0; b < kNumBuffers; ++b) {
+      boundary.free.Push(Packet(new std::vector<Tensor>(
+          s == 0 || s == k ? 0 : boundary.vars.size())));
+    }
+  }
+
+  for (size_t s = 0; s < k; ++s) {
+    std::unique_ptr<Stage> stage(new Stage);
+    stage->begin = s == 0 ? 0 : ops[bounds[s]];
+    stage->end = s + 1 == k ? insts.size() : ops[bounds[s + 1]];
+    stage->scope = &exec_scope->NewScope();
+    if (!core_groups.empty()) stage->cores = core_groups[s];
+    // The stage works on its own copy of all the vars it touches but the
+    // weights.
+    std::set<std::string> locals(boundaries_[s].vars.begin(),
+                                 boundaries_[s].vars.end());
+    locals.insert(boundaries_[s + 1].vars.begin(),
+                  boundaries_[s + 1].vars.end());
+    for (size_t i = stage->begin; i < stage->end; ++i) {
+      if (insts[i].is_feed_fetch()) continue;
+      auto* op_info = insts[i].op()->op_info();
+      for (auto& name : op_info->input_names()) {
+        if (!weights_.count(name)) locals.insert(name);
+      }
+      for (auto& name : op_info->output_names()) {
+        locals.insert(name);
+      }
+    }
+    for (auto& name : locals) {
+      auto* tensor = stage->scope->LocalVar(name)->GetMutable<Tensor>();
+      auto* var = exec_scope->FindVar(name);
+      if (var && var->IsType<Tensor>() &&
+          var->Get<Tensor>().memory_size() > 0) {
+        tensor->CopyDataFrom(var->Get<Tensor>());
+        tensor->set_precision(var->Get<Tensor>().precision());
+      }
+    }
+    for (auto& name : boundaries_[s].vars) {
+      stage->inputs.push_back(
+          stage->scope->FindLocalVar(name)->GetMutable<Tensor>());
+    }
+    for (auto& name : boundaries_[s + 1].vars) {
+      stage->outputs.push_back(
+          &stage->scope->FindLocalVar(name)->Get<Tensor>());
+    }
+    for (size_t i = stage->begin; i < stage->end; ++i) {
+      if (!insts[i].is_feed_fetch()) insts[i].Attach(stage->scope);
+    }
+    VLOG(3) << "pipeline stage " << s << ": instructions [" << stage->begin
+            << ", " << stage->end << "), " << boundaries_[s].vars.size()
+            << " inputs, " << boundaries_[s + 1].vars.size() << " outputs";
+    stages_.push_back(std::move(stage));
+  }
+  for (size_t s = 0; s < k; ++s) {
+    stages_[s]->thread = std::thread(&PipelineExecutor::RunStage, this, s);
+  }
+}
+
+void PipelineExecutor::RunStage(size_t i) {
+  auto& stage = *stages_[i];
+  auto& in = boundaries_[i];
+  auto& out = boundaries_[i + 1];
+  bool last = i + 1 == stages_.size();
+  BindToCores(stage.cores);
+  auto& insts = *program_->mutable_instructions();
+  Packet in_packet;
+  Packet out_packet;
+  while (in.ready.Pop(&in_packet)) {
+    for (size_t j = 0; j < stage.inputs.size(); ++j) {
+      auto& src = (*in_packet)[j];
+      stage.inputs[j]->ShareDataWith(src);
+      stage.inputs[j]->set_precision(src.precision());
+    }
+    for (size_t j = stage.begin; j < stage.end; ++j) {
+      if (!insts[j].is_feed_fetch()) insts[j].Run();
+    }
+    CHECK(out.free.Pop(&out_packet));
+    // The outputs of the pipeline are handed to the caller, they get fresh
+    // tensors for each frame.
+    if (last) out_packet->resize(stage.outputs.size());
+    for (size_t j = 0; j < stage.outputs.size(); ++j) {
+      auto& dst = (*out_packet)[j];
+      dst.CopyDataFrom(*stage.outputs[j]);
+      dst.set_precision(stage.outputs[j]->precision());
+    }
+    // The inputs of the pipeline belong to the caller, drop them.
+    if (i == 0) in_packet->clear();
+    in.free.Push(std::move(in_packet));
+    out.ready.Push(std::move(out_packet));
+  }
+  out.ready.Close();
+}
+
+void PipelineExecutor::Push(std::vector<Tensor>&& inputs) {
+  CHECK(!stages_.empty()) << "the pipeline is not started";
+  CHECK(!closed_) << "the pipeline is closed";
+  CHECK_EQ(inputs.size(), input_vars_.size());
+  auto& boundary = boundaries_.front();
+  Packet packet;
+  CHECK(boundary.free.Pop(&packet));
+  packet->swap(inputs);
+  boundary.ready.Push(std::move(packet));
+}
+
+bool PipelineExecutor::Pop(std::vector<Tensor>* outputs) {
+  CHECK(!stages_.empty()) << "the pipeline is not started";
+  auto& boundary = boundaries_.back();
+  Packet packet;
+  if (!boundary.ready.Pop(&packet)) return false;
+  outputs->swap(*packet);
+  packet->clear();
+  boundary.free.Push(std::move(packet));
+  return true;
+}
+
+void PipelineExecutor::Close() {
+  if (closed_) return;
+  closed_ = true;
+  if (!stages_.empty()) boundaries_.front().ready.Close();
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,152 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * PipelineExecutor runs a RuntimeProgram as a pipeline over a stream of
+ * frames. The instructions are split into contiguous stages of balanced
+ * cost, each stage runs on its own thread, optionally pinned to a group of
+ * cores, so that stage `i` works on frame `n` while stage `i + 1` works on
+ * frame `n - 1`.
+ *
+ * Each stage owns a child of the exec scope holding its own copy of the
+ * activations, only the weights are shared. The vars live across a stage
+ * boundary are copied into one of the two packets of the boundary, so that
+ * a stage fills a packet while the next one reads the other.
+ *
+ * The program must not be run by other means once the pipeline is started,
+ * its ops are bound to the stage scopes. Only the host and x86 kernels are
+ * supported, the ARM contexts share a global workspace.
+ *
+ * Usage:
+ *
+ *   PipelineExecutor pipeline(program, {"image"}, {"out"});
+ *   pipeline.Start(3, pipeline.Profile(sample));
+ *   std::thread reader([&] {
+ *     std::vector<Tensor> outs;
+ *     while (pipeline.Pop(&outs)) ...
+ *   });
+ *   for (...) pipeline.Push(std::move(frame));
+ *   pipeline.Close();
+ *   reader.join();
+ */
+class PipelineExecutor {
+ public:
+  PipelineExecutor(RuntimeProgram* program,
+                   const std::vector<std::string>& input_vars,
+                   const std::vector<std::string>& output_vars);
+  ~PipelineExecutor();
+
+  // Run the program on `inputs` in the exec scope and return the average
+  // time in microseconds of each instruction, the feed and fetch ones cost
+  // zero. It must be called before `Start`.
+  std::vector<double> Profile(const std::vector<Tensor>& inputs,
+                              int repeats = 1);
+
+  // Split the instructions into `num_stages` stages, balanced by `costs`,
+  // the cost of each instruction, equal costs if it is empty. The thread of
+  // the stage `i` is bound to the cores `core_groups[i]` if it is given.
+  void Start(int num_stages,
+             const std::vector<double>& costs = {},
+             const std::vector<std::vector<int>>& core_groups = {});
+
+  // Feed the inputs of a frame, in the order of `input_vars`. It blocks
+  // while the first stage is two frames behind.
+  void Push(std::vector<Tensor>&& inputs);
+
+  // Get the outputs of the next frame, in the order of `output_vars`. It
+  // returns false once the pipeline is closed and all the frames are out.
+  bool Pop(std::vector<Tensor>* outputs);
+
+  // No more frames will be pushed.
+  void Close();
+
+  size_t num_stages() const { return stages_.size(); }
+  // The instructions of the stage `i` are [stage_begin(i), stage_end(i)).
+  size_t stage_begin(size_t i) const { return stages_[i]->begin; }
+  size_t stage_end(size_t i) const { return stages_[i]->end; }
+  // The vars passed from the stage `i - 1` to the stage `i`.
+  const std::vector<std::string>& boundary_vars(size_t i) const {
+    return boundaries_[i].vars;
+  }
+
+  // Split `costs` into `k` non-empty contiguous parts minimizing the largest
+  // sum, return the k + 1 part boundaries.
+  static std::vector<size_t> BalancedSplit(const std::vector<double>& costs,
+                                           size_t k);
+
+ private:
+  using Packet = std::unique_ptr<std::vector<Tensor>>;
+
+  class PacketQueue {
+   public:
+    void Push(Packet&& packet);
+    // Return false if the queue is closed and empty.
+    bool Pop(Packet* packet);
+    void Close();
+
+   private:
+    std::deque<Packet> packets_;
+    bool closed_{false};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+  };
+
+  struct Boundary {
+    std::vector<std::string> vars;
+    PacketQueue ready;
+    PacketQueue free;
+  };
+
+  struct Stage {
+    size_t begin{};
+    size_t end{};
+    Scope* scope{};
+    std::vector<Tensor*> inputs;
+    std::vector<const Tensor*> outputs;
+    std::vector<int> cores;
+    std::thread thread;
+  };
+
+  // Get the vars live before the instruction `pos`.
+  std::set<std::string> LiveVars(size_t pos) const;
+  void RunStage(size_t i);
+
+  RuntimeProgram* program_;
+  std::vector<std::string> input_vars_;
+  std::vector<std::string> output_vars_;
+  // The vars no instruction writes, shared by the stages.
+  std::set<std::string> weights_;
+  std::vector<std::unique_ptr<Stage>> stages_;
+  // The boundary `i` is the input of the stage `i`, the last one is the
+  // output of the pipeline.
+  std::deque<Boundary> boundaries_;
+  bool closed_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
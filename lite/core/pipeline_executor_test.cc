@@ -0,0 +1,200 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/pipeline_executor.h"
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+struct FakeParam {
+  std::vector<const Tensor*> X;
+  std::vector<Tensor*> Out;
+};
+
+// An op with any inputs and outputs, its kernel sets each output to the
+// elementwise sum of the inputs plus one.
+class FakeOp : public OpLite {
+ public:
+  FakeOp() : OpLite("fake") {}
+  bool CheckShape() const override { return true; }
+  bool InferShape() const override {
+    for (auto* out : param_.Out) {
+      out->Resize(param_.X[0]->dims());
+    }
+    return true;
+  }
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    param_.X.clear();
+    param_.Out.clear();
+    for (auto& name : opdesc.Input("X")) {
+      param_.X.push_back(GetTensor(scope, name));
+    }
+    for (auto& name : opdesc.Output("Out")) {
+      param_.Out.push_back(GetMutableTensor(scope, name));
+    }
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override { kernel->SetParam(param_); }
+  std::string DebugString() const override { return "fake"; }
+
+ private:
+  mutable FakeParam param_;
+};
+
+class FakeKernel : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  void Run() override {
+    auto& param = Param<FakeParam>();
+    // Long enough for the stages to overlap.
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    for (auto* out : param.Out) {
+      auto* out_data = out->mutable_data<float>();
+      for (int64_t i = 0; i < out->numel(); ++i) {
+        out_data[i] = 1.f;
+        for (auto* x : param.X) {
+          out_data[i] += x->data<float>()[i];
+        }
+      }
+    }
+  }
+};
+
+class PipelineExecutorTest : public ::testing::Test {
+ protected:
+  // x -> a -> y0 -> c(w) -> out0
+  //      a -> y1 -> d    -> out1
+  // x -> b -> z  -> d
+  void SetUp() override {
+    for (auto& name : {"x", "w", "y0", "y1", "z", "out0", "out1"}) {
+      scope_.Var(name)->GetMutable<Tensor>();
+    }
+    auto* w = scope_.FindVar("w")->GetMutable<Tensor>();
+    w->Resize({3});
+    for (int i = 0; i < 3; ++i) {
+      w->mutable_data<float>()[i] = 10.f;
+    }
+    std::vector<Instruction> insts;
+    auto add = [&](const std::vector<std::string>& inputs,
+                   const std::vector<std::string>& outputs) {
+      cpp::OpDesc desc;
+      desc.SetType("fake");
+      desc.SetInput("X", inputs);
+      desc.SetOutput("Out", outputs);
+      std::shared_ptr<OpLite> op(new FakeOp);
+      op->Attach(desc, &scope_);
+      std::unique_ptr<KernelBase> kernel(new FakeKernel);
+      op->AttachKernel(kernel.get());
+      insts.emplace_back(op, std::move(kernel));
+    };
+    add({"x"}, {"y0", "y1"});
+    add({"x"}, {"z"});
+    add({"y0", "w"}, {"out0"});
+    add({"y1", "z"}, {"out1"});
+    program_.reset(new RuntimeProgram(std::move(insts)));
+    program_->set_exec_scope(&scope_);
+  }
+
+  static std::vector<Tensor> Frame(float v) {
+    std::vector<Tensor> frame(1);
+    frame[0].Resize({3});
+    for (int i = 0; i < 3; ++i) {
+      frame[0].mutable_data<float>()[i] = v + i;
+    }
+    return frame;
+  }
+
+  // Stream `num_frames` frames and check the outputs.
+  void Stream(PipelineExecutor* pipeline, int num_frames) {
+    std::thread reader([&] {
+      std::vector<Tensor> outs;
+      int n = 0;
+      while (pipeline->Pop(&outs)) {
+        ASSERT_EQ(outs.size(), 2UL);
+        for (int i = 0; i < 3; ++i) {
+          float x = n + i;
+          EXPECT_EQ(outs[0].data<float>()[i], x + 12.f);
+          EXPECT_EQ(outs[1].data<float>()[i], 2.f * x + 3.f);
+        }
+        ++n;
+      }
+      EXPECT_EQ(n, num_frames);
+    });
+    for (int n = 0; n < num_frames; ++n) {
+      pipeline->Push(Frame(n));
+    }
+    pipeline->Close();
+    reader.join();
+  }
+
+  Scope scope_;
+  std::unique_ptr<RuntimeProgram> program_;
+};
+
+TEST(PipelineExecutor, BalancedSplit) {
+  using bounds = std::vector<size_t>;
+  EXPECT_EQ(PipelineExecutor::BalancedSplit({1, 1, 1, 1}, 2),
+            bounds({0, 2, 4}));
+  EXPECT_EQ(PipelineExecutor::BalancedSplit({5, 1, 1, 1, 1, 1}, 2),
+            bounds({0, 1, 6}));
+  EXPECT_EQ(PipelineExecutor::BalancedSplit({1, 2, 3, 4, 5}, 3),
+            bounds({0, 3, 4, 5}));
+  EXPECT_EQ(PipelineExecutor::BalancedSplit({0, 0, 0}, 3),
+            bounds({0, 1, 2, 3}));
+  EXPECT_EQ(PipelineExecutor::BalancedSplit({7}, 1), bounds({0, 1}));
+}
+
+TEST_F(PipelineExecutorTest, two_stages) {
+  PipelineExecutor pipeline(program_.get(), {"x"}, {"out0", "out1"});
+  auto costs = pipeline.Profile(Frame(0));
+  ASSERT_EQ(costs.size(), 4UL);
+  pipeline.Start(2, {1, 1, 1, 1});
+  ASSERT_EQ(pipeline.num_stages(), 2UL);
+  EXPECT_EQ(pipeline.stage_end(0), 2UL);
+  using names = std::vector<std::string>;
+  EXPECT_EQ(pipeline.boundary_vars(0), names({"x"}));
+  EXPECT_EQ(pipeline.boundary_vars(1), names({"y0", "y1", "z"}));
+  EXPECT_EQ(pipeline.boundary_vars(2), names({"out0", "out1"}));
+  Stream(&pipeline, 20);
+}
+
+TEST_F(PipelineExecutorTest, one_stage_per_op) {
+  PipelineExecutor pipeline(program_.get(), {"x"}, {"out0", "out1"});
+  unsigned num_cores = std::thread::hardware_concurrency();
+  std::vector<std::vector<int>> core_groups;
+  for (int i = 0; i < 8; ++i) {
+    core_groups.push_back({static_cast<int>(i % std::max(num_cores, 1U))});
+  }
+  pipeline.Start(8, {}, core_groups);
+  ASSERT_EQ(pipeline.num_stages(), 4UL);
+  using names = std::vector<std::string>;
+  EXPECT_EQ(pipeline.boundary_vars(3), names({"out0", "y1", "z"}));
+  Stream(&pipeline, 20);
+}
+
+TEST_F(PipelineExecutorTest, destroy_without_pop) {
+  PipelineExecutor pipeline(program_.get(), {"x"}, {"out1"});
+  pipeline.Start(2);
+  pipeline.Push(Frame(0));
+  pipeline.Push(Frame(1));
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "lite/core/program.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
 #include <unordered_map>
 #include "lite/model_parser/cpp/block_desc.h"
 #include "lite/model_parser/cpp/op_desc.h"
@@ -67,7 +70,11 @@ void RuntimeProgram::UpdateVarsOfProgram(cpp::ProgramDesc* desc) {
         auto* v = main_block.AddVar<cpp::VarDesc>();
         v->SetName((it->second).Name());
         v->SetType((it->second).GetType());
-        v->SetPersistable((it->second).Persistable());
+        // The vars folded by the constant_folding_pass become persistable.
+        auto* var = scope->FindVar(in_name);
+        bool folded = var && var->IsType<lite::Tensor>() &&
+                      var->Get<lite::Tensor>().persistable();
+        v->SetPersistable((it->second).Persistable() || folded);
       } else {
         // New created vars must be LOD_TENSOR
         auto* v = main_block.AddVar<cpp::VarDesc>();
@@ -112,10 +119,13 @@ void RuntimeProgram::UpdateVarsOfProgram(cpp::ProgramDesc* desc) {
 }
 
 void RuntimeProgram::Run() {
-  for (auto& inst : instructions_) {
-    std::string op_type = inst.op()->op_info()->Type();
-    if (op_type == "feed" || op_type == "fetch") continue;
+  if (!shape_checks_.empty()) CheckShapeRanges();
+  for (size_t i = 0; i < instructions_.size(); ++i) {
+    auto& inst = instructions_[i];
+    if (inst.is_feed_fetch()) continue;
+    if (memo_ && BeforeMemoized(i)) continue;
     inst.Run();
+    if (memo_) AfterMemoized(i);
 #ifdef LITE_WITH_PROFILE
 #ifdef LITE_WITH_PRECISION_PROFILE
     LITE_PRECISION_PROFILE(inst)
@@ -124,7 +134,390 @@ void RuntimeProgram::Run() {
   }
 }
 
-void Program::Build(const cpp::ProgramDesc& prog) {
+void RuntimeProgram::Run(const std::vector<std::string>& fetch_vars,
+                         const std::vector<std::string>& start_vars) {
+  if (!shape_checks_.empty()) CheckShapeRanges();
+  for (size_t idx : PrunedInstructions(fetch_vars, start_vars)) {
+    auto& inst = instructions_[idx];
+    inst.Run();
+#ifdef LITE_WITH_PROFILE
+#ifdef LITE_WITH_PRECISION_PROFILE
+    LITE_PRECISION_PROFILE(inst)
+#endif  // LITE_WITH_PRECISION_PROFILE
+#endif  // LITE_WITH_PROFILE
+  }
+}
+
+const std::vector<size_t>& RuntimeProgram::PrunedInstructions(
+    const std::vector<std::string>& fetch_vars,
+    const std::vector<std::string>& start_vars) {
+  std::set<std::string> fetch(fetch_vars.begin(), fetch_vars.end());
+  std::set<std::string> start(start_vars.begin(), start_vars.end());
+  std::string key;
+  for (auto& name : fetch) key += name + ",";
+  key += ";";
+  for (auto& name : start) key += name + ",";
+  auto it = pruned_instructions_.find(key);
+  if (it != pruned_instructions_.end()) {
+    return it->second;
+  }
+
+  for (auto& name : fetch) {
+    CHECK(!exec_scope_ || exec_scope_->FindVar(name))
+        << "the fetch var " << name << " is not in the program";
+  }
+  // A start var shares its name with another var if it is reused by the
+  // memory_optimize_pass, the instructions writing the other var would
+  // overwrite the data set by the caller.
+  std::map<std::string, int> writers;
+  for (auto& inst : instructions_) {
+    if (inst.is_feed_fetch()) continue;
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      if (start.count(name)) writers[name]++;
+    }
+  }
+  for (auto& name : start) {
+    CHECK(!exec_scope_ || exec_scope_->FindVar(name))
+        << "the start var " << name << " is not in the program";
+    CHECK_LE(writers[name], 1) << "the start var " << name
+                               << " is written by several ops, it might be "
+                                  "reused by the memory_optimize_pass";
+  }
+
+  auto insts = Prune(fetch, start);
+  // The op writing a start var may still run for another fetch var, it would
+  // overwrite the data set by the caller.
+  for (size_t i : insts) {
+    for (auto& name : instructions_[i].op()->op_info()->output_names()) {
+      CHECK(!start.count(name))
+          << "the start var " << name << " is computed by the op "
+          << instructions_[i].op()->op_info()->Type()
+          << ", which the fetch vars " << key << " need to run";
+    }
+  }
+  VLOG(3) << "run " << insts.size() << " of " << instructions_.size()
+          << " instructions for the fetch vars " << key;
+  return pruned_instructions_.emplace(key, std::move(insts)).first->second;
+}
+
+std::vector<size_t> RuntimeProgram::Prune(
+    const std::set<std::string>& fetch,
+    const std::set<std::string>& start,
+    std::set<std::string>* free_vars) const {
+  // Walk the instructions backward and keep the ones that write a var still
+  // needed by the kept ones after them.
+  std::set<std::string> needed;
+  for (auto& name : fetch) {
+    if (!start.count(name)) needed.insert(name);
+  }
+  std::vector<size_t> insts;
+  for (size_t i = instructions_.size(); i-- > 0;) {
+    auto& inst = instructions_[i];
+    if (inst.is_feed_fetch()) continue;
+    auto* op_info = inst.op()->op_info();
+    auto out_names = op_info->output_names();
+    bool keep = std::any_of(
+        out_names.begin(), out_names.end(), [&](const std::string& name) {
+          return needed.count(name) > 0;
+        });
+    if (!keep) continue;
+    for (auto& name : out_names) {
+      needed.erase(name);
+    }
+    for (auto& name : op_info->input_names()) {
+      if (!start.count(name)) needed.insert(name);
+    }
+    insts.push_back(i);
+  }
+  std::reverse(insts.begin(), insts.end());
+  if (free_vars) {
+    *free_vars = std::move(needed);
+  }
+  return insts;
+}
+
+void RuntimeProgram::Memoize(const std::vector<std::string>& input_vars,
+                             const std::vector<std::string>& output_vars,
+                             size_t capacity) {
+  CHECK(exec_scope_) << "the exec scope should be set first";
+  std::set<std::string> inputs(input_vars.begin(), input_vars.end());
+  std::set<std::string> outputs(output_vars.begin(), output_vars.end());
+  for (auto& name : output_vars) {
+    CHECK(!inputs.count(name)) << "the var " << name
+                               << " is both an input and an output";
+  }
+  std::set<std::string> free_vars;
+  auto insts = Prune(outputs, inputs, &free_vars);
+  CHECK(!insts.empty()) << "no instruction computes the memoized outputs";
+
+  std::unique_ptr<Memo> memo(new Memo);
+  memo->input_vars = input_vars;
+  memo->output_vars = output_vars;
+  memo->in_subgraph.resize(instructions_.size(), false);
+  for (size_t i : insts) {
+    memo->in_subgraph[i] = true;
+  }
+  memo->first = insts.front();
+  memo->last = insts.back();
+  memo->cache.reset(new TensorMemoCache(capacity));
+
+  // The subgraph reads nothing but the inputs and the weights, which no
+  // instruction writes.
+  std::set<std::string> written;
+  for (auto& inst : instructions_) {
+    for (auto& name : inst.op()->op_info()->output_names()) {
+      written.insert(name);
+    }
+  }
+  for (auto& name : free_vars) {
+    CHECK(inputs.count(name) || !written.count(name))
+        << "the memoized subgraph reads " << name
+        << ", it should be one of the input vars";
+  }
+
+  // The inputs are hashed before the first instruction of the subgraph, and
+  // the outputs are copied back where they would be computed. The other
+  // instructions in between should neither change the inputs nor read the
+  // vars inside the subgraph.
+  std::map<std::string, size_t> last_writer;
+  for (size_t i = 0; i < instructions_.size(); ++i) {
+    auto& inst = instructions_[i];
+    if (inst.is_feed_fetch()) continue;
+    auto* op_info = inst.op()->op_info();
+    for (auto& name : op_info->input_names()) {
+      auto it = last_writer.find(name);
+      if (it == last_writer.end()) continue;
+      if (memo->in_subgraph[i] && inputs.count(name)) {
+        CHECK_LT(it->second, memo->first)
+            << "the input var " << name
+            << " is written after the memoized subgraph starts";
+      }
+      if (!memo->in_subgraph[i] && memo->in_subgraph[it->second]) {
+        CHECK(outputs.count(name))
+            << "the var " << name << " of the memoized subgraph is read by "
+            << op_info->Type() << ", it should be one of the output vars";
+      }
+    }
+    for (auto& name : op_info->output_names()) {
+      last_writer[name] = i;
+    }
+  }
+  std::map<std::string, size_t> output_writer;
+  for (size_t i : insts) {
+    for (auto& name : instructions_[i].op()->op_info()->output_names()) {
+      if (outputs.count(name)) output_writer[name] = i;
+    }
+  }
+  for (size_t k = 0; k < output_vars.size(); ++k) {
+    memo->outputs_at[output_writer.at(output_vars[k])].push_back(k);
+  }
+  VLOG(3) << "memoize " << insts.size() << " instructions in ["
+          << memo->first << ", " << memo->last << "]";
+  memo_ = std::move(memo);
+}
+
+std::vector<const Tensor*> RuntimeProgram::VarTensors(
+    const std::vector<std::string>& names) const {
+  std::vector<const Tensor*> res;
+  for (auto& name : names) {
+    auto* var = exec_scope_->FindVar(name);
+    CHECK(var) << "no var " << name << " in the exec scope";
+    res.push_back(&var->Get<Tensor>());
+  }
+  return res;
+}
+
+bool RuntimeProgram::BeforeMemoized(size_t i) {
+  auto& memo = *memo_;
+  if (i == memo.first) {
+    auto inputs = VarTensors(memo.input_vars);
+    memo.hash = TensorMemoCache::Hash(inputs);
+    memo.hit = memo.cache->Find(memo.hash, inputs);
+    if (!memo.hit) {
+      memo.inputs = TensorMemoCache::Snapshot(inputs);
+      memo.outputs.clear();
+      memo.outputs.resize(memo.output_vars.size());
+    }
+  }
+  if (!memo.hit || !memo.in_subgraph[i]) {
+    return false;
+  }
+  auto it = memo.outputs_at.find(i);
+  if (it != memo.outputs_at.end()) {
+    for (size_t k : it->second) {
+      auto* var = exec_scope_->FindVar(memo.output_vars[k]);
+      TensorMemoCache::Copy((*memo.hit)[k], var->GetMutable<Tensor>());
+    }
+  }
+  if (i == memo.last) {
+    memo.hit = nullptr;
+  }
+  return true;
+}
+
+void RuntimeProgram::AfterMemoized(size_t i) {
+  auto& memo = *memo_;
+  if (memo.hit || i < memo.first || i > memo.last) {
+    return;
+  }
+  auto it = memo.outputs_at.find(i);
+  if (it != memo.outputs_at.end()) {
+    for (size_t k : it->second) {
+      auto* var = exec_scope_->FindVar(memo.output_vars[k]);
+      TensorMemoCache::Copy(var->Get<Tensor>(), &memo.outputs[k]);
+    }
+  }
+  if (i == memo.last) {
+    memo.cache->Insert(
+        memo.hash, std::move(memo.inputs), std::move(memo.outputs));
+    memo.inputs.clear();
+    memo.outputs.clear();
+  }
+}
+
+void RuntimeProgram::PreplanShapes(
+    const std::map<std::string, ShapeRange>& ranges) {
+  CHECK(exec_scope_) << "the exec scope should be set first";
+  shape_checks_.clear();
+  for (auto& it : ranges) {
+    auto& range = it.second;
+    CHECK(range.min.size() == range.opt.size() &&
+          range.opt.size() == range.max.size())
+        << "the min, opt and max shapes of " << it.first
+        << " should have the same rank";
+    CHECK(!range.max.empty()) << "empty shape range of " << it.first;
+    for (size_t i = 0; i < range.max.size(); ++i) {
+      CHECK(range.min[i] > 0 && range.min[i] <= range.opt[i] &&
+            range.opt[i] <= range.max[i])
+          << "invalid shape range of " << it.first << " at dim " << i;
+    }
+    auto* var = exec_scope_->FindVar(it.first);
+    CHECK(var) << "no input var " << it.first << " in the exec scope";
+    ShapeCheck check;
+    check.name = it.first;
+    check.tensor = var->GetMutable<Tensor>();
+    check.range = range;
+    shape_checks_.push_back(check);
+  }
+
+  auto set_inputs = [this](bool max) {
+    for (auto& check : shape_checks_) {
+      auto& shape = max ? check.range.max : check.range.opt;
+      auto* x = check.tensor;
+      x->Resize(shape);
+      auto precision = InputPrecision(check.name);
+      size_t bytes = x->numel() * PrecisionTypeLength(precision);
+      std::memset(x->mutable_data(TARGET(kHost), bytes), 0, bytes);
+      // A single sequence, for the inputs of the sequence ops.
+      x->set_lod({{0, static_cast<uint64_t>(shape[0])}});
+    }
+  };
+  auto before = GetMemoryStats(TARGET(kHost));
+  set_inputs(true);
+  PlanBuffers();
+  set_inputs(false);
+  for (auto& check : shape_checks_) {
+    check.tensor->set_lod({});
+  }
+  auto after = GetMemoryStats(TARGET(kHost));
+  VLOG(3) << "preplanned " << shape_checks_.size() << " inputs, host buffers "
+          << before.live_bytes << " -> " << after.live_bytes << " bytes";
+}
+
+PrecisionType RuntimeProgram::InputPrecision(const std::string& name) const {
+  for (auto& inst : instructions_) {
+    std::string arg;
+    if (!inst.op()->op_info()->GetInputArgname(name, &arg)) continue;
+    auto* kernel = inst.kernel();
+    const auto* type = ParamTypeRegistry::Global().RetrieveInArgument(
+        kernel->place(), kernel->GenParamTypeKey(), arg);
+    if (type && type->type->precision() != PRECISION(kAny)) {
+      return type->type->precision();
+    }
+    break;
+  }
+  return PRECISION(kFloat);
+}
+
+void RuntimeProgram::PlanBuffers() {
+  // The inputs whose values are read by the InferShape of their op: the
+  // shape of reshape, the output size of interpolate and the bounds of
+  // range. No kernel runs here, so only the values of the weights are known,
+  // the other ones are computed by ops which have not run yet.
+  static const std::set<std::string> value_args{
+      "Shape", "ShapeTensor", "OutSize", "Start", "End", "Step"};
+  // The ops running a block, whose outputs are only known by running it.
+  static const std::set<std::string> block_ops{
+      "while", "conditional_block", "conditional_block_infer"};
+  auto is_weight = [this](const std::string& name) {
+    auto* var = exec_scope_->FindVar(name);
+    return var && var->IsType<Tensor>() && var->Get<Tensor>().persistable();
+  };
+  std::set<std::string> unplanned;
+  size_t num_planned = 0;
+  for (auto& inst : instructions_) {
+    if (inst.is_feed_fetch()) continue;
+    auto* op = inst.op();
+    auto* op_info = op->op_info();
+    bool planned = !block_ops.count(op_info->Type());
+    for (auto& arg : value_args) {
+      if (!op_info->HasInput(arg)) continue;
+      for (auto& name : op_info->Input(arg)) {
+        planned = planned && is_weight(name);
+      }
+    }
+    for (auto& name : op_info->input_names()) {
+      planned = planned && !unplanned.count(name);
+    }
+    planned = planned && op->CheckShape() && op->InferShape();
+    if (planned) ++num_planned;
+    auto* kernel = inst.kernel();
+    const auto target = kernel->target();
+    const bool host_memory = target == TARGET(kHost) ||
+                             target == TARGET(kX86) || target == TARGET(kARM);
+    for (auto& name : op_info->output_names()) {
+      if (!planned) {
+        unplanned.insert(name);
+        continue;
+      }
+      std::string arg;
+      auto* var = exec_scope_->FindVar(name);
+      if (!host_memory || !var || !var->IsType<Tensor>() ||
+          !op_info->GetOutputArgname(name, &arg)) {
+        continue;
+      }
+      auto precision = PRECISION(kFloat);
+      const auto* type = ParamTypeRegistry::Global().RetrieveOutArgument(
+          kernel->place(), kernel->GenParamTypeKey(), arg);
+      if (type && type->type->precision() != PRECISION(kAny)) {
+        precision = type->type->precision();
+      }
+      auto* out = var->GetMutable<Tensor>();
+      out->mutable_data(target, out->numel() * PrecisionTypeLength(precision));
+    }
+  }
+  VLOG(3) << "planned the buffers of " << num_planned << " instructions, "
+          << unplanned.size() << " outputs are left to the first run";
+}
+
+void RuntimeProgram::CheckShapeRanges() {
+  for (auto& check : shape_checks_) {
+    if (check.warned) continue;
+    auto& dims = check.tensor->dims();
+    bool in_range = dims.size() == check.range.max.size();
+    for (size_t i = 0; in_range && i < dims.size(); ++i) {
+      in_range = dims[i] >= check.range.min[i] && dims[i] <= check.range.max[i];
+    }
+    if (!in_range) {
+      LOG(WARNING) << "the shape " << dims << " of " << check.name
+                   << " is out of its preplanned range, the buffers may grow";
+      check.warned = true;
+    }
+  }
+}
+
+void Program::Build(const cpp::ProgramDesc& prog,
+                    ParamStreamLoader* param_loader) {
   CHECK(ops_.empty()) << "Executor duplicate Build found";
 
   // Create operators.
@@ -145,6 +538,11 @@ void Program::Build(const cpp::ProgramDesc& prog) {
               sub_block_idx);
       static_cast<operators::WhileOpLite*>(op.get())->SetSubBlock(sub_block);
     }
+    if (param_loader) {
+      for (auto& name : op_desc.input_vars()) {
+        param_loader->WaitFor(name);
+      }
+    }
     ops_.emplace_back(std::move(op));
     ops_.back()->Attach(op_desc, exec_scope_);
   }
@@ -205,6 +603,16 @@ void Instruction::Run() {
   has_run_ = true;
 }
 
+void Instruction::Attach(lite::Scope* scope) {
+  CHECK(op_) << "op null";
+  CHECK(kernel_) << "kernel null";
+  // The op_info is reset by `Attach`, copy it first.
+  auto op_info = *op_->op_info();
+  op_->Attach(op_info, scope);
+  op_->AttachKernel(kernel_.get());
+  first_epoch_ = true;
+}
+
 STL::ostream& operator<<(STL::ostream& os, const Instruction& other) {
   os << other.kernel_->summary() << "\t(" << other.kernel_->doc() << ")";
   return os;
@@ -14,14 +14,18 @@
 
 #pragma once
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 #include "lite/core/kernel.h"
+#include "lite/core/memo_cache.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
 #include "lite/model_parser/cpp/program_desc.h"
+#include "lite/model_parser/param_stream_loader.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/basic_profiler.h"
 #endif  // LITE_WITH_PROFILE
@@ -38,15 +42,18 @@ static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
 struct Program {
  public:
   explicit Program(const std::shared_ptr<Scope>& root) { scope_ = root; }
+  // If `param_loader` is set, the params are still being streamed into the
+  // scope, and each op waits for its own params before attached.
   Program(const cpp::ProgramDesc& desc,
           const std::shared_ptr<Scope>& root,
-          const std::vector<Place>& valid_places)
+          const std::vector<Place>& valid_places,
+          ParamStreamLoader* param_loader = nullptr)
       : scope_(root), valid_places_(valid_places), desc_(desc) {
     CHECK(scope_) << "scope should be init first";
     VLOG(4) << "prepare work";
     PrepareWorkspace(desc);
     VLOG(4) << "build desc";
-    Build(desc);
+    Build(desc, param_loader);
     VLOG(4) << "build desc finished";
   }
 
@@ -68,7 +75,8 @@ struct Program {
 
  private:
   // Build from a program and scope.
-  void Build(const cpp::ProgramDesc& program);
+  void Build(const cpp::ProgramDesc& program,
+             ParamStreamLoader* param_loader = nullptr);
   // Create temporary variables.
   void PrepareWorkspace(const cpp::ProgramDesc& program);
 
@@ -88,8 +96,9 @@ struct Instruction {
   Instruction(const std::shared_ptr<OpLite>& op,
               std::unique_ptr<KernelBase>&& kernel)
       : op_(op), kernel_(std::move(kernel)) {
+    is_feed_fetch_ = op_->Type() == "feed" || op_->Type() == "fetch";
 #ifdef LITE_WITH_PROFILE
-    if (op_->Type() != "feed" && op_->Type() != "fetch") {
+    if (!is_feed_fetch_) {
       profile_id_ = profile::BasicProfiler<profile::BasicTimer>::Global()
                         .NewRcd(kernel_->SerializedKernelType())
                         .id();
@@ -107,15 +116,21 @@ struct Instruction {
   // Run the instruction.
   void Run();
 
+  // Bind the op and the kernel to the variables of `scope`.
+  void Attach(lite::Scope* scope);
+
   friend STL::ostream& operator<<(STL::ostream& os, const Instruction& other);
 
   const OpLite* op() const { return op_.get(); }
   const KernelBase* kernel() const { return kernel_.get(); }
   KernelBase* mutable_kernel() { return kernel_.get(); }
+  // The feed and fetch ops are resolved at build time and skipped at runtime.
+  bool is_feed_fetch() const { return is_feed_fetch_; }
 
  private:
   std::shared_ptr<OpLite> op_;
   std::unique_ptr<KernelBase> kernel_;
+  bool is_feed_fetch_{false};
   bool first_epoch_{true};
   bool has_run_{false};
 
@@ -125,6 +140,14 @@ struct Instruction {
 #endif  // LITE_WITH_PROFILE
 };
 
+// The shapes an input var takes at runtime, see
+// `RuntimeProgram::PreplanShapes`.
+struct ShapeRange {
+  std::vector<int64_t> min;
+  std::vector<int64_t> opt;
+  std::vector<int64_t> max;
+};
+
 /*
  * A program contains kernels for runtime.
  */
@@ -139,12 +162,47 @@ class LITE_API RuntimeProgram {
 
   void Run();
 
+  // Run only the instructions the vars `fetch_vars` depend on. The vars in
+  // `start_vars` are set by the caller in the exec scope before, so the
+  // instructions computing them are pruned as well. It is an error if one of
+  // them is needed for another fetch var, as it would overwrite the start
+  // var. The pruned instructions are cached for each configuration.
+  void Run(const std::vector<std::string>& fetch_vars,
+           const std::vector<std::string>& start_vars);
+
+  // Get the indices of the instructions `Run(fetch_vars, start_vars)`
+  // executes, in the execution order.
+  const std::vector<size_t>& PrunedInstructions(
+      const std::vector<std::string>& fetch_vars,
+      const std::vector<std::string>& start_vars);
+
+  // Memoize the subgraph computing `output_vars` from `input_vars` in
+  // `Run()`. The subgraph is made of the instructions `output_vars` depend
+  // on, down to `input_vars` and the weights. The input tensors are hashed
+  // before the subgraph starts, if the outputs of the same inputs are cached,
+  // the subgraph is skipped and the cached outputs are copied back. At most
+  // `capacity` results are cached.
+  void Memoize(const std::vector<std::string>& input_vars,
+               const std::vector<std::string>& output_vars,
+               size_t capacity = 16);
+  bool memoized() const { return memo_ != nullptr; }
+
+  // Plan for the input vars whose shapes vary in `ranges`. The shapes are
+  // inferred with the inputs at their max shapes, and the output buffers
+  // grow to them, no kernel runs. After that, a run with the inputs in their
+  // ranges allocates no output buffer, an input out of its range is warned
+  // about. The ops whose shapes depend on the values of a tensor other than
+  // a weight, and the ones after them, are not planned. The inputs are left
+  // at the opt shapes, filled with zeros.
+  void PreplanShapes(const std::map<std::string, ShapeRange>& ranges);
+
   void set_exec_scope(lite::Scope* x) { exec_scope_ = x; }
   lite::Scope* exec_scope() { return exec_scope_; }
 
   size_t num_instructions() const { return instructions_.size(); }
 
   const std::vector<Instruction>& instructions() const { return instructions_; }
+  std::vector<Instruction>* mutable_instructions() { return &instructions_; }
 
   // `SaveOpInfosToProgram` will update the op list(ops_) of the block 0
   // in ProgramDesc.
@@ -157,8 +215,55 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+
+  // Get the instructions the vars `fetch` depend on, stopping at the vars in
+  // `start`. The vars they read but none of them writes go to `free_vars`.
+  std::vector<size_t> Prune(const std::set<std::string>& fetch,
+                            const std::set<std::string>& start,
+                            std::set<std::string>* free_vars = nullptr) const;
+
+  std::vector<const Tensor*> VarTensors(
+      const std::vector<std::string>& names) const;
+  // Called around the i-th instruction by `Run()`, return true if it is
+  // skipped for a memoized result.
+  bool BeforeMemoized(size_t i);
+  void AfterMemoized(size_t i);
+  // The precision the first reader of the var `name` declares for it.
+  PrecisionType InputPrecision(const std::string& name) const;
+  // Infer the shapes of the instructions and grow their output buffers.
+  void PlanBuffers();
+  void CheckShapeRanges();
+
+  struct Memo {
+    std::vector<std::string> input_vars;
+    std::vector<std::string> output_vars;
+    std::vector<bool> in_subgraph;
+    size_t first{};
+    size_t last{};
+    // The outputs written for the last time by each instruction.
+    std::map<size_t, std::vector<size_t>> outputs_at;
+    std::unique_ptr<TensorMemoCache> cache;
+    // The state of the current run.
+    const std::vector<Tensor>* hit{};
+    uint64_t hash{};
+    std::vector<Tensor> inputs;
+    std::vector<Tensor> outputs;
+  };
+
   std::vector<Instruction> instructions_;
   lite::Scope* exec_scope_{};
+  // The pruned instructions, keyed by the fetch and start vars.
+  std::map<std::string, std::vector<size_t>> pruned_instructions_;
+  std::unique_ptr<Memo> memo_;
+
+  struct ShapeCheck {
+    std::string name;
+    Tensor* tensor{};
+    ShapeRange range;
+    bool warned{false};
+  };
+  // The inputs planned by `PreplanShapes`.
+  std::vector<ShapeCheck> shape_checks_;
 };
 
 }  // namespace lite
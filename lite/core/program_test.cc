@@ -0,0 +1,372 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/program.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+// An op with any inputs and outputs, its kernel records the runs and sets
+// each output to the sum of the inputs plus one.
+class FakeOp : public OpLite {
+ public:
+  FakeOp() : OpLite("fake") {}
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "fake"; }
+};
+
+class FakeKernel : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  FakeKernel(std::vector<std::string>* log,
+             const std::string& name,
+             Scope* scope,
+             const std::vector<std::string>& inputs,
+             const std::vector<std::string>& outputs)
+      : log_(log),
+        name_(name),
+        scope_(scope),
+        inputs_(inputs),
+        outputs_(outputs) {}
+
+  void Run() override {
+    log_->push_back(name_);
+    float sum = 1.f;
+    for (auto& name : inputs_) {
+      sum += scope_->FindVar(name)->Get<Tensor>().data<float>()[0];
+    }
+    for (auto& name : outputs_) {
+      auto* out = scope_->FindVar(name)->GetMutable<Tensor>();
+      out->Resize({1});
+      out->mutable_data<float>()[0] = sum;
+    }
+  }
+
+ private:
+  std::vector<std::string>* log_;
+  std::string name_;
+  Scope* scope_;
+  std::vector<std::string> inputs_;
+  std::vector<std::string> outputs_;
+};
+
+// Its output takes the shape of its input, the outputs whose shapes are
+// inferred are recorded.
+class ShapeOp : public OpLite {
+ public:
+  explicit ShapeOp(std::vector<std::string>* log)
+      : OpLite("shape_like"), log_(log) {}
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    x_ = scope->FindVar(opdesc.Input("X").front())->GetMutable<Tensor>();
+    out_name_ = opdesc.Output("Out").front();
+    out_ = scope->FindVar(out_name_)->GetMutable<Tensor>();
+    return true;
+  }
+  bool InferShape() const override {
+    log_->push_back(out_name_);
+    out_->Resize(x_->dims());
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "shape_like"; }
+
+ private:
+  std::vector<std::string>* log_;
+  Tensor* x_{};
+  Tensor* out_{};
+  std::string out_name_;
+};
+
+// Its output "y" takes the shape of the input "x", the shapes it is
+// re-initialized for are recorded.
+class ShapeKernel : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  ShapeKernel(Scope* scope, std::vector<DDim>* reinit)
+      : scope_(scope), reinit_(reinit) {}
+
+  void ReInitWhenNeeded() override {
+    auto& dims = scope_->FindVar("x")->Get<Tensor>().dims();
+    if (dims != last_dims_) {
+      reinit_->push_back(dims);
+      last_dims_ = dims;
+    }
+  }
+
+  void Run() override {
+    auto& x = scope_->FindVar("x")->Get<Tensor>();
+    auto* y = scope_->FindVar("y")->GetMutable<Tensor>();
+    y->Resize(x.dims());
+    const float* x_data = x.data<float>();
+    float* y_data = y->mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); ++i) {
+      y_data[i] = x_data[i] + 1.f;
+    }
+  }
+
+ private:
+  Scope* scope_;
+  std::vector<DDim>* reinit_;
+  DDim last_dims_;
+};
+
+class RuntimeProgramTest : public ::testing::Test {
+ protected:
+  // x -> a -> y0 -> c -> out0
+  //      a -> y1 -> d -> out1
+  // x -> b -> z  -> d
+  void SetUp() override {
+    for (auto& name : {"x", "y0", "y1", "z", "out0", "out1"}) {
+      scope_.Var(name);
+    }
+    SetVar("x", 0.f);
+    std::vector<Instruction> insts;
+    auto add = [&](const std::string& name,
+                   const std::vector<std::string>& inputs,
+                   const std::vector<std::string>& outputs) {
+      cpp::OpDesc desc;
+      desc.SetType("fake");
+      desc.SetInput("X", inputs);
+      desc.SetOutput("Out", outputs);
+      std::shared_ptr<OpLite> op(new FakeOp);
+      op->Attach(desc, &scope_);
+      std::unique_ptr<KernelBase> kernel(
+          new FakeKernel(&log_, name, &scope_, inputs, outputs));
+      insts.emplace_back(op, std::move(kernel));
+    };
+    add("a", {"x"}, {"y0", "y1"});
+    add("b", {"x"}, {"z"});
+    add("c", {"y0"}, {"out0"});
+    add("d", {"y1", "z"}, {"out1"});
+    program_.reset(new RuntimeProgram(std::move(insts)));
+    program_->set_exec_scope(&scope_);
+  }
+
+  void SetVar(const std::string& name, float v) {
+    auto* x = scope_.FindVar(name)->GetMutable<Tensor>();
+    x->Resize({1});
+    x->mutable_data<float>()[0] = v;
+  }
+
+  float GetVar(const std::string& name) {
+    return scope_.FindVar(name)->Get<Tensor>().data<float>()[0];
+  }
+
+  std::vector<std::string> Run() {
+    log_.clear();
+    program_->Run();
+    return log_;
+  }
+
+  std::vector<std::string> Run(const std::vector<std::string>& fetch,
+                               const std::vector<std::string>& start) {
+    log_.clear();
+    program_->Run(fetch, start);
+    return log_;
+  }
+
+  Scope scope_;
+  std::vector<std::string> log_;
+  std::unique_ptr<RuntimeProgram> program_;
+};
+
+TEST_F(RuntimeProgramTest, fetch) {
+  using names = std::vector<std::string>;
+  EXPECT_EQ(Run({"out0"}, {}), names({"a", "c"}));
+  EXPECT_EQ(Run({"out1"}, {}), names({"a", "b", "d"}));
+  EXPECT_EQ(Run({"out0", "out1"}, {}), names({"a", "b", "c", "d"}));
+  EXPECT_EQ(Run({"z"}, {}), names({"b"}));
+}
+
+TEST_F(RuntimeProgramTest, start) {
+  using names = std::vector<std::string>;
+  SetVar("y0", 0.f);
+  SetVar("y1", 0.f);
+  SetVar("z", 0.f);
+  EXPECT_EQ(Run({"out0"}, {"y0"}), names({"c"}));
+  EXPECT_EQ(Run({"out1"}, {"z"}), names({"a", "d"}));
+  EXPECT_EQ(Run({"out1"}, {"y1", "z"}), names({"d"}));
+  // The producer of y0 is needed for y1, it would overwrite y0.
+  EXPECT_DEATH(Run({"out0", "out1"}, {"y0"}), "");
+  EXPECT_EQ(Run({"out0", "out1"}, {"y0", "y1"}), names({"b", "c", "d"}));
+  // A fetch var set by the caller needs nothing to run.
+  EXPECT_TRUE(Run({"y0"}, {"y0"}).empty());
+}
+
+TEST_F(RuntimeProgramTest, cache) {
+  auto& insts = program_->PrunedInstructions({"out0", "out1"}, {"z"});
+  EXPECT_EQ(insts, std::vector<size_t>({0, 2, 3}));
+  // The order of the names does not matter.
+  EXPECT_EQ(&program_->PrunedInstructions({"out1", "out0"}, {"z"}), &insts);
+  EXPECT_NE(&program_->PrunedInstructions({"out0", "out1"}, {}), &insts);
+}
+
+TEST_F(RuntimeProgramTest, memoize) {
+  using names = std::vector<std::string>;
+  // The subgraph {a, c} computes out0 from x, y1 is read by d outside of it.
+  program_->Memoize({"x"}, {"out0", "y1"}, 2);
+  EXPECT_EQ(Run(), names({"a", "b", "c", "d"}));
+  EXPECT_EQ(GetVar("out0"), 2.f);
+  EXPECT_EQ(GetVar("out1"), 3.f);
+
+  SetVar("out0", 0.f);
+  SetVar("y1", 0.f);
+  EXPECT_EQ(Run(), names({"b", "d"}));
+  EXPECT_EQ(GetVar("out0"), 2.f);
+  EXPECT_EQ(GetVar("out1"), 3.f);
+
+  SetVar("x", 1.f);
+  EXPECT_EQ(Run(), names({"a", "b", "c", "d"}));
+  EXPECT_EQ(GetVar("out0"), 3.f);
+  SetVar("x", 2.f);
+  EXPECT_EQ(Run(), names({"a", "b", "c", "d"}));
+  SetVar("x", 1.f);
+  EXPECT_EQ(Run(), names({"b", "d"}));
+  EXPECT_EQ(GetVar("out0"), 3.f);
+  EXPECT_EQ(GetVar("out1"), 5.f);
+  // x = 0 is evicted by the capacity of 2.
+  SetVar("x", 0.f);
+  EXPECT_EQ(Run(), names({"a", "b", "c", "d"}));
+}
+
+std::shared_ptr<OpLite> MakeShapeOp(Scope* scope,
+                                    std::vector<std::string>* log,
+                                    const std::string& x,
+                                    const std::string& out,
+                                    const std::string& shape = "",
+                                    const std::string& shape_arg = "Shape") {
+  cpp::OpDesc desc;
+  desc.SetType("shape_like");
+  desc.SetInput("X", {x});
+  if (!shape.empty()) desc.SetInput(shape_arg, {shape});
+  desc.SetOutput("Out", {out});
+  std::shared_ptr<OpLite> op(new ShapeOp(log));
+  op->Attach(desc, scope);
+  return op;
+}
+
+TEST(RuntimeProgram, preplan_shapes) {
+  Scope scope;
+  scope.Var("x");
+  scope.Var("y");
+  std::vector<std::string> inferred;
+  std::vector<DDim> reinit;
+  std::vector<Instruction> insts;
+  insts.emplace_back(
+      MakeShapeOp(&scope, &inferred, "x", "y"),
+      std::unique_ptr<KernelBase>(new ShapeKernel(&scope, &reinit)));
+  RuntimeProgram program(std::move(insts));
+  program.set_exec_scope(&scope);
+
+  program.PreplanShapes({{"x", ShapeRange{{1, 2}, {1, 4}, {2, 8}}}});
+  // The shapes are inferred at the max shape, no kernel runs, and the input
+  // is left at the opt one.
+  EXPECT_EQ(inferred, std::vector<std::string>({"y"}));
+  EXPECT_TRUE(reinit.empty());
+  auto* x = scope.FindVar("x")->GetMutable<Tensor>();
+  EXPECT_EQ(x->dims(), DDim({1, 4}));
+  EXPECT_TRUE(x->lod().empty());
+
+  // No buffer is allocated for the shapes in the range.
+  int64_t live_bytes = GetMemoryStats(TARGET(kHost)).live_bytes;
+  for (auto& shape : std::vector<std::vector<int64_t>>{
+           {2, 8}, {1, 2}, {2, 5}, {1, 4}}) {
+    x->Resize(shape);
+    float* x_data = x->mutable_data<float>();
+    for (int64_t i = 0; i < x->numel(); ++i) {
+      x_data[i] = i;
+    }
+    program.Run();
+    auto& y = scope.FindVar("y")->Get<Tensor>();
+    ASSERT_EQ(y.dims(), x->dims());
+    for (int64_t i = 0; i < y.numel(); ++i) {
+      EXPECT_EQ(y.data<float>()[i], i + 1.f);
+    }
+    EXPECT_EQ(GetMemoryStats(TARGET(kHost)).live_bytes, live_bytes);
+  }
+  // Only the shape changes re-initialize the kernel.
+  EXPECT_EQ(reinit.size(), 4u);
+}
+
+TEST(RuntimeProgram, preplan_shapes_skip_shape_inputs) {
+  Scope scope;
+  for (auto& name : {"x", "s", "y", "z", "w"}) {
+    scope.Var(name);
+  }
+  // x -> a(Shape: s) -> y -> b -> z
+  // x -> c -> w
+  std::vector<std::string> inferred;
+  std::vector<std::string> log;
+  std::vector<Instruction> insts;
+  auto add = [&](const std::string& name,
+                 const std::string& x,
+                 const std::string& out,
+                 const std::string& shape) {
+    insts.emplace_back(MakeShapeOp(&scope, &inferred, x, out, shape),
+                       std::unique_ptr<KernelBase>(
+                           new FakeKernel(&log, name, &scope, {x}, {out})));
+  };
+  add("a", "x", "y", "s");
+  add("b", "y", "z", "");
+  add("c", "x", "w", "");
+  RuntimeProgram program(std::move(insts));
+  program.set_exec_scope(&scope);
+
+  program.PreplanShapes({{"x", ShapeRange{{1}, {2}, {4}}}});
+  // The shape of y depends on the values of s, neither a nor b is planned.
+  EXPECT_EQ(inferred, std::vector<std::string>({"w"}));
+  EXPECT_TRUE(log.empty());
+  EXPECT_EQ(scope.FindVar("w")->Get<Tensor>().dims(), DDim({4}));
+}
+
+TEST(RuntimeProgram, preplan_shapes_skip_computed_values) {
+  Scope scope;
+  for (auto& name : {"x", "t", "u", "v"}) {
+    scope.Var(name);
+  }
+  auto* k = scope.Var("k")->GetMutable<Tensor>();
+  k->Resize({1});
+  k->mutable_data<float>()[0] = 1.f;
+  k->set_persistable(true);
+  // x -> f -> t, x -> r(Start: t) -> u, as a fill_constant feeding a range.
+  // x -> q(Start: k) -> v, with the start a weight.
+  std::vector<std::string> inferred;
+  std::vector<std::string> log;
+  std::vector<Instruction> insts;
+  auto add = [&](const std::string& name,
+                 const std::string& out,
+                 const std::string& start) {
+    insts.emplace_back(MakeShapeOp(&scope, &inferred, "x", out, start, "Start"),
+                       std::unique_ptr<KernelBase>(
+                           new FakeKernel(&log, name, &scope, {"x"}, {out})));
+  };
+  add("f", "t", "");
+  add("r", "u", "t");
+  add("q", "v", "k");
+  RuntimeProgram program(std::move(insts));
+  program.set_exec_scope(&scope);
+
+  program.PreplanShapes({{"x", ShapeRange{{1}, {2}, {4}}}});
+  // t is only computed by running f, the start of r is unknown.
+  EXPECT_EQ(inferred, std::vector<std::string>({"t", "v"}));
+  EXPECT_TRUE(log.empty());
+}
+
+}  // namespace lite
+}  // namespace paddle
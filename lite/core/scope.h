@@ -39,6 +39,10 @@ class Scope final {
 
   Variable* Var(const std::string& name);
 
+  // Create the variable in this scope, even if an ancestor has one with the
+  // same name.
+  Variable* LocalVar(const std::string& name);
+
   Variable* FindVar(const std::string& name) const;
 
   Variable* FindLocalVar(const std::string& name) const;
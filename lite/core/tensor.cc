@@ -15,6 +15,7 @@
 #ifndef LITE_WITH_FPGA
 
 #include "lite/core/tensor.h"
+#include <algorithm>
 #include <string>
 #include "lite/utils/string.h"
 
@@ -77,20 +78,51 @@ void TensorLite::ShareDataWith(const TensorLite &other) {
   target_ = other.target_;
   lod_ = other.lod_;
   memory_size_ = other.memory_size_;
+  offset_ = other.offset_;
 }
 
 void TensorLite::CopyDataFrom(const TensorLite &other) {
   dims_ = other.dims_;
-  target_ = other.target_;
   lod_ = other.lod_;
-  memory_size_ = other.memory_size_;
-  buffer_->CopyDataFrom(*other.buffer_, memory_size_);
+  // TODO(Superjomn) support copy between different targets.
+  void *dst = mutable_data(other.target_, other.memory_size_);
+  TargetCopy(target_, dst, other.raw_data(), memory_size_);
 }
 
 void *TensorLite::mutable_data(size_t memory_size) {
   memory_size_ = memory_size;
-  buffer_->ResetLazy(target_, memory_size_);
-  return buffer_->data();
+  ReserveBuffer(target_);
+  return static_cast<char *>(buffer_->data()) + offset_;
+}
+
+void TensorLite::ResetBuffer(const std::shared_ptr<Buffer> &buffer) {
+  CHECK(buffer);
+  CHECK_GE(buffer->space(), memory_size_);
+  buffer_ = buffer;
+  target_ = buffer->target();
+  offset_ = 0;
+}
+
+void TensorLite::ReserveBuffer(TargetType target) {
+  if (buffer_->read_only()) {
+    auto buffer = std::make_shared<Buffer>();
+    buffer->ResetLazy(target, offset_ + memory_size_);
+    if (buffer_->target() == target) {
+      TargetCopy(target,
+                 buffer->data(),
+                 buffer_->data(),
+                 std::min(buffer_->space(), offset_ + memory_size_));
+    }
+    buffer_ = buffer;
+    return;
+  }
+  if (buffer_.use_count() > 1 && buffer_->data() &&
+      (buffer_->target() != target ||
+       buffer_->space() < offset_ + memory_size_)) {
+    buffer_ = std::make_shared<Buffer>();
+    offset_ = 0;
+  }
+  buffer_->ResetLazy(target, offset_ + memory_size_);
 }
 
 void *TensorLite::mutable_data(TargetType target, size_t memory_size) {
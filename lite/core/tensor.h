@@ -140,7 +140,7 @@ class TensorLite {
   template <typename T, typename R = T>
   R *mutable_data() {
     memory_size_ = dims_.production() * sizeof(T);
-    buffer_->ResetLazy(target_, memory_size_);
+    ReserveBuffer(target_);
     return reinterpret_cast<R *>(static_cast<char *>(buffer_->data()) +
                                  offset_);
   }
@@ -162,7 +162,7 @@ class TensorLite {
   R *mutable_data(TargetType target) {
     target_ = target;
     memory_size_ = dims_.production() * sizeof(T);
-    buffer_->ResetLazy(target, memory_size());
+    ReserveBuffer(target);
     return reinterpret_cast<R *>(static_cast<char *>(buffer_->data()) +
                                  offset_);
   }
@@ -182,6 +182,12 @@ class TensorLite {
 
   bool IsInitialized() const { return buffer_->data(); }
 
+  // The buffer holding the data, which may be shared with other tensors.
+  const std::shared_ptr<Buffer> &buffer() const { return buffer_; }
+  // Hold the data of the tensor in `buffer` from now on, with the same bytes
+  // at its beginning.
+  void ResetBuffer(const std::shared_ptr<Buffer> &buffer);
+
   // Other share data to this.
   void ShareDataWith(const TensorLite &other);
 
@@ -203,6 +209,12 @@ class TensorLite {
   }
 
  private:
+  // Make sure the buffer holds `memory_size_` bytes after `offset_`. A view
+  // never grows the buffer it shares with other tensors, which would free the
+  // data they hold, it takes a buffer of its own instead. A read-only buffer
+  // is copied on the first write.
+  void ReserveBuffer(TargetType target);
+
   TargetType target_{TargetType::kHost};
   // precision_ and persistable_ are only used for persistable vars.
   // If your tensor wants to be saved and loaded correctly, you must
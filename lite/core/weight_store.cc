@@ -0,0 +1,171 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/weight_store.h"
+#include <algorithm>
+#include <cstring>
+#include "lite/utils/hash.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+constexpr uint64_t kMul = 0x9ddfea08eb382d69ULL;
+
+inline uint64_t Mix(uint64_t h, uint64_t v) {
+  v *= kMul;
+  v ^= v >> 47;
+  return (h ^ v) * kMul;
+}
+
+inline uint64_t Load64(const char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+bool IsHostTarget(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+
+// The NUMA node the weights of the calling thread are loaded for, -1 if any.
+thread_local int weight_numa_node = -1;
+
+}  // namespace
+
+WeightStore::NumaNodeGuard::NumaNodeGuard(int node)
+    : prev_node_(weight_numa_node) {
+  if (node >= 0) weight_numa_node = node;
+}
+
+WeightStore::NumaNodeGuard::~NumaNodeGuard() { weight_numa_node = prev_node_; }
+
+int WeightStore::NumaNodeGuard::current() { return weight_numa_node; }
+
+WeightStore &WeightStore::Global() {
+  static auto *x = new WeightStore;
+  return *x;
+}
+
+// Four independent lanes of 8 bytes, so that the multiplications of a block
+// overlap, the weights are hashed at memory speed.
+uint64_t WeightStore::HashBytes(const void *data, size_t size) {
+  const char *p = static_cast<const char *>(data);
+  uint64_t h[4] = {size, size ^ kMul, size + kMul, size * kMul};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    h[0] = Mix(h[0], Load64(p + i));
+    h[1] = Mix(h[1], Load64(p + i + 8));
+    h[2] = Mix(h[2], Load64(p + i + 16));
+    h[3] = Mix(h[3], Load64(p + i + 24));
+  }
+  for (; i + 8 <= size; i += 8) {
+    h[0] = Mix(h[0], Load64(p + i));
+  }
+  if (i < size) {
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + i, size - i);
+    h[1] = Mix(h[1], tail);
+  }
+  uint64_t res = Mix(Mix(Mix(h[0], h[1]), h[2]), h[3]);
+  return res ^ (res >> 29);
+}
+
+void WeightStore::set_enabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = enabled;
+}
+
+bool WeightStore::enabled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return enabled_;
+}
+
+void WeightStore::Dedup(lite::Tensor *tensor) {
+  CHECK(tensor);
+#ifndef LITE_WITH_FPGA
+  if (!enabled()) return;
+  const auto &buffer = tensor->buffer();
+  const size_t bytes = tensor->memory_size();
+  if (!buffer->data() || bytes == 0 || tensor->offset() != 0 ||
+      !IsHostTarget(buffer->target())) {
+    return;
+  }
+  auto dims = tensor->dims().Vectorize();
+  size_t key = HashBytes(tensor->raw_data(), bytes);
+  key = hash_combine(key, static_cast<int>(tensor->precision()));
+  key = hash_combine(key, static_cast<int>(buffer->target()));
+  for (auto dim : dims) {
+    key = hash_combine(key, dim);
+  }
+  const int numa_node = weight_numa_node;
+  key = hash_combine(key, numa_node);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = entries_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto &entry = it->second;
+    auto shared = entry.buffer.lock();
+    if (!shared || entry.bytes != bytes || entry.dims != dims ||
+        entry.precision != tensor->precision() ||
+        entry.numa_node != numa_node || shared->target() != buffer->target()) {
+      continue;
+    }
+    if (shared == buffer) return;
+    if (std::memcmp(shared->data(), tensor->raw_data(), bytes) != 0) {
+      continue;
+    }
+    tensor->ResetBuffer(shared);
+    ++num_shared_;
+    shared_bytes_ += bytes;
+    return;
+  }
+
+  buffer->set_read_only(true);
+  entries_.emplace(
+      key, Entry{buffer, dims, tensor->precision(), bytes, numa_node});
+  if (++num_inserted_ > std::max<size_t>(entries_.size() / 2, 64)) {
+    PruneLocked();
+  }
+#endif  // LITE_WITH_FPGA
+}
+
+void WeightStore::PruneLocked() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.buffer.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  num_inserted_ = 0;
+}
+
+WeightStore::Stats WeightStore::stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PruneLocked();
+  Stats stats;
+  stats.num_weights = entries_.size();
+  for (auto &item : entries_) {
+    stats.bytes += item.second.bytes;
+  }
+  stats.num_shared = num_shared_;
+  stats.shared_bytes = shared_bytes_;
+  return stats;
+}
+
+}  // namespace lite
+}  // namespace paddle
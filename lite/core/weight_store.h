@@ -0,0 +1,100 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+#include "lite/core/memory.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * A process-wide store of the loaded weights, addressed by their content. The
+ * model loaders pass every weight they load to `Dedup`, and a weight with the
+ * same bytes, dims and precision as one already held by a predictor takes its
+ * buffer instead of keeping a copy, e.g. for the many variants of the same
+ * backbone served by one process.
+ *
+ * The shared buffers are read-only: a tensor copies its buffer before the
+ * first write, so that a pass or a kernel that transforms a weight in place
+ * does not change it for the other predictors. The store only holds weak
+ * references, a buffer is freed with the last tensor using it.
+ */
+class WeightStore {
+ public:
+  static WeightStore &Global();
+
+  // Share the buffer of an identical weight with `tensor`, or register its
+  // buffer for the next ones. Only the host tensors are shared.
+  void Dedup(lite::Tensor *tensor);
+
+  // On by default, only affects the weights loaded afterwards.
+  void set_enabled(bool enabled);
+  bool enabled() const;
+
+  struct Stats {
+    // The distinct weights held by the predictors.
+    int64_t num_weights{0};
+    int64_t bytes{0};
+    // The weights loaded so far which were found in the store.
+    int64_t num_shared{0};
+    int64_t shared_bytes{0};
+  };
+  Stats stats();
+
+  static uint64_t HashBytes(const void *data, size_t size);
+
+  // While it lives, the weights loaded by the calling thread are only shared
+  // with the ones loaded for the same NUMA node, so that the predictors bound
+  // to a node read a copy in its memory. A negative node keeps the one of
+  // the enclosing guard.
+  class NumaNodeGuard {
+   public:
+    explicit NumaNodeGuard(int node);
+    ~NumaNodeGuard();
+
+    // The node of the calling thread, -1 if it is not in a guard.
+    static int current();
+
+   private:
+    int prev_node_;
+  };
+
+ private:
+  struct Entry {
+    std::weak_ptr<Buffer> buffer;
+    std::vector<int64_t> dims;
+    PrecisionType precision;
+    size_t bytes;
+    int numa_node;
+  };
+
+  void PruneLocked();
+
+  mutable std::mutex mutex_;
+  bool enabled_{true};
+  std::unordered_multimap<uint64_t, Entry> entries_;
+  int64_t num_shared_{0};
+  int64_t shared_bytes_{0};
+  // The entries inserted since the expired ones were last removed.
+  size_t num_inserted_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,122 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/weight_store.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+void FillWeight(Tensor* tensor, const std::vector<int64_t>& dims, float v) {
+  tensor->Resize(dims);
+  tensor->set_precision(PRECISION(kFloat));
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = v + i;
+  }
+}
+
+TEST(weight_store, hash) {
+  std::vector<char> bytes(100);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<char>(i);
+  }
+  // Every byte and the size change the hash.
+  auto hash = WeightStore::HashBytes(bytes.data(), bytes.size());
+  EXPECT_NE(WeightStore::HashBytes(bytes.data(), bytes.size() - 1), hash);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] ^= 1;
+    EXPECT_NE(WeightStore::HashBytes(bytes.data(), bytes.size()), hash);
+    bytes[i] ^= 1;
+  }
+  EXPECT_EQ(WeightStore::HashBytes(bytes.data(), bytes.size()), hash);
+}
+
+TEST(weight_store, dedup) {
+  auto& store = WeightStore::Global();
+  auto before = store.stats();
+  {
+    Tensor a, b, c, d;
+    FillWeight(&a, {4, 8}, 1.f);
+    FillWeight(&b, {4, 8}, 1.f);
+    FillWeight(&c, {4, 8}, 2.f);
+    FillWeight(&d, {8, 4}, 1.f);
+    for (auto* tensor : {&a, &b, &c, &d}) {
+      store.Dedup(tensor);
+    }
+    EXPECT_EQ(a.buffer(), b.buffer());
+    EXPECT_NE(a.buffer(), c.buffer());
+    EXPECT_NE(a.buffer(), d.buffer());
+    EXPECT_TRUE(a.buffer()->read_only());
+
+    auto stats = store.stats();
+    EXPECT_EQ(stats.num_weights, before.num_weights + 3);
+    EXPECT_EQ(stats.bytes, before.bytes + 3 * 32 * 4);
+    EXPECT_EQ(stats.num_shared, before.num_shared + 1);
+    EXPECT_EQ(stats.shared_bytes, before.shared_bytes + 32 * 4);
+
+    // A write copies the shared data first.
+    const float* shared = a.data<float>();
+    float* data = b.mutable_data<float>();
+    EXPECT_NE(data, shared);
+    EXPECT_FALSE(b.buffer()->read_only());
+    for (int i = 0; i < 32; ++i) {
+      EXPECT_EQ(data[i], 1.f + i);
+    }
+    data[0] = -1.f;
+    EXPECT_EQ(a.data<float>()[0], 1.f);
+  }
+  // The buffers are released with their last tensors.
+  auto stats = store.stats();
+  EXPECT_EQ(stats.num_weights, before.num_weights);
+  EXPECT_EQ(stats.bytes, before.bytes);
+}
+
+TEST(weight_store, numa_node) {
+  auto& store = WeightStore::Global();
+  Tensor a, b, c, d;
+  FillWeight(&a, {16}, 4.f);
+  FillWeight(&b, {16}, 4.f);
+  FillWeight(&c, {16}, 4.f);
+  FillWeight(&d, {16}, 4.f);
+  store.Dedup(&a);
+  {
+    WeightStore::NumaNodeGuard guard(1);
+    store.Dedup(&b);
+    WeightStore::NumaNodeGuard inner(-1);
+    store.Dedup(&c);
+  }
+  store.Dedup(&d);
+  // One copy per node.
+  EXPECT_NE(a.buffer(), b.buffer());
+  EXPECT_EQ(b.buffer(), c.buffer());
+  EXPECT_EQ(a.buffer(), d.buffer());
+}
+
+TEST(weight_store, disabled) {
+  auto& store = WeightStore::Global();
+  store.set_enabled(false);
+  Tensor a, b;
+  FillWeight(&a, {16}, 3.f);
+  FillWeight(&b, {16}, 3.f);
+  store.Dedup(&a);
+  store.Dedup(&b);
+  EXPECT_NE(a.buffer(), b.buffer());
+  EXPECT_FALSE(a.buffer()->read_only());
+  store.set_enabled(true);
+}
+
+}  // namespace lite
+}  // namespace paddle
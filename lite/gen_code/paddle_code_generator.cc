@@ -13,12 +13,22 @@
 // limitations under the License.
 
 #include <gflags/gflags.h>
+#include <map>
+#include "lite/api/paddle_use_ops.h"
 #include "lite/gen_code/gen_code.h"
+#include "lite/gen_code/static_gen_code.h"
 #include "lite/model_parser/model_parser.h"
 #include "lite/model_parser/pb/program_desc.h"
 
 DEFINE_string(optimized_model, "", "");
 DEFINE_string(generated_code_file, "__generated_code__.cc", "");
+DEFINE_string(static_input_shapes,
+              "",
+              "Generate a dependency-free function for these fixed input "
+              "shapes, such as \"image:1,3,224,224;im_info:1,3\".");
+DEFINE_string(static_func_name,
+              "Predict",
+              "The name of the function generated with static_input_shapes.");
 
 namespace paddle {
 namespace lite {
@@ -44,12 +54,50 @@ void GenCode(const std::string& model_dir, const std::string& out_file) {
   file.close();
 }
 
+void GenStaticCode(const std::string& model_dir,
+                   const std::string& input_shapes,
+                   const std::string& func_name,
+                   const std::string& out_file) {
+  lite::Scope scope;
+  cpp::ProgramDesc cpp_desc;
+  std::string model_file = model_dir + "/model";
+  std::string param_file = model_dir + "/params";
+  LoadModelPb(model_dir, model_file, param_file, &scope, &cpp_desc, true);
+
+  std::map<std::string, std::vector<int64_t>> shapes;
+  for (auto& item : Split(input_shapes, ";")) {
+    auto name_shape = Split(item, ":");
+    CHECK_EQ(name_shape.size(), 2UL) << "Invalid input shape " << item;
+    auto& shape = shapes[name_shape[0]];
+    for (auto& dim : Split(name_shape[1], ",")) {
+      shape.push_back(std::stoll(dim));
+    }
+  }
+
+  StaticProgramCodeGenerator codegen(cpp_desc, scope, shapes, func_name);
+
+  std::ofstream file(out_file);
+
+  file << codegen.GenCode();
+
+  file.close();
+  LOG(INFO) << "Generated " << func_name << " in " << out_file << ", with a "
+            << codegen.arena_bytes() << " bytes arena";
+}
+
 }  // namespace gencode
 }  // namespace lite
 }  // namespace paddle
 
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, false);
+  if (!FLAGS_static_input_shapes.empty()) {
+    paddle::lite::gencode::GenStaticCode(FLAGS_optimized_model,
+                                         FLAGS_static_input_shapes,
+                                         FLAGS_static_func_name,
+                                         FLAGS_generated_code_file);
+    return 0;
+  }
   paddle::lite::gencode::GenCode(FLAGS_optimized_model,
                                  FLAGS_generated_code_file);
   return 0;
@@ -0,0 +1,798 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/gen_code/static_gen_code.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include "lite/core/op_lite.h"
+#include "lite/core/op_registry.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace gencode {
+
+// The offsets in the arena are aligned to 64 bytes.
+static constexpr int64_t kArenaAlign = 16;
+
+static int64_t Production(const std::vector<int64_t> &dims,
+                          size_t begin,
+                          size_t end) {
+  int64_t res = 1;
+  for (size_t i = begin; i < end && i < dims.size(); ++i) {
+    res *= dims[i];
+  }
+  return res;
+}
+
+static int64_t Production(const std::vector<int64_t> &dims) {
+  return Production(dims, 0, dims.size());
+}
+
+static std::string IntLiteral(int64_t x) {
+  CHECK_LE(x, std::numeric_limits<int>::max());
+  return std::to_string(x);
+}
+
+// A float literal that reads back to the same float.
+static std::string FloatLiteral(float x) {
+  if (std::isnan(x)) return "NAN";
+  if (std::isinf(x)) return x > 0 ? "INFINITY" : "-INFINITY";
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.9g", x);
+  std::string res(buf);
+  if (res.find_first_of(".e") == std::string::npos) res += ".";
+  return res + "f";
+}
+
+static std::string DimsRepr(const std::vector<int64_t> &dims) {
+  return "[" + Join(dims, ", ") + "]";
+}
+
+static std::string ActLiteral(const std::string &act_type) {
+  if (act_type.empty()) return "ops::kNone";
+  if (act_type == "relu") return "ops::kRelu";
+  if (act_type == "relu6") return "ops::kRelu6";
+  if (act_type == "leaky_relu") return "ops::kLeakyRelu";
+  if (act_type == "sigmoid") return "ops::kSigmoid";
+  if (act_type == "tanh") return "ops::kTanh";
+  LOG(FATAL) << "The static code generator does not support the activation "
+             << act_type;
+  return "";
+}
+
+// The [top, left] paddings of a conv2d or pool2d op, whose paddings are
+// either [h, w] or [top, bottom, left, right].
+static std::pair<int, int> TopLeftPaddings(
+    const cpp::OpDesc &desc,
+    const std::vector<int64_t> &in_dims,
+    const std::vector<int64_t> &out_dims,
+    const std::vector<int> &ksize,
+    const std::vector<int> &strides) {
+  std::string algorithm = desc.HasAttr("padding_algorithm")
+                              ? desc.GetAttr<std::string>("padding_algorithm")
+                              : "EXPLICIT";
+  if (algorithm == "VALID") return {0, 0};
+  if (algorithm == "SAME") {
+    int pad_h = std::max<int64_t>(
+        (out_dims[2] - 1) * strides[0] + ksize[0] - in_dims[2], 0);
+    int pad_w = std::max<int64_t>(
+        (out_dims[3] - 1) * strides[1] + ksize[1] - in_dims[3], 0);
+    return {pad_h / 2, pad_w / 2};
+  }
+  auto paddings = desc.GetAttr<std::vector<int>>("paddings");
+  if (paddings.size() == 2) return {paddings[0], paddings[1]};
+  CHECK_EQ(paddings.size(), 4UL);
+  return {paddings[0], paddings[2]};
+}
+
+StaticProgramCodeGenerator::StaticProgramCodeGenerator(
+    const cpp::ProgramDesc &program,
+    const lite::Scope &scope,
+    const std::map<std::string, std::vector<int64_t>> &input_shapes,
+    const std::string &func_name)
+    : program_(program),
+      scope_(scope),
+      input_shapes_(input_shapes),
+      func_name_(func_name) {}
+
+std::string StaticProgramCodeGenerator::GenCode() {
+  auto *block = program_.GetBlock<cpp::BlockDesc>(0);
+
+  // The shapes are inferred in a scope of its own, sharing the weights.
+  lite::Scope exec_scope;
+  for (size_t i = 0; i < block->VarsSize(); ++i) {
+    auto *var = block->GetVar<cpp::VarDesc>(i);
+    auto name = var->Name();
+    if (name == "feed" || name == "fetch") continue;
+    auto *tensor = exec_scope.Var(name)->GetMutable<lite::Tensor>();
+    if (var->Persistable()) {
+      auto *weight = scope_.FindVar(name);
+      CHECK(weight) << "The weight " << name << " is not loaded";
+      tensor->ShareDataWith(weight->Get<lite::Tensor>());
+    }
+  }
+
+  for (size_t i = 0; i < block->OpsSize(); ++i) {
+    step_ = static_cast<int>(i);
+    AddOp(*block->GetOp<cpp::OpDesc>(i), &exec_scope);
+  }
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    CHECK(!input_names_[i].empty()) << "The feed column " << i << " is unused";
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    CHECK(!outputs_[i].first.empty()) << "The fetch column " << i
+                                      << " is unused";
+  }
+  PlanArena();
+
+  STL::stringstream os;
+  os << "// Generated by StaticProgramCodeGenerator, do not edit.\n";
+  os << "//\n";
+  os << "// Inputs:\n";
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    os << "//   inputs[" << i << "]: " << input_names_[i] << ", float"
+       << DimsRepr(input_shapes_.at(input_names_[i])) << "\n";
+  }
+  os << "// Outputs:\n";
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    os << "//   outputs[" << i << "]: " << outputs_[i].first << ", float"
+       << DimsRepr(values_[outputs_[i].second].dims) << "\n";
+  }
+  os << "// Arena: " << arena_bytes() << " bytes.\n";
+  os << "\n";
+  os << "#include \"lite/gen_code/static_ops.h\"\n";
+  os << "\n";
+  os << "namespace paddle {\n";
+  os << "namespace gencode {\n";
+  os << "namespace {\n";
+  os << "\n";
+  for (size_t i = 0; i < constants_.size(); ++i) {
+    EmitConstant(i, &os);
+  }
+  os << "alignas(64) float arena[" << std::max<int64_t>(arena_size_, 1)
+     << "];\n";
+  os << "\n";
+  os << "}  // namespace\n";
+  os << "\n";
+  os << "void " << func_name_
+     << "(const float* const* inputs, float* const* outputs) {\n";
+  os << "  namespace ops = ::paddle::lite::gencode::static_ops;\n";
+  for (auto &call : calls_) {
+    EmitCall(call, &os);
+  }
+  os << "}\n";
+  os << "\n";
+  os << "}  // namespace gencode\n";
+  os << "}  // namespace paddle\n";
+  return os.str();
+}
+
+void StaticProgramCodeGenerator::InferShape(const cpp::OpDesc &desc,
+                                            lite::Scope *exec_scope) {
+  auto op = LiteOpRegistry::Global().Create(desc.Type());
+  CHECK(op) << "The op " << desc.Type() << " is not registered";
+  op->Attach(desc, exec_scope);
+  CHECK(op->CheckShape()) << "The shapes of " << desc.Type() << " mismatch";
+  op->InferShape();
+  out_dims_.clear();
+  for (auto &param : desc.OutputArgumentNames()) {
+    for (auto &name : desc.Output(param)) {
+      out_dims_[name] =
+          exec_scope->FindVar(name)->Get<lite::Tensor>().dims().Vectorize();
+    }
+  }
+}
+
+void StaticProgramCodeGenerator::AddOp(const cpp::OpDesc &desc,
+                                       lite::Scope *exec_scope) {
+  const auto &type = desc.Type();
+  if (type == "feed") {
+    auto name = desc.Output("Out").front();
+    int col = desc.GetAttr<int>("col");
+    auto it = input_shapes_.find(name);
+    CHECK(it != input_shapes_.end()) << "The shape of the input " << name
+                                     << " is not given";
+    exec_scope->FindVar(name)->GetMutable<lite::Tensor>()->Resize(it->second);
+    Value value;
+    value.dims = it->second;
+    value.input = col;
+    var_values_[name] = values_.size();
+    values_.push_back(value);
+    if (input_names_.size() <= static_cast<size_t>(col)) {
+      input_names_.resize(col + 1);
+    }
+    input_names_[col] = name;
+    return;
+  }
+  if (type == "fetch") {
+    auto name = desc.Input("X").front();
+    int col = desc.GetAttr<int>("col");
+    int x = Use(name);
+    if (outputs_.size() <= static_cast<size_t>(col)) {
+      outputs_.resize(col + 1);
+    }
+    outputs_[col] = std::make_pair(name, x);
+    AddCall("", {"fetch: " + name});
+    AddCall("std::memcpy",
+            {"outputs[" + std::to_string(col) + "]",
+             x,
+             "sizeof(float) * " + IntLiteral(Production(values_[x].dims))});
+    return;
+  }
+
+  InferShape(desc, exec_scope);
+  std::vector<std::string> outputs;
+  for (auto &param : desc.OutputArgumentNames()) {
+    for (auto &name : desc.Output(param)) outputs.push_back(name);
+  }
+  AddCall("", {type + ": " + Join(outputs, ", ")});
+
+  if (type == "fc") {
+    AddFc(desc);
+  } else if (type == "mul") {
+    AddMul(desc);
+  } else if (type.find("elementwise_") != std::string::npos) {
+    AddElementwise(desc);
+  } else if (type == "relu" || type == "relu6" || type == "leaky_relu" ||
+             type == "sigmoid" || type == "tanh") {
+    AddActivation(desc);
+  } else if (type == "scale") {
+    AddScale(desc);
+  } else if (type == "softmax") {
+    AddSoftmax(desc);
+  } else if (type == "conv2d" || type == "depthwise_conv2d") {
+    AddConv2d(desc);
+  } else if (type == "pool2d") {
+    AddPool2d(desc);
+  } else if (type == "batch_norm") {
+    AddBatchNorm(desc);
+  } else if (type == "concat") {
+    AddConcat(desc);
+  } else if (type == "transpose" || type == "transpose2") {
+    AddTranspose(desc);
+  } else if (type == "dropout") {
+    AddDropout(desc);
+  } else if (type == "reshape" || type == "reshape2" || type == "flatten" ||
+             type == "flatten2" || type == "squeeze" || type == "squeeze2" ||
+             type == "unsqueeze" || type == "unsqueeze2") {
+    AddAlias(desc.Input("X").front(), desc.Output("Out").front());
+  } else if (type == "io_copy" || type == "io_copy_once") {
+    AddAlias(desc.Input("Input").front(), desc.Output("Out").front());
+  } else {
+    LOG(FATAL) << "The static code generator does not support the op " << type;
+  }
+}
+
+void StaticProgramCodeGenerator::AddFc(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("Input").front());
+  int w = Use(desc.Input("W").front());
+  Arg bias("nullptr");
+  if (desc.HasInput("Bias") && !desc.Input("Bias").empty()) {
+    bias = Use(desc.Input("Bias").front());
+  }
+  int out = Define(desc.Output("Out").front());
+  int in_num_col_dims = desc.GetAttr<int>("in_num_col_dims");
+  std::string act_type = desc.HasAttr("activation_type")
+                             ? desc.GetAttr<std::string>("activation_type")
+                             : "";
+  const auto x_dims = values_[x].dims;
+  const auto w_dims = values_[w].dims;
+  AddCall("ops::Fc",
+          {x,
+           w,
+           bias,
+           out,
+           IntLiteral(Production(x_dims, 0, in_num_col_dims)),
+           IntLiteral(Production(x_dims, in_num_col_dims, x_dims.size())),
+           IntLiteral(w_dims[1]),
+           ActLiteral(act_type),
+           "0.f"});
+}
+
+void StaticProgramCodeGenerator::AddMul(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int y = Use(desc.Input("Y").front());
+  int out = Define(desc.Output("Out").front());
+  int x_num_col_dims = desc.GetAttr<int>("x_num_col_dims");
+  int y_num_col_dims = desc.GetAttr<int>("y_num_col_dims");
+  const auto x_dims = values_[x].dims;
+  const auto y_dims = values_[y].dims;
+  AddCall("ops::Fc",
+          {x,
+           y,
+           "nullptr",
+           out,
+           IntLiteral(Production(x_dims, 0, x_num_col_dims)),
+           IntLiteral(Production(x_dims, x_num_col_dims, x_dims.size())),
+           IntLiteral(Production(y_dims, y_num_col_dims, y_dims.size())),
+           "ops::kNone",
+           "0.f"});
+}
+
+void StaticProgramCodeGenerator::AddElementwise(const cpp::OpDesc &desc) {
+  static const std::map<std::string, std::string> kFunctors{
+      {"add", "ops::AddFunctor"},
+      {"sub", "ops::SubFunctor"},
+      {"mul", "ops::MulFunctor"},
+      {"div", "ops::DivFunctor"},
+      {"max", "ops::MaxFunctor"}};
+  const auto &type = desc.Type();
+  // elementwise_<op> or fusion_elementwise_<op>_activation.
+  auto begin = type.find("elementwise_") + std::string("elementwise_").size();
+  auto end = type.find('_', begin);
+  auto functor = kFunctors.find(type.substr(begin, end - begin));
+  CHECK(functor != kFunctors.end()) << "Unsupported op " << type;
+  std::string act_type;
+  if (type.find("fusion_") == 0) {
+    act_type = desc.GetAttr<std::string>("act_type");
+  }
+
+  int x = Use(desc.Input("X").front());
+  int y = Use(desc.Input("Y").front());
+  int out = Define(desc.Output("Out").front());
+  const auto x_dims = values_[x].dims;
+  auto y_dims = values_[y].dims;
+  int axis = desc.GetAttr<int>("axis");
+  if (axis < 0) axis = x_dims.size() - y_dims.size();
+  // The dimensions of 1 at both ends of y are broadcast anyway.
+  while (y_dims.size() > 1 && y_dims.back() == 1) y_dims.pop_back();
+  while (y_dims.size() > 1 && y_dims.front() == 1) {
+    y_dims.erase(y_dims.begin());
+    ++axis;
+  }
+  int64_t n = Production(y_dims);
+  if (n == 1) {
+    axis = x_dims.size();
+    y_dims.clear();
+  }
+  CHECK_LE(axis + y_dims.size(), x_dims.size());
+  for (size_t i = 0; i < y_dims.size(); ++i) {
+    CHECK_EQ(y_dims[i], x_dims[axis + i])
+        << "The static code generator only broadcasts Y to X in " << type;
+  }
+  AddCall("ops::Elementwise<" + functor->second + ">",
+          {x,
+           y,
+           out,
+           IntLiteral(Production(x_dims, 0, axis)),
+           IntLiteral(n),
+           IntLiteral(Production(x_dims, axis + y_dims.size(), x_dims.size())),
+           ActLiteral(act_type),
+           "0.f"});
+}
+
+void StaticProgramCodeGenerator::AddActivation(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Out").front());
+  float alpha = desc.Type() == "leaky_relu" ? desc.GetAttr<float>("alpha") : 0;
+  AddCall("ops::Activation",
+          {x,
+           out,
+           IntLiteral(Production(values_[x].dims)),
+           ActLiteral(desc.Type()),
+           FloatLiteral(alpha)});
+}
+
+void StaticProgramCodeGenerator::AddScale(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Out").front());
+  float scale = desc.GetAttr<float>("scale");
+  float bias = desc.GetAttr<float>("bias");
+  if (!desc.GetAttr<bool>("bias_after_scale")) bias *= scale;
+  AddCall("ops::Scale",
+          {x,
+           out,
+           IntLiteral(Production(values_[x].dims)),
+           FloatLiteral(scale),
+           FloatLiteral(bias)});
+}
+
+void StaticProgramCodeGenerator::AddSoftmax(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Out").front());
+  const auto x_dims = values_[x].dims;
+  int axis = desc.HasAttr("axis") ? desc.GetAttr<int>("axis") : -1;
+  if (axis < 0) axis += x_dims.size();
+  AddCall("ops::Softmax",
+          {x,
+           out,
+           IntLiteral(Production(x_dims, 0, axis)),
+           IntLiteral(x_dims[axis]),
+           IntLiteral(Production(x_dims, axis + 1, x_dims.size()))});
+}
+
+void StaticProgramCodeGenerator::AddConv2d(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("Input").front());
+  int w = Use(desc.Input("Filter").front());
+  Arg bias("nullptr");
+  if (desc.HasInput("Bias") && !desc.Input("Bias").empty()) {
+    bias = Use(desc.Input("Bias").front());
+  }
+  int out = Define(desc.Output("Output").front());
+  const auto x_dims = values_[x].dims;
+  const auto w_dims = values_[w].dims;
+  const auto out_dims = values_[out].dims;
+  CHECK_EQ(x_dims.size(), 4UL);
+  auto strides = desc.GetAttr<std::vector<int>>("strides");
+  auto dilations = desc.GetAttr<std::vector<int>>("dilations");
+  std::vector<int> ksize{static_cast<int>(w_dims[2]),
+                         static_cast<int>(w_dims[3])};
+  auto paddings = TopLeftPaddings(desc, x_dims, out_dims, ksize, strides);
+  if (desc.HasAttr("padding_algorithm") &&
+      desc.GetAttr<std::string>("padding_algorithm") == "SAME") {
+    dilations = {1, 1};
+  }
+  std::string act_type;
+  float alpha = 0.f;
+  if (desc.HasAttr("with_act") && desc.GetAttr<bool>("with_act")) {
+    act_type = desc.GetAttr<std::string>("act_type");
+    if (act_type == "leaky_relu") {
+      alpha = desc.GetAttr<float>("leaky_relu_alpha");
+    }
+  }
+  // The input unfolded for the GEMM of a group, not needed by a depthwise
+  // or a pointwise convolution.
+  const int groups = desc.GetAttr<int>("groups");
+  const int64_t ic_per_group = x_dims[1] / groups;
+  const bool depthwise = ic_per_group == 1 && out_dims[1] == groups;
+  const bool pointwise = ksize[0] == 1 && ksize[1] == 1 && strides[0] == 1 &&
+                         strides[1] == 1 && out_dims[2] == x_dims[2] &&
+                         out_dims[3] == x_dims[3] && paddings.first == 0 &&
+                         paddings.second == 0;
+  Arg col("nullptr");
+  if (!depthwise && !pointwise) {
+    col = Scratch(ic_per_group * ksize[0] * ksize[1] * out_dims[2] *
+                  out_dims[3]);
+  }
+  AddCall("ops::Conv2d",
+          {x,
+           w,
+           bias,
+           out,
+           IntLiteral(x_dims[0]),
+           IntLiteral(x_dims[1]),
+           IntLiteral(x_dims[2]),
+           IntLiteral(x_dims[3]),
+           IntLiteral(out_dims[1]),
+           IntLiteral(out_dims[2]),
+           IntLiteral(out_dims[3]),
+           IntLiteral(ksize[0]),
+           IntLiteral(ksize[1]),
+           IntLiteral(strides[0]),
+           IntLiteral(strides[1]),
+           IntLiteral(paddings.first),
+           IntLiteral(paddings.second),
+           IntLiteral(dilations[0]),
+           IntLiteral(dilations[1]),
+           IntLiteral(groups),
+           ActLiteral(act_type),
+           FloatLiteral(alpha),
+           col});
+}
+
+void StaticProgramCodeGenerator::AddPool2d(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Out").front());
+  const auto x_dims = values_[x].dims;
+  const auto out_dims = values_[out].dims;
+  CHECK_EQ(x_dims.size(), 4UL);
+  CHECK(!desc.HasAttr("adaptive") || !desc.GetAttr<bool>("adaptive"))
+      << "The static code generator does not support adaptive pool2d";
+  auto ksize = desc.GetAttr<std::vector<int>>("ksize");
+  auto strides = desc.GetAttr<std::vector<int>>("strides");
+  std::pair<int, int> paddings{0, 0};
+  if (desc.GetAttr<bool>("global_pooling")) {
+    ksize = {static_cast<int>(x_dims[2]), static_cast<int>(x_dims[3])};
+    strides = {1, 1};
+  } else {
+    paddings = TopLeftPaddings(desc, x_dims, out_dims, ksize, strides);
+  }
+  bool exclusive =
+      desc.HasAttr("exclusive") ? desc.GetAttr<bool>("exclusive") : true;
+  bool is_max = desc.GetAttr<std::string>("pooling_type") == "max";
+  AddCall("ops::Pool2d",
+          {x,
+           out,
+           IntLiteral(x_dims[0] * x_dims[1]),
+           IntLiteral(x_dims[2]),
+           IntLiteral(x_dims[3]),
+           IntLiteral(out_dims[2]),
+           IntLiteral(out_dims[3]),
+           IntLiteral(ksize[0]),
+           IntLiteral(ksize[1]),
+           IntLiteral(strides[0]),
+           IntLiteral(strides[1]),
+           IntLiteral(paddings.first),
+           IntLiteral(paddings.second),
+           is_max ? "true" : "false",
+           exclusive ? "true" : "false"});
+}
+
+// Folded into a scale and a bias per channel at generation time.
+void StaticProgramCodeGenerator::AddBatchNorm(const cpp::OpDesc &desc) {
+  auto weight = [&](const std::string &param) {
+    auto name = desc.Input(param).front();
+    auto *var = scope_.FindVar(name);
+    CHECK(var) << "The " << param << " of batch_norm must be a weight";
+    return var->Get<lite::Tensor>().data<float>();
+  };
+  const float *scale = weight("Scale");
+  const float *bias = weight("Bias");
+  const float *mean = weight("Mean");
+  const float *variance = weight("Variance");
+  float epsilon = desc.GetAttr<float>("epsilon");
+
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Y").front());
+  const auto x_dims = values_[x].dims;
+  CHECK_GE(x_dims.size(), 2UL);
+  int64_t channels = x_dims[1];
+  std::vector<float> new_scale(channels), new_bias(channels);
+  for (int64_t c = 0; c < channels; ++c) {
+    new_scale[c] = scale[c] / std::sqrt(variance[c] + epsilon);
+    new_bias[c] = bias[c] - mean[c] * new_scale[c];
+  }
+  auto origin = desc.Input("Scale").front();
+  int a = AddConstant(origin + " (folded scale)", {channels}, &new_scale);
+  int b = AddConstant(origin + " (folded bias)", {channels}, &new_bias);
+  AddCall("ops::ChannelAffine",
+          {x,
+           a,
+           b,
+           out,
+           IntLiteral(x_dims[0]),
+           IntLiteral(channels),
+           IntLiteral(Production(x_dims, 2, x_dims.size()))});
+}
+
+void StaticProgramCodeGenerator::AddConcat(const cpp::OpDesc &desc) {
+  std::vector<int> xs;
+  for (auto &name : desc.Input("X")) xs.push_back(Use(name));
+  int out = Define(desc.Output("Out").front());
+  const auto out_dims = values_[out].dims;
+  int axis = desc.GetAttr<int>("axis");
+  if (axis < 0) axis += out_dims.size();
+  int64_t outer = Production(out_dims, 0, axis);
+  int64_t out_inner = Production(out_dims, axis, out_dims.size());
+  int64_t offset = 0;
+  for (int x : xs) {
+    const auto x_dims = values_[x].dims;
+    int64_t inner = Production(x_dims, axis, x_dims.size());
+    AddCall("ops::ConcatSlice",
+            {x,
+             out,
+             IntLiteral(outer),
+             IntLiteral(inner),
+             IntLiteral(out_inner),
+             IntLiteral(offset)});
+    offset += inner;
+  }
+}
+
+void StaticProgramCodeGenerator::AddTranspose(const cpp::OpDesc &desc) {
+  int x = Use(desc.Input("X").front());
+  int out = Define(desc.Output("Out").front());
+  const auto x_dims = values_[x].dims;
+  auto axis = desc.GetAttr<std::vector<int>>("axis");
+  CHECK_LE(x_dims.size(), 6UL);
+  CHECK_EQ(axis.size(), x_dims.size());
+  AddCall("ops::Transpose",
+          {x,
+           out,
+           "{{" + Join(x_dims, ", ") + "}}",
+           "{{" + Join(axis, ", ") + "}}",
+           IntLiteral(x_dims.size())});
+}
+
+void StaticProgramCodeGenerator::AddDropout(const cpp::OpDesc &desc) {
+  auto x_name = desc.Input("X").front();
+  auto out_name = desc.Output("Out").front();
+  auto implementation =
+      desc.HasAttr("dropout_implementation")
+          ? desc.GetAttr<std::string>("dropout_implementation")
+          : "downgrade_in_infer";
+  if (implementation == "upscale_in_train") {
+    AddAlias(x_name, out_name);
+    return;
+  }
+  int x = Use(x_name);
+  int out = Define(out_name);
+  AddCall("ops::Scale",
+          {x,
+           out,
+           IntLiteral(Production(values_[x].dims)),
+           FloatLiteral(1.f - desc.GetAttr<float>("dropout_prob")),
+           "0.f"});
+}
+
+void StaticProgramCodeGenerator::AddAlias(const std::string &input,
+                                          const std::string &output) {
+  Value value = values_[Use(input)];
+  value.dims = out_dims_.at(output);
+  var_values_[output] = values_.size();
+  values_.push_back(value);
+}
+
+int StaticProgramCodeGenerator::Use(const std::string &name) {
+  auto it = var_values_.find(name);
+  if (it == var_values_.end()) {
+    auto *var = scope_.FindVar(name);
+    CHECK(var) << "The variable " << name << " is used before defined";
+    const auto &tensor = var->Get<lite::Tensor>();
+    CHECK(tensor.precision() == PRECISION(kFloat) ||
+          tensor.precision() == PRECISION(kUnk))
+        << "The static code generator only supports float weights, " << name;
+    Constant constant;
+    constant.origin = name;
+    constant.dims = tensor.dims().Vectorize();
+    constant.data = tensor.data<float>();
+    constants_.push_back(std::move(constant));
+    Value value;
+    value.dims = tensor.dims().Vectorize();
+    value.constant = constants_.size() - 1;
+    it = var_values_.emplace(name, values_.size()).first;
+    values_.push_back(value);
+  }
+  int buffer = values_[it->second].buffer;
+  if (buffer >= 0) {
+    buffers_[buffer].last = std::max(buffers_[buffer].last, step_);
+  }
+  return it->second;
+}
+
+int StaticProgramCodeGenerator::Define(const std::string &name) {
+  Buffer buffer;
+  buffer.size = Production(out_dims_.at(name));
+  buffer.first = step_;
+  buffer.last = step_;
+  buffers_.push_back(buffer);
+  Value value;
+  value.dims = out_dims_.at(name);
+  value.buffer = buffers_.size() - 1;
+  var_values_[name] = values_.size();
+  values_.push_back(value);
+  return values_.size() - 1;
+}
+
+int StaticProgramCodeGenerator::Scratch(int64_t size) {
+  Buffer buffer;
+  buffer.size = size;
+  buffer.first = step_;
+  buffer.last = step_;
+  buffers_.push_back(buffer);
+  Value value;
+  value.dims = {size};
+  value.buffer = buffers_.size() - 1;
+  values_.push_back(value);
+  return values_.size() - 1;
+}
+
+int StaticProgramCodeGenerator::AddConstant(const std::string &origin,
+                                            const std::vector<int64_t> &dims,
+                                            std::vector<float> *data) {
+  Constant constant;
+  constant.origin = origin;
+  constant.dims = dims;
+  constant.folded.swap(*data);
+  constants_.push_back(std::move(constant));
+  Value value;
+  value.dims = dims;
+  value.constant = constants_.size() - 1;
+  values_.push_back(value);
+  return values_.size() - 1;
+}
+
+/*
+ * Greedy offset assignment: the buffers are placed from the largest one, each
+ * at the lowest offset that does not overlap a placed buffer alive at the
+ * same time. An op's outputs are alive together with its inputs, so they
+ * never share memory.
+ */
+void StaticProgramCodeGenerator::PlanArena() {
+  auto aligned = [](int64_t size) {
+    return (size + kArenaAlign - 1) / kArenaAlign * kArenaAlign;
+  };
+  std::vector<int> order(buffers_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return buffers_[a].size > buffers_[b].size;
+  });
+  std::vector<int> placed;
+  arena_size_ = 0;
+  for (int i : order) {
+    auto &buffer = buffers_[i];
+    std::vector<int> alive;
+    for (int j : placed) {
+      if (buffers_[j].first <= buffer.last &&
+          buffer.first <= buffers_[j].last) {
+        alive.push_back(j);
+      }
+    }
+    std::sort(alive.begin(), alive.end(), [&](int a, int b) {
+      return buffers_[a].offset < buffers_[b].offset;
+    });
+    int64_t offset = 0;
+    for (int j : alive) {
+      if (offset + aligned(buffer.size) <= buffers_[j].offset) break;
+      offset = std::max(offset, buffers_[j].offset + aligned(buffers_[j].size));
+    }
+    buffer.offset = offset;
+    arena_size_ = std::max(arena_size_, offset + aligned(buffer.size));
+    placed.push_back(i);
+  }
+}
+
+std::string StaticProgramCodeGenerator::Pointer(int value) const {
+  const auto v = values_[value];
+  if (v.input >= 0) return "inputs[" + std::to_string(v.input) + "]";
+  if (v.constant >= 0) return "w_" + std::to_string(v.constant);
+  CHECK_GE(v.buffer, 0);
+  int64_t offset = buffers_[v.buffer].offset;
+  return offset == 0 ? "arena" : "arena + " + std::to_string(offset);
+}
+
+void StaticProgramCodeGenerator::EmitConstant(int index,
+                                              STL::stringstream *os) const {
+  const auto &constant = constants_[index];
+  int64_t size = Production(constant.dims);
+  const float *data =
+      constant.folded.empty() ? constant.data : constant.folded.data();
+  *os << "// " << constant.origin << " " << DimsRepr(constant.dims) << "\n";
+  *os << "alignas(64) const float w_" << index << "["
+      << std::max<int64_t>(size, 1) << "] = {";
+  for (int64_t i = 0; i < size; ++i) {
+    *os << (i % 4 == 0 ? "\n    " : " ") << FloatLiteral(data[i]) << ",";
+  }
+  *os << "\n};\n\n";
+}
+
+void StaticProgramCodeGenerator::EmitCall(const Call &call,
+                                          STL::stringstream *os) const {
+  if (call.func.empty()) {
+    *os << "  // " << call.args.front().text << "\n";
+    return;
+  }
+  std::vector<std::string> args;
+  for (auto &arg : call.args) {
+    args.push_back(arg.value >= 0 ? Pointer(arg.value) : arg.text);
+  }
+  std::string line = "  " + call.func + "(" + Join(args, ", ") + ");";
+  if (line.size() <= 80) {
+    *os << line << "\n";
+    return;
+  }
+  // Wrapped at 80 columns, aligned after the parenthesis.
+  std::string indent(call.func.size() + 3, ' ');
+  line = "  " + call.func + "(" + args.front();
+  for (size_t i = 1; i < args.size(); ++i) {
+    std::string next = ", " + args[i];
+    if (line.size() + next.size() + 2 > 80) {
+      *os << line << ",\n";
+      line = indent + args[i];
+    } else {
+      line += next;
+    }
+  }
+  *os << line << ");\n";
+}
+
+}  // namespace gencode
+}  // namespace lite
+}  // namespace paddle
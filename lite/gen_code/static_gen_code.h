@@ -0,0 +1,150 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/program_desc.h"
+#include "lite/utils/all.h"
+
+namespace paddle {
+namespace lite {
+namespace gencode {
+
+/*
+ * Generates a self-contained translation unit that runs a float program for
+ * fixed input shapes, unlike ProgramCodeGenerator whose code rebuilds the ops
+ * and goes through the registry, the Scope and the kernels at runtime.
+ *
+ * The shapes of all the variables are inferred once by the operators at
+ * generation time, then every op becomes a direct call of a function of
+ * static_ops.h with its shapes as constants. The temporary variables live at
+ * precomputed offsets of one static arena, where variables with disjoint
+ * lifetimes share memory, and the weights are embedded as aligned constant
+ * arrays. The generated code only includes static_ops.h:
+ *
+ *   void <func_name>(const float* const* inputs, float* const* outputs);
+ *
+ * with the inputs and outputs in the order of the feed and fetch columns. As
+ * the arena is static, the function is not reentrant.
+ */
+class StaticProgramCodeGenerator {
+ public:
+  StaticProgramCodeGenerator(
+      const cpp::ProgramDesc &program,
+      const lite::Scope &scope,
+      const std::map<std::string, std::vector<int64_t>> &input_shapes,
+      const std::string &func_name = "Predict");
+
+  std::string GenCode();
+
+  // The bytes of the static arena, available after GenCode.
+  size_t arena_bytes() const { return arena_size_ * sizeof(float); }
+
+ private:
+  // One definition of a variable: a slice of the arena, a feed input or a
+  // constant. The ops that only change the shape alias their input value.
+  struct Value {
+    std::vector<int64_t> dims;
+    int buffer{-1};
+    int input{-1};
+    int constant{-1};
+  };
+  struct Buffer {
+    int64_t size{};
+    int first{};
+    int last{};
+    int64_t offset{};
+  };
+  struct Constant {
+    std::string origin;
+    std::vector<int64_t> dims;
+    const float *data{};
+    std::vector<float> folded;
+  };
+  // An argument of a generated call, a value or a literal.
+  struct Arg {
+    Arg(int value) : value(value) {}  // NOLINT
+    Arg(const std::string &text) : text(text) {}  // NOLINT
+    Arg(const char *text) : text(text) {}  // NOLINT
+    int value{-1};
+    std::string text;
+  };
+  // A generated statement, a comment if there is no function.
+  struct Call {
+    std::string func;
+    std::vector<Arg> args;
+  };
+
+  void InferShape(const cpp::OpDesc &desc, lite::Scope *exec_scope);
+  void AddOp(const cpp::OpDesc &desc, lite::Scope *exec_scope);
+
+  void AddFc(const cpp::OpDesc &desc);
+  void AddMul(const cpp::OpDesc &desc);
+  void AddElementwise(const cpp::OpDesc &desc);
+  void AddActivation(const cpp::OpDesc &desc);
+  void AddScale(const cpp::OpDesc &desc);
+  void AddSoftmax(const cpp::OpDesc &desc);
+  void AddConv2d(const cpp::OpDesc &desc);
+  void AddPool2d(const cpp::OpDesc &desc);
+  void AddBatchNorm(const cpp::OpDesc &desc);
+  void AddConcat(const cpp::OpDesc &desc);
+  void AddTranspose(const cpp::OpDesc &desc);
+  void AddDropout(const cpp::OpDesc &desc);
+  void AddAlias(const std::string &input, const std::string &output);
+
+  // The current value of a variable, a constant for a weight.
+  int Use(const std::string &name);
+  // A new arena buffer for an output of the current op.
+  int Define(const std::string &name);
+  // An arena buffer of `size` floats used by the current op only.
+  int Scratch(int64_t size);
+  int AddConstant(const std::string &origin,
+                  const std::vector<int64_t> &dims,
+                  std::vector<float> *data);
+
+  void AddCall(const std::string &func, const std::vector<Arg> &args) {
+    calls_.push_back(Call{func, args});
+  }
+
+  void PlanArena();
+  std::string Pointer(int value) const;
+  void EmitConstant(int index, STL::stringstream *os) const;
+  void EmitCall(const Call &call, STL::stringstream *os) const;
+
+  cpp::ProgramDesc program_;
+  const lite::Scope &scope_;
+  std::map<std::string, std::vector<int64_t>> input_shapes_;
+  std::string func_name_;
+
+  std::vector<Value> values_;
+  std::vector<Buffer> buffers_;
+  std::vector<Constant> constants_;
+  std::map<std::string, int> var_values_;
+  std::vector<std::string> input_names_;
+  std::vector<std::pair<std::string, int>> outputs_;
+  std::vector<Call> calls_;
+  // The dims of the op outputs given by InferShape.
+  std::map<std::string, std::vector<int64_t>> out_dims_;
+  int step_{};
+  int64_t arena_size_{};
+};
+
+}  // namespace gencode
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,283 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/gen_code/static_gen_code.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/gen_code/static_ops.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace gencode {
+
+void AddVar(cpp::BlockDesc *block, const std::string &name, bool persistable) {
+  auto *var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetPersistable(persistable);
+}
+
+void AddWeight(cpp::BlockDesc *block,
+               lite::Scope *scope,
+               const std::string &name,
+               const std::vector<int64_t> &dims,
+               float offset) {
+  AddVar(block, name, true);
+  auto *tensor = scope->Var(name)->GetMutable<lite::Tensor>();
+  tensor->Resize(dims);
+  auto *data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = offset + 0.01f * (i % 7);
+  }
+}
+
+cpp::OpDesc *AddOp(cpp::BlockDesc *block,
+                   const std::string &type,
+                   const std::string &x_param,
+                   const std::string &x,
+                   const std::string &out_param,
+                   const std::string &out) {
+  auto *op = block->AddOp<cpp::OpDesc>();
+  op->SetType(type);
+  op->SetInput(x_param, {x});
+  op->SetOutput(out_param, {out});
+  return op;
+}
+
+// feed -> conv2d -> batch_norm -> relu -> pool2d -> reshape2 -> fc -> softmax
+// -> fetch.
+void BuildProgram(cpp::ProgramDesc *program, lite::Scope *scope) {
+  auto *block = program->AddBlock<cpp::BlockDesc>();
+  for (auto name : {"feed", "fetch", "x", "conv_out", "bn_out", "relu_out"}) {
+    AddVar(block, name, false);
+  }
+  for (auto name : {"pool_out", "reshape_out", "xshape", "fc_out", "out"}) {
+    AddVar(block, name, false);
+  }
+  AddWeight(block, scope, "conv_w", {4, 2, 3, 3}, -0.03f);
+  AddWeight(block, scope, "bn_scale", {4}, 1.f);
+  AddWeight(block, scope, "bn_bias", {4}, 0.1f);
+  AddWeight(block, scope, "bn_mean", {4}, 0.02f);
+  AddWeight(block, scope, "bn_variance", {4}, 0.5f);
+  AddWeight(block, scope, "fc_w", {36, 5}, -0.02f);
+  AddWeight(block, scope, "fc_b", {5}, 0.f);
+
+  auto *feed = AddOp(block, "feed", "X", "feed", "Out", "x");
+  feed->SetAttr<int>("col", 0);
+
+  auto *conv = AddOp(block, "conv2d", "Input", "x", "Output", "conv_out");
+  conv->SetInput("Filter", {"conv_w"});
+  conv->SetAttr<std::vector<int>>("strides", {1, 1});
+  conv->SetAttr<std::vector<int>>("paddings", {1, 1});
+  conv->SetAttr<std::vector<int>>("dilations", {1, 1});
+  conv->SetAttr<int>("groups", 1);
+
+  auto *bn = AddOp(block, "batch_norm", "X", "conv_out", "Y", "bn_out");
+  bn->SetInput("Scale", {"bn_scale"});
+  bn->SetInput("Bias", {"bn_bias"});
+  bn->SetInput("Mean", {"bn_mean"});
+  bn->SetInput("Variance", {"bn_variance"});
+  bn->SetAttr<int>("is_test", 1);
+  bn->SetAttr<float>("epsilon", 1e-5f);
+  bn->SetAttr<float>("momentum", 0.9f);
+  bn->SetAttr<std::string>("data_layout", "NCHW");
+
+  AddOp(block, "relu", "X", "bn_out", "Out", "relu_out");
+
+  auto *pool = AddOp(block, "pool2d", "X", "relu_out", "Out", "pool_out");
+  pool->SetAttr<std::string>("pooling_type", "max");
+  pool->SetAttr<std::vector<int>>("ksize", {2, 2});
+  pool->SetAttr<bool>("global_pooling", false);
+  pool->SetAttr<std::vector<int>>("strides", {2, 2});
+  pool->SetAttr<std::vector<int>>("paddings", {0, 0});
+
+  auto *reshape =
+      AddOp(block, "reshape2", "X", "pool_out", "Out", "reshape_out");
+  reshape->SetOutput("XShape", {"xshape"});
+  reshape->SetAttr<std::vector<int>>("shape", {1, -1});
+
+  auto *fc = AddOp(block, "fc", "Input", "reshape_out", "Out", "fc_out");
+  fc->SetInput("W", {"fc_w"});
+  fc->SetInput("Bias", {"fc_b"});
+  fc->SetAttr<int>("in_num_col_dims", 1);
+
+  auto *softmax = AddOp(block, "softmax", "X", "fc_out", "Out", "out");
+  softmax->SetAttr<int>("axis", -1);
+
+  auto *fetch = AddOp(block, "fetch", "X", "out", "Out", "fetch");
+  fetch->SetAttr<int>("col", 0);
+}
+
+TEST(static_gen_code, program) {
+  cpp::ProgramDesc program;
+  lite::Scope scope;
+  BuildProgram(&program, &scope);
+
+  StaticProgramCodeGenerator codegen(program, scope, {{"x", {1, 2, 6, 6}}});
+  std::string code = codegen.GenCode();
+  LOG(INFO) << "\n" << code;
+
+  // No framework in the generated code.
+  EXPECT_EQ(code.find("Scope"), std::string::npos);
+  EXPECT_EQ(code.find("Tensor"), std::string::npos);
+  EXPECT_NE(code.find("#include \"lite/gen_code/static_ops.h\""),
+            std::string::npos);
+  EXPECT_NE(code.find("void Predict(const float* const* inputs, "
+                      "float* const* outputs)"),
+            std::string::npos);
+
+  // The weights, with the batch_norm folded into a scale and a bias.
+  EXPECT_NE(code.find("alignas(64) const float w_0[72]"), std::string::npos);
+  EXPECT_NE(code.find("// bn_scale (folded scale) [4]"), std::string::npos);
+  EXPECT_NE(code.find("// bn_scale (folded bias) [4]"), std::string::npos);
+  EXPECT_NE(code.find("alignas(64) const float w_3[180]"), std::string::npos);
+  EXPECT_EQ(code.find("bn_mean"), std::string::npos);
+
+  // Lifetimes: the im2col buffer of the conv [1, 1], conv_out [1, 2],
+  // bn_out [2, 3], relu_out [3, 4], pool_out and its reshape [4, 6], fc_out
+  // [6, 7] and out [7, 8]. With offsets aligned to 16 floats, conv_out is
+  // placed after the 648 floats of the im2col buffer.
+  EXPECT_EQ(codegen.arena_bytes(), 800 * sizeof(float));
+  EXPECT_NE(code.find("ops::Conv2d(inputs[0], w_0, nullptr, arena + 656, 1, "
+                      "2, 6, 6, 4, 6, 6, 3, 3,"),
+            std::string::npos);
+  EXPECT_NE(code.find("1, 1, 1, 1, 1, 1, 1, ops::kNone, 0.f, arena);"),
+            std::string::npos);
+  EXPECT_NE(code.find("ops::ChannelAffine(arena + 656, w_1, w_2, arena, 1, 4, "
+                      "36);"),
+            std::string::npos);
+  EXPECT_NE(code.find("ops::Activation(arena, arena + 144, 144, ops::kRelu, "
+                      "0.f);"),
+            std::string::npos);
+  EXPECT_NE(code.find("ops::Fc(arena, w_3, w_4, arena + 48, 1, 36, 5, "
+                      "ops::kNone, 0.f);"),
+            std::string::npos);
+  EXPECT_NE(code.find("ops::Softmax(arena + 48, arena, 1, 5, 1);"),
+            std::string::npos);
+  EXPECT_NE(code.find("std::memcpy(outputs[0], arena, sizeof(float) * 5);"),
+            std::string::npos);
+}
+
+namespace ops = static_ops;
+
+std::vector<float> Sequence(size_t size, float scale) {
+  std::vector<float> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = scale * static_cast<float>((i * 7) % 11) - 0.2f;
+  }
+  return v;
+}
+
+// The portable Gemm, which MatMul does not call with LITE_WITH_X86. The
+// sizes cross the blocks of k and n.
+TEST(static_ops, gemm) {
+  const int m = 3, k = 150, n = 600, ldc = 610;
+  auto a = Sequence(m * k, 0.1f);
+  auto b = Sequence(k * n, -0.05f);
+  std::vector<float> c(m * ldc, 7.f);
+  ops::Gemm(a.data(), b.data(), c.data(), m, n, k, k, n, ldc);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      float ref = 0.f;
+      for (int p = 0; p < k; ++p) ref += a[i * k + p] * b[p * n + j];
+      EXPECT_NEAR(c[i * ldc + j], ref, 1e-3f);
+    }
+    // The padding of the rows is left untouched.
+    EXPECT_EQ(c[i * ldc + n], 7.f);
+  }
+}
+
+TEST(static_ops, fc) {
+  const int m = 3, k = 20, n = 17;
+  auto x = Sequence(m * k, 0.1f);
+  auto w = Sequence(k * n, -0.05f);
+  auto bias = Sequence(n, 0.3f);
+  for (auto act : {ops::kNone, ops::kRelu, ops::kSigmoid}) {
+    std::vector<float> out(m * n);
+    ops::Fc(x.data(), w.data(), bias.data(), out.data(), m, k, n, act, 0.f);
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        float ref = bias[j];
+        for (int p = 0; p < k; ++p) ref += x[i * k + p] * w[p * n + j];
+        EXPECT_NEAR(out[i * n + j], ops::Activate(ref, act, 0.f), 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(static_ops, conv2d) {
+  struct Case {
+    int ic, oc, kh, stride, pad, dilation, groups;
+  };
+  // A 3x3 conv, a pointwise one, a grouped one and a depthwise one.
+  for (auto c : {Case{3, 5, 3, 1, 1, 1, 1},
+                 Case{4, 6, 1, 1, 0, 1, 1},
+                 Case{4, 6, 3, 2, 1, 2, 2},
+                 Case{4, 4, 3, 1, 1, 1, 4}}) {
+    const int n = 2, ih = 9, iw = 7;
+    const int ek = (c.kh - 1) * c.dilation + 1;
+    const int oh = (ih + 2 * c.pad - ek) / c.stride + 1;
+    const int ow = (iw + 2 * c.pad - ek) / c.stride + 1;
+    const int icg = c.ic / c.groups, ocg = c.oc / c.groups;
+    auto x = Sequence(n * c.ic * ih * iw, 0.1f);
+    auto w = Sequence(c.oc * icg * c.kh * c.kh, -0.07f);
+    auto bias = Sequence(c.oc, 0.2f);
+    std::vector<float> out(n * c.oc * oh * ow);
+    std::vector<float> col(icg * c.kh * c.kh * oh * ow);
+    ops::Conv2d(x.data(), w.data(), bias.data(), out.data(), n, c.ic, ih, iw,
+                c.oc, oh, ow, c.kh, c.kh, c.stride, c.stride, c.pad, c.pad,
+                c.dilation, c.dilation, c.groups, ops::kRelu, 0.f,
+                c.kh == 1 ? nullptr : col.data());
+    for (int b = 0; b < n; ++b) {
+      for (int o = 0; o < c.oc; ++o) {
+        for (int oy = 0; oy < oh; ++oy) {
+          for (int ox = 0; ox < ow; ++ox) {
+            float ref = bias[o];
+            for (int ci = 0; ci < icg; ++ci) {
+              const int ch = o / ocg * icg + ci;
+              for (int ky = 0; ky < c.kh; ++ky) {
+                for (int kx = 0; kx < c.kh; ++kx) {
+                  const int iy = oy * c.stride - c.pad + ky * c.dilation;
+                  const int ix = ox * c.stride - c.pad + kx * c.dilation;
+                  if (iy < 0 || iy >= ih || ix < 0 || ix >= iw) continue;
+                  ref += x[((b * c.ic + ch) * ih + iy) * iw + ix] *
+                         w[((o * icg + ci) * c.kh + ky) * c.kh + kx];
+                }
+              }
+            }
+            EXPECT_NEAR(out[((b * c.oc + o) * oh + oy) * ow + ox],
+                        std::max(ref, 0.f),
+                        1e-4f);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace gencode
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(conv2d);
+USE_LITE_OP(batch_norm);
+USE_LITE_OP(relu);
+USE_LITE_OP(pool2d);
+USE_LITE_OP(reshape2);
+USE_LITE_OP(fc);
+USE_LITE_OP(softmax);
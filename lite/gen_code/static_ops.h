@@ -0,0 +1,581 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/*
+ * The operators called by the code of StaticProgramCodeGenerator. This header
+ * is shipped together with the generated translation unit, so it only depends
+ * on the C++ standard library. The matrix products of fc, mul and conv2d run
+ * on the cache-blocked Gemm below; built with LITE_WITH_X86, they go to the
+ * GEMM of the x86 backend instead, and the generated code is to be linked
+ * with it. Every function is inline and all the shapes are passed as
+ * constants by the generated code, so that the compiler can specialize the
+ * loops of each call site.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/math/sgemm.h"
+#endif
+
+namespace paddle {
+namespace lite {
+namespace gencode {
+namespace static_ops {
+
+enum Act { kNone = 0, kRelu, kRelu6, kLeakyRelu, kSigmoid, kTanh };
+
+// A shape or a permutation of at most 6 dimensions, passed by value.
+struct Shape {
+  int d[6];
+};
+
+inline float Activate(float x, Act act, float alpha) {
+  switch (act) {
+    case kRelu:
+      return x > 0.f ? x : 0.f;
+    case kRelu6:
+      return std::min(std::max(x, 0.f), 6.f);
+    case kLeakyRelu:
+      return x > 0.f ? x : alpha * x;
+    case kSigmoid:
+      return 1.f / (1.f + std::exp(-x));
+    case kTanh:
+      return std::tanh(x);
+    default:
+      return x;
+  }
+}
+
+inline void Activation(
+    const float* x, float* out, int size, Act act, float alpha) {
+  for (int i = 0; i < size; ++i) {
+    out[i] = Activate(x[i], act, alpha);
+  }
+}
+
+/*
+ * c[m, n] = a[m, k] * b[k, n], all row major. The products run over blocks
+ * of b of kBlockK x kBlockN floats, which stay in the L2 cache while every
+ * row of a goes through them, and the inner loop over a row of the block is
+ * left to the vectorizer.
+ */
+inline void Gemm(const float* a,
+                 const float* b,
+                 float* c,
+                 int m,
+                 int n,
+                 int k,
+                 int lda,
+                 int ldb,
+                 int ldc) {
+  const int kBlockK = 64;
+  const int kBlockN = 512;
+  for (int i = 0; i < m; ++i) {
+    std::fill(c + i * ldc, c + i * ldc + n, 0.f);
+  }
+  for (int p0 = 0; p0 < k; p0 += kBlockK) {
+    const int p1 = std::min(p0 + kBlockK, k);
+    for (int j0 = 0; j0 < n; j0 += kBlockN) {
+      const int j1 = std::min(j0 + kBlockN, n);
+      for (int i = 0; i < m; ++i) {
+        float* c_row = c + i * ldc;
+        for (int p = p0; p < p1; ++p) {
+          const float a_ip = a[i * lda + p];
+          const float* b_row = b + p * ldb;
+          for (int j = j0; j < j1; ++j) {
+            c_row[j] += a_ip * b_row[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+#ifdef LITE_WITH_X86
+// Set the activation of a GEMM epilogue. Only the piecewise linear ones are
+// fused, return false if `act` is to be applied after the GEMM.
+inline bool FuseActivation(Act act,
+                           float alpha,
+                           x86::math::SgemmEpilogue* epilogue) {
+  switch (act) {
+    case kNone:
+      return true;
+    case kRelu:
+      epilogue->act = lite_api::ActivationType::kRelu;
+      return true;
+    case kRelu6:
+      epilogue->act = lite_api::ActivationType::kRelu6;
+      return true;
+    case kLeakyRelu:
+      epilogue->act = lite_api::ActivationType::kLeakyRelu;
+      epilogue->leaky_alpha = alpha;
+      return true;
+    default:
+      return false;
+  }
+}
+#endif
+
+/*
+ * c[m, n] = act(a[m, k] * b[k, n] + bias), row major, where the bias is
+ * indexed by the row if `bias_per_row`, by the column otherwise, and may be
+ * null.
+ */
+inline void MatMul(const float* a,
+                   const float* b,
+                   const float* bias,
+                   bool bias_per_row,
+                   float* c,
+                   int m,
+                   int n,
+                   int k,
+                   Act act,
+                   float alpha) {
+#ifdef LITE_WITH_X86
+  x86::math::SgemmEpilogue epilogue;
+  epilogue.bias = bias;
+  epilogue.bias_per_row = bias_per_row;
+  const bool fused = FuseActivation(act, alpha, &epilogue);
+  x86::math::Sgemm(
+      false, false, m, n, k, 1.f, a, k, b, n, 0.f, c, n, &epilogue);
+  if (!fused) Activation(c, c, m * n, act, alpha);
+#else
+  Gemm(a, b, c, m, n, k, k, n, n);
+  for (int i = 0; i < m; ++i) {
+    float* c_row = c + i * n;
+    if (bias) {
+      for (int j = 0; j < n; ++j) {
+        c_row[j] += bias_per_row ? bias[i] : bias[j];
+      }
+    }
+    if (act != kNone) Activation(c_row, c_row, n, act, alpha);
+  }
+#endif
+}
+
+// out[m, n] = act(x[m, k] * w[k, n] + bias[n]), bias may be null.
+inline void Fc(const float* x,
+               const float* w,
+               const float* bias,
+               float* out,
+               int m,
+               int k,
+               int n,
+               Act act,
+               float alpha) {
+  MatMul(x, w, bias, false, out, m, n, k, act, alpha);
+}
+
+/*
+ * out[i, j, l] = act(x[i, j, l] op y[j]) where x is viewed as
+ * [pre, n, post], the broadcast of Paddle's elementwise operators.
+ */
+template <typename Functor>
+inline void Elementwise(const float* x,
+                        const float* y,
+                        float* out,
+                        int pre,
+                        int n,
+                        int post,
+                        Act act,
+                        float alpha) {
+  Functor op;
+  for (int i = 0; i < pre; ++i) {
+    for (int j = 0; j < n; ++j) {
+      const float b = y[j];
+      const int offset = (i * n + j) * post;
+      for (int l = 0; l < post; ++l) {
+        out[offset + l] = Activate(op(x[offset + l], b), act, alpha);
+      }
+    }
+  }
+}
+
+struct AddFunctor {
+  float operator()(float a, float b) const { return a + b; }
+};
+struct SubFunctor {
+  float operator()(float a, float b) const { return a - b; }
+};
+struct MulFunctor {
+  float operator()(float a, float b) const { return a * b; }
+};
+struct DivFunctor {
+  float operator()(float a, float b) const { return a / b; }
+};
+struct MaxFunctor {
+  float operator()(float a, float b) const { return a > b ? a : b; }
+};
+
+// out = x * scale + bias.
+inline void Scale(
+    const float* x, float* out, int size, float scale, float bias) {
+  for (int i = 0; i < size; ++i) {
+    out[i] = x[i] * scale + bias;
+  }
+}
+
+// out[i, c, j] = x[i, c, j] * scale[c] + bias[c], a folded batch_norm.
+inline void ChannelAffine(const float* x,
+                          const float* scale,
+                          const float* bias,
+                          float* out,
+                          int n,
+                          int c,
+                          int size) {
+  for (int i = 0; i < n; ++i) {
+    for (int ch = 0; ch < c; ++ch) {
+      const int offset = (i * c + ch) * size;
+      for (int j = 0; j < size; ++j) {
+        out[offset + j] = x[offset + j] * scale[ch] + bias[ch];
+      }
+    }
+  }
+}
+
+// Softmax along the middle axis of x viewed as [outer, axis_size, inner].
+inline void Softmax(
+    const float* x, float* out, int outer, int axis_size, int inner) {
+  for (int i = 0; i < outer; ++i) {
+    for (int l = 0; l < inner; ++l) {
+      const float* in_ptr = x + i * axis_size * inner + l;
+      float* out_ptr = out + i * axis_size * inner + l;
+      float max_value = in_ptr[0];
+      for (int j = 1; j < axis_size; ++j) {
+        max_value = std::max(max_value, in_ptr[j * inner]);
+      }
+      float sum = 0.f;
+      for (int j = 0; j < axis_size; ++j) {
+        out_ptr[j * inner] = std::exp(in_ptr[j * inner] - max_value);
+        sum += out_ptr[j * inner];
+      }
+      const float inv_sum = 1.f / sum;
+      for (int j = 0; j < axis_size; ++j) {
+        out_ptr[j * inner] *= inv_sum;
+      }
+    }
+  }
+}
+
+/*
+ * The depthwise NCHW convolution with a [c, 1, kh, kw] filter, bias may be
+ * null. Each filter tap is accumulated into a whole output row, with the
+ * range of the row that reads inside the input computed once, so the inner
+ * loop has no bound checks.
+ */
+inline void DepthwiseConv2d(const float* x,
+                            const float* w,
+                            const float* bias,
+                            float* out,
+                            int n,
+                            int c,
+                            int ih,
+                            int iw,
+                            int oh,
+                            int ow,
+                            int kh,
+                            int kw,
+                            int stride_h,
+                            int stride_w,
+                            int pad_top,
+                            int pad_left,
+                            int dilation_h,
+                            int dilation_w,
+                            Act act,
+                            float alpha) {
+  for (int p = 0; p < n * c; ++p) {
+    const int ch = p % c;
+    const float* in_plane = x + p * ih * iw;
+    float* out_plane = out + p * oh * ow;
+    const float init = bias ? bias[ch] : 0.f;
+    for (int i = 0; i < oh * ow; ++i) {
+      out_plane[i] = init;
+    }
+    const float* w_ptr = w + ch * kh * kw;
+    for (int ky = 0; ky < kh; ++ky) {
+      for (int kx = 0; kx < kw; ++kx) {
+        const float weight = w_ptr[ky * kw + kx];
+        const int x_offset = kx * dilation_w - pad_left;
+        // The output columns whose input column is in [0, iw).
+        int ox_begin = 0;
+        while (ox_begin < ow && ox_begin * stride_w + x_offset < 0) {
+          ++ox_begin;
+        }
+        int ox_end = ow;
+        while (ox_end > ox_begin && (ox_end - 1) * stride_w + x_offset >= iw) {
+          --ox_end;
+        }
+        for (int oy = 0; oy < oh; ++oy) {
+          const int iy = oy * stride_h - pad_top + ky * dilation_h;
+          if (iy < 0 || iy >= ih) continue;
+          const float* in_row = in_plane + iy * iw;
+          float* out_row = out_plane + oy * ow;
+          for (int ox = ox_begin; ox < ox_end; ++ox) {
+            out_row[ox] += weight * in_row[ox * stride_w + x_offset];
+          }
+        }
+      }
+    }
+    if (act != kNone) {
+      for (int i = 0; i < oh * ow; ++i) {
+        out_plane[i] = Activate(out_plane[i], act, alpha);
+      }
+    }
+  }
+}
+
+/*
+ * Unfold the [c, ih, iw] input of a convolution into the [c * kh * kw, oh *
+ * ow] matrix `col`, the padding reads 0. As in DepthwiseConv2d, the range of
+ * each output row that reads inside the input is computed once per tap.
+ */
+inline void Im2Col(const float* x,
+                   float* col,
+                   int c,
+                   int ih,
+                   int iw,
+                   int oh,
+                   int ow,
+                   int kh,
+                   int kw,
+                   int stride_h,
+                   int stride_w,
+                   int pad_top,
+                   int pad_left,
+                   int dilation_h,
+                   int dilation_w) {
+  for (int ch = 0; ch < c; ++ch) {
+    const float* in_plane = x + ch * ih * iw;
+    for (int ky = 0; ky < kh; ++ky) {
+      for (int kx = 0; kx < kw; ++kx) {
+        float* col_row = col + ((ch * kh + ky) * kw + kx) * oh * ow;
+        const int x_offset = kx * dilation_w - pad_left;
+        int ox_begin = 0;
+        while (ox_begin < ow && ox_begin * stride_w + x_offset < 0) {
+          ++ox_begin;
+        }
+        int ox_end = ow;
+        while (ox_end > ox_begin && (ox_end - 1) * stride_w + x_offset >= iw) {
+          --ox_end;
+        }
+        for (int oy = 0; oy < oh; ++oy) {
+          float* dst = col_row + oy * ow;
+          const int iy = oy * stride_h - pad_top + ky * dilation_h;
+          if (iy < 0 || iy >= ih) {
+            std::fill(dst, dst + ow, 0.f);
+            continue;
+          }
+          const float* in_row = in_plane + iy * iw;
+          std::fill(dst, dst + ox_begin, 0.f);
+          for (int ox = ox_begin; ox < ox_end; ++ox) {
+            dst[ox] = in_row[ox * stride_w + x_offset];
+          }
+          std::fill(dst + ox_end, dst + ow, 0.f);
+        }
+      }
+    }
+  }
+}
+
+/*
+ * NCHW convolution with a [oc, ic / groups, kh, kw] filter, bias may be null.
+ * Each group is a MatMul, [oc / groups, ic / groups * kh * kw]
+ * x [ic / groups * kh * kw, oh * ow], on the input unfolded into `col`. A 1x1
+ * filter of stride 1 and no padding reads the input directly, with a null
+ * `col`. A depthwise convolution goes to DepthwiseConv2d, its GEMMs would
+ * have a single row.
+ */
+inline void Conv2d(const float* x,
+                   const float* w,
+                   const float* bias,
+                   float* out,
+                   int n,
+                   int ic,
+                   int ih,
+                   int iw,
+                   int oc,
+                   int oh,
+                   int ow,
+                   int kh,
+                   int kw,
+                   int stride_h,
+                   int stride_w,
+                   int pad_top,
+                   int pad_left,
+                   int dilation_h,
+                   int dilation_w,
+                   int groups,
+                   Act act,
+                   float alpha,
+                   float* col) {
+  const int ic_per_group = ic / groups;
+  const int oc_per_group = oc / groups;
+  if (ic_per_group == 1 && oc_per_group == 1) {
+    DepthwiseConv2d(x,
+                    w,
+                    bias,
+                    out,
+                    n,
+                    ic,
+                    ih,
+                    iw,
+                    oh,
+                    ow,
+                    kh,
+                    kw,
+                    stride_h,
+                    stride_w,
+                    pad_top,
+                    pad_left,
+                    dilation_h,
+                    dilation_w,
+                    act,
+                    alpha);
+    return;
+  }
+  const int k = ic_per_group * kh * kw;
+  const int size = oh * ow;
+  for (int b = 0; b < n; ++b) {
+    for (int g = 0; g < groups; ++g) {
+      const float* in = x + (b * ic + g * ic_per_group) * ih * iw;
+      if (col) {
+        Im2Col(in,
+               col,
+               ic_per_group,
+               ih,
+               iw,
+               oh,
+               ow,
+               kh,
+               kw,
+               stride_h,
+               stride_w,
+               pad_top,
+               pad_left,
+               dilation_h,
+               dilation_w);
+        in = col;
+      }
+      MatMul(w + g * oc_per_group * k,
+             in,
+             bias ? bias + g * oc_per_group : nullptr,
+             true,
+             out + (b * oc + g * oc_per_group) * size,
+             oc_per_group,
+             size,
+             k,
+             act,
+             alpha);
+    }
+  }
+}
+
+/*
+ * NCHW max or average pooling over `planes` = N * C planes. The average is
+ * over the window clipped to the input when `exclusive`, over the whole
+ * kernel otherwise.
+ */
+inline void Pool2d(const float* x,
+                   float* out,
+                   int planes,
+                   int ih,
+                   int iw,
+                   int oh,
+                   int ow,
+                   int kh,
+                   int kw,
+                   int stride_h,
+                   int stride_w,
+                   int pad_top,
+                   int pad_left,
+                   bool is_max,
+                   bool exclusive) {
+  for (int p = 0; p < planes; ++p) {
+    const float* in_plane = x + p * ih * iw;
+    float* out_plane = out + p * oh * ow;
+    for (int oy = 0; oy < oh; ++oy) {
+      const int y0 = std::max(oy * stride_h - pad_top, 0);
+      const int y1 = std::min(oy * stride_h - pad_top + kh, ih);
+      for (int ox = 0; ox < ow; ++ox) {
+        const int x0 = std::max(ox * stride_w - pad_left, 0);
+        const int x1 = std::min(ox * stride_w - pad_left + kw, iw);
+        float value = is_max ? -INFINITY : 0.f;
+        for (int iy = y0; iy < y1; ++iy) {
+          for (int ix = x0; ix < x1; ++ix) {
+            const float v = in_plane[iy * iw + ix];
+            value = is_max ? std::max(value, v) : value + v;
+          }
+        }
+        if (!is_max) {
+          const int count = exclusive ? (y1 - y0) * (x1 - x0) : kh * kw;
+          value = count > 0 ? value / count : 0.f;
+        }
+        out_plane[oy * ow + ox] = value;
+      }
+    }
+  }
+}
+
+/*
+ * Copy x viewed as [outer, inner] into the columns [offset, offset + inner)
+ * of out viewed as [outer, out_inner], one input of a concat.
+ */
+inline void ConcatSlice(const float* x,
+                        float* out,
+                        int outer,
+                        int inner,
+                        int out_inner,
+                        int offset) {
+  for (int i = 0; i < outer; ++i) {
+    std::memcpy(out + i * out_inner + offset,
+                x + i * inner,
+                sizeof(float) * inner);
+  }
+}
+
+// out = x.transpose(axis), for a rank of at most 6.
+inline void Transpose(
+    const float* x, float* out, Shape in_dims, Shape axis, int rank) {
+  int in_strides[6];
+  int out_dims[6];
+  int size = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    in_strides[i] = size;
+    size *= in_dims.d[i];
+  }
+  for (int i = 0; i < rank; ++i) {
+    out_dims[i] = in_dims.d[axis.d[i]];
+  }
+  int index[6] = {0, 0, 0, 0, 0, 0};
+  for (int i = 0; i < size; ++i) {
+    int in_offset = 0;
+    for (int d = 0; d < rank; ++d) {
+      in_offset += index[d] * in_strides[axis.d[d]];
+    }
+    out[i] = x[in_offset];
+    for (int d = rank - 1; d >= 0; --d) {
+      if (++index[d] < out_dims[d]) break;
+      index[d] = 0;
+    }
+  }
+}
+
+}  // namespace static_ops
+}  // namespace gencode
+}  // namespace lite
+}  // namespace paddle
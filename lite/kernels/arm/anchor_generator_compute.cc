@@ -27,6 +27,11 @@ namespace arm {
 
 void AnchorGeneratorCompute::Run() {
   auto& param = Param<operators::AnchorGeneratorParam>();
+  // The anchors only depend on the shape of the input, they are computed
+  // again only when the shape changes.
+  if (param.Input->dims() == input_dims_) return;
+  input_dims_ = param.Input->dims();
+
   auto* anchors = param.Anchors;
   auto* variances = param.Variances;
   auto* input = param.Input;
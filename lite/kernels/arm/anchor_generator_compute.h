@@ -30,6 +30,10 @@ class AnchorGeneratorCompute
   void Run() override;
 
   virtual ~AnchorGeneratorCompute() = default;
+
+ private:
+  // The shape of the last computed anchors.
+  DDim input_dims_;
 };
 
 }  // namespace arm
@@ -39,6 +39,9 @@ void ConcatCompute::Run() {
   std::vector<lite::Tensor*> inputs = param.x;
   auto* out = param.output;
   int axis = param.axis;
+  if (param.inplace && inplace_.Run(inputs, axis, sizeof(float), out)) {
+    return;
+  }
   out->mutable_data<float>();
 
   /// Sometimes direct copies will be faster, this maybe need deeply analysis.
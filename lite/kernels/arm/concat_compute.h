@@ -14,6 +14,7 @@
 
 #pragma once
 #include <algorithm>
+#include "lite/backends/host/math/concat_inplace.h"
 #include "lite/core/kernel.h"
 #include "lite/operators/concat_op.h"
 
@@ -29,6 +30,9 @@ class ConcatCompute : public KernelLite<TARGET(kARM), PRECISION(kFloat)> {
   void Run() override;
 
   virtual ~ConcatCompute() = default;
+
+ private:
+  host::math::ConcatInplace inplace_;
 };
 
 }  // namespace arm
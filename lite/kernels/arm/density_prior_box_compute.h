@@ -29,6 +29,11 @@ class DensityPriorBoxCompute
   void Run() override;
 
   virtual ~DensityPriorBoxCompute() = default;
+
+ private:
+  // The shapes of the last computed priors.
+  DDim input_dims_;
+  DDim image_dims_;
 };
 
 }  // namespace arm
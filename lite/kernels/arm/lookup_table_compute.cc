@@ -17,6 +17,7 @@
 #include <vector>
 #include "lite/api/paddle_place.h"
 #include "lite/backends/arm/math/funcs.h"
+#include "lite/backends/host/math/rowwise_quant.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/tensor.h"
 #include "lite/core/type_system.h"
@@ -40,8 +41,7 @@ void LookupTableCompute::Run() {
   auto ids_data = ids->data<float>();
 
   int64_t row_number = table_dim[0];
-  int64_t row_width = table_dim[1];
-  auto table_data = w->data<float>();
+  int64_t row_width = param.enable_int8 ? param.row_width : table_dim[1];
   auto dout = out->mutable_data<float>();
 
   for (int64_t i = 0; i < ids_numel; ++i) {
@@ -53,9 +53,19 @@ void LookupTableCompute::Run() {
           << "look uptable ids[i] < row_number check failed";
       CHECK_GE(ids_data[i], 0) << "lookuptable ids[i] >= 0 check failed";
 
-      memcpy(dout + i * row_width,
-             table_data + ids_int * row_width,
-             row_width * sizeof(float));
+      if (param.enable_int8) {
+        // Dequantize the row on the fly, the table stays quantized.
+        lite::host::math::DequantizeRow(
+            w->data<int8_t>() + ids_int * table_dim[1],
+            row_width,
+            param.bit_length,
+            param.Scale->data<float>()[ids_int],
+            dout + i * row_width);
+      } else {
+        memcpy(dout + i * row_width,
+               w->data<float>() + ids_int * row_width,
+               row_width * sizeof(float));
+      }
     }
   }
   *(out->mutable_lod()) = ids->lod();
@@ -74,5 +84,6 @@ REGISTER_LITE_KERNEL(lookup_table,
                      def)
     .BindInput("W", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kARM))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
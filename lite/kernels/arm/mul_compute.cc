@@ -85,6 +85,70 @@ void MulCompute::Run() {
   }
 }
 
+void MulInt8Compute::PrepareForRun() {
+  auto& param = Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+  auto y_dims = param.y->dims();
+  k_ = static_cast<int>(y_dims.Slice(0, param.y_num_col_dims).production());
+  n_ = static_cast<int>(
+      y_dims.Slice(param.y_num_col_dims, y_dims.size()).production());
+
+  // The gemm scales the rows of A, so the weight is A: out^T = w^T * x^T with
+  // w^T in n x k, packed once from the k x n weight.
+  lite::arm::math::prepackA_int8(&weights_, *param.y, n_, k_, 1, true, &ctx);
+
+  CHECK(!param.weight_scale.empty()) << "Int8 mul param must has weight_scale";
+  CHECK(param.weight_scale.size() == 1 ||
+        param.weight_scale.size() == static_cast<size_t>(n_))
+      << "the size of weight_scale should be 1 or the output channel";
+  scale_.resize(n_);
+  for (int i = 0; i < n_; ++i) {
+    float ws = param.weight_scale.size() == 1 ? param.weight_scale[0]
+                                              : param.weight_scale[i];
+    scale_[i] = ws * param.input_scale;
+  }
+}
+
+void MulInt8Compute::Run() {
+  auto& param = Param<param_t>();
+  auto& ctx = this->ctx_->template As<ARMContext>();
+
+  auto x_dims = param.x->dims();
+  int m = static_cast<int>(x_dims.Slice(0, param.x_num_col_dims).production());
+  int x_w = static_cast<int>(
+      x_dims.Slice(param.x_num_col_dims, x_dims.size()).production());
+  CHECK_EQ(x_w, k_) << "x_w must be equal with y_h";
+
+  const auto* x_data = param.x->data<int8_t>();
+  auto* o_data = param.output->mutable_data<float>();
+  // x is m x k, that is x^T stored transposed. A single row needs no
+  // transpose of the n x m result.
+  float* c_data = o_data;
+  if (m > 1) {
+    out_trans_.Resize({n_, m});
+    c_data = out_trans_.mutable_data<float>();
+  }
+  lite::arm::math::gemm_prepack_int8(weights_.data<int8_t>(),
+                                     x_data,
+                                     nullptr,
+                                     c_data,
+                                     n_,
+                                     m,
+                                     k_,
+                                     false,
+                                     false,
+                                     true,
+                                     scale_.data(),
+                                     &ctx);
+  if (m > 1) {
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n_; ++j) {
+        o_data[i * n_ + j] = c_data[j * m + i];
+      }
+    }
+  }
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
@@ -96,3 +160,10 @@ REGISTER_LITE_KERNEL(
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(
+    mul, kARM, kInt8, kNCHW, paddle::lite::kernels::arm::MulInt8Compute, def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kARM), PRECISION(kFloat))})
+    .Finalize();
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <vector>
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -36,6 +37,27 @@ class MulCompute : public KernelLite<TARGET(kARM), PRECISION(kFloat)> {
   int m_, n_, k_;
 };
 
+// The int8 mul with fp32 output, the weight is quantized with one scale per
+// output channel.
+class MulInt8Compute : public KernelLite<TARGET(kARM), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MulInt8Compute() = default;
+
+ private:
+  // The transposed weight, n x k, packed for the int8 gemm.
+  Tensor weights_;
+  // The n x m output of the gemm.
+  Tensor out_trans_;
+  std::vector<float> scale_;
+  int n_, k_;
+};
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
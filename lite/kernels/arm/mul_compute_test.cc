@@ -15,6 +15,7 @@
 #include "lite/kernels/arm/mul_compute.h"
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <random>
@@ -174,9 +175,64 @@ TEST(mul_arm, num_col_dims) {
   }
 }
 
+TEST(mul_arm, int8_compare_test) {
+  // A single row goes out of the gemm as is, the other ones are transposed.
+  for (int m : {1, 3}) {
+    for (int n : {1, 5, 16}) {
+      for (int k : {3, 20}) {
+        VLOG(3) << "m: " << m << ", n: " << n << ", k: " << k;
+        lite::Tensor x, y, out;
+        x.Resize({m, k});
+        y.Resize({k, n});
+        out.Resize({m, n});
+        auto* x_data = x.mutable_data<int8_t>();
+        auto* y_data = y.mutable_data<int8_t>();
+        for (int i = 0; i < m * k; ++i) {
+          x_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+        }
+        for (int i = 0; i < k * n; ++i) {
+          y_data[i] = static_cast<int8_t>((i * 53) % 255 - 127);
+        }
+
+        MulInt8Compute mul;
+        operators::MulParam param;
+        param.x = &x;
+        param.y = &y;
+        param.output = &out;
+        param.enable_int8 = true;
+        param.input_scale = 0.02f;
+        for (int j = 0; j < n; ++j) {
+          param.weight_scale.push_back(0.001f * (j + 1));
+        }
+
+        DeviceInfo::Init();
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<ARMContext>();
+        mul.SetParam(param);
+        mul.SetContext(std::move(ctx));
+        mul.PrepareForRun();
+        mul.Run();
+
+        const auto* out_data = out.data<float>();
+        for (int i = 0; i < m; ++i) {
+          for (int j = 0; j < n; ++j) {
+            float ref = 0.f;
+            for (int p = 0; p < k; ++p) {
+              ref += static_cast<float>(x_data[i * k + p]) * y_data[p * n + j];
+            }
+            ref *= param.input_scale * param.weight_scale[j];
+            EXPECT_NEAR(out_data[i * n + j], ref, 1e-3 * std::fabs(ref) + 1e-4);
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace arm
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(mul, kARM, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kARM, kInt8, kNCHW, def);
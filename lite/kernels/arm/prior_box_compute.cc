@@ -48,6 +48,14 @@ inline void ExpandAspectRatios(const std::vector<float>& input_aspect_ratior,
 
 void PriorBoxCompute::Run() {
   auto& param = Param<operators::PriorBoxParam>();
+  // The priors only depend on the shapes of the input and the image, they
+  // are computed again only when the shapes change.
+  if (param.input->dims() == input_dims_ &&
+      param.image->dims() == image_dims_) {
+    return;
+  }
+  input_dims_ = param.input->dims();
+  image_dims_ = param.image->dims();
 
   bool is_flip = param.flip;
   bool is_clip = param.clip;
@@ -28,6 +28,11 @@ class PriorBoxCompute : public KernelLite<TARGET(kARM), PRECISION(kFloat)> {
   void Run() override;
 
   virtual ~PriorBoxCompute() = default;
+
+ private:
+  // The shapes of the last computed priors.
+  DDim input_dims_;
+  DDim image_dims_;
 };
 
 }  // namespace arm
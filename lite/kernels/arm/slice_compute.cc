@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include "lite/kernels/arm/slice_compute.h"
+#include <algorithm>
 #include <vector>
 #include "lite/backends/arm/math/funcs.h"
 
@@ -32,6 +33,17 @@ void SliceCompute::Run() {
   std::vector<int> starts = param.starts;
   std::vector<int> ends = param.ends;
   std::vector<int> axes = param.axes;
+  if (param.inplace) {
+    // Slicing the outermost axis, the output is a view of the input.
+    auto out_dims = param.Out->dims();
+    int64_t start = starts[0] < 0 ? starts[0] + input_dims[0] : starts[0];
+    int64_t end = ends[0] < 0 ? ends[0] + input_dims[0] : ends[0];
+    start = std::max<int64_t>(0, std::min<int64_t>(start, input_dims[0]));
+    end = std::max<int64_t>(start, std::min<int64_t>(end, input_dims[0]));
+    param.Out->ShareDataWith(param.X->Slice<int>(start, end));
+    param.Out->Resize(out_dims);
+    return;
+  }
   const auto* x_data = param.X->data<int>();
   auto* o_data = param.Out->mutable_data<int>();
   lite::arm::math::slice(
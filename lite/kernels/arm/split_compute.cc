@@ -25,6 +25,17 @@ void SplitCompute::Run() {
   auto& param = Param<operators::SplitParam>();
   const float* din = param.x->data<float>();
   auto& dout = param.output;
+  if (param.inplace) {
+    // Splitting the outermost axis, the outputs are views of the input.
+    int64_t begin = 0;
+    for (auto* out : dout) {
+      auto out_dims = out->dims();
+      out->ShareDataWith(param.x->Slice<float>(begin, begin + out_dims[0]));
+      out->Resize(out_dims);
+      begin += out_dims[0];
+    }
+    return;
+  }
   auto in_dim = param.x->dims();
   std::vector<int> in_strides(in_dim.size());
   in_strides[in_dim.size() - 1] = in_dim[in_dim.size() - 1];
@@ -26,8 +26,14 @@ void UnsqueezeCompute::Run() {
   auto output = param.Out;
   auto x_dims = x->dims();
   auto* x_data = x->data<float>();
-  auto* out_data = output->mutable_data<float>();
-  memcpy(out_data, x_data, x_dims.production() * sizeof(float));
+  if (param.inplace) {
+    auto out_dims = output->dims();
+    output->ShareDataWith(*x);
+    output->Resize(out_dims);
+  } else {
+    auto* out_data = output->mutable_data<float>();
+    memcpy(out_data, x_data, x_dims.production() * sizeof(float));
+  }
 }
 
 void Unsqueeze2Compute::Run() {
@@ -37,9 +43,15 @@ void Unsqueeze2Compute::Run() {
   auto xshape = param.XShape;
   auto x_dims = x->dims();
   auto* x_data = x->data<float>();
-  auto* out_data = output->mutable_data<float>();
   auto* xshape_data = xshape->mutable_data<float>();
-  memcpy(out_data, x_data, x_dims.production() * sizeof(float));
+  if (param.inplace) {
+    auto out_dims = output->dims();
+    output->ShareDataWith(*x);
+    output->Resize(out_dims);
+  } else {
+    auto* out_data = output->mutable_data<float>();
+    memcpy(out_data, x_data, x_dims.production() * sizeof(float));
+  }
   memcpy(xshape_data, x_data, x_dims.production() * sizeof(float));
 }
 
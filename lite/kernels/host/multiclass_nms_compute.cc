@@ -16,84 +16,13 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-static void GetMaxScoreIndex(const std::vector<T>& scores,
-                             const T threshold,
-                             int top_k,
-                             std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
-}
-
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = std::max(box1[0], box2[0]);
-    const T inter_ymin = std::max(box1[1], box2[1]);
-    const T inter_xmax = std::min(box1[2], box2[2]);
-    const T inter_ymax = std::min(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-}
-
 template <class T>
 void SliceOneClass(const Tensor& items,
                    const int class_id,
@@ -116,64 +45,37 @@ void SliceOneClass(const Tensor& items,
   }
 }
 
-template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
-             const T score_threshold,
-             const T nms_threshold,
-             const T eta,
+void NMSFast(const float* bbox_data,
+             const float* scores_data,
+             const int64_t num_boxes,
+             const int64_t box_size,
+             const float score_threshold,
+             const float nms_threshold,
+             const float eta,
              const int64_t top_k,
              std::vector<int>* selected_indices,
              const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
-  // 4: [xmin ymin xmax ymax]
-  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
-  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
-
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  GetMaxScoreIndex(scores_data, score_threshold, top_k, &sorted_indices);
-
+  // box_size is 4: [xmin ymin xmax ymax]
+  // or 8, 16, 24, 32: [x1 y1 x2 y2 ... xn yn]
+  lite::host::math::ScoreIndex sorted_indices;
+  lite::host::math::GetMaxScoreIndex(
+      scores_data, num_boxes, score_threshold, top_k, &sorted_indices);
+  if (box_size == 4) {
+    lite::host::math::NMSBoxes(bbox_data,
+                               sorted_indices,
+                               nms_threshold,
+                               eta,
+                               normalized,
+                               selected_indices);
+    return;
+  }
+  // Only the first box can be selected without an IoU.
+  if (sorted_indices.size() > 1) {
+    LOG(FATAL) << "PolyIoU not implement.";
+  }
   selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap = PolyIoU<T>(bbox_data + idx * box_size,
-                               bbox_data + kept_idx * box_size,
-                               box_size,
-                               normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
+  for (auto& it : sorted_indices) {
+    selected_indices->push_back(it.second);
   }
 }
 
@@ -195,35 +97,53 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
   int num_det = 0;
 
   int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
+  int64_t num_boxes = scores_size == 3 ? scores.dims()[1] : scores.dims()[0];
+  int64_t box_size = scores_size == 3 ? bboxes.dims()[1] : bboxes.dims()[2];
+  std::vector<std::vector<int>> class_indices(class_num);
+  // The classes are independent, they run NMS in parallel.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (class_num > 1)
+#endif
   for (int64_t c = 0; c < class_num; ++c) {
     if (c == background_label) continue;
+    const T* score_data = nullptr;
+    const T* bbox_data = nullptr;
+    Tensor bbox_slice, score_slice;
     if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
+      score_data = scores.data<T>() + c * num_boxes;
+      bbox_data = bboxes.data<T>();
     } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
+      score_slice.Resize({num_boxes, 1});
+      bbox_slice.Resize({num_boxes, box_size});
       SliceOneClass<T>(scores, c, &score_slice);
       SliceOneClass<T>(bboxes, c, &bbox_slice);
+      score_data = score_slice.data<T>();
+      bbox_data = bbox_slice.data<T>();
     }
-    NMSFast(bbox_slice,
-            score_slice,
+    NMSFast(bbox_data,
+            score_data,
+            num_boxes,
+            box_size,
             score_threshold,
             nms_threshold,
             nms_eta,
             nms_top_k,
-            &((*indices)[c]),
+            &class_indices[c],
             normalized);
     if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
+      std::sort(class_indices[c].begin(), class_indices[c].end());
     }
-    num_det += (*indices)[c].size();
+  }
+  for (int64_t c = 0; c < class_num; ++c) {
+    if (c == background_label) continue;
+    num_det += class_indices[c].size();
+    (*indices)[c] = std::move(class_indices[c]);
   }
 
   *num_nmsed_out = num_det;
   const T* scores_data = scores.data<T>();
   if (keep_top_k > -1 && num_det > keep_top_k) {
+    Tensor score_slice;
     const T* sdata;
     std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
     for (const auto& it : *indices) {
@@ -242,23 +162,31 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
             std::make_pair(sdata[idx], std::make_pair(label, idx)));
       }
     }
-    // Keep top k results per image.
-    std::stable_sort(score_index_pairs.begin(),
-                     score_index_pairs.end(),
-                     SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+    // Keep top k results per image. Only the kept ones are sorted, equal
+    // scores keep their order as in a stable sort.
+    std::vector<int> order(score_index_pairs.size());
+    for (size_t j = 0; j < order.size(); ++j) {
+      order[j] = j;
+    }
+    std::partial_sort(order.begin(),
+                      order.begin() + keep_top_k,
+                      order.end(),
+                      [&score_index_pairs](int a, int b) {
+                        float sa = score_index_pairs[a].first;
+                        float sb = score_index_pairs[b].first;
+                        return sa > sb || (sa == sb && a < b);
+                      });
 
     // Store the new indices.
     std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
+    for (int64_t j = 0; j < keep_top_k; ++j) {
+      int label = score_index_pairs[order[j]].second.first;
+      int idx = score_index_pairs[order[j]].second.second;
       new_indices[label].push_back(idx);
     }
     if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
+      for (auto& it : new_indices) {
+        std::sort(it.second.begin(), it.second.end());
       }
     }
     new_indices.swap(*indices);
@@ -0,0 +1,110 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/yolo_box_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+static inline float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+void YoloBoxCompute::Run() {
+  auto& param = Param<operators::YoloBoxParam>();
+  const lite::Tensor* X = param.X;
+  const lite::Tensor* ImgSize = param.ImgSize;
+  lite::Tensor* Boxes = param.Boxes;
+  lite::Tensor* Scores = param.Scores;
+  const std::vector<int>& anchors = param.anchors;
+  const int class_num = param.class_num;
+  const float conf_thresh = param.conf_thresh;
+
+  const int n = X->dims()[0];
+  const int h = X->dims()[2];
+  const int w = X->dims()[3];
+  const int b_num = Boxes->dims()[1];
+  const int an_num = anchors.size() / 2;
+  const int input_size = param.downsample_ratio * h;
+  const int stride = h * w;
+  const int an_stride = (class_num + 5) * stride;
+
+  const float* x_data = X->data<float>();
+  const int* img_size_data = ImgSize->data<int>();
+  float* boxes_data = Boxes->mutable_data<float>();
+  float* scores_data = Scores->mutable_data<float>();
+  // The boxes below the confidence threshold are left as zeros.
+  std::memset(boxes_data, 0, Boxes->numel() * sizeof(float));
+  std::memset(scores_data, 0, Scores->numel() * sizeof(float));
+
+  // Every anchor of every image writes its own boxes and scores.
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < an_num; ++j) {
+      const float img_height = img_size_data[2 * i];
+      const float img_width = img_size_data[2 * i + 1];
+      const int anchor_w = anchors[2 * j];
+      const int anchor_h = anchors[2 * j + 1];
+      const float* x = x_data + (i * an_num + j) * an_stride;
+      for (int k = 0; k < h; ++k) {
+        for (int l = 0; l < w; ++l) {
+          const int hw = k * w + l;
+          const float conf = Sigmoid(x[4 * stride + hw]);
+          if (conf < conf_thresh) {
+            continue;
+          }
+          const float cx = (l + Sigmoid(x[hw])) * img_width / h;
+          const float cy = (k + Sigmoid(x[stride + hw])) * img_height / h;
+          const float bw =
+              std::exp(x[2 * stride + hw]) * anchor_w * img_width / input_size;
+          const float bh = std::exp(x[3 * stride + hw]) * anchor_h *
+                           img_height / input_size;
+          const int out_idx = i * b_num + j * stride + hw;
+          float* box = boxes_data + out_idx * 4;
+          box[0] = std::max(cx - bw / 2, 0.f);
+          box[1] = std::max(cy - bh / 2, 0.f);
+          box[2] = std::min(cx + bw / 2, img_width - 1);
+          box[3] = std::min(cy + bh / 2, img_height - 1);
+          float* score = scores_data + out_idx * class_num;
+          for (int c = 0; c < class_num; ++c) {
+            score[c] = conf * Sigmoid(x[(5 + c) * stride + hw]);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(yolo_box,
+                     kHost,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::host::YoloBoxCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindInput("ImgSize", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindOutput("Boxes", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindOutput("Scores", {LiteType::GetTensorTy(TARGET(kHost))})
+    .Finalize();
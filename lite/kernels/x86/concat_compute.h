@@ -15,6 +15,7 @@
 
 #include <Eigen/Core>
 #include <vector>
+#include "lite/backends/host/math/concat_inplace.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -42,6 +43,7 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t axis = static_cast<int64_t>(param.axis);
     auto x_dims = param.x[0]->dims();
     auto out = param.output;
+    if (param.inplace && inplace_.Run(param.x, axis, sizeof(T), out)) return;
     if (param.x.size() == 1) return;
 
     auto output_data = param.output->template mutable_data<T>();
@@ -63,6 +65,9 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
   }
   virtual ~ConcatCompute() = default;
+
+ private:
+  host::math::ConcatInplace inplace_;
 };
 
 }  // namespace x86
@@ -74,6 +74,48 @@ TEST(concat_x86, run_test) {
   }
 }
 
+TEST(concat_x86, inplace) {
+  lite::Tensor x1, x2, out;
+  std::vector<lite::Tensor*> x = {&x1, &x2};
+
+  ConcatCompute<float> concat;
+  operators::ConcatParam param;
+  param.x = x;
+  param.output = &out;
+  param.axis = 1;
+  param.inplace = true;
+  concat.SetParam(param);
+
+  // The producers write into the inputs, then concat runs.
+  auto run = [&](int64_t batch_size, float v1, float v2) {
+    x1.Resize({batch_size, 1, 2, 2});
+    x2.Resize({batch_size, 2, 2, 2});
+    out.Resize({batch_size, 3, 2, 2});
+    auto* x1_data = x1.mutable_data<float>();
+    auto* x2_data = x2.mutable_data<float>();
+    for (int64_t i = 0; i < x1.numel(); i++) x1_data[i] = v1;
+    for (int64_t i = 0; i < x2.numel(); i++) x2_data[i] = v2;
+    concat.Run();
+    auto* out_data = out.data<float>();
+    for (int64_t n = 0; n < batch_size; n++) {
+      for (int i = 0; i < 12; i++) {
+        EXPECT_EQ(out_data[n * 12 + i], i < 4 ? v1 : v2);
+      }
+    }
+  };
+
+  run(1, 1, 2);
+  // The inputs are views of the output now.
+  EXPECT_EQ(x1.data<float>(), out.data<float>());
+  EXPECT_EQ(x2.data<float>(), out.data<float>() + 4);
+  run(1, 3, 4);
+  EXPECT_EQ(x1.data<float>(), out.data<float>());
+  // Not contiguous with a batch of 2, the inputs are copied.
+  run(2, 5, 6);
+  run(1, 7, 8);
+  EXPECT_EQ(x2.data<float>(), out.data<float>() + 4);
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -23,6 +23,9 @@ REGISTER_LITE_KERNEL(conv2d,
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("SparseWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("SparseIndex",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
     .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
 
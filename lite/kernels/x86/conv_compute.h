@@ -14,9 +14,13 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "lite/backends/host/math/sparse_gemm.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/conv_winograd.h"
 #include "lite/backends/x86/math/im2col.h"
 #include "lite/backends/x86/math/vol2col.h"
 #include "lite/core/kernel.h"
@@ -44,13 +48,41 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// Below this many input or output channels the winograd transforms cost more
+// than the GEMM they save.
+constexpr int kWinogradMinChannels = 16;
+
 template <typename T>
 class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::ConvParam;
+
+  // 3x3 convolutions of stride 1 with enough channels run by winograd, with
+  // the filter transformed here once.
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    if (!UseWinograd(param)) return;
+    const auto& o_dims = param.output->dims();
+    const int tile = paddle::lite::x86::math::WinogradConv3x3::PickTile(
+        static_cast<int>(o_dims[2]), static_cast<int>(o_dims[3]));
+    winograd_.reset(new paddle::lite::x86::math::WinogradConv3x3(
+        tile,
+        param.filter->data<float>(),
+        static_cast<int>(param.filter->dims()[0]),
+        static_cast<int>(param.filter->dims()[1])));
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::ConvParam>();
+    if (!param.filter) {
+      RunSparse1x1(param);
+      return;
+    }
+    if (winograd_) {
+      RunWinograd(context, param);
+      return;
+    }
     lite::Tensor filter = *param.filter;
     param.output->mutable_data<T>();
     const int batch_size = static_cast<int>(param.x->dims()[0]);
@@ -155,6 +187,113 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~Conv2dCompute() = default;
+
+ private:
+  static bool UseWinograd(const operators::ConvParam& param) {
+    if (!std::is_same<T, float>::value || !param.filter) return false;
+    const auto& w_dims = param.filter->dims();
+    if (w_dims.size() != 4 || w_dims[2] != 3 || w_dims[3] != 3 ||
+        param.groups != 1) {
+      return false;
+    }
+    if (w_dims[0] < kWinogradMinChannels || w_dims[1] < kWinogradMinChannels) {
+      return false;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+      if (param.strides[i] != 1 || param.dilations[i] != 1) return false;
+    }
+    const auto& act = param.activation_param;
+    if (act.has_active &&
+        act.active_type != lite_api::ActivationType::kRelu &&
+        act.active_type != lite_api::ActivationType::kRelu6 &&
+        act.active_type != lite_api::ActivationType::kLeakyRelu) {
+      return false;
+    }
+    return true;
+  }
+
+  void RunWinograd(const X86Context& context,
+                   const operators::ConvParam& param) {
+    const auto& x_dims = param.x->dims();
+    const auto& o_dims = param.output->dims();
+    const int batch_size = static_cast<int>(x_dims[0]);
+    const int ic = static_cast<int>(x_dims[1]);
+    const int ih = static_cast<int>(x_dims[2]);
+    const int iw = static_cast<int>(x_dims[3]);
+    const int oc = static_cast<int>(o_dims[1]);
+    const int oh = static_cast<int>(o_dims[2]);
+    const int ow = static_cast<int>(o_dims[3]);
+    paddle::lite::x86::math::SgemmEpilogue epilogue;
+    epilogue.bias = param.bias ? param.bias->data<float>() : nullptr;
+    const auto& act = param.activation_param;
+    if (act.has_active) {
+      epilogue.act = act.active_type;
+      epilogue.leaky_alpha = act.Leaky_relu_alpha;
+    } else if (param.fuse_relu) {
+      epilogue.act = lite_api::ActivationType::kRelu;
+    }
+    const float* x = param.x->data<float>();
+    float* out = param.output->mutable_data<float>();
+    for (int i = 0; i < batch_size; ++i) {
+      winograd_->Run(context,
+                     x + static_cast<int64_t>(i) * ic * ih * iw,
+                     ih,
+                     iw,
+                     param.paddings[0],
+                     param.paddings[1],
+                     out + static_cast<int64_t>(i) * oc * oh * ow,
+                     oh,
+                     ow,
+                     &epilogue);
+    }
+  }
+
+  // A 1x1 convolution by a [oc, ic] filter in block-CSR format, with the bias
+  // and the activation fused.
+  void RunSparse1x1(const operators::ConvParam& param) {
+    const auto& sparse = param.sparse_filter;
+    const int batch_size = static_cast<int>(param.x->dims()[0]);
+    const int ic = static_cast<int>(param.x->dims()[1]);
+    const int oc = static_cast<int>(sparse.dims[0]);
+    const int size = static_cast<int>(param.x->dims().production() /
+                                      (batch_size * ic));
+    CHECK_EQ(sparse.dims[1], ic);
+    CHECK_EQ(param.output->dims().production(),
+             static_cast<int64_t>(batch_size) * oc * size);
+    host::math::BlockCsrMatrix filter(sparse.values->data<float>(),
+                                      sparse.index->data<int>(),
+                                      oc,
+                                      ic,
+                                      sparse.block_h,
+                                      sparse.block_w);
+    const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+    const float* x = param.x->data<float>();
+    float* out = param.output->mutable_data<float>();
+    for (int i = 0; i < batch_size; ++i) {
+      host::math::SparseDenseMatMul(filter,
+                                    x + static_cast<int64_t>(i) * ic * size,
+                                    size,
+                                    bias,
+                                    out + static_cast<int64_t>(i) * oc * size);
+    }
+
+    const auto& act = param.activation_param;
+    if (!act.has_active) return;
+    const int64_t numel = param.output->dims().production();
+    if (act.active_type == lite_api::ActivationType::kRelu) {
+      for (int64_t i = 0; i < numel; ++i) {
+        out[i] = out[i] > 0.f ? out[i] : 0.f;
+      }
+    } else if (act.active_type == lite_api::ActivationType::kLeakyRelu) {
+      for (int64_t i = 0; i < numel; ++i) {
+        out[i] = out[i] > 0.f ? out[i] : out[i] * act.Leaky_relu_alpha;
+      }
+    } else {
+      LOG(FATAL) << "unsupported activation of a sparse conv";
+    }
+  }
+
+  std::unique_ptr<paddle::lite::x86::math::WinogradConv3x3> winograd_;
 };
 
 }  // namespace x86
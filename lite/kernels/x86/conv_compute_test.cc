@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/conv_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -90,6 +91,127 @@ TEST(conv2d_x86, run_test) {
   }
 }
 
+TEST(conv2d_x86, sparse_1x1) {
+  const int batch_size = 2, ic = 8, oc = 16, size = 3 * 5;
+  lite::Tensor x, values, index, bias, out;
+  x.Resize({batch_size, ic, 3, 5});
+  auto* x_data = x.mutable_data<float>();
+  for (int i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>(i % 11) - 5.f;
+  }
+  // Blocks of 4 output channels, one input channel out of three is nonzero.
+  std::vector<float> filter(oc * ic, 0.f);
+  for (int i = 0; i < oc; i++) {
+    for (int j = 0; j < ic; j++) {
+      if ((i / 4 + j) % 3 == 0) filter[i * ic + j] = (i + 1.f) / (j + 2.f);
+    }
+  }
+  bias.Resize({oc});
+  auto* bias_data = bias.mutable_data<float>();
+  for (int i = 0; i < oc; i++) {
+    bias_data[i] = 0.5f - i % 3;
+  }
+  std::vector<float> blocks;
+  std::vector<int> blocks_index;
+  host::math::DenseToBlockCsr(
+      filter.data(), oc, ic, 4, 1, &blocks, &blocks_index);
+  values.Resize({static_cast<int64_t>(blocks.size()) / 4, 4, 1});
+  std::copy(blocks.begin(), blocks.end(), values.mutable_data<float>());
+  index.Resize({static_cast<int64_t>(blocks_index.size())});
+  std::copy(
+      blocks_index.begin(), blocks_index.end(), index.mutable_data<int>());
+  out.Resize({batch_size, oc, 3, 5});
+
+  Conv2dCompute<float> conv2d;
+  operators::ConvParam param;
+  param.x = &x;
+  param.sparse_filter.values = &values;
+  param.sparse_filter.index = &index;
+  param.sparse_filter.dims = lite::DDim({oc, ic, 1, 1});
+  param.sparse_filter.block_h = 4;
+  param.bias = &bias;
+  param.output = &out;
+  param.strides = {1, 1};
+  param.paddings = {0, 0};
+  param.groups = 1;
+  param.dilations = {1, 1};
+  param.activation_param.has_active = true;
+  param.activation_param.active_type = lite_api::ActivationType::kRelu;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
+  conv2d.SetParam(param);
+  conv2d.Run();
+
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < oc; i++) {
+      for (int p = 0; p < size; p++) {
+        float ref = bias_data[i];
+        for (int j = 0; j < ic; j++) {
+          ref += filter[i * ic + j] * x_data[(b * ic + j) * size + p];
+        }
+        EXPECT_NEAR(out.data<float>()[(b * oc + i) * size + p],
+                    std::max(ref, 0.f),
+                    1e-4);
+      }
+    }
+  }
+}
+
+TEST(conv2d_x86, winograd) {
+  const int batch_size = 2, ic = 16, oc = 24, h = 12, w = 10;
+  lite::Tensor x, filter, bias, out, ref;
+  x.Resize({batch_size, ic, h, w});
+  filter.Resize({oc, ic, 3, 3});
+  bias.Resize({oc});
+  out.Resize({batch_size, oc, h, w});
+  ref.Resize({batch_size, oc, h, w});
+  for (int i = 0; i < x.numel(); i++) {
+    x.mutable_data<float>()[i] = (i % 13) * 0.1f - 0.6f;
+  }
+  for (int i = 0; i < filter.numel(); i++) {
+    filter.mutable_data<float>()[i] = (i % 7) * 0.05f - 0.15f;
+  }
+  for (int i = 0; i < oc; i++) {
+    bias.mutable_data<float>()[i] = i * 0.1f - 1.f;
+  }
+
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.output = &ref;
+  param.strides = {1, 1};
+  param.paddings = {1, 1};
+  param.groups = 1;
+  param.dilations = {1, 1};
+  // Without PrepareForRun the GEMM path runs, it has no bias nor activation.
+  Conv2dCompute<float> conv_gemm;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv_gemm.SetContext(std::move(ctx));
+  conv_gemm.SetParam(param);
+  conv_gemm.Run();
+
+  param.bias = &bias;
+  param.output = &out;
+  param.activation_param.has_active = true;
+  param.activation_param.active_type = lite_api::ActivationType::kRelu;
+  Conv2dCompute<float> conv_winograd;
+  ctx.reset(new KernelContext);
+  ctx->As<X86Context>();
+  conv_winograd.SetContext(std::move(ctx));
+  conv_winograd.SetParam(param);
+  conv_winograd.PrepareForRun();
+  conv_winograd.Run();
+
+  const int size = h * w;
+  for (int i = 0; i < out.numel(); i++) {
+    const float expect =
+        std::max(ref.data<float>()[i] + bias.data<float>()[i / size % oc], 0.f);
+    EXPECT_NEAR(out.data<float>()[i], expect, 1e-4);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
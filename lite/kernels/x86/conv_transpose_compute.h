@@ -0,0 +1,165 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/im2col.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/types.h"
+#include "lite/operators/conv_transpose_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The transpose of a convolution, as the gradient of the input of conv2d: the
+ * GEMM of the transposed [ic, oc * kh * kw] filter of a group by its
+ * [ic, hin * win] input gives the columns of the output, which col2im adds up
+ * into the [oc, hout, wout] image. A 1x1 filter with stride 1 and no padding
+ * writes its output directly.
+ */
+template <typename T>
+class Conv2dTransposeCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    const auto& x_dims = param.x->dims();
+    const auto& w_dims = param.filter->dims();
+    const auto& o_dims = param.output->dims();
+    CHECK_EQ(x_dims.size(), 4UL) << "only conv2d_transpose is supported";
+    const int batch_size = static_cast<int>(x_dims[0]);
+    const int ic = static_cast<int>(x_dims[1]);
+    const int hin = static_cast<int>(x_dims[2]);
+    const int win = static_cast<int>(x_dims[3]);
+    const int oc = static_cast<int>(o_dims[1]);
+    const int hout = static_cast<int>(o_dims[2]);
+    const int wout = static_cast<int>(o_dims[3]);
+    const int kh = static_cast<int>(w_dims[2]);
+    const int kw = static_cast<int>(w_dims[3]);
+    const int groups = param.groups;
+    const int ic_group = ic / groups;
+    const int oc_group = oc / groups;
+    const int m = oc_group * kh * kw;
+    const int n = hin * win;
+    const bool is_1x1 = kh == 1 && kw == 1 && param.strides[0] == 1 &&
+                        param.strides[1] == 1 && param.paddings[0] == 0 &&
+                        param.paddings[1] == 0;
+
+    if (!is_1x1) {
+      col_.Resize({oc_group, kh, kw, hin, win});
+      col_.mutable_data<T>();
+    }
+    const std::vector<int> paddings{param.paddings[0],
+                                    param.paddings[1],
+                                    param.paddings[0],
+                                    param.paddings[1]};
+    paddle::lite::x86::math::Col2ImFunctor<
+        paddle::lite::x86::math::ColFormat::kCFO,
+        lite::TargetType::kX86,
+        T>
+        col2im;
+    auto blas =
+        paddle::lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+
+    const T* x = param.x->data<T>();
+    const T* filter = param.filter->data<T>();
+    T* out = param.output->mutable_data<T>();
+    const int64_t out_group_size =
+        static_cast<int64_t>(oc_group) * hout * wout;
+    for (int i = 0; i < batch_size; i++) {
+      for (int g = 0; g < groups; g++) {
+        const T* x_group = x + (static_cast<int64_t>(i) * groups + g) *
+                                   ic_group * n;
+        const T* filter_group =
+            filter + static_cast<int64_t>(g) * ic_group * m;
+        T* out_data = out + (static_cast<int64_t>(i) * groups + g) *
+                                out_group_size;
+        T* col_data = is_1x1 ? out_data : col_.mutable_data<T>();
+        blas.GEMM(true,
+                  false,
+                  m,
+                  n,
+                  ic_group,
+                  T(1),
+                  filter_group,
+                  m,
+                  x_group,
+                  n,
+                  T(0),
+                  col_data,
+                  n);
+        if (is_1x1) continue;
+        std::memset(out_data, 0, sizeof(T) * out_group_size);
+        lite::Tensor out_batch = param.output->Slice<T>(i, i + 1);
+        out_batch.Resize({oc, hout, wout});
+        lite::Tensor out_group =
+            out_batch.Slice<T>(g * oc_group, (g + 1) * oc_group);
+        col2im(context,
+               col_,
+               param.dilations,
+               param.strides,
+               paddings,
+               &out_group);
+      }
+    }
+    AddBiasRelu(param, out, batch_size, oc, hout * wout);
+  }
+
+  virtual ~Conv2dTransposeCompute() = default;
+
+ private:
+  static void AddBiasRelu(const operators::ConvParam& param,
+                          T* out,
+                          int batch_size,
+                          int channels,
+                          int size) {
+    const T* bias = param.bias ? param.bias->data<T>() : nullptr;
+    if (!bias && !param.fuse_relu) return;
+    const int planes = batch_size * channels;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int p = 0; p < planes; ++p) {
+      T* plane = out + static_cast<int64_t>(p) * size;
+      const T b = bias ? bias[p % channels] : T(0);
+      if (param.fuse_relu) {
+        for (int j = 0; j < size; ++j) {
+          const T v = plane[j] + b;
+          plane[j] = v > T(0) ? v : T(0);
+        }
+      } else {
+        for (int j = 0; j < size; ++j) {
+          plane[j] += b;
+        }
+      }
+    }
+  }
+
+  // The columns of a group, kept between the runs.
+  lite::Tensor col_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,151 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_transpose_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Every input pixel scatters its filter into the output.
+static void deconv_ref(const lite::Tensor& x,
+                       const lite::Tensor& filter,
+                       const lite::Tensor* bias,
+                       const operators::ConvParam& param,
+                       lite::Tensor* out) {
+  const int num = x.dims()[0], ic = x.dims()[1];
+  const int hin = x.dims()[2], win = x.dims()[3];
+  const int oc = out->dims()[1], hout = out->dims()[2], wout = out->dims()[3];
+  const int kh = filter.dims()[2], kw = filter.dims()[3];
+  const int ic_group = ic / param.groups, oc_group = oc / param.groups;
+  const float* x_data = x.data<float>();
+  const float* w_data = filter.data<float>();
+  float* out_data = out->mutable_data<float>();
+  for (int n = 0; n < num; n++) {
+    for (int o = 0; o < oc; o++) {
+      for (int i = 0; i < hout * wout; i++) {
+        out_data[(n * oc + o) * hout * wout + i] =
+            bias ? bias->data<float>()[o] : 0.f;
+      }
+    }
+    for (int c = 0; c < ic; c++) {
+      const int g = c / ic_group;
+      for (int h = 0; h < hin; h++) {
+        for (int w = 0; w < win; w++) {
+          const float v = x_data[((n * ic + c) * hin + h) * win + w];
+          for (int oo = 0; oo < oc_group; oo++) {
+            const int o = g * oc_group + oo;
+            for (int i = 0; i < kh; i++) {
+              const int y = h * param.strides[0] - param.paddings[0] +
+                            i * param.dilations[0];
+              if (y < 0 || y >= hout) continue;
+              for (int j = 0; j < kw; j++) {
+                const int z = w * param.strides[1] - param.paddings[1] +
+                              j * param.dilations[1];
+                if (z < 0 || z >= wout) continue;
+                out_data[((n * oc + o) * hout + y) * wout + z] +=
+                    v * w_data[((c * oc_group + oo) * kh + i) * kw + j];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  if (param.fuse_relu) {
+    for (int i = 0; i < out->numel(); i++) {
+      out_data[i] = out_data[i] > 0.f ? out_data[i] : 0.f;
+    }
+  }
+}
+
+TEST(conv2d_transpose_x86, retrive_op) {
+  auto conv2d_transpose =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "conv2d_transpose");
+  ASSERT_FALSE(conv2d_transpose.empty());
+  ASSERT_TRUE(conv2d_transpose.front());
+}
+
+TEST(conv2d_transpose_x86, compare_with_ref) {
+  struct Case {
+    int groups, kernel, stride, padding, dilation;
+    bool bias, relu;
+  };
+  std::vector<Case> cases{{1, 3, 2, 1, 1, true, false},
+                          {2, 4, 2, 1, 1, false, true},
+                          {1, 3, 1, 1, 2, true, true},
+                          {1, 2, 3, 0, 1, false, false},
+                          {2, 1, 1, 0, 1, true, false}};
+  for (auto& c : cases) {
+    const int num = 2, ic = 4, oc = 6, hin = 5, win = 7;
+    const int extent = c.dilation * (c.kernel - 1) + 1;
+    const int hout = (hin - 1) * c.stride + extent - 2 * c.padding;
+    const int wout = (win - 1) * c.stride + extent - 2 * c.padding;
+    lite::Tensor x, filter, bias, out, ref;
+    x.Resize({num, ic, hin, win});
+    filter.Resize({ic, oc / c.groups, c.kernel, c.kernel});
+    bias.Resize({oc});
+    out.Resize({num, oc, hout, wout});
+    ref.Resize({num, oc, hout, wout});
+    for (int i = 0; i < x.numel(); i++) {
+      x.mutable_data<float>()[i] = (i % 13) * 0.1f - 0.6f;
+    }
+    for (int i = 0; i < filter.numel(); i++) {
+      filter.mutable_data<float>()[i] = (i % 7) * 0.2f - 0.5f;
+    }
+    for (int i = 0; i < oc; i++) {
+      bias.mutable_data<float>()[i] = i * 0.3f - 1.f;
+    }
+
+    operators::ConvParam param;
+    param.x = &x;
+    param.filter = &filter;
+    param.bias = c.bias ? &bias : nullptr;
+    param.output = &out;
+    param.strides = {c.stride, c.stride};
+    param.paddings = {c.padding, c.padding};
+    param.dilations = {c.dilation, c.dilation};
+    param.groups = c.groups;
+    param.fuse_relu = c.relu;
+
+    Conv2dTransposeCompute<float> conv2d_transpose;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    conv2d_transpose.SetContext(std::move(ctx));
+    conv2d_transpose.SetParam(param);
+    // Twice, the columns are kept between the runs.
+    for (int run = 0; run < 2; run++) {
+      conv2d_transpose.Run();
+    }
+
+    deconv_ref(x, filter, param.bias, param, &ref);
+    for (int i = 0; i < out.numel(); i++) {
+      EXPECT_NEAR(out.data<float>()[i], ref.data<float>()[i], 1e-4);
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d_transpose, kX86, kFloat, kNCHW, def);
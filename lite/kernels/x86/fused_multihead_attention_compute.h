@@ -0,0 +1,160 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/types.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The heads are read in place from Q, K and V of [batch, seq_len, hidden]
+ * with a leading dimension of `hidden`, so the transposed tensors are never
+ * built. The query rows of a head are processed in blocks small enough for
+ * their scores to stay in cache, the bias and the softmax are applied to a
+ * block right after its score GEMM, and the output GEMM writes the block of a
+ * head straight into its columns of Out.
+ */
+template <typename T>
+class FusedMultiheadAttentionCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedMultiheadAttentionParam;
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<param_t>();
+    auto dims = param.Q->dims();
+    const int batch = dims[0];
+    const int seq_len = dims[1];
+    const int hidden = dims[2];
+    const int head_number = param.head_number;
+    const int head_size = hidden / head_number;
+    const T alpha = static_cast<T>(param.alpha);
+    const T out_scale = static_cast<T>(param.out_scale);
+
+    const T* q = param.Q->template data<T>();
+    const T* k = param.K->template data<T>();
+    const T* v = param.V->template data<T>();
+    T* out = param.Out->template mutable_data<T>();
+
+    // The strides of BiasQK, 0 on the broadcast dims. It may have less than 4
+    // dims, aligned to the last one.
+    const T* bias = nullptr;
+    int64_t bias_strides[4] = {0, 0, 0, 0};
+    if (param.BiasQK) {
+      bias = param.BiasQK->template data<T>();
+      auto bias_dims = param.BiasQK->dims();
+      const int offset = 4 - static_cast<int>(bias_dims.size());
+      int64_t stride = 1;
+      for (int i = static_cast<int>(bias_dims.size()) - 1; i >= 0; --i) {
+        bias_strides[offset + i] = bias_dims[i] == 1 ? 0 : stride;
+        stride *= bias_dims[i];
+      }
+    }
+
+    const int block_rows =
+        std::max(1, std::min(seq_len, kScoresBlockSize / seq_len));
+    scores_.Resize({block_rows, seq_len});
+    T* scores = scores_.template mutable_data<T>();
+
+    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+    for (int b = 0; b < batch; ++b) {
+      for (int h = 0; h < head_number; ++h) {
+        const int64_t head_offset =
+            static_cast<int64_t>(b) * seq_len * hidden + h * head_size;
+        const T* qh = q + head_offset;
+        const T* kh = k + head_offset;
+        const T* vh = v + head_offset;
+        T* oh = out + head_offset;
+        for (int row = 0; row < seq_len; row += block_rows) {
+          const int rows = std::min(block_rows, seq_len - row);
+          blas.GEMM(false,
+                    true,
+                    rows,
+                    seq_len,
+                    head_size,
+                    alpha,
+                    qh + static_cast<int64_t>(row) * hidden,
+                    hidden,
+                    kh,
+                    hidden,
+                    T(0),
+                    scores,
+                    seq_len);
+          for (int i = 0; i < rows; ++i) {
+            const T* bias_row =
+                bias ? bias + b * bias_strides[0] + h * bias_strides[1] +
+                           (row + i) * bias_strides[2]
+                     : nullptr;
+            AddBiasSoftmax(
+                scores + i * seq_len, bias_row, bias_strides[3], seq_len);
+          }
+          blas.GEMM(false,
+                    false,
+                    rows,
+                    head_size,
+                    seq_len,
+                    out_scale,
+                    scores,
+                    seq_len,
+                    vh,
+                    hidden,
+                    T(0),
+                    oh + static_cast<int64_t>(row) * hidden,
+                    hidden);
+        }
+      }
+    }
+  }
+
+  virtual ~FusedMultiheadAttentionCompute() = default;
+
+ private:
+  static void AddBiasSoftmax(T* x, const T* bias, int64_t stride, int n) {
+    T max_val = -std::numeric_limits<T>::max();
+    for (int j = 0; j < n; ++j) {
+      if (bias) x[j] += bias[j * stride];
+      max_val = std::max(max_val, x[j]);
+    }
+    T sum = 0;
+    for (int j = 0; j < n; ++j) {
+      x[j] = std::exp(x[j] - max_val);
+      sum += x[j];
+    }
+    const T inv_sum = T(1) / sum;
+    for (int j = 0; j < n; ++j) {
+      x[j] *= inv_sum;
+    }
+  }
+
+  // The number of scores of a block of query rows, 64KB of floats.
+  static constexpr int kScoresBlockSize = 16384;
+
+  lite::Tensor scores_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
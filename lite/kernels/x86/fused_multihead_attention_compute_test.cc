@@ -0,0 +1,162 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_multihead_attention_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The unfused attention on [batch, seq_len, hidden] with a bias of
+// [batch, 1, seq_len, seq_len].
+void attention_ref(const std::vector<float>& q,
+                   const std::vector<float>& k,
+                   const std::vector<float>& v,
+                   const std::vector<float>& bias,
+                   int batch,
+                   int seq_len,
+                   int hidden,
+                   int head_number,
+                   float alpha,
+                   float out_scale,
+                   std::vector<float>* out) {
+  int head_size = hidden / head_number;
+  out->assign(batch * seq_len * hidden, 0.f);
+  for (int b = 0; b < batch; ++b) {
+    for (int h = 0; h < head_number; ++h) {
+      for (int i = 0; i < seq_len; ++i) {
+        std::vector<float> p(seq_len);
+        float max_val = -1e30f;
+        for (int j = 0; j < seq_len; ++j) {
+          float dot = 0.f;
+          for (int d = 0; d < head_size; ++d) {
+            dot += q[(b * seq_len + i) * hidden + h * head_size + d] *
+                   k[(b * seq_len + j) * hidden + h * head_size + d];
+          }
+          p[j] = alpha * dot + bias[(b * seq_len + i) * seq_len + j];
+          max_val = std::max(max_val, p[j]);
+        }
+        float sum = 0.f;
+        for (int j = 0; j < seq_len; ++j) {
+          p[j] = std::exp(p[j] - max_val);
+          sum += p[j];
+        }
+        for (int d = 0; d < head_size; ++d) {
+          float acc = 0.f;
+          for (int j = 0; j < seq_len; ++j) {
+            int idx = (b * seq_len + j) * hidden + h * head_size + d;
+            acc += p[j] / sum * v[idx];
+          }
+          (*out)[(b * seq_len + i) * hidden + h * head_size + d] =
+              acc * out_scale;
+        }
+      }
+    }
+  }
+}
+
+TEST(fused_multihead_attention_x86, retrive_op) {
+  auto attention =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "fused_multihead_attention");
+  ASSERT_FALSE(attention.empty());
+  ASSERT_TRUE(attention.front());
+}
+
+TEST(fused_multihead_attention_x86, run_test) {
+  // A bias of 2 dims broadcasts over the batch and the heads.
+  for (int bias_rank : {4, 2}) {
+    for (int seq_len : {1, 7, 300}) {
+      const int batch = 2, head_number = 3, head_size = 4;
+      const int hidden = head_number * head_size;
+      lite::Tensor q, k, v, bias, out;
+      for (auto* x : {&q, &k, &v}) {
+        x->Resize({batch, seq_len, hidden});
+        auto* data = x->mutable_data<float>();
+        for (int i = 0; i < x->numel(); ++i) {
+          data[i] = std::sin(i * 0.37f + (x == &k) + 2 * (x == &v));
+        }
+      }
+      if (bias_rank == 4) {
+        bias.Resize({batch, 1, seq_len, seq_len});
+      } else {
+        bias.Resize({seq_len, seq_len});
+      }
+      auto* bias_data = bias.mutable_data<float>();
+      for (int i = 0; i < bias.numel(); ++i) {
+        bias_data[i] = (i % 5 == 0) ? -10000.f : 0.f;
+      }
+      // The bias of every image for the reference.
+      std::vector<float> full_bias;
+      for (int b = 0; b < batch; ++b) {
+        int64_t offset = bias_rank == 4 ? b * seq_len * seq_len : 0;
+        full_bias.insert(full_bias.end(),
+                         bias_data + offset,
+                         bias_data + offset + seq_len * seq_len);
+      }
+      out.Resize({batch, seq_len, hidden});
+
+      FusedMultiheadAttentionCompute<float> attention;
+      operators::FusedMultiheadAttentionParam param;
+      param.Q = &q;
+      param.K = &k;
+      param.V = &v;
+      param.BiasQK = &bias;
+      param.Out = &out;
+      param.head_number = head_number;
+      param.alpha = 0.5f;
+      param.out_scale = 0.9f;
+
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      attention.SetContext(std::move(ctx));
+      attention.SetParam(param);
+      attention.Run();
+
+      auto to_vec = [](const lite::Tensor& x) {
+        return std::vector<float>(x.data<float>(),
+                                  x.data<float>() + x.numel());
+      };
+      std::vector<float> ref;
+      attention_ref(to_vec(q),
+                    to_vec(k),
+                    to_vec(v),
+                    full_bias,
+                    batch,
+                    seq_len,
+                    hidden,
+                    head_number,
+                    param.alpha,
+                    param.out_scale,
+                    &ref);
+      for (int i = 0; i < out.numel(); ++i) {
+        EXPECT_NEAR(out.data<float>()[i], ref[i], 1e-4);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_multihead_attention, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,189 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/interpolate_compute.h"
+#include <algorithm>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void InterpAxis::Build(int in_size,
+                       int out_size,
+                       bool bilinear,
+                       bool align_corners,
+                       int align_mode) {
+  float ratio = 0.f;
+  if (out_size > 1) {
+    ratio = align_corners ? static_cast<float>(in_size - 1) / (out_size - 1)
+                          : static_cast<float>(in_size) / out_size;
+  }
+  const bool half_pixel = align_mode == 0 && !align_corners;
+  index0.resize(out_size);
+  index1.resize(out_size);
+  lambda.resize(out_size);
+  for (int k = 0; k < out_size; ++k) {
+    if (!bilinear) {
+      int index = align_corners ? static_cast<int>(ratio * k + 0.5f)
+                                : static_cast<int>(ratio * k);
+      index = std::min(index, in_size - 1);
+      index0[k] = index;
+      index1[k] = index;
+      lambda[k] = 0.f;
+      continue;
+    }
+    float src = half_pixel ? ratio * (k + 0.5f) - 0.5f : ratio * k;
+    src = std::max(src, 0.f);
+    const int index = std::min(static_cast<int>(src), in_size - 1);
+    index0[k] = index;
+    index1[k] = std::min(index + 1, in_size - 1);
+    lambda[k] = src - index;
+  }
+}
+
+void InterpolateCompute::BilinearPlane(const float* in,
+                                       float* out,
+                                       float* rows) const {
+  const int in_w = shape_[1];
+  const int out_h = shape_[2];
+  const int out_w = shape_[3];
+  const int* x0 = w_axis_.index0.data();
+  const int* x1 = w_axis_.index1.data();
+  const float* lx = w_axis_.lambda.data();
+  auto interp_row = [&](int y, float* row) {
+    const float* src = in + static_cast<int64_t>(y) * in_w;
+    for (int j = 0; j < out_w; ++j) {
+      const float a = src[x0[j]];
+      row[j] = a + lx[j] * (src[x1[j]] - a);
+    }
+  };
+
+  float* row0 = rows;
+  float* row1 = rows + out_w;
+  int prev0 = -1;
+  int prev1 = -1;
+  for (int i = 0; i < out_h; ++i) {
+    const int y0 = h_axis_.index0[i];
+    const int y1 = h_axis_.index1[i];
+    if (y0 != prev0 || y1 != prev1) {
+      if (y0 == prev1) {
+        // Going down by one source row, the bottom row becomes the top one.
+        std::swap(row0, row1);
+      } else {
+        interp_row(y0, row0);
+      }
+      interp_row(y1, row1);
+      prev0 = y0;
+      prev1 = y1;
+    }
+    const float ly = h_axis_.lambda[i];
+    float* dst = out + static_cast<int64_t>(i) * out_w;
+    for (int j = 0; j < out_w; ++j) {
+      dst[j] = row0[j] + ly * (row1[j] - row0[j]);
+    }
+  }
+}
+
+void InterpolateCompute::NearestPlane(const float* in, float* out) const {
+  const int in_w = shape_[1];
+  const int out_h = shape_[2];
+  const int out_w = shape_[3];
+  const int* x0 = w_axis_.index0.data();
+  for (int i = 0; i < out_h; ++i) {
+    const float* src = in + static_cast<int64_t>(h_axis_.index0[i]) * in_w;
+    float* dst = out + static_cast<int64_t>(i) * out_w;
+    for (int j = 0; j < out_w; ++j) {
+      dst[j] = src[x0[j]];
+    }
+  }
+}
+
+void InterpolateCompute::Run() {
+  auto& param = Param<operators::InterpolateParam>();
+  auto x_dims = param.X->dims();
+  CHECK_EQ(x_dims.size(), 4UL);
+  if (param.OutSize != nullptr) {
+    const int* out_size = param.OutSize->data<int>();
+    param.Out->Resize({x_dims[0], x_dims[1], out_size[0], out_size[1]});
+  }
+  auto out_dims = param.Out->dims();
+  const int in_h = static_cast<int>(x_dims[2]);
+  const int in_w = static_cast<int>(x_dims[3]);
+  const int out_h = static_cast<int>(out_dims[2]);
+  const int out_w = static_cast<int>(out_dims[3]);
+  CHECK(out_h > 0 && out_w > 0) << "invalid output size " << out_dims;
+
+  std::vector<int> shape{in_h, in_w, out_h, out_w};
+  if (shape != shape_) {
+    h_axis_.Build(
+        in_h, out_h, bilinear_, param.align_corners, param.align_mode);
+    w_axis_.Build(
+        in_w, out_w, bilinear_, param.align_corners, param.align_mode);
+    shape_ = shape;
+  }
+
+  const float* x = param.X->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  const int planes = static_cast<int>(x_dims[0] * x_dims[1]);
+  const int64_t in_size = static_cast<int64_t>(in_h) * in_w;
+  const int64_t out_size = static_cast<int64_t>(out_h) * out_w;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+#endif
+  {
+    // The two horizontally interpolated rows of a thread.
+    std::vector<float> rows(bilinear_ ? 2 * out_w : 0);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp for
+#endif
+    for (int p = 0; p < planes; ++p) {
+      if (bilinear_) {
+        BilinearPlane(x + p * in_size, out + p * out_size, rows.data());
+      } else {
+        NearestPlane(x + p * in_size, out + p * out_size);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(bilinear_interp,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::BilinearInterpCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutSize",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(nearest_interp,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::NearestInterpCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutSize",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
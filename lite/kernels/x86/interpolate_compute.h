@@ -0,0 +1,85 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/interpolate_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The source pixels of the output of an interpolation along one axis, with
+ * the weight of the second one, see the interpolate ops of Fluid for the
+ * coordinates given by align_corners and align_mode.
+ */
+struct InterpAxis {
+  std::vector<int> index0;
+  std::vector<int> index1;
+  std::vector<float> lambda;
+
+  void Build(int in_size,
+             int out_size,
+             bool bilinear,
+             bool align_corners,
+             int align_mode);
+};
+
+/*
+ * bilinear_interp and nearest_interp on NCHW images. The tables of the source
+ * pixels and their weights only depend on the sizes, they are built on the
+ * first run with a new shape and reused after that. The planes of the images
+ * run in parallel; a bilinear output row is interpolated from two source rows
+ * which are first interpolated horizontally, and reused by the next output
+ * row if it has the same sources.
+ */
+class InterpolateCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::InterpolateParam;
+
+  explicit InterpolateCompute(bool bilinear) : bilinear_(bilinear) {}
+
+  void Run() override;
+
+  virtual ~InterpolateCompute() = default;
+
+ private:
+  void BilinearPlane(const float* in, float* out, float* rows) const;
+  void NearestPlane(const float* in, float* out) const;
+
+  bool bilinear_;
+  // The shape the tables are built for.
+  std::vector<int> shape_;
+  InterpAxis h_axis_;
+  InterpAxis w_axis_;
+};
+
+class BilinearInterpCompute : public InterpolateCompute {
+ public:
+  BilinearInterpCompute() : InterpolateCompute(true) {}
+};
+
+class NearestInterpCompute : public InterpolateCompute {
+ public:
+  NearestInterpCompute() : InterpolateCompute(false) {}
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,193 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/interpolate_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The bilinear and nearest interpolation of Fluid, pixel by pixel.
+static float interp_ref(const float* in,
+                        int in_h,
+                        int in_w,
+                        int out_h,
+                        int out_w,
+                        int k,
+                        int l,
+                        bool bilinear,
+                        bool align_corners,
+                        int align_mode) {
+  auto ratio = [&](int in_size, int out_size) {
+    if (out_size <= 1) return 0.f;
+    return align_corners ? static_cast<float>(in_size - 1) / (out_size - 1)
+                         : static_cast<float>(in_size) / out_size;
+  };
+  const float ratio_h = ratio(in_h, out_h);
+  const float ratio_w = ratio(in_w, out_w);
+  if (!bilinear) {
+    const int in_k = align_corners ? static_cast<int>(ratio_h * k + 0.5)
+                                   : static_cast<int>(ratio_h * k);
+    const int in_l = align_corners ? static_cast<int>(ratio_w * l + 0.5)
+                                   : static_cast<int>(ratio_w * l);
+    return in[in_k * in_w + in_l];
+  }
+  const bool align_flag = align_mode == 0 && !align_corners;
+  int y_n = align_flag ? static_cast<int>(ratio_h * (k + 0.5) - 0.5)
+                       : static_cast<int>(ratio_h * k);
+  y_n = std::max(y_n, 0);
+  const int y_s = std::min(y_n + 1, in_h - 1);
+  const float src_y = std::max(ratio_h * (k + 0.5f) - 0.5f, 0.f);
+  const float d_n = align_flag ? src_y - y_n : ratio_h * k - y_n;
+  const float d_s = 1.f - d_n;
+  int x_w = align_flag ? static_cast<int>(ratio_w * (l + 0.5) - 0.5)
+                       : static_cast<int>(ratio_w * l);
+  x_w = std::max(x_w, 0);
+  const int x_e = std::min(x_w + 1, in_w - 1);
+  const float src_x = std::max(ratio_w * (l + 0.5f) - 0.5f, 0.f);
+  const float d_w = align_flag ? src_x - x_w : ratio_w * l - x_w;
+  const float d_e = 1.f - d_w;
+  return in[y_n * in_w + x_w] * d_s * d_e + in[y_s * in_w + x_w] * d_n * d_e +
+         in[y_n * in_w + x_e] * d_s * d_w + in[y_s * in_w + x_e] * d_n * d_w;
+}
+
+static void check_interp(bool bilinear,
+                         bool align_corners,
+                         int align_mode,
+                         int out_h,
+                         int out_w,
+                         bool with_out_size) {
+  const int num = 2, channels = 3, in_h = 5, in_w = 7;
+  lite::Tensor x, out, out_size;
+  x.Resize({num, channels, in_h, in_w});
+  auto* x_data = x.mutable_data<float>();
+  for (int i = 0; i < x.numel(); i++) {
+    x_data[i] = (i * 37 % 17) * 0.25f;
+  }
+  operators::InterpolateParam param;
+  param.X = &x;
+  param.Out = &out;
+  param.align_corners = align_corners;
+  param.align_mode = align_mode;
+  if (with_out_size) {
+    out_size.Resize({2});
+    out_size.mutable_data<int>()[0] = out_h;
+    out_size.mutable_data<int>()[1] = out_w;
+    param.OutSize = &out_size;
+    out.Resize({num, channels, 1, 1});
+  } else {
+    out.Resize({num, channels, out_h, out_w});
+  }
+
+  std::unique_ptr<InterpolateCompute> interp;
+  if (bilinear) {
+    interp.reset(new BilinearInterpCompute);
+  } else {
+    interp.reset(new NearestInterpCompute);
+  }
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  interp->SetContext(std::move(ctx));
+  interp->SetParam(param);
+  interp->Run();
+
+  ASSERT_EQ(out.dims(), DDim({num, channels, out_h, out_w}));
+  const float* out_data = out.data<float>();
+  for (int p = 0; p < num * channels; p++) {
+    for (int k = 0; k < out_h; k++) {
+      for (int l = 0; l < out_w; l++) {
+        EXPECT_NEAR(out_data[(p * out_h + k) * out_w + l],
+                    interp_ref(x_data + p * in_h * in_w,
+                               in_h,
+                               in_w,
+                               out_h,
+                               out_w,
+                               k,
+                               l,
+                               bilinear,
+                               align_corners,
+                               align_mode),
+                    1e-5);
+      }
+    }
+  }
+}
+
+TEST(interpolate_x86, retrive_op) {
+  for (auto op : {"bilinear_interp", "nearest_interp"}) {
+    auto interp =
+        KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(op);
+    ASSERT_FALSE(interp.empty());
+    ASSERT_TRUE(interp.front());
+  }
+}
+
+TEST(interpolate_x86, bilinear) {
+  for (bool align_corners : {true, false}) {
+    for (int align_mode : {0, 1}) {
+      check_interp(true, align_corners, align_mode, 10, 14, false);
+      check_interp(true, align_corners, align_mode, 3, 4, false);
+      check_interp(true, align_corners, align_mode, 11, 9, true);
+    }
+  }
+}
+
+TEST(interpolate_x86, nearest) {
+  for (bool align_corners : {true, false}) {
+    check_interp(false, align_corners, 1, 10, 14, false);
+    check_interp(false, align_corners, 1, 3, 4, false);
+    check_interp(false, align_corners, 1, 11, 9, true);
+  }
+}
+
+TEST(interpolate_x86, shape_change) {
+  lite::Tensor x, out;
+  operators::InterpolateParam param;
+  param.X = &x;
+  param.Out = &out;
+  param.align_corners = true;
+  BilinearInterpCompute interp;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  interp.SetContext(std::move(ctx));
+  interp.SetParam(param);
+  // The tables follow the shape of the input.
+  for (int size : {2, 3, 2}) {
+    x.Resize({1, 1, size, size});
+    for (int i = 0; i < x.numel(); i++) {
+      x.mutable_data<float>()[i] = i;
+    }
+    out.Resize({1, 1, 2 * size - 1, 2 * size - 1});
+    interp.Run();
+    // The corners are kept and every other pixel is a midpoint.
+    EXPECT_NEAR(out.data<float>()[0], 0.f, 1e-6);
+    EXPECT_NEAR(out.data<float>()[out.numel() - 1], size * size - 1, 1e-5);
+    EXPECT_NEAR(out.data<float>()[1], 0.5f, 1e-6);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(bilinear_interp, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(nearest_interp, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,90 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <algorithm>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::LayerNormParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::LayerNormParam>();
+    auto matrix_dim = param.X->dims().Flatten2D(param.begin_norm_axis);
+    const int left = static_cast<int>(matrix_dim[0]);
+    const int right = static_cast<int>(matrix_dim[1]);
+    if (param.Scale) {
+      CHECK_EQ(param.Scale->numel(), right);
+    }
+    if (param.Bias) {
+      CHECK_EQ(param.Bias->numel(), right);
+    }
+
+    // The jit kernel takes a non-const input, it never writes into it.
+    auto* x = const_cast<T*>(param.X->template data<T>());
+    auto* y = param.Y->template mutable_data<T>();
+    auto* mean = param.Mean->template mutable_data<T>();
+    auto* var = param.Variance->template mutable_data<T>();
+    const T* scale = param.Scale ? param.Scale->template data<T>() : nullptr;
+    const T* bias = param.Bias ? param.Bias->template data<T>() : nullptr;
+    const float epsilon = param.epsilon;
+
+    // The rows are normalized independently, split them into blocks of
+    // about kBlockSize elements to run on several threads.
+    const int block_rows = std::max(1, kBlockSize / std::max(right, 1));
+    const int num_blocks = (left + block_rows - 1) / block_rows;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int b = 0; b < num_blocks; ++b) {
+      const int begin = b * block_rows;
+      const int rows = std::min(block_rows, left - begin);
+      const int64_t offset = static_cast<int64_t>(begin) * right;
+      // The kernel cache is thread local.
+      auto compute =
+          jit::KernelFuncs<jit::LayerNormTuple<T>, fluid::CPUPlace>::Cache()
+              .At(right);
+      compute(x + offset,
+              y + offset,
+              mean + begin,
+              var + begin,
+              scale,
+              bias,
+              rows,
+              epsilon,
+              right);
+    }
+  }
+
+  virtual ~LayerNormCompute() = default;
+
+ private:
+  static constexpr int kBlockSize = 4096;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,143 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/kernels/x86/layer_norm_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void LayerNormRef(const lite::Tensor& x,
+                  const lite::Tensor* scale,
+                  const lite::Tensor* bias,
+                  int begin_norm_axis,
+                  float epsilon,
+                  std::vector<float>* y,
+                  std::vector<float>* mean,
+                  std::vector<float>* var) {
+  auto matrix_dim = x.dims().Flatten2D(begin_norm_axis);
+  int left = matrix_dim[0];
+  int right = matrix_dim[1];
+  const float* x_data = x.data<float>();
+  y->resize(left * right);
+  mean->resize(left);
+  var->resize(left);
+  for (int i = 0; i < left; ++i) {
+    const float* row = x_data + i * right;
+    float m = 0.f;
+    for (int j = 0; j < right; ++j) m += row[j];
+    m /= right;
+    float v = 0.f;
+    for (int j = 0; j < right; ++j) v += (row[j] - m) * (row[j] - m);
+    v /= right;
+    (*mean)[i] = m;
+    (*var)[i] = v;
+    for (int j = 0; j < right; ++j) {
+      float out = (row[j] - m) / std::sqrt(v + epsilon);
+      if (scale) out *= scale->data<float>()[j];
+      if (bias) out += bias->data<float>()[j];
+      (*y)[i * right + j] = out;
+    }
+  }
+}
+
+TEST(layer_norm_x86, retrive_op) {
+  auto layer_norm =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "layer_norm");
+  ASSERT_FALSE(layer_norm.empty());
+  ASSERT_TRUE(layer_norm.front());
+}
+
+TEST(layer_norm_x86, init) {
+  LayerNormCompute<float> layer_norm;
+  ASSERT_EQ(layer_norm.precision(), PRECISION(kFloat));
+  ASSERT_EQ(layer_norm.target(), TARGET(kX86));
+}
+
+TEST(layer_norm_x86, run_test) {
+  // The last shape has more rows than a single thread block.
+  for (auto shape : std::vector<std::vector<int64_t>>{
+           {2, 3, 4}, {3, 5, 17}, {1, 7, 64}, {4, 128, 33}}) {
+    for (int begin_norm_axis : {1, 2}) {
+      for (bool with_affine : {false, true}) {
+        lite::Tensor x, scale, bias, y, mean, var;
+        x.Resize(lite::DDim(shape));
+        auto matrix_dim = x.dims().Flatten2D(begin_norm_axis);
+        int left = matrix_dim[0];
+        int right = matrix_dim[1];
+        auto* x_data = x.mutable_data<float>();
+        for (int64_t i = 0; i < x.numel(); ++i) {
+          x_data[i] = static_cast<float>((i * 7) % 13) * 0.3f - 1.5f;
+        }
+        scale.Resize({right});
+        bias.Resize({right});
+        for (int i = 0; i < right; ++i) {
+          scale.mutable_data<float>()[i] = 0.5f + 0.1f * (i % 5);
+          bias.mutable_data<float>()[i] = -0.2f + 0.05f * (i % 3);
+        }
+        y.Resize(x.dims());
+        mean.Resize({left});
+        var.Resize({left});
+
+        LayerNormCompute<float> layer_norm;
+        operators::LayerNormParam param;
+        param.X = &x;
+        param.Scale = with_affine ? &scale : nullptr;
+        param.Bias = with_affine ? &bias : nullptr;
+        param.Y = &y;
+        param.Mean = &mean;
+        param.Variance = &var;
+        param.begin_norm_axis = begin_norm_axis;
+        param.epsilon = 1e-5f;
+
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        layer_norm.SetContext(std::move(ctx));
+        layer_norm.SetParam(param);
+        layer_norm.Run();
+
+        std::vector<float> y_ref, mean_ref, var_ref;
+        LayerNormRef(x,
+                     param.Scale,
+                     param.Bias,
+                     begin_norm_axis,
+                     param.epsilon,
+                     &y_ref,
+                     &mean_ref,
+                     &var_ref);
+        for (int i = 0; i < left; ++i) {
+          EXPECT_NEAR(mean.data<float>()[i], mean_ref[i], 1e-4);
+          EXPECT_NEAR(var.data<float>()[i], var_ref[i], 1e-4);
+        }
+        for (int64_t i = 0; i < y.numel(); ++i) {
+          EXPECT_NEAR(y.data<float>()[i], y_ref[i], 1e-4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(layer_norm, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,77 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include "lite/backends/host/math/rowwise_quant.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_lite.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/type_system.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+class LookupTableCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::LookupTableParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* w = param.W;
+    auto* ids = param.Ids;
+    auto* out = param.Out;
+
+    auto table_dims = w->dims();
+    int64_t row_number = table_dims[0];
+    int64_t row_width = param.enable_int8 ? param.row_width : table_dims[1];
+    int64_t ids_numel = ids->numel();
+    auto* ids_data = ids->data<int64_t>();
+    auto* dout = out->mutable_data<T>();
+
+    for (int64_t i = 0; i < ids_numel; ++i) {
+      int64_t id = ids_data[i];
+      T* out_row = dout + i * row_width;
+      if (param.padding_idx != -1 && id == param.padding_idx) {
+        memset(out_row, 0, row_width * sizeof(T));
+        continue;
+      }
+      CHECK_LT(id, row_number) << "lookup_table ids[i] < row_number failed";
+      CHECK_GE(id, 0) << "lookup_table ids[i] >= 0 check failed";
+      if (param.enable_int8) {
+        // Dequantize the row on the fly, the table stays quantized.
+        lite::host::math::DequantizeRow(w->data<int8_t>() + id * table_dims[1],
+                                        row_width,
+                                        param.bit_length,
+                                        param.Scale->data<float>()[id],
+                                        out_row);
+      } else {
+        memcpy(out_row, w->data<T>() + id * row_width, row_width * sizeof(T));
+      }
+    }
+    *(out->mutable_lod()) = ids->lod();
+  }
+
+  virtual ~LookupTableCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
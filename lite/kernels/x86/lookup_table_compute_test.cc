@@ -0,0 +1,113 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/lookup_table_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(lookup_table_x86, retrive_op) {
+  auto lookup_table =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "lookup_table");
+  ASSERT_FALSE(lookup_table.empty());
+  ASSERT_TRUE(lookup_table.front());
+}
+
+// Look up the rows {3, 0, padding, 5} of a 6 x 7 table, with the table in
+// float or quantized with `bit_length` bits.
+void RunLookupTable(int bit_length) {
+  const int64_t rows = 6;
+  const int64_t width = 7;
+  const int64_t padding_idx = 4;
+  lite::Tensor table, w, scale, ids, out;
+  table.Resize({rows, width});
+  auto* table_data = table.mutable_data<float>();
+  for (int64_t i = 0; i < table.numel(); ++i) {
+    table_data[i] = std::sin(static_cast<float>(i)) * (i % rows + 1);
+  }
+  std::vector<int64_t> ids_value{3, 0, padding_idx, 5};
+  ids.Resize({static_cast<int64_t>(ids_value.size()), 1});
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (size_t i = 0; i < ids_value.size(); ++i) {
+    ids_data[i] = ids_value[i];
+  }
+  out.Resize({static_cast<int64_t>(ids_value.size()), width});
+
+  operators::LookupTableParam param;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  if (bit_length == 32) {
+    param.W = &table;
+  } else {
+    int64_t row_bytes = host::math::QuantizedRowBytes(width, bit_length);
+    w.Resize({rows, row_bytes});
+    scale.Resize({rows});
+    host::math::QuantizeRowwise(table_data,
+                                rows,
+                                width,
+                                bit_length,
+                                w.mutable_data<int8_t>(),
+                                scale.mutable_data<float>());
+    param.W = &w;
+    param.Scale = &scale;
+    param.enable_int8 = true;
+    param.bit_length = bit_length;
+    param.row_width = width;
+  }
+
+  LookupTableCompute<float> lookup_table;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  lookup_table.SetContext(std::move(ctx));
+  lookup_table.SetParam(param);
+  lookup_table.Run();
+
+  auto* out_data = out.data<float>();
+  for (size_t i = 0; i < ids_value.size(); ++i) {
+    for (int64_t j = 0; j < width; ++j) {
+      float expect = ids_value[i] == padding_idx
+                         ? 0.f
+                         : table_data[ids_value[i] * width + j];
+      // The rounding error is at most half of the scale of the row.
+      float tolerance = 1e-6;
+      if (bit_length != 32 && ids_value[i] != padding_idx) {
+        tolerance += scale.data<float>()[ids_value[i]] / 2;
+      }
+      EXPECT_NEAR(out_data[i * width + j], expect, tolerance);
+    }
+  }
+}
+
+TEST(lookup_table_x86, run_test) {
+  for (int bit_length : {32, 8, 4}) {
+    RunLookupTable(bit_length);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lookup_table, kX86, kFloat, kNCHW, def);
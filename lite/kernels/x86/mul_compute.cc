@@ -22,6 +22,9 @@ REGISTER_LITE_KERNEL(mul,
                      def)
     .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("SparseWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("SparseIndex",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
 
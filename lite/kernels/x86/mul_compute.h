@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include "lite/backends/host/math/sparse_gemm.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
@@ -48,6 +49,10 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
     auto* x = param.x;
     auto* y = param.y;
+    if (!y) {
+      RunSparse(param);
+      return;
+    }
 
     Tensor x_matrix, y_matrix;
 
@@ -79,6 +84,25 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // The weight is a [rows, cols] matrix in block-CSR format.
+  void RunSparse(const operators::MulParam& param) {
+    const auto& sparse = param.sparse_y;
+    auto y_dims = sparse.dims.Flatten2D(param.y_num_col_dims);
+    auto x_dims = param.x->dims().Flatten2D(param.x_num_col_dims);
+    CHECK_EQ(x_dims[1], y_dims[0]);
+    host::math::BlockCsrMatrix y(sparse.values->data<float>(),
+                                 sparse.index->data<int>(),
+                                 y_dims[0],
+                                 y_dims[1],
+                                 sparse.block_h,
+                                 sparse.block_w);
+    host::math::DenseSparseMatMul(param.x->data<float>(),
+                                  x_dims[0],
+                                  y,
+                                  param.output->mutable_data<float>());
+  }
 };
 
 #ifdef LITE_WITH_TRAIN
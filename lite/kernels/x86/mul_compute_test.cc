@@ -14,6 +14,7 @@
 
 #include "lite/kernels/x86/mul_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -78,6 +79,57 @@ TEST(mul_x86, run_test) {
   }
 }
 
+TEST(mul_x86, sparse) {
+  const int m = 3, k = 16, n = 32;
+  lite::Tensor x, y, values, index, out, ref;
+  x.Resize({m, k});
+  y.Resize({k, n});
+  auto* x_data = x.mutable_data<float>();
+  auto* y_data = y.mutable_data<float>();
+  for (int i = 0; i < m * k; i++) {
+    x_data[i] = i % 5 == 0 ? 0.f : static_cast<float>(i % 7) - 3.f;
+  }
+  // Every other block of 4 columns of every third row is nonzero.
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) {
+      y_data[i * n + j] =
+          i % 3 == 0 && j / 4 % 2 == 0 ? static_cast<float>(i - j) / 8 : 0.f;
+    }
+  }
+  std::vector<float> blocks;
+  std::vector<int> blocks_index;
+  host::math::DenseToBlockCsr(y_data, k, n, 1, 4, &blocks, &blocks_index);
+  values.Resize({static_cast<int64_t>(blocks.size()) / 4, 1, 4});
+  std::copy(blocks.begin(), blocks.end(), values.mutable_data<float>());
+  index.Resize({static_cast<int64_t>(blocks_index.size())});
+  std::copy(
+      blocks_index.begin(), blocks_index.end(), index.mutable_data<int>());
+
+  for (auto* output : {&ref, &out}) {
+    output->Resize({m, n});
+    MulCompute<float> mul;
+    operators::MulParam param;
+    param.x = &x;
+    if (output == &ref) {
+      param.y = &y;
+    } else {
+      param.sparse_y.values = &values;
+      param.sparse_y.index = &index;
+      param.sparse_y.dims = y.dims();
+      param.sparse_y.block_w = 4;
+    }
+    param.output = output;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    mul.SetContext(std::move(ctx));
+    mul.SetParam(param);
+    mul.Run();
+  }
+  for (int i = 0; i < m * n; i++) {
+    EXPECT_NEAR(out.data<float>()[i], ref.data<float>()[i], 1e-5);
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -27,10 +27,13 @@ namespace kernels {
 namespace x86 {
 
 template <typename T>
-void Compute(const lite::Tensor* in, lite::Tensor* out) {
+void Compute(const lite::Tensor* in, lite::Tensor* out, bool inplace) {
   auto out_dims = out->dims();
-  auto in_dims = in->dims();
-  out->CopyDataFrom(*in);
+  if (inplace) {
+    out->ShareDataWith(*in);
+  } else {
+    out->CopyDataFrom(*in);
+  }
   out->Resize(out_dims);
 }
 
@@ -41,7 +44,7 @@ class ReshapeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    Compute<T>(param.x, param.output);
+    Compute<T>(param.x, param.output, param.inplace);
   }
 
   virtual ~ReshapeCompute() = default;
@@ -57,7 +60,7 @@ class Reshape2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    Compute<T>(param.x, param.output);
+    Compute<T>(param.x, param.output, param.inplace);
   }
 
   virtual ~Reshape2Compute() = default;
@@ -128,6 +128,20 @@ class SliceCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
+    if (param.inplace) {
+      // Slicing the outermost axis, the output is a view of the input.
+      auto in_dims = param.X->dims();
+      auto out_dims = param.Out->dims();
+      int64_t start =
+          param.starts[0] < 0 ? param.starts[0] + in_dims[0] : param.starts[0];
+      int64_t end =
+          param.ends[0] < 0 ? param.ends[0] + in_dims[0] : param.ends[0];
+      start = std::max<int64_t>(0, std::min<int64_t>(start, in_dims[0]));
+      end = std::max<int64_t>(start, std::min<int64_t>(end, in_dims[0]));
+      param.Out->ShareDataWith(param.X->template Slice<T>(start, end));
+      param.Out->Resize(out_dims);
+      return;
+    }
     slice_compute_<T>(param.X,
                       param.Out,
                       param.axes,
@@ -257,6 +257,39 @@ TEST(slice_x86, run_test) {
   test_case6(x, out);
 }
 
+TEST(slice_x86, inplace) {
+  lite::Tensor x;
+  lite::Tensor out;
+  x.Resize(lite::DDim(std::vector<int64_t>({4, 3})));
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<float>(i);
+  }
+  // The shape inferred by the op.
+  out.Resize(lite::DDim(std::vector<int64_t>({2, 3})));
+
+  SliceCompute<float> slice;
+  operators::SliceParam param;
+  param.X = &x;
+  param.Out = &out;
+  param.axes = {0};
+  param.starts = {-3};
+  param.ends = {3};
+  param.inplace = true;
+
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  slice.SetContext(std::move(ctx));
+  slice.SetParam(param);
+  slice.Run();
+
+  ASSERT_EQ(out.dims(), lite::DDim(std::vector<int64_t>({2, 3})));
+  EXPECT_EQ(out.data<float>(), x_data + 3);
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    EXPECT_EQ(out.data<float>()[i], static_cast<float>(i + 3));
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
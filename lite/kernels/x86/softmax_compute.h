@@ -13,8 +13,10 @@
 // limitations under the License.
 #pragma once
 
-#include <vector>
-#include "lite/backends/x86/math/softmax.h"
+#include <algorithm>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 namespace paddle {
@@ -52,28 +54,40 @@ class SoftmaxCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<operators::SoftmaxParam>();
-    auto& context = ctx_->As<X86Context>();
     CHECK(param.output);
     CHECK(param.x);
-    param.output->mutable_data<T>();
     const int rank = param.x->dims().size();
     const int axis = CanonicalAxis(param.axis, rank);
-    int axis_dim = param.x->dims()[axis];
+    const int axis_dim = param.x->dims()[axis];
     const int n = SizeToAxis(axis, param.x->dims());
     const int d = SizeFromAxis(axis, param.x->dims());
-    std::vector<int64_t> shape{n, d};
+    const int remain = d / axis_dim;
+    const T* x = param.x->template data<T>();
+    T* out = param.output->template mutable_data<T>();
 
-    lite::Tensor input_2d, out_2d;
-    input_2d.ShareDataWith(*param.x);
-    input_2d.Resize(lite::DDim(shape));
-    out_2d.ShareDataWith(*param.output);
-    out_2d.Resize(lite::DDim(shape));
-
-    lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-        context, axis_dim, &input_2d, &out_2d);
+    // Each of the n rows is normalized on its own, split them into blocks
+    // of about kBlockSize elements to run on several threads.
+    const int block_rows = std::max(1, kBlockSize / std::max(d, 1));
+    const int num_blocks = (n + block_rows - 1) / block_rows;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int b = 0; b < num_blocks; ++b) {
+      const int begin = b * block_rows;
+      const int rows = std::min(block_rows, n - begin);
+      const int64_t offset = static_cast<int64_t>(begin) * d;
+      // The kernel cache is thread local.
+      auto compute =
+          jit::KernelFuncs<jit::SoftmaxTuple<T>, fluid::CPUPlace>::Cache().At(
+              d);
+      compute(x + offset, out + offset, d, rows, remain);
+    }
   }
 
   virtual ~SoftmaxCompute() = default;
+
+ private:
+  static constexpr int kBlockSize = 4096;
 };
 
 }  // namespace x86
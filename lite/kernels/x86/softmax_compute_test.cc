@@ -14,6 +14,8 @@
 
 #include "lite/kernels/x86/softmax_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -76,6 +78,54 @@ TEST(softmax_x86, run_test) {
   }
 }
 
+TEST(softmax_x86, run_blocks) {
+  // Enough rows to be split into several blocks, over the last and a middle
+  // axis.
+  for (int axis : {-1, 1}) {
+    lite::Tensor x, out;
+    std::vector<int64_t> shape{64, 6, 33};
+    x.Resize(lite::DDim(shape));
+    out.Resize(lite::DDim(shape));
+    auto* x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>((i * 5) % 11) * 0.25f;
+    }
+
+    SoftmaxCompute<float> softmax;
+    operators::SoftmaxParam param;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    softmax.SetContext(std::move(ctx));
+    param.x = &x;
+    param.output = &out;
+    param.axis = axis;
+    softmax.SetParam(param);
+    softmax.Run();
+
+    const int axis_dim = shape[axis < 0 ? 2 : axis];
+    const int inner = axis < 0 ? 1 : shape[2];
+    const int outer = x.numel() / (axis_dim * inner);
+    const float* out_data = out.data<float>();
+    for (int o = 0; o < outer; o++) {
+      for (int k = 0; k < inner; k++) {
+        const int base = o * axis_dim * inner + k;
+        float max_v = x_data[base];
+        for (int j = 1; j < axis_dim; j++) {
+          max_v = std::max(max_v, x_data[base + j * inner]);
+        }
+        float sum = 0.f;
+        for (int j = 0; j < axis_dim; j++) {
+          sum += std::exp(x_data[base + j * inner] - max_v);
+        }
+        for (int j = 0; j < axis_dim; j++) {
+          const float ref = std::exp(x_data[base + j * inner] - max_v) / sum;
+          EXPECT_NEAR(out_data[base + j * inner], ref, 1e-5);
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -36,8 +36,14 @@ class SqueezeCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto output = param.Out;
     auto x_dims = x->dims();
     auto* x_data = x->data<T>();
-    auto* out_data = output->mutable_data<T>();
-    memcpy(out_data, x_data, x_dims.production() * sizeof(T));
+    if (param.inplace) {
+      auto out_dims = output->dims();
+      output->ShareDataWith(*x);
+      output->Resize(out_dims);
+    } else {
+      auto* out_data = output->mutable_data<T>();
+      memcpy(out_data, x_data, x_dims.production() * sizeof(T));
+    }
   }
 
   virtual ~SqueezeCompute() = default;
@@ -55,9 +61,15 @@ class Squeeze2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto xshape = param.XShape;
     auto x_dims = x->dims();
     auto* x_data = x->data<T>();
-    auto* out_data = output->mutable_data<T>();
     auto* xshape_data = xshape->mutable_data<T>();
-    memcpy(out_data, x_data, x_dims.production() * sizeof(T));
+    if (param.inplace) {
+      auto out_dims = output->dims();
+      output->ShareDataWith(*x);
+      output->Resize(out_dims);
+    } else {
+      auto* out_data = output->mutable_data<T>();
+      memcpy(out_data, x_data, x_dims.production() * sizeof(T));
+    }
     memcpy(xshape_data, x_data, x_dims.production() * sizeof(T));
   }
 
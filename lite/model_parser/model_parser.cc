@@ -20,11 +20,13 @@
 #include "lite/core/scope.h"
 #include "lite/core/tensor.h"
 #include "lite/core/variable.h"
+#include "lite/core/weight_store.h"
 #include "lite/model_parser/desc_apis.h"
 #include "lite/model_parser/naive_buffer/combined_params_desc.h"
 #include "lite/model_parser/naive_buffer/param_desc.h"
 #include "lite/model_parser/naive_buffer/program_desc.h"
 #include "lite/model_parser/naive_buffer/var_desc.h"
+#include "lite/model_parser/pb_wire_parser.h"
 #ifndef LITE_ON_TINY_PUBLISH
 #include "lite/model_parser/pb/program_desc.h"
 #include "lite/model_parser/pb/var_desc.h"
@@ -123,18 +125,7 @@ void LoadLoDTensor(std::istream &is, Variable *var) {
   }
 
   TensorFromStream(is, tensor);
-}
-
-void ReadBinaryFile(const std::string &filename, std::string *contents) {
-  std::ifstream fin(filename, std::ios::in | std::ios::binary);
-  CHECK(fin.is_open()) << "Cannot open file: " << filename;
-  fin.seekg(0, std::ios::end);
-  auto size = fin.tellg();
-  contents->clear();
-  contents->resize(size);
-  fin.seekg(0, std::ios::beg);
-  fin.read(&(contents->at(0)), contents->size());
-  fin.close();
+  WeightStore::Global().Dedup(tensor);
 }
 
 std::unique_ptr<framework::proto::ProgramDesc> LoadProgram(
@@ -160,111 +151,6 @@ void LoadParam(const std::string &path, Variable *out) {
   LoadLoDTensor(fin, out);
 }
 
-bool IsPersistable(const cpp::VarDesc &var) {
-  if (var.Persistable() && var.GetType() != VarDescAPI::Type::FEED_MINIBATCH &&
-      var.GetType() != VarDescAPI::Type::FETCH_LIST &&
-      var.GetType() != VarDescAPI::Type::RAW) {
-    return true;
-  }
-  return false;
-}
-
-void LoadCombinedParamsPb(const std::string &path,
-                          lite::Scope *scope,
-                          const cpp::ProgramDesc &cpp_prog,
-                          bool params_from_memory) {
-  CHECK(scope);
-  auto prog = cpp_prog;
-  auto &main_block_desc = *prog.GetBlock<cpp::BlockDesc>(0);
-
-  // Get vars
-  std::vector<std::string> paramlist;
-  for (size_t i = 0; i < main_block_desc.VarsSize(); ++i) {
-    auto &var = *main_block_desc.GetVar<cpp::VarDesc>(i);
-    if (!IsPersistable(var)) continue;
-    paramlist.push_back(var.Name());
-  }
-  std::sort(paramlist.begin(), paramlist.end());
-
-  // Load vars
-  auto load_var_func = [&](std::istream &is) {
-    for (size_t i = 0; i < paramlist.size(); ++i) {
-      auto *var = scope->Var(paramlist[i]);
-      // Error checking
-      CHECK(static_cast<bool>(is))
-          << "There is a problem with loading model parameters";
-      LoadLoDTensor(is, var);
-    }
-    is.peek();
-    CHECK(is.eof()) << "You are not allowed to load partial data via"
-                    << " LoadCombinedParamsPb, use LoadParam instead.";
-  };
-
-  if (params_from_memory) {
-    std::stringstream fin(path, std::ios::in | std::ios::binary);
-    load_var_func(fin);
-  } else {
-    std::ifstream fin(path, std::ios::binary);
-    CHECK(fin.is_open());
-    load_var_func(fin);
-  }
-}
-
-void LoadModelPb(const std::string &model_dir,
-                 const std::string &model_file,
-                 const std::string &param_file,
-                 Scope *scope,
-                 cpp::ProgramDesc *cpp_prog,
-                 bool combined,
-                 bool model_from_memory) {
-  CHECK(cpp_prog);
-  CHECK(scope);
-  cpp_prog->ClearBlocks();
-
-  // Load model
-  VLOG(4) << "Start load model program...";
-  std::string prog_path = model_dir + "/__model__";
-  if (combined) {
-    prog_path = model_file;
-  }
-  framework::proto::ProgramDesc pb_proto_prog =
-      *LoadProgram(prog_path, model_from_memory);
-  pb::ProgramDesc pb_prog(&pb_proto_prog);
-  // Transform to cpp::ProgramDesc
-  TransformProgramDescAnyToCpp(pb_prog, cpp_prog);
-
-  // Load Params
-  // NOTE: Only main block be used now.
-  VLOG(4) << "Start load model params...";
-  CHECK(!(!combined && model_from_memory))
-      << "If you want use the model_from_memory,"
-      << " you should load the combined model using cfg.set_model_buffer "
-         "interface.";
-  if (combined) {
-    LoadCombinedParamsPb(param_file, scope, *cpp_prog, model_from_memory);
-  } else {
-    auto main_block = pb_proto_prog.blocks(0);
-    for (auto &var : main_block.vars()) {
-      if (var.name() == "feed" || var.name() == "fetch" || !var.persistable())
-        continue;
-
-      std::string file_path = model_dir + "/" + var.name();
-      VLOG(4) << "reading weight " << var.name();
-
-      std::ifstream file(file_path);
-      switch (var.type().type()) {
-        case framework::proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var(var.name()));
-          break;
-        default:
-          CHECK(false) << "unknown weight type";
-      }
-    }
-  }
-
-  VLOG(4) << "Load protobuf model in '" << model_dir << "'' successfully";
-}
-
 void SaveModelPb(const std::string &model_dir,
                  const Scope &exec_scope,
                  const cpp::ProgramDesc &cpp_prog,
@@ -572,6 +458,141 @@ void SaveModelNaive(const std::string &model_dir,
 }
 #endif
 
+void ReadBinaryFile(const std::string &filename, std::string *contents) {
+  std::ifstream fin(filename, std::ios::in | std::ios::binary);
+  CHECK(fin.is_open()) << "Cannot open file: " << filename;
+  fin.seekg(0, std::ios::end);
+  auto size = fin.tellg();
+  CHECK_GE(size, 0) << "Cannot read file: " << filename;
+  contents->clear();
+  contents->resize(size);
+  if (contents->empty()) return;
+  fin.seekg(0, std::ios::beg);
+  fin.read(&(contents->at(0)), contents->size());
+  CHECK(fin) << "Cannot read file: " << filename;
+  fin.close();
+}
+
+bool IsPersistable(const cpp::VarDesc &var) {
+  if (var.Persistable() && var.GetType() != VarDescAPI::Type::FEED_MINIBATCH &&
+      var.GetType() != VarDescAPI::Type::FETCH_LIST &&
+      var.GetType() != VarDescAPI::Type::RAW) {
+    return true;
+  }
+  return false;
+}
+
+void LoadCombinedParamsPb(const std::string &path,
+                          lite::Scope *scope,
+                          const cpp::ProgramDesc &cpp_prog,
+                          bool params_from_memory) {
+  CHECK(scope);
+  auto prog = cpp_prog;
+  auto &main_block_desc = *prog.GetBlock<cpp::BlockDesc>(0);
+
+  // Get vars
+  std::vector<std::string> paramlist;
+  for (size_t i = 0; i < main_block_desc.VarsSize(); ++i) {
+    auto &var = *main_block_desc.GetVar<cpp::VarDesc>(i);
+    if (!IsPersistable(var)) continue;
+    paramlist.push_back(var.Name());
+  }
+  std::sort(paramlist.begin(), paramlist.end());
+
+  // Load vars, the tensors are parsed one after another from the buffer, or
+  // from the file without reading it as a whole.
+  if (params_from_memory) {
+    const std::string &buffer = path;
+    size_t offset = 0;
+    for (size_t i = 0; i < paramlist.size(); ++i) {
+      auto *tensor = scope->Var(paramlist[i])->GetMutable<lite::Tensor>();
+      // Error checking
+      CHECK_LT(offset, buffer.size())
+          << "There is a problem with loading model parameters";
+      offset += pb_wire::ParseLoDTensor(
+          buffer.data() + offset, buffer.size() - offset, tensor);
+      WeightStore::Global().Dedup(tensor);
+    }
+    CHECK_EQ(offset, buffer.size())
+        << "You are not allowed to load partial data via"
+        << " LoadCombinedParamsPb, use LoadParam instead.";
+    return;
+  }
+  std::ifstream fin(path, std::ios::binary);
+  CHECK(fin.is_open()) << "Cannot open file: " << path;
+  for (size_t i = 0; i < paramlist.size(); ++i) {
+    auto *tensor = scope->Var(paramlist[i])->GetMutable<lite::Tensor>();
+    pb_wire::ParseLoDTensor(&fin, tensor);
+    WeightStore::Global().Dedup(tensor);
+  }
+  fin.peek();
+  CHECK(fin.eof()) << "You are not allowed to load partial data via"
+                   << " LoadCombinedParamsPb, use LoadParam instead.";
+}
+
+void LoadModelPb(const std::string &model_dir,
+                 const std::string &model_file,
+                 const std::string &param_file,
+                 Scope *scope,
+                 cpp::ProgramDesc *cpp_prog,
+                 bool combined,
+                 bool model_from_memory) {
+  CHECK(cpp_prog);
+  CHECK(scope);
+  cpp_prog->ClearBlocks();
+
+  // Load model
+  VLOG(4) << "Start load model program...";
+  std::string prog_path = model_dir + "/__model__";
+  if (combined) {
+    prog_path = model_file;
+  }
+  std::string prog_buffer;
+  if (!model_from_memory) {
+    ReadBinaryFile(prog_path, &prog_buffer);
+  }
+  const std::string &buffer = model_from_memory ? prog_path : prog_buffer;
+  // Decode the ProgramDesc to cpp::ProgramDesc directly.
+  pb_wire::ParseProgramDesc(buffer.data(), buffer.size(), cpp_prog);
+
+  // Load Params
+  // NOTE: Only main block be used now.
+  VLOG(4) << "Start load model params...";
+  CHECK(!(!combined && model_from_memory))
+      << "If you want use the model_from_memory,"
+      << " you should load the combined model using cfg.set_model_buffer "
+         "interface.";
+  if (combined) {
+    LoadCombinedParamsPb(param_file, scope, *cpp_prog, model_from_memory);
+  } else {
+    auto &main_block = *cpp_prog->GetBlock<cpp::BlockDesc>(0);
+    std::string param_buffer;
+    for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+      auto &var = *main_block.GetVar<cpp::VarDesc>(i);
+      if (var.Name() == "feed" || var.Name() == "fetch" || !var.Persistable())
+        continue;
+
+      std::string file_path = model_dir + "/" + var.Name();
+      VLOG(4) << "reading weight " << var.Name();
+
+      switch (var.GetType()) {
+        case VarDescAPI::Type::LOD_TENSOR: {
+          auto *tensor = scope->Var(var.Name())->GetMutable<lite::Tensor>();
+          ReadBinaryFile(file_path, &param_buffer);
+          pb_wire::ParseLoDTensor(
+              param_buffer.data(), param_buffer.size(), tensor);
+          WeightStore::Global().Dedup(tensor);
+          break;
+        }
+        default:
+          CHECK(false) << "unknown weight type";
+      }
+    }
+  }
+
+  VLOG(4) << "Load protobuf model in '" << model_dir << "'' successfully";
+}
+
 template <typename T>
 void SetTensorDataNaive(T *out, size_t size, const std::vector<T> &src) {
   CHECK(out);
@@ -582,14 +603,14 @@ void SetTensorDataNaive(T *out, size_t size, const std::vector<T> &src) {
 }
 
 void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
-                       lite::Scope *scope,
+                       Variable *var,
                        const std::string &name) {
-  CHECK(scope);
+  CHECK(var);
   CHECK_EQ(desc.Name(), name)
       << "Var name not equal: ParamDesc.name=" << desc.Name()
       << "vs filename=" << name;
 
-  auto *tensor = scope->Var(name)->GetMutable<lite::Tensor>();
+  auto *tensor = var->GetMutable<lite::Tensor>();
 
   VLOG(3) << "model version " << desc.ModelVersion();
   CHECK_EQ(desc.TensorVersion(), 0U) << "Only version 0 is supported";
@@ -622,10 +643,18 @@ void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
       LOG(FATAL) << "unknown type";
   }
   tensor->set_persistable(true);
+  WeightStore::Global().Dedup(tensor);
+}
+
+void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
+                       lite::Scope *scope,
+                       const std::string &name) {
+  CHECK(scope);
+  GetParamInfoNaive(desc, scope->Var(name), name);
 }
 
 void LoadParamNaive(const std::string &path,
-                    lite::Scope *scope,
+                    Variable *var,
                     const std::string &name) {
   // Load param
   naive_buffer::BinaryTable table;
@@ -633,7 +662,14 @@ void LoadParamNaive(const std::string &path,
   naive_buffer::proto::ParamDesc pt_desc(&table);
   pt_desc.Load();
   naive_buffer::ParamDesc desc(&pt_desc);
-  GetParamInfoNaive(desc, scope, name);
+  GetParamInfoNaive(desc, var, name);
+}
+
+void LoadParamNaive(const std::string &path,
+                    lite::Scope *scope,
+                    const std::string &name) {
+  CHECK(scope);
+  LoadParamNaive(path, scope->Var(name), name);
 }
 
 void LoadCombinedParamsNaive(const std::string &path,
@@ -669,24 +705,46 @@ void LoadCombinedParamsNaive(const std::string &path,
   }
 }
 
-void LoadModelNaive(const std::string &model_dir,
-                    Scope *scope,
-                    cpp::ProgramDesc *cpp_prog,
-                    bool combined) {
+void LoadCombinedParamsNaive(const std::string &path,
+                             const ParamVarGetter &get_var,
+                             const ParamLoadedCallback &on_loaded) {
+  naive_buffer::BinaryTable table;
+  table.LoadFromFile(path);
+  naive_buffer::proto::CombinedParamsDesc pt_desc(&table);
+  pt_desc.Load();
+  naive_buffer::CombinedParamsDesc desc(&pt_desc);
+
+  for (size_t i = 0; i < desc.ParamsSize(); ++i) {
+    naive_buffer::ParamDesc param_desc(desc.GetParam(i));
+    const std::string name = param_desc.Name();
+    GetParamInfoNaive(param_desc, get_var(name), name);
+    if (on_loaded) on_loaded(name);
+  }
+}
+
+void LoadProgramNaive(const std::string &path, cpp::ProgramDesc *cpp_prog) {
   CHECK(cpp_prog);
-  CHECK(scope);
   cpp_prog->ClearBlocks();
 
-  // Load model
-  const std::string prog_path = model_dir + "/__model__.nb";
   naive_buffer::BinaryTable table;
-  table.LoadFromFile(prog_path);
+  table.LoadFromFile(path);
   naive_buffer::proto::ProgramDesc nb_proto_prog(&table);
   nb_proto_prog.Load();
   naive_buffer::ProgramDesc nb_prog(&nb_proto_prog);
 
   // Transform to cpp::ProgramDesc
   TransformProgramDescAnyToCpp(nb_prog, cpp_prog);
+}
+
+void LoadModelNaive(const std::string &model_dir,
+                    Scope *scope,
+                    cpp::ProgramDesc *cpp_prog,
+                    bool combined) {
+  CHECK(cpp_prog);
+  CHECK(scope);
+
+  // Load model
+  LoadProgramNaive(model_dir + "/__model__.nb", cpp_prog);
 
   // Load Params
   // NOTE: Only main block be used now.
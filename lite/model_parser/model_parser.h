@@ -16,6 +16,7 @@
 // parse an operator definitions and so on.
 
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,6 +31,11 @@
 namespace paddle {
 namespace lite {
 
+// Get the variable that the param named `name` should be loaded into.
+using ParamVarGetter = std::function<Variable*(const std::string& name)>;
+// Invoked once the param named `name` has been fully loaded.
+using ParamLoadedCallback = std::function<void(const std::string& name)>;
+
 #ifndef LITE_ON_TINY_PUBLISH
 // Read a __model__ file.
 std::unique_ptr<framework::proto::ProgramDesc> LoadProgram(
@@ -41,19 +47,8 @@ void LoadParams(const std::string& path);
 // Load a single parameter to an output tensor.
 void LoadParam(const std::string& path, Variable* out);
 
-void LoadCombinedParamsPb(const std::string& path,
-                          lite::Scope* scope,
-                          const cpp::ProgramDesc& prog,
-                          bool params_from_memory = false);
-
-// Read a model and files of parameters in pb format.
-void LoadModelPb(const std::string& model_dir,
-                 const std::string& model_file,
-                 const std::string& param_file,
-                 Scope* scope,
-                 cpp::ProgramDesc* prog,
-                 bool combined = false,
-                 bool model_from_memory = false);
+// Load a LoDTensor from a stream in the fluid format.
+void LoadLoDTensor(std::istream& is, Variable* var);
 
 // Save a model and files of parameters in pb format.
 void SaveModelPb(const std::string& model_dir,
@@ -73,7 +68,6 @@ void SerializeTensor(std::ostream& os,
 // LoDTensor to ostream
 void TensorToStream(std::ostream& os, const lite::Tensor& tensor);
 void TensorFromStream(std::istream& is, lite::Tensor* tensor);
-void ReadBinaryFile(const std::string& filename, std::string* contents);
 
 // For naive buffer
 void SaveParamNaive(const std::string& path,
@@ -90,10 +84,42 @@ void SaveModelNaive(const std::string& model_dir,
                     bool combined = true);
 #endif
 
+bool IsPersistable(const cpp::VarDesc& var);
+
+void ReadBinaryFile(const std::string& filename, std::string* contents);
+
+// The models in pb format are decoded without protobuf, see pb_wire_parser.h.
+void LoadCombinedParamsPb(const std::string& path,
+                          lite::Scope* scope,
+                          const cpp::ProgramDesc& prog,
+                          bool params_from_memory = false);
+
+// Read a model and files of parameters in pb format.
+void LoadModelPb(const std::string& model_dir,
+                 const std::string& model_file,
+                 const std::string& param_file,
+                 Scope* scope,
+                 cpp::ProgramDesc* prog,
+                 bool combined = false,
+                 bool model_from_memory = false);
+
 void LoadParamNaive(const std::string& path,
                     lite::Scope* scope,
                     const std::string& name);
 
+void LoadParamNaive(const std::string& path,
+                    Variable* var,
+                    const std::string& name);
+
+// Load the program of a naive buffer model, without the params.
+void LoadProgramNaive(const std::string& path, cpp::ProgramDesc* cpp_prog);
+
+// Load combined naive buffer params one by one, `on_loaded` is invoked after
+// each param is read.
+void LoadCombinedParamsNaive(const std::string& path,
+                             const ParamVarGetter& get_var,
+                             const ParamLoadedCallback& on_loaded);
+
 void LoadModelNaive(const std::string& model_dir,
                     lite::Scope* scope,
                     cpp::ProgramDesc* prog,
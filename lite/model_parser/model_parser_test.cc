@@ -15,7 +15,9 @@
 #include "lite/model_parser/model_parser.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <cstring>
 #include "lite/core/scope.h"
+#include "lite/model_parser/param_stream_loader.h"
 
 DEFINE_string(model_dir, "", "");
 
@@ -43,6 +45,32 @@ TEST(ModelParser, LoadModelPb) {
   LoadModelPb(FLAGS_model_dir, "", "", &scope, &prog);
 }
 
+TEST(ModelParser, ParamStreamLoaderPb) {
+  CHECK(!FLAGS_model_dir.empty());
+  cpp::ProgramDesc prog;
+  Scope scope;
+  LoadModelPb(FLAGS_model_dir, "", "", &scope, &prog);
+
+  cpp::ProgramDesc stream_prog;
+  Scope stream_scope;
+  ParamStreamLoader loader;
+  loader.LoadModelPb(FLAGS_model_dir, "", "", &stream_scope, &stream_prog);
+  auto params = ParamsInProgramOrder(stream_prog);
+  ASSERT_FALSE(params.empty());
+  for (auto& name : params) {
+    loader.WaitFor(name);
+    const auto& expect = scope.FindVar(name)->Get<lite::Tensor>();
+    const auto& actual = stream_scope.FindVar(name)->Get<lite::Tensor>();
+    ASSERT_EQ(expect.dims(), actual.dims());
+    ASSERT_EQ(expect.memory_size(), actual.memory_size());
+    EXPECT_EQ(0,
+              memcmp(expect.data<void>(),
+                     actual.data<void>(),
+                     expect.memory_size()));
+  }
+  loader.WaitAll();
+}
+
 TEST(ModelParser, SaveModelPb) {
   CHECK(!FLAGS_model_dir.empty());
   cpp::ProgramDesc prog;
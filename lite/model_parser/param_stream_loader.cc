@@ -0,0 +1,208 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/param_stream_loader.h"
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include "lite/core/weight_store.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+#include "lite/model_parser/model_parser.h"
+#include "lite/model_parser/pb_wire_parser.h"
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/cpu_info.h"
+#endif
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+bool IsStreamedParam(const cpp::VarDesc& var) {
+  return var.Persistable() && var.Name() != "feed" && var.Name() != "fetch";
+}
+
+}  // namespace
+
+std::vector<std::string> ParamsInProgramOrder(const cpp::ProgramDesc& prog) {
+  auto program = prog;
+  CHECK(program.BlocksSize());
+  auto& main_block = *program.GetBlock<cpp::BlockDesc>(0);
+
+  std::set<std::string> persistables;
+  for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+    auto& var = *main_block.GetVar<cpp::VarDesc>(i);
+    if (IsStreamedParam(var)) persistables.insert(var.Name());
+  }
+
+  std::vector<std::string> params;
+  std::set<std::string> visited;
+  for (size_t i = 0; i < main_block.OpsSize(); ++i) {
+    auto& op_desc = *main_block.GetOp<cpp::OpDesc>(i);
+    for (auto& name : op_desc.input_vars()) {
+      if (persistables.count(name) && !visited.count(name)) {
+        visited.insert(name);
+        params.push_back(name);
+      }
+    }
+  }
+  for (auto& name : persistables) {
+    if (!visited.count(name)) params.push_back(name);
+  }
+  return params;
+}
+
+void ParamStreamLoader::LoadModelPb(const std::string& model_dir,
+                                    const std::string& model_file,
+                                    const std::string& param_file,
+                                    Scope* scope,
+                                    cpp::ProgramDesc* cpp_prog,
+                                    bool combined) {
+  CHECK(cpp_prog);
+  CHECK(scope);
+  const std::string prog_path =
+      combined ? model_file : model_dir + "/__model__";
+  std::string prog_buffer;
+  ReadBinaryFile(prog_path, &prog_buffer);
+  pb_wire::ParseProgramDesc(prog_buffer.data(), prog_buffer.size(), cpp_prog);
+
+  if (combined) {
+    // The combined params file stores the params sorted by name, they can
+    // only be streamed in that order.
+    auto& main_block = *cpp_prog->GetBlock<cpp::BlockDesc>(0);
+    std::vector<std::string> params;
+    for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+      auto& var = *main_block.GetVar<cpp::VarDesc>(i);
+      if (IsPersistable(var)) params.push_back(var.Name());
+    }
+    std::sort(params.begin(), params.end());
+    Launch(scope, params, [=] {
+      // The file is parsed tensor by tensor, not read as a whole.
+      std::ifstream fin(param_file, std::ios::binary);
+      CHECK(fin.is_open()) << "Cannot open file: " << param_file;
+      for (auto& name : params) {
+        auto* tensor = param_var(name)->GetMutable<lite::Tensor>();
+        pb_wire::ParseLoDTensor(&fin, tensor);
+        WeightStore::Global().Dedup(tensor);
+        Publish(name);
+      }
+    });
+  } else {
+    auto params = ParamsInProgramOrder(*cpp_prog);
+    Launch(scope, params, [=] {
+      std::string buffer;
+      for (auto& name : params) {
+        VLOG(4) << "streaming weight " << name;
+        ReadBinaryFile(model_dir + "/" + name, &buffer);
+        auto* tensor = param_var(name)->GetMutable<lite::Tensor>();
+        pb_wire::ParseLoDTensor(buffer.data(), buffer.size(), tensor);
+        WeightStore::Global().Dedup(tensor);
+        Publish(name);
+      }
+    });
+  }
+}
+
+void ParamStreamLoader::LoadModelNaive(const std::string& model_dir,
+                                       Scope* scope,
+                                       cpp::ProgramDesc* cpp_prog,
+                                       bool combined) {
+  CHECK(cpp_prog);
+  CHECK(scope);
+  LoadProgramNaive(model_dir + "/__model__.nb", cpp_prog);
+
+  auto params = ParamsInProgramOrder(*cpp_prog);
+  if (combined) {
+    const std::string combined_params_path = model_dir + "/param.nb";
+    Launch(scope, params, [=] {
+      LoadCombinedParamsNaive(
+          combined_params_path,
+          [&](const std::string& name) { return param_var(name); },
+          [&](const std::string& name) { Publish(name); });
+    });
+  } else {
+    Launch(scope, params, [=] {
+      for (auto& name : params) {
+        VLOG(4) << "streaming weight " << name;
+        LoadParamNaive(model_dir + "/" + name + ".nb", param_var(name), name);
+        Publish(name);
+      }
+    });
+  }
+}
+
+void ParamStreamLoader::Launch(Scope* scope,
+                               const std::vector<std::string>& params,
+                               std::function<void()>&& job) {
+  WaitAll();
+  param_vars_.clear();
+  loaded_.clear();
+  for (auto& name : params) {
+    auto* var = scope->Var(name);
+    var->GetMutable<lite::Tensor>();
+    param_vars_[name] = var;
+  }
+  finished_ = false;
+
+  // The weights are loaded for the NUMA node of the caller. The node of the
+  // WeightStore is thread_local and lost by the new thread, so it is passed
+  // on. The CPU affinity is inherited on Linux, rebinding the thread is only
+  // defensive, and records its node for `x86::BoundNumaNode`.
+  const int weight_node = WeightStore::NumaNodeGuard::current();
+#ifdef LITE_WITH_X86
+  const int bound_node = x86::BoundNumaNode();
+#endif
+  auto task = std::move(job);
+  worker_ = std::thread([=] {
+#ifdef LITE_WITH_X86
+    if (bound_node >= 0 && !x86::BindToNumaNode(bound_node)) {
+      LOG(WARNING) << "Failed to bind the loader to the NUMA node "
+                   << bound_node;
+    }
+#endif
+    {
+      WeightStore::NumaNodeGuard numa_guard(weight_node);
+      task();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    cond_.notify_all();
+  });
+}
+
+void ParamStreamLoader::Publish(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  loaded_.insert(name);
+  cond_.notify_all();
+}
+
+void ParamStreamLoader::WaitFor(const std::string& name) {
+  if (!param_vars_.count(name)) return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [&] { return finished_ || loaded_.count(name); });
+  CHECK(loaded_.count(name)) << "Persistable var[" << name << "] not found";
+}
+
+void ParamStreamLoader::WaitAll() {
+  if (worker_.joinable()) worker_.join();
+  for (auto& item : param_vars_) {
+    CHECK(loaded_.count(item.first)) << "Persistable var[" << item.first
+                                     << "] not found";
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,101 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/core/scope.h"
+#include "lite/model_parser/cpp/program_desc.h"
+
+namespace paddle {
+namespace lite {
+
+// Get the persistable vars of the main block, ordered by the first op that
+// consumes each of them. Params that no op reads are appended at the end.
+std::vector<std::string> ParamsInProgramOrder(const cpp::ProgramDesc& prog);
+
+/*
+ * ParamStreamLoader reads the program of a model synchronously and then
+ * streams the parameters into the scope on a background thread, so that the
+ * ops and kernels can be created while the remaining weights are still being
+ * read from the storage. A consumer calls `WaitFor` with the names it needs
+ * before touching them.
+ *
+ * All the param variables are created in the scope before the background
+ * thread starts, the thread itself never modifies the scope.
+ *
+ * Usage:
+ *
+ *   ParamStreamLoader loader;
+ *   loader.LoadModelNaive(model_dir, scope, &prog);
+ *   for (auto& op : ops) {
+ *     for (auto& name : op.input_vars()) loader.WaitFor(name);
+ *     // attach op ...
+ *   }
+ *   loader.WaitAll();
+ */
+class ParamStreamLoader {
+ public:
+  ParamStreamLoader() = default;
+  ~ParamStreamLoader() { WaitAll(); }
+
+  void LoadModelPb(const std::string& model_dir,
+                   const std::string& model_file,
+                   const std::string& param_file,
+                   Scope* scope,
+                   cpp::ProgramDesc* prog,
+                   bool combined = false);
+
+  void LoadModelNaive(const std::string& model_dir,
+                      Scope* scope,
+                      cpp::ProgramDesc* prog,
+                      bool combined = true);
+
+  // Block until the param `name` is ready. It returns immediately for the
+  // vars that are not streamed by this loader.
+  void WaitFor(const std::string& name);
+
+  // Block until all the params are ready.
+  void WaitAll();
+
+ private:
+  // Create the param vars in `scope` and run `job` on the background thread.
+  void Launch(Scope* scope,
+              const std::vector<std::string>& params,
+              std::function<void()>&& job);
+  void Publish(const std::string& name);
+
+  Variable* param_var(const std::string& name) const {
+    auto it = param_vars_.find(name);
+    CHECK(it != param_vars_.end()) << "unknown param " << name;
+    return it->second;
+  }
+
+ private:
+  std::map<std::string, Variable*> param_vars_;
+  std::set<std::string> loaded_;
+  bool finished_{true};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread worker_;
+};
+
+}  // namespace lite
+}  // namespace paddle
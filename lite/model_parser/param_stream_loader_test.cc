@@ -0,0 +1,82 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/param_stream_loader.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "lite/core/framework.pb.h"
+#include "lite/core/weight_store.h"
+#include "lite/model_parser/model_parser.h"
+
+namespace paddle {
+namespace lite {
+
+// A combined model of the params "w0" and "w1".
+void SaveCombinedModel(const std::string& model_file,
+                       const std::string& param_file) {
+  framework::proto::ProgramDesc prog;
+  prog.mutable_version()->set_version(1005000);
+  auto* block = prog.add_blocks();
+  block->set_idx(0);
+  block->set_parent_idx(-1);
+  std::ofstream params(param_file, std::ios::binary);
+  for (int k = 0; k < 2; ++k) {
+    auto* var = block->add_vars();
+    var->set_name("w" + std::to_string(k));
+    var->set_persistable(true);
+    var->mutable_type()->set_type(framework::proto::VarType::LOD_TENSOR);
+
+    lite::Tensor tensor;
+    tensor.Resize({3, 7});
+    tensor.set_precision(PRECISION(kFloat));
+    auto* data = tensor.mutable_data<float>();
+    for (int i = 0; i < tensor.numel(); ++i) {
+      data[i] = 0.5f * i - 13.f * k + 1001.f;
+    }
+    TensorToStream(params, tensor);
+  }
+  std::ofstream(model_file, std::ios::binary) << prog.SerializeAsString();
+}
+
+TEST(ParamStreamLoader, dedup_per_numa_node) {
+  const std::string model_file = "param_stream_loader_test_model";
+  const std::string param_file = "param_stream_loader_test_params";
+  SaveCombinedModel(model_file, param_file);
+
+  // The weights are streamed by the loader thread, for the node of the
+  // caller.
+  Scope scopes[3];
+  const int nodes[3] = {0, 1, 0};
+  for (int i = 0; i < 3; ++i) {
+    WeightStore::NumaNodeGuard guard(nodes[i]);
+    cpp::ProgramDesc prog;
+    ParamStreamLoader loader;
+    loader.LoadModelPb("", model_file, param_file, &scopes[i], &prog, true);
+    loader.WaitAll();
+  }
+  for (auto* name : {"w0", "w1"}) {
+    auto buffer = [&](int i) {
+      return scopes[i].FindVar(name)->Get<lite::Tensor>().buffer();
+    };
+    EXPECT_EQ(buffer(0), buffer(2));
+    EXPECT_NE(buffer(0), buffer(1));
+  }
+  std::remove(model_file.c_str());
+  std::remove(param_file.c_str());
+}
+
+}  // namespace lite
+}  // namespace paddle
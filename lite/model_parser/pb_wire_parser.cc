@@ -0,0 +1,479 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/pb_wire_parser.h"
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace pb_wire {
+
+namespace {
+
+// The field numbers and enum values follow lite/core/framework.proto.
+enum ProgramDescField { kProgramBlocks = 1, kProgramVersion = 4 };
+enum BlockDescField {
+  kBlockIdx = 1,
+  kBlockParentIdx = 2,
+  kBlockVars = 3,
+  kBlockOps = 4,
+  kBlockForwardBlockIdx = 5,
+};
+enum VarDescField { kVarName = 1, kVarType = 2, kVarPersistable = 3 };
+enum OpDescField {
+  kOpInputs = 1,
+  kOpOutputs = 2,
+  kOpType = 3,
+  kOpAttrs = 4,
+};
+enum OpVarField { kOpVarParameter = 1, kOpVarArguments = 2 };
+enum AttrField {
+  kAttrName = 1,
+  kAttrType = 2,
+  kAttrI = 3,
+  kAttrF = 4,
+  kAttrS = 5,
+  kAttrInts = 6,
+  kAttrFloats = 7,
+  kAttrStrings = 8,
+  kAttrB = 10,
+  kAttrBools = 11,
+  kAttrBlockIdx = 12,
+  kAttrL = 13,
+  kAttrBlocksIdx = 14,
+  kAttrLongs = 15,
+};
+enum TensorDescField { kTensorDataType = 1, kTensorDims = 2 };
+
+// Read a repeated scalar field, which may be packed or not.
+template <typename T, typename ReadFn>
+void ReadRepeated(WireReader* reader,
+                  uint32_t wire_type,
+                  std::vector<T>* out,
+                  ReadFn read) {
+  if (wire_type == WireReader::kLengthDelimited) {
+    WireReader packed = reader->ReadLengthDelimited();
+    while (!packed.Done()) out->push_back(static_cast<T>(read(&packed)));
+  } else {
+    out->push_back(static_cast<T>(read(reader)));
+  }
+}
+
+uint64_t ReadVarint(WireReader* r) { return r->ReadVarint(); }
+float ReadFloat(WireReader* r) { return r->ReadFloat(); }
+
+VarDescAPI::Type ParseVarType(WireReader reader) {
+  int type = -1;
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    if (field == 1 && wire_type == WireReader::kVarint) {
+      type = static_cast<int>(reader.ReadVarint());
+    } else {
+      reader.Skip(wire_type);
+    }
+  }
+  // Same as pb::VarDesc::GetType, values of framework::proto::VarType::Type.
+  switch (type) {
+    case 7:
+      return VarDescAPI::Type::LOD_TENSOR;
+    case 13:
+      return VarDescAPI::Type::LOD_TENSOR_ARRAY;
+    case 12:
+      return VarDescAPI::Type::LOD_RANK_TABLE;
+    case 8:
+      return VarDescAPI::Type::SELECTED_ROWS;
+    case 9:
+      return VarDescAPI::Type::FEED_MINIBATCH;
+    case 10:
+      return VarDescAPI::Type::FETCH_LIST;
+    case 11:
+      return VarDescAPI::Type::STEP_SCOPES;
+    case 14:
+      return VarDescAPI::Type::PLACE_LIST;
+    case 15:
+      return VarDescAPI::Type::READER;
+    default:
+      LOG(FATAL) << "Unknown var type";
+      return VarDescAPI::Type();
+  }
+}
+
+void ParseVarDesc(WireReader reader, cpp::VarDesc* var) {
+  var->SetPersistable(false);
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kVarName:
+        var->SetName(reader.ReadString());
+        break;
+      case kVarType:
+        var->SetType(ParseVarType(reader.ReadLengthDelimited()));
+        break;
+      case kVarPersistable:
+        var->SetPersistable(reader.ReadVarint() != 0);
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+}
+
+void ParseOpVar(WireReader reader,
+                std::string* parameter,
+                std::vector<std::string>* arguments) {
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kOpVarParameter:
+        *parameter = reader.ReadString();
+        break;
+      case kOpVarArguments:
+        arguments->push_back(reader.ReadString());
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+}
+
+void ParseAttr(WireReader reader, cpp::OpDesc* op) {
+  using AttrType = OpDescAPI::AttrType;
+  std::string name;
+  int type = -1;
+  int32_t i = 0;
+  float f = 0.f;
+  std::string s;
+  bool b = false;
+  int32_t block_idx = 0;
+  int64_t l = 0;
+  std::vector<int> ints;
+  std::vector<float> floats;
+  std::vector<std::string> strings;
+  std::vector<int64_t> longs;
+
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kAttrName:
+        name = reader.ReadString();
+        break;
+      case kAttrType:
+        type = static_cast<int>(reader.ReadVarint());
+        break;
+      case kAttrI:
+        i = static_cast<int32_t>(reader.ReadVarint());
+        break;
+      case kAttrF:
+        f = reader.ReadFloat();
+        break;
+      case kAttrS:
+        s = reader.ReadString();
+        break;
+      case kAttrInts:
+        ReadRepeated(&reader, wire_type, &ints, ReadVarint);
+        break;
+      case kAttrFloats:
+        ReadRepeated(&reader, wire_type, &floats, ReadFloat);
+        break;
+      case kAttrStrings:
+        strings.push_back(reader.ReadString());
+        break;
+      case kAttrB:
+        b = reader.ReadVarint() != 0;
+        break;
+      case kAttrBlockIdx:
+        block_idx = static_cast<int32_t>(reader.ReadVarint());
+        break;
+      case kAttrL:
+        l = static_cast<int64_t>(reader.ReadVarint());
+        break;
+      case kAttrLongs:
+        ReadRepeated(&reader, wire_type, &longs, ReadVarint);
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+
+  switch (static_cast<AttrType>(type)) {
+    case AttrType::INT:
+      op->SetAttr<int32_t>(name, i);
+      break;
+    case AttrType::FLOAT:
+      op->SetAttr<float>(name, f);
+      break;
+    case AttrType::STRING:
+      op->SetAttr<std::string>(name, s);
+      break;
+    case AttrType::LONG:
+      op->SetAttr<int64_t>(name, l);
+      break;
+    case AttrType::INTS:
+      op->SetAttr<std::vector<int>>(name, ints);
+      break;
+    case AttrType::FLOATS:
+      op->SetAttr<std::vector<float>>(name, floats);
+      break;
+    case AttrType::BOOLEAN:
+      op->SetAttr<bool>(name, b);
+      break;
+    case AttrType::STRINGS:
+      op->SetAttr<std::vector<std::string>>(name, strings);
+      break;
+    case AttrType::LONGS:
+      op->SetAttr<std::vector<int64_t>>(name, longs);
+      break;
+    case AttrType::BLOCK:
+      // Keep the same as TransformOpDescAnyToCpp, the block index is stored
+      // as an INT attribute.
+      op->SetAttr<int32_t>(name, block_idx);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported attr type found " << type;
+  }
+}
+
+void ParseOpDesc(WireReader reader, cpp::OpDesc* op) {
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kOpType:
+        op->SetType(reader.ReadString());
+        break;
+      case kOpInputs:
+      case kOpOutputs: {
+        std::string parameter;
+        std::vector<std::string> arguments;
+        ParseOpVar(reader.ReadLengthDelimited(), &parameter, &arguments);
+        if (field == kOpInputs) {
+          op->SetInput(parameter, arguments);
+        } else {
+          op->SetOutput(parameter, arguments);
+        }
+        break;
+      }
+      case kOpAttrs:
+        ParseAttr(reader.ReadLengthDelimited(), op);
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+}
+
+void ParseBlockDesc(WireReader reader, cpp::BlockDesc* block) {
+  block->SetIdx(0);
+  block->SetParentIdx(0);
+  block->SetForwardBlockIdx(-1);
+  block->ClearOps();
+  block->ClearVars();
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kBlockIdx:
+        block->SetIdx(static_cast<int32_t>(reader.ReadVarint()));
+        break;
+      case kBlockParentIdx:
+        block->SetParentIdx(static_cast<int32_t>(reader.ReadVarint()));
+        break;
+      case kBlockForwardBlockIdx:
+        block->SetForwardBlockIdx(static_cast<int32_t>(reader.ReadVarint()));
+        break;
+      case kBlockVars:
+        ParseVarDesc(reader.ReadLengthDelimited(),
+                     block->AddVar<cpp::VarDesc>());
+        break;
+      case kBlockOps:
+        ParseOpDesc(reader.ReadLengthDelimited(), block->AddOp<cpp::OpDesc>());
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+}
+
+int64_t ParseVersion(WireReader reader) {
+  int64_t version = 0;
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    if (field == 1 && wire_type == WireReader::kVarint) {
+      version = static_cast<int64_t>(reader.ReadVarint());
+    } else {
+      reader.Skip(wire_type);
+    }
+  }
+  return version;
+}
+
+}  // namespace
+
+void ParseProgramDesc(const char* data, size_t size, cpp::ProgramDesc* prog) {
+  CHECK(prog);
+  prog->ClearBlocks();
+  WireReader reader(data, size);
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kProgramBlocks:
+        ParseBlockDesc(reader.ReadLengthDelimited(),
+                       prog->AddBlock<cpp::BlockDesc>());
+        break;
+      case kProgramVersion:
+        prog->SetVersion(ParseVersion(reader.ReadLengthDelimited()));
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+}
+
+namespace {
+
+// The bytes of a serialized LoDTensor from a memory buffer.
+class BufferSource {
+ public:
+  BufferSource(const char* data, size_t size) : cur_(data), end_(data + size) {}
+
+  void Read(void* dst, size_t size) {
+    CHECK_LE(size, static_cast<size_t>(end_ - cur_))
+        << "There is a problem with loading model parameters";
+    memcpy(dst, cur_, size);
+    cur_ += size;
+  }
+
+  const char* cur() const { return cur_; }
+
+ private:
+  const char* cur_;
+  const char* end_;
+};
+
+// The bytes of a serialized LoDTensor from a stream, e.g. a params file.
+class StreamSource {
+ public:
+  explicit StreamSource(std::istream* is) : is_(is) {}
+
+  void Read(void* dst, size_t size) {
+    is_->read(static_cast<char*>(dst), size);
+    CHECK(*is_) << "There is a problem with loading model parameters";
+  }
+
+ private:
+  std::istream* is_;
+};
+
+template <typename Source>
+void ParseLoDTensorFrom(Source* src, lite::Tensor* tensor) {
+  CHECK(tensor);
+  uint32_t version;
+  src->Read(&version, sizeof(version));
+  VLOG(3) << "model version " << version;
+
+  // Load LoD information
+  uint64_t lod_level;
+  src->Read(&lod_level, sizeof(lod_level));
+  auto& lod = *tensor->mutable_lod();
+  lod.resize(lod_level);
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t level_size;
+    src->Read(&level_size, sizeof(level_size));
+    lod[i].resize(level_size / sizeof(uint64_t));
+    src->Read(lod[i].data(), level_size);
+  }
+
+  src->Read(&version, sizeof(version));
+  CHECK_EQ(version, 0U) << "Only version 0 is supported";
+
+  // Load the TensorDesc message
+  int32_t desc_size;
+  src->Read(&desc_size, sizeof(desc_size));
+  CHECK_GE(desc_size, 0) << "Cannot parse tensor desc";
+  std::string desc(desc_size, '\0');
+  src->Read(&desc[0], desc.size());
+  WireReader reader(desc.data(), desc.size());
+  int data_type = -1;
+  std::vector<int64_t> dims;
+  while (!reader.Done()) {
+    uint32_t field, wire_type;
+    reader.ReadTag(&field, &wire_type);
+    switch (field) {
+      case kTensorDataType:
+        data_type = static_cast<int>(reader.ReadVarint());
+        break;
+      case kTensorDims:
+        ReadRepeated(&reader, wire_type, &dims, ReadVarint);
+        break;
+      default:
+        reader.Skip(wire_type);
+    }
+  }
+
+  tensor->Resize(lite::DDim(dims));
+  void* buf = nullptr;
+  size_t elem_size = 0;
+  // Values of framework::proto::VarType::Type, the same as TensorFromStream.
+  switch (data_type) {
+#define SET_TENSOR(desc, type, precision) \
+  case desc:                              \
+    buf = tensor->mutable_data<type>();   \
+    elem_size = sizeof(type);             \
+    tensor->set_precision(precision);     \
+    break
+
+    SET_TENSOR(5, float, PRECISION(kFloat));
+    SET_TENSOR(21, int8_t, PRECISION(kInt8));
+    SET_TENSOR(1, int16_t, PRECISION(kInt16));
+    SET_TENSOR(2, int32_t, PRECISION(kInt32));
+    SET_TENSOR(3, int64_t, PRECISION(kInt64));
+#undef SET_TENSOR
+    default:
+      LOG(FATAL) << "unknown type " << data_type;
+  }
+  tensor->set_persistable(true);
+
+  // The data goes straight into the tensor.
+  src->Read(buf, tensor->dims().production() * elem_size);
+}
+
+}  // namespace
+
+size_t ParseLoDTensor(const char* data, size_t size, lite::Tensor* tensor) {
+  BufferSource src(data, size);
+  ParseLoDTensorFrom(&src, tensor);
+  return src.cur() - data;
+}
+
+void ParseLoDTensor(std::istream* is, lite::Tensor* tensor) {
+  CHECK(is);
+  StreamSource src(is);
+  ParseLoDTensorFrom(&src, tensor);
+}
+
+}  // namespace pb_wire
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,153 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/*
+ * This file implements a protobuf-free reader for the Fluid model format. The
+ * `__model__` file is a serialized framework.proto ProgramDesc, and it is
+ * decoded from the wire format straight into cpp::ProgramDesc, without the
+ * generated protobuf classes and the pb::XXDesc wrappers. It works in the
+ * tiny publish library, where protobuf is not available.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include "lite/core/tensor.h"
+#include "lite/model_parser/cpp/program_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace pb_wire {
+
+/*
+ * WireReader decodes the protobuf wire format from a memory buffer. It holds
+ * no copy of the data, a sub-message is read by another WireReader on a
+ * sub-range of the same buffer.
+ */
+class WireReader {
+ public:
+  // The wire types of protobuf, groups are not used by framework.proto.
+  enum WireType {
+    kVarint = 0,
+    kFixed64 = 1,
+    kLengthDelimited = 2,
+    kFixed32 = 5,
+  };
+
+  WireReader(const char* data, size_t size)
+      : cur_(reinterpret_cast<const uint8_t*>(data)), end_(cur_ + size) {}
+
+  bool Done() const { return cur_ >= end_; }
+
+  // Read the key of the next field.
+  void ReadTag(uint32_t* field, uint32_t* wire_type) {
+    uint64_t key = ReadVarint();
+    *field = static_cast<uint32_t>(key >> 3);
+    *wire_type = static_cast<uint32_t>(key & 0x7);
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t res = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      CHECK(cur_ < end_) << "truncated varint";
+      uint8_t byte = *cur_++;
+      res |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return res;
+    }
+    LOG(FATAL) << "malformed varint";
+    return res;
+  }
+
+  uint32_t ReadFixed32() {
+    CHECK_LE(4, end_ - cur_) << "truncated fixed32";
+    uint32_t res;
+    memcpy(&res, cur_, sizeof(res));
+    cur_ += sizeof(res);
+    return res;
+  }
+
+  uint64_t ReadFixed64() {
+    CHECK_LE(8, end_ - cur_) << "truncated fixed64";
+    uint64_t res;
+    memcpy(&res, cur_, sizeof(res));
+    cur_ += sizeof(res);
+    return res;
+  }
+
+  float ReadFloat() {
+    uint32_t bits = ReadFixed32();
+    float res;
+    memcpy(&res, &bits, sizeof(res));
+    return res;
+  }
+
+  // Read a length-delimited field as a reader on its payload.
+  WireReader ReadLengthDelimited() {
+    uint64_t size = ReadVarint();
+    CHECK_LE(size, static_cast<uint64_t>(end_ - cur_))
+        << "truncated length-delimited field";
+    WireReader res(reinterpret_cast<const char*>(cur_), size);
+    cur_ += size;
+    return res;
+  }
+
+  std::string ReadString() {
+    WireReader payload = ReadLengthDelimited();
+    return std::string(reinterpret_cast<const char*>(payload.cur_),
+                       payload.end_ - payload.cur_);
+  }
+
+  void Skip(uint32_t wire_type) {
+    switch (wire_type) {
+      case kVarint:
+        ReadVarint();
+        break;
+      case kFixed64:
+        ReadFixed64();
+        break;
+      case kLengthDelimited:
+        ReadLengthDelimited();
+        break;
+      case kFixed32:
+        ReadFixed32();
+        break;
+      default:
+        LOG(FATAL) << "unsupported wire type " << wire_type;
+    }
+  }
+
+ private:
+  const uint8_t* cur_;
+  const uint8_t* end_;
+};
+
+// Decode a serialized framework.proto ProgramDesc into `prog`.
+void ParseProgramDesc(const char* data, size_t size, cpp::ProgramDesc* prog);
+
+// Decode a LoDTensor serialized by `TensorToStream` into `tensor`, return the
+// number of bytes consumed, so that a combined params buffer can be read
+// tensor by tensor.
+size_t ParseLoDTensor(const char* data, size_t size, lite::Tensor* tensor);
+
+// Decode the next LoDTensor of `is` into `tensor`. Only the small header is
+// buffered, the data is read straight into the tensor, so that a combined
+// params file is never held in memory as a whole.
+void ParseLoDTensor(std::istream* is, lite::Tensor* tensor);
+
+}  // namespace pb_wire
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,200 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/model_parser/pb_wire_parser.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lite/core/framework.pb.h"
+#include "lite/model_parser/compatible_pb.h"
+#include "lite/model_parser/model_parser.h"
+#include "lite/model_parser/pb/program_desc.h"
+
+namespace paddle {
+namespace lite {
+
+framework::proto::ProgramDesc MakeProgram() {
+  framework::proto::ProgramDesc prog;
+  prog.mutable_version()->set_version(1005000);
+  auto* block = prog.add_blocks();
+  block->set_idx(0);
+  block->set_parent_idx(-1);
+
+  auto* w = block->add_vars();
+  w->set_name("w");
+  w->set_persistable(true);
+  w->mutable_type()->set_type(framework::proto::VarType::LOD_TENSOR);
+  auto* x = block->add_vars();
+  x->set_name("x");
+  x->mutable_type()->set_type(framework::proto::VarType::LOD_TENSOR);
+
+  auto* op = block->add_ops();
+  op->set_type("conv2d");
+  auto* in = op->add_inputs();
+  in->set_parameter("Input");
+  in->add_arguments("x");
+  auto* filter = op->add_inputs();
+  filter->set_parameter("Filter");
+  filter->add_arguments("w");
+  auto* out = op->add_outputs();
+  out->set_parameter("Output");
+  out->add_arguments("y");
+
+  auto add_attr = [&](const std::string& name, framework::proto::AttrType t) {
+    auto* attr = op->add_attrs();
+    attr->set_name(name);
+    attr->set_type(t);
+    return attr;
+  };
+  add_attr("groups", framework::proto::INT)->set_i(-3);
+  add_attr("alpha", framework::proto::FLOAT)->set_f(0.5f);
+  add_attr("data_format", framework::proto::STRING)->set_s("NCHW");
+  add_attr("use_mkldnn", framework::proto::BOOLEAN)->set_b(true);
+  add_attr("seed", framework::proto::LONG)->set_l(-(1LL << 40));
+  auto* ints = add_attr("strides", framework::proto::INTS);
+  ints->add_ints(1);
+  ints->add_ints(-2);
+  auto* floats = add_attr("scales", framework::proto::FLOATS);
+  floats->add_floats(1.5f);
+  floats->add_floats(-2.f);
+  auto* strs = add_attr("names", framework::proto::STRINGS);
+  strs->add_strings("a");
+  strs->add_strings("bc");
+  auto* longs = add_attr("shape", framework::proto::LONGS);
+  longs->add_longs(-1);
+  longs->add_longs(1LL << 35);
+  add_attr("sub_block", framework::proto::BLOCK)->set_block_idx(2);
+  return prog;
+}
+
+TEST(PbWireParser, ParseProgramDesc) {
+  auto proto_prog = MakeProgram();
+  std::string buffer = proto_prog.SerializeAsString();
+
+  cpp::ProgramDesc expect;
+  pb::ProgramDesc pb_prog(&proto_prog);
+  TransformProgramDescAnyToCpp(pb_prog, &expect);
+
+  cpp::ProgramDesc actual;
+  pb_wire::ParseProgramDesc(buffer.data(), buffer.size(), &actual);
+
+  ASSERT_EQ(actual.Version(), expect.Version());
+  ASSERT_EQ(actual.BlocksSize(), expect.BlocksSize());
+  auto& eb = *expect.GetBlock<cpp::BlockDesc>(0);
+  auto& ab = *actual.GetBlock<cpp::BlockDesc>(0);
+  EXPECT_EQ(ab.Idx(), eb.Idx());
+  EXPECT_EQ(ab.ParentIdx(), eb.ParentIdx());
+  EXPECT_EQ(ab.ForwardBlockIdx(), eb.ForwardBlockIdx());
+  ASSERT_EQ(ab.VarsSize(), eb.VarsSize());
+  for (size_t i = 0; i < eb.VarsSize(); ++i) {
+    auto& ev = *eb.GetVar<cpp::VarDesc>(i);
+    auto& av = *ab.GetVar<cpp::VarDesc>(i);
+    EXPECT_EQ(av.Name(), ev.Name());
+    EXPECT_EQ(av.GetType(), ev.GetType());
+    EXPECT_EQ(av.Persistable(), ev.Persistable());
+  }
+
+  ASSERT_EQ(ab.OpsSize(), 1UL);
+  auto& eo = *eb.GetOp<cpp::OpDesc>(0);
+  auto& ao = *ab.GetOp<cpp::OpDesc>(0);
+  EXPECT_EQ(ao.Type(), eo.Type());
+  EXPECT_EQ(ao.inputs(), eo.inputs());
+  EXPECT_EQ(ao.outputs(), eo.outputs());
+  EXPECT_EQ(ao.attr_types(), eo.attr_types());
+  EXPECT_EQ(ao.GetAttr<int32_t>("groups"), -3);
+  EXPECT_EQ(ao.GetAttr<float>("alpha"), 0.5f);
+  EXPECT_EQ(ao.GetAttr<std::string>("data_format"), "NCHW");
+  EXPECT_EQ(ao.GetAttr<bool>("use_mkldnn"), true);
+  EXPECT_EQ(ao.GetAttr<int64_t>("seed"), -(1LL << 40));
+  EXPECT_EQ(ao.GetAttr<std::vector<int>>("strides"),
+            eo.GetAttr<std::vector<int>>("strides"));
+  EXPECT_EQ(ao.GetAttr<std::vector<float>>("scales"),
+            eo.GetAttr<std::vector<float>>("scales"));
+  EXPECT_EQ(ao.GetAttr<std::vector<std::string>>("names"),
+            eo.GetAttr<std::vector<std::string>>("names"));
+  EXPECT_EQ(ao.GetAttr<std::vector<int64_t>>("shape"),
+            eo.GetAttr<std::vector<int64_t>>("shape"));
+  EXPECT_EQ(ao.GetAttr<int32_t>("sub_block"), 2);
+}
+
+TEST(PbWireParser, ParseLoDTensor) {
+  lite::Tensor tensor;
+  tensor.Resize({2, 3});
+  tensor.set_precision(PRECISION(kFloat));
+  auto* data = tensor.mutable_data<float>();
+  for (int i = 0; i < tensor.numel(); ++i) {
+    data[i] = i * 0.25f;
+  }
+  tensor.mutable_lod()->push_back({0, 1, 2});
+
+  std::stringstream ss;
+  TensorToStream(ss, tensor);
+  TensorToStream(ss, tensor);
+  std::string buffer = ss.str();
+
+  size_t offset = 0;
+  for (int k = 0; k < 2; ++k) {
+    lite::Tensor out;
+    offset += pb_wire::ParseLoDTensor(
+        buffer.data() + offset, buffer.size() - offset, &out);
+    ASSERT_EQ(out.dims(), tensor.dims());
+    ASSERT_EQ(out.lod(), tensor.lod());
+    ASSERT_EQ(out.precision(), PRECISION(kFloat));
+    EXPECT_TRUE(out.persistable());
+    for (int i = 0; i < tensor.numel(); ++i) {
+      EXPECT_EQ(out.data<float>()[i], data[i]);
+    }
+  }
+  EXPECT_EQ(offset, buffer.size());
+}
+
+TEST(PbWireParser, ParseLoDTensorFromStream) {
+  lite::Tensor tensor;
+  tensor.Resize({4, 5});
+  tensor.set_precision(PRECISION(kInt32));
+  auto* data = tensor.mutable_data<int32_t>();
+  for (int i = 0; i < tensor.numel(); ++i) {
+    data[i] = i * 3 - 7;
+  }
+
+  std::stringstream ss;
+  TensorToStream(ss, tensor);
+  TensorToStream(ss, tensor);
+  for (int k = 0; k < 2; ++k) {
+    lite::Tensor out;
+    pb_wire::ParseLoDTensor(&ss, &out);
+    ASSERT_EQ(out.dims(), tensor.dims());
+    ASSERT_EQ(out.precision(), PRECISION(kInt32));
+    for (int i = 0; i < tensor.numel(); ++i) {
+      EXPECT_EQ(out.data<int32_t>()[i], data[i]);
+    }
+  }
+  ss.peek();
+  EXPECT_TRUE(ss.eof());
+}
+
+TEST(PbWireParser, ReadEmptyFile) {
+  const std::string path = "pb_wire_parser_test_empty";
+  std::ofstream(path, std::ios::binary).close();
+  std::string contents = "stale";
+  ReadBinaryFile(path, &contents);
+  EXPECT_TRUE(contents.empty());
+  std::remove(path.c_str());
+}
+
+}  // namespace lite
+}  // namespace paddle
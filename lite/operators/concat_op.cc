@@ -67,6 +67,9 @@ bool ConcatOpLite::AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) {
   CHECK(scope->FindVar(out));
   param_.output = scope->FindVar(out)->GetMutable<lite::Tensor>();
   param_.axis = op_desc.GetAttr<int>("axis");
+  if (op_desc.HasAttr("inplace")) {
+    param_.inplace = op_desc.GetAttr<bool>("inplace");
+  }
 
   return true;
 }
@@ -24,11 +24,12 @@ namespace operators {
 bool ConvOpLite::CheckShape() const {
   CHECK_OR_FALSE(param_.x);
   CHECK_OR_FALSE(param_.output);
-  CHECK_OR_FALSE(param_.filter);
+  CHECK_OR_FALSE(param_.filter || param_.sparse_filter.values);
   // bias is optional.
 
   const auto in_dims = param_.x->dims();
-  const auto filter_dims = param_.filter->dims();
+  const auto filter_dims =
+      param_.filter ? param_.filter->dims() : param_.sparse_filter.dims;
 
   CHECK_OR_FALSE(in_dims.size() == 4 || in_dims.size() == 5);
 
@@ -75,7 +76,8 @@ inline void UpdatePaddingAndDilation(std::vector<int>* paddings,
 
 bool ConvOpLite::InferShape() const {
   const auto in_dims = param_.x->dims();
-  const auto filter_dims = param_.filter->dims();
+  const auto filter_dims =
+      param_.filter ? param_.filter->dims() : param_.sparse_filter.dims;
 
   UpdatePaddingAndDilation(&param_.paddings,
                            &param_.dilations,
@@ -39,11 +39,16 @@ class ConvOpLite : public OpLite {
   // TODO(Superjomn) replace framework::OpDesc with a lite one.
   bool AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) override {
     auto X = op_desc.Input("Input").front();
-    auto Filter = op_desc.Input("Filter").front();
     auto Out = op_desc.Output("Output").front();
 
     param_.x = scope->FindVar(X)->GetMutable<lite::Tensor>();
-    param_.filter = scope->FindVar(Filter)->GetMutable<lite::Tensor>();
+    if (AttachSparseWeight(op_desc, scope, &param_.sparse_filter)) {
+      param_.filter = nullptr;
+    } else {
+      param_.sparse_filter = SparseWeightParam();
+      auto Filter = op_desc.Input("Filter").front();
+      param_.filter = scope->FindVar(Filter)->GetMutable<lite::Tensor>();
+    }
     param_.output = scope->FindVar(Out)->GetMutable<lite::Tensor>();
 
     param_.strides = op_desc.GetAttr<std::vector<int>>("strides");
@@ -23,3 +23,7 @@ namespace operators {}  // namespace operators
 
 REGISTER_LITE_OP(fake_dequantize_max_abs,
                  paddle::lite::operators::FakeDequantizeMaxAbsOpLite);
+// The dequantize op of the embedding tables quantized by PaddleSlim, it
+// computes the same out = x * scale / max_range.
+REGISTER_LITE_OP(dequantize_abs_max,
+                 paddle::lite::operators::FakeDequantizeMaxAbsOpLite);
@@ -58,6 +58,9 @@ bool FlattenOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   axis_ = opdesc.GetAttr<int>("axis");
 
   param_.inplace = false;
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
 
   CHECK(param_.x) << "Input(X) of FlattenOp should not be null.";
   CHECK(param_.output) << "Output(Out) of FlattenOp should not be null.";
@@ -0,0 +1,83 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_multihead_attention_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedMultiheadAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.Q);
+  CHECK_OR_FALSE(param_.K);
+  CHECK_OR_FALSE(param_.V);
+  CHECK_OR_FALSE(param_.Out);
+  const auto &q_dims = param_.Q->dims();
+  const auto &k_dims = param_.K->dims();
+  CHECK_EQ_OR_FALSE(q_dims.size(), 3UL);
+  CHECK_OR_FALSE(k_dims == q_dims);
+  CHECK_OR_FALSE(param_.V->dims() == q_dims);
+  CHECK_GT_OR_FALSE(param_.head_number, 0);
+  CHECK_EQ_OR_FALSE(q_dims[2] % param_.head_number, 0);
+  if (param_.BiasQK) {
+    // Broadcast to [batch, head_number, seq_len, seq_len] from the last axis,
+    // as the elementwise_add it replaces does.
+    const auto &bias_dims = param_.BiasQK->dims();
+    CHECK_GE_OR_FALSE(4UL, bias_dims.size());
+    const int64_t full[4] = {
+        q_dims[0], param_.head_number, q_dims[1], q_dims[1]};
+    const int offset = 4 - static_cast<int>(bias_dims.size());
+    for (size_t i = 0; i < bias_dims.size(); ++i) {
+      CHECK_OR_FALSE(bias_dims[i] == full[offset + i] || bias_dims[i] == 1);
+    }
+  }
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::InferShape() const {
+  param_.Out->Resize(param_.Q->dims());
+  *param_.Out->mutable_lod() = param_.Q->lod();
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::AttachImpl(const cpp::OpDesc &opdesc,
+                                           lite::Scope *scope) {
+  param_.Q =
+      scope->FindVar(opdesc.Input("Q").front())->GetMutable<lite::Tensor>();
+  param_.K =
+      scope->FindVar(opdesc.Input("K").front())->GetMutable<lite::Tensor>();
+  param_.V =
+      scope->FindVar(opdesc.Input("V").front())->GetMutable<lite::Tensor>();
+  param_.Out =
+      scope->FindVar(opdesc.Output("Out").front())->GetMutable<lite::Tensor>();
+  param_.BiasQK = nullptr;
+  if (opdesc.HasInput("BiasQK") && !opdesc.Input("BiasQK").empty()) {
+    param_.BiasQK = scope->FindVar(opdesc.Input("BiasQK").front())
+                        ->GetMutable<lite::Tensor>();
+  }
+  param_.head_number = opdesc.GetAttr<int>("head_number");
+  param_.alpha = opdesc.GetAttr<float>("alpha");
+  if (opdesc.HasAttr("out_scale")) {
+    param_.out_scale = opdesc.GetAttr<float>("out_scale");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_multihead_attention,
+                 paddle::lite::operators::FusedMultiheadAttentionOp);
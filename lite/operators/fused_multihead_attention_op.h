@@ -0,0 +1,61 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+#include <vector>
+#include "lite/core/op_lite.h"
+#include "lite/core/scope.h"
+#include "lite/utils/all.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+/*
+ * The scaled dot-product attention of a transformer layer over all the heads,
+ * fused from the chain of reshape2, transpose2, scale, matmul, elementwise_add,
+ * softmax, matmul, transpose2 and reshape2 by
+ * lite_multihead_attention_fuse_pass. For each head h:
+ *
+ *   Out[:, :, h] = softmax(alpha * Q[:, :, h] K[:, :, h]^T + BiasQK[:, h])
+ *                  V[:, :, h] * out_scale
+ *
+ * where Q[:, :, h] is the h-th slice of head_size columns.
+ */
+class FusedMultiheadAttentionOp : public OpLite {
+ public:
+  FusedMultiheadAttentionOp() {}
+  explicit FusedMultiheadAttentionOp(const std::string &op_type)
+      : OpLite(op_type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShape() const override;
+
+  bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
+
+  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+
+  std::string DebugString() const override {
+    return "fused_multihead_attention";
+  }
+
+ private:
+  mutable FusedMultiheadAttentionParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
@@ -30,9 +30,10 @@ bool LayerNormOp::CheckShape() const {
 bool LayerNormOp::InferShape() const {
   auto out_dims = param_.X->dims();
   param_.Y->Resize(out_dims);
-  auto inner_size = out_dims.Flatten2D(param_.begin_norm_axis)[1];
-  param_.Mean->Resize(std::vector<int64_t>({inner_size}));
-  param_.Variance->Resize(std::vector<int64_t>({inner_size}));
+  // One mean and one variance for each of the normalized rows.
+  auto left = out_dims.Flatten2D(param_.begin_norm_axis)[0];
+  param_.Mean->Resize(std::vector<int64_t>({left}));
+  param_.Variance->Resize(std::vector<int64_t>({left}));
 
   auto out_lod = param_.Y->mutable_lod();
   *out_lod = param_.X->lod();
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/operators/lookup_table_op.h"
+#include "lite/backends/host/math/rowwise_quant.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
 
@@ -33,6 +34,14 @@ bool LookupTableOpLite::CheckShape() const {
   CHECK_EQ_OR_FALSE(table_dims.size(), 2)
   CHECK_EQ_OR_FALSE(ids_dims[ids_rank - 1], 1)
 
+  if (param_.enable_int8) {
+    CHECK_OR_FALSE(param_.Scale)
+    CHECK_EQ_OR_FALSE(param_.Scale->numel(), table_dims[0])
+    CHECK_EQ_OR_FALSE(
+        table_dims[1],
+        host::math::QuantizedRowBytes(param_.row_width, param_.bit_length))
+  }
+
   return true;
 }
 
@@ -48,7 +57,7 @@ bool LookupTableOpLite::InferShape() const {
   for (int i = 0; i < ids_rank - 1; ++i) {
     out_dims.push_back(ids_dims[i]);
   }
-  out_dims.push_back(table_dims[1]);
+  out_dims.push_back(param_.enable_int8 ? param_.row_width : table_dims[1]);
   param_.Out->Resize(lite::DDim{out_dims});
   return true;
 }
@@ -65,6 +74,17 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc &op_desc,
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
 
+  // For the quantized table
+  if (op_desc.HasAttr("enable_int8")) {
+    param_.enable_int8 = op_desc.GetAttr<bool>("enable_int8");
+  }
+  if (param_.enable_int8) {
+    auto scale = op_desc.Input("Scale").front();
+    param_.Scale = scope->FindVar(scale)->GetMutable<lite::Tensor>();
+    param_.bit_length = op_desc.GetAttr<int>("bit_length");
+    param_.row_width = op_desc.GetAttr<int64_t>("row_width");
+  }
+
   return true;
 }
 
@@ -21,13 +21,13 @@ namespace operators {
 
 bool MulOpLite::CheckShape() const {
   CHECK_OR_FALSE(param_.x);
-  CHECK_OR_FALSE(param_.y);
+  CHECK_OR_FALSE(param_.y || param_.sparse_y.values);
   CHECK_OR_FALSE(param_.output);
 
   // bias is optional.
 
   const auto x_dims = param_.x->dims();
-  const auto y_dims = param_.y->dims();
+  const auto y_dims = param_.y ? param_.y->dims() : param_.sparse_y.dims;
 
   CHECK_GT_OR_FALSE(x_dims.size(), static_cast<size_t>(param_.x_num_col_dims));
   CHECK_GT_OR_FALSE(y_dims.size(), static_cast<size_t>(param_.y_num_col_dims));
@@ -52,7 +52,7 @@ bool MulOpLite::CheckShape() const {
 
 bool MulOpLite::InferShape() const {
   const auto x_dims = param_.x->dims();
-  const auto y_dims = param_.y->dims();
+  const auto y_dims = param_.y ? param_.y->dims() : param_.sparse_y.dims;
 
   // Set output dims
   std::vector<int64_t> out_dims;
@@ -39,24 +39,40 @@ class MulOpLite : public OpLite {
   // TODO(Superjomn) replace framework::OpDesc with a lite one.
   bool AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) override {
     CHECK(!op_desc.Input("X").empty());
-    CHECK(!op_desc.Input("Y").empty());
     CHECK(!op_desc.Output("Out").empty());
 
     auto input = op_desc.Input("X").front();
-    auto W = op_desc.Input("Y").front();
     auto out = op_desc.Output("Out").front();
     auto *var = scope->FindVar(input);
     CHECK(var);
     param_.x = &var->Get<Tensor>();
-    var = scope->FindVar(W);
-    CHECK(var) << "no var called " << W;
-    param_.y = &var->Get<Tensor>();
+    if (AttachSparseWeight(op_desc, scope, &param_.sparse_y)) {
+      param_.y = nullptr;
+    } else {
+      param_.sparse_y = SparseWeightParam();
+      CHECK(!op_desc.Input("Y").empty());
+      auto W = op_desc.Input("Y").front();
+      var = scope->FindVar(W);
+      CHECK(var) << "no var called " << W;
+      param_.y = &var->Get<Tensor>();
+    }
     var = scope->FindVar(out);
     CHECK(var) << "no var called " << out;
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
 
+    // For Int8
+    if (op_desc.HasAttr("enable_int8")) {
+      param_.enable_int8 = op_desc.GetAttr<bool>("enable_int8");
+      if (op_desc.HasAttr("input_scale"))
+        param_.input_scale = op_desc.GetAttr<float>("input_scale");
+      if (op_desc.HasAttr("weight_scale"))
+        param_.weight_scale =
+            op_desc.GetAttr<std::vector<float>>("weight_scale");
+      if (op_desc.HasAttr("output_scale"))
+        param_.output_scale = op_desc.GetAttr<float>("output_scale");
+    }
     return true;
   }
 
@@ -103,10 +103,45 @@ struct InterpolateParam {
   std::string interp_method{"Nearest"};
 };
 
+/*
+ * A weight pruned by the sparse_weight_pass. It is replaced by the
+ * "SparseWeight" input, its nonzero blocks, and the "SparseIndex" input,
+ * their int32 block-CSR index, see lite/backends/host/math/sparse_gemm.h. The
+ * dims of the dense weight and the size of the blocks are attributes.
+ */
+struct SparseWeightParam {
+  const lite::Tensor* values{};
+  const lite::Tensor* index{};
+  lite::DDim dims;
+  int block_h{1};
+  int block_w{1};
+};
+
+// Attach the sparse weight of an op, return false if its weight is dense.
+inline bool AttachSparseWeight(const cpp::OpDesc& op_desc,
+                               lite::Scope* scope,
+                               SparseWeightParam* param) {
+  if (!op_desc.HasInput("SparseWeight")) return false;
+  auto* values = scope->FindVar(op_desc.Input("SparseWeight").front());
+  auto* index = scope->FindVar(op_desc.Input("SparseIndex").front());
+  CHECK(values && index) << "the sparse weight is not loaded";
+  param->values = &values->Get<lite::Tensor>();
+  param->index = &index->Get<lite::Tensor>();
+  auto dims = op_desc.GetAttr<std::vector<int>>("sparse_weight_dims");
+  param->dims = lite::DDim(std::vector<int64_t>(dims.begin(), dims.end()));
+  auto block = op_desc.GetAttr<std::vector<int>>("sparse_block");
+  CHECK_EQ(block.size(), 2UL);
+  param->block_h = block[0];
+  param->block_w = block[1];
+  return true;
+}
+
 // For Mul Op
 struct MulParam {
   const lite::Tensor* x{};
+  // Null if the weight is sparse.
   const lite::Tensor* y{};
+  SparseWeightParam sparse_y;
   lite::Tensor* output{};
 
   int x_num_col_dims{1};
@@ -207,6 +242,8 @@ struct ConcatParam {
   std::vector<lite::Tensor*> x{};
   lite::Tensor* output{};
   int axis{0};
+  // Whether the inputs may be turned into views of the output.
+  bool inplace{false};
 };
 
 /// ----------------------- activation operators ----------------------
@@ -236,7 +273,9 @@ struct ActivationGradParam {
 // For Convolution op
 struct ConvParam {
   lite::Tensor* x{};
+  // Null if the filter is sparse.
   lite::Tensor* filter{};
+  SparseWeightParam sparse_filter;
   lite::Tensor* bias{nullptr};
   lite::Tensor* residualData{nullptr};
   lite::Tensor* output{};
@@ -319,6 +358,8 @@ struct SplitParam {
   int axis{-1};
   int num{0};
   std::vector<int> sections;
+  // Only splitting the outermost axis can be inplace.
+  bool inplace{false};
 };
 
 // For Transpose op
@@ -615,6 +656,13 @@ struct LookupTableParam {
   lite::Tensor* Ids{nullptr};
   lite::Tensor* Out{nullptr};
   int64_t padding_idx{-1};
+  // For the row-wise quantized table, W holds the quantized rows, see
+  // lite/backends/host/math/rowwise_quant.h, and Scale holds one scale per
+  // row.
+  bool enable_int8{false};
+  int bit_length{8};
+  int64_t row_width{0};
+  lite::Tensor* Scale{nullptr};
 };
 
 struct Im2SequenceParam {
@@ -773,6 +821,8 @@ struct SliceParam {
   std::vector<int> starts{};
   std::vector<int> ends{};
   std::vector<int> decrease_axis{};
+  // Only slicing the outermost axis can be inplace.
+  bool inplace{false};
 };
 
 struct AffineChannelParam {
@@ -820,6 +870,7 @@ struct SqueezeParam {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  bool inplace{false};
 };
 
 struct UnsqueezeParam {
@@ -827,6 +878,7 @@ struct UnsqueezeParam {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  bool inplace{false};
 };
 
 /// ----------------------- expand operators ----------------------
@@ -846,6 +898,21 @@ struct MatMulParam {
   float alpha{1.0f};
 };
 
+// For the fused_multihead_attention op, Q, K, V and Out are [batch, seq_len,
+// head_number * head_size], BiasQK is added to the scores of each head.
+struct FusedMultiheadAttentionParam {
+  const lite::Tensor* Q{};
+  const lite::Tensor* K{};
+  const lite::Tensor* V{};
+  const lite::Tensor* BiasQK{};
+  lite::Tensor* Out{};
+  int head_number{1};
+  // The scale of the scores before softmax.
+  float alpha{1.0f};
+  // The scale of the output, folded from dropout and the second matmul.
+  float out_scale{1.0f};
+};
+
 struct GatherParam {
   const lite::Tensor* X{};
   const lite::Tensor* Index{};
@@ -82,6 +82,9 @@ bool SliceOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   if (opdesc.HasAttr("decrease_axis")) {
     param_.decrease_axis = opdesc.GetAttr<std::vector<int>>("decrease_axis");
   }
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
   return true;
 }
 
@@ -94,6 +94,9 @@ bool SqueezeOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   if (opdesc.HasAttr("axes")) {
     param_.axes = opdesc.GetAttr<std::vector<int>>("axes");
   }
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
   CHECK(param_.X) << "Input(X) of SqueezeOp should not be null.";
   CHECK(param_.Out) << "Output(Out) of SqueezeOp should not be null.";
   return true;
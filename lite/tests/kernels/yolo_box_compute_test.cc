@@ -243,9 +243,9 @@ void test_yolobox(Place place) {
 }
 
 TEST(YoloBox, precision) {
-// #ifdef LITE_WITH_X86
-//   Place place(TARGET(kX86));
-// #endif
+#ifdef LITE_WITH_X86
+  test_yolobox(Place(TARGET(kHost)));
+#endif
 #ifdef LITE_WITH_ARM
   Place place(TARGET(kARM));
   test_yolobox(place);
@@ -51,10 +51,14 @@
 
 #ifdef LITE_SHUTDOWN_LOG
 #define VLOG(level) paddle::lite::Voidify()
+#define VLOG_IS_ON(level) false
 #else
 // VLOG()
 #define VLOG(level) \
   paddle::lite::VLogMessage(__FILE__, __FUNCTION__, __LINE__, level).stream()
+// The arguments of VLOG are always evaluated, guard the expensive logging
+// loops with VLOG_IS_ON, the same as glog.
+#define VLOG_IS_ON(level) (paddle::lite::VLogLevel() >= (level))
 #endif
 
 // CHECK()
@@ -130,6 +134,12 @@ class LogMessageFatal : public LogMessage {
   }
 };
 
+// The verbose level set by the environment variable GLOG_v.
+inline int32_t VLogLevel() {
+  const char* GLOG_v = std::getenv("GLOG_v");
+  return (GLOG_v && atoi(GLOG_v) > 0) ? atoi(GLOG_v) : 0;
+}
+
 // VLOG
 class VLogMessage {
  public: